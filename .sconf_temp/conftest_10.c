@@ -0,0 +1,18 @@
+
+
+#include <assert.h>
+
+#ifdef __cplusplus
+extern "C"
+#endif
+char XScreenSaverQueryExtension();
+
+int main() {
+#if defined (__stub_XScreenSaverQueryExtension) || defined (__stub___XScreenSaverQueryExtension)
+  fail fail fail
+#else
+  XScreenSaverQueryExtension();
+#endif
+
+  return 0;
+}
@@ -0,0 +1,10 @@
+
+
+#include "stdio.h"
+#include "editline/readline.h"
+
+int
+main() {
+  
+return 0;
+}
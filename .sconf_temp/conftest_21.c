@@ -0,0 +1,3 @@
+
+#include "openssl/ssl.h"
+
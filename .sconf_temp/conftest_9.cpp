@@ -0,0 +1,3 @@
+
+#include "boost/signals.hpp"
+
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -20,6 +20,8 @@
 #include "Swiften/Elements/AuthSuccess.h"
 #include "Swiften/Elements/AuthFailure.h"
 #include "Swiften/Elements/AuthRequest.h"
+#include "Swiften/Elements/StartTLSRequest.h"
+#include "Swiften/Elements/TLSProceed.h"
 #include "Swiften/SASL/PLAINMessage.h"
 
 namespace Swift {
@@ -36,7 +38,8 @@ ServerFromClientSession::ServerFromClientSession(
 			userRegistry_(userRegistry),
 			authenticated_(false),
 			initialized(false),
-			allowSASLEXTERNAL(false) {
+			allowSASLEXTERNAL(false),
+			tlsContextFactory_(NULL) {
 }
 
 
@@ -45,7 +48,18 @@ void ServerFromClientSession::handleElement(boost::shared_ptr<ToplevelElement> e
 		onElementReceived(element);
 	}
 	else {
-		if (AuthRequest* authRequest = dynamic_cast<AuthRequest*>(element.get())) {
+		if (dynamic_cast<StartTLSRequest*>(element.get())) {
+			if (tlsContextFactory_ && !isTLSEncrypted() && !authenticated_) {
+				getXMPPLayer()->writeElement(boost::make_shared<TLSProceed>());
+				if (!addTLSEncryption(tlsContextFactory_, tlsCertificate_)) {
+					finishSession(TLSError);
+				}
+			}
+			else {
+				finishSession(UnexpectedElementError);
+			}
+		}
+		else if (AuthRequest* authRequest = dynamic_cast<AuthRequest*>(element.get())) {
 			if (authRequest->getMechanism() == "PLAIN" || (allowSASLEXTERNAL && authRequest->getMechanism() == "EXTERNAL")) {
 				if (authRequest->getMechanism() == "EXTERNAL") {
 						getXMPPLayer()->writeElement(boost::make_shared<AuthSuccess>());
@@ -95,6 +109,9 @@ void ServerFromClientSession::handleStreamStart(const ProtocolHeader& incomingHe
 
 	boost::shared_ptr<StreamFeatures> features(new StreamFeatures());
 	if (!authenticated_) {
+		if (tlsContextFactory_ && !isTLSEncrypted()) {
+			features->setHasStartTLS();
+		}
 		features->addAuthenticationMechanism("PLAIN");
 		if (allowSASLEXTERNAL) {
 			features->addAuthenticationMechanism("EXTERNAL");
@@ -116,4 +133,9 @@ void ServerFromClientSession::setAllowSASLEXTERNAL() {
 	allowSASLEXTERNAL = true;
 }
 
+void ServerFromClientSession::setAllowStartTLS(TLSContextFactory* tlsContextFactory, CertificateWithKey::ref certificate) {
+	tlsContextFactory_ = tlsContextFactory;
+	tlsCertificate_ = certificate;
+}
+
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -15,6 +15,7 @@
 #include <Swiften/JID/JID.h>
 #include <Swiften/Network/Connection.h>
 #include <Swiften/Base/ByteArray.h>
+#include <Swiften/TLS/CertificateWithKey.h>
 
 namespace Swift {
 	class ProtocolHeader;
@@ -28,6 +29,7 @@ namespace Swift {
 	class ConnectionLayer;
 	class Connection;
 	class XMLParserFactory;
+	class TLSContextFactory;
 
 	class ServerFromClientSession : public Session {
 		public:
@@ -42,6 +44,11 @@ namespace Swift {
 			boost::signal<void ()> onSessionStarted;
 			void setAllowSASLEXTERNAL();
 
+			/**
+			 * Offers STARTTLS to the client, using the given certificate.
+			 */
+			void setAllowStartTLS(TLSContextFactory* tlsContextFactory, CertificateWithKey::ref certificate);
+
 		private:
 			void handleElement(boost::shared_ptr<ToplevelElement>);
 			void handleStreamStart(const ProtocolHeader& header);
@@ -57,6 +64,8 @@ namespace Swift {
 			bool authenticated_;
 			bool initialized;
 			bool allowSASLEXTERNAL;
+			TLSContextFactory* tlsContextFactory_;
+			CertificateWithKey::ref tlsCertificate_;
 			std::string user_;
 	};
 }
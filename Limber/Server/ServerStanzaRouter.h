@@ -1,13 +1,15 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <string>
+#include <vector>
 #include <boost/shared_ptr.hpp>
-#include <map>
+#include <boost/unordered_map.hpp>
 
 #include <Swiften/JID/JID.h>
 #include <Swiften/Elements/Stanza.h>
@@ -25,6 +27,8 @@ namespace Swift {
 			void removeClientSession(ServerSession*);
 
 		private:
-			std::vector<ServerSession*> clientSessions_;
+			// Client sessions, indexed by bare JID
+			typedef boost::unordered_map<std::string, std::vector<ServerSession*> > SessionIndex;
+			SessionIndex clientSessions_;
 	};
 }
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/lexical_cast.hpp>
 
 #include "Swiften/Elements/Message.h"
 #include "Limber/Server/ServerStanzaRouter.h"
@@ -22,6 +23,9 @@ class ServerStanzaRouterTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testRouteStanza_BareJIDWithMultipleSessions);
 		CPPUNIT_TEST(testRouteStanza_BareJIDWithOnlyNegativePriorities);
 		CPPUNIT_TEST(testRouteStanza_BareJIDWithChangingPresence);
+		CPPUNIT_TEST(testRouteStanza_BareJIDWithOtherUserSessions);
+		CPPUNIT_TEST(testRouteStanza_AfterRemoveClientSession);
+		CPPUNIT_TEST(testRouteStanza_ManySessions);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -123,6 +127,65 @@ class ServerStanzaRouterTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(session2.sentStanzas.size()));
 		}
 
+		void testRouteStanza_BareJIDWithOtherUserSessions() {
+			ServerStanzaRouter testling;
+			MockServerSession session1(JID("foo@bar.com/Bla"), 1);
+			testling.addClientSession(&session1);
+			MockServerSession session2(JID("baz@bar.com/Bla"), 8);
+			testling.addClientSession(&session2);
+
+			bool result = testling.routeStanza(createMessageTo("foo@bar.com"));
+
+			CPPUNIT_ASSERT(result);
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(session1.sentStanzas.size()));
+			CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(session2.sentStanzas.size()));
+		}
+
+		void testRouteStanza_AfterRemoveClientSession() {
+			ServerStanzaRouter testling;
+			MockServerSession session1(JID("foo@bar.com/Bla"), 1);
+			testling.addClientSession(&session1);
+			MockServerSession session2(JID("foo@bar.com/Baz"), 8);
+			testling.addClientSession(&session2);
+
+			testling.removeClientSession(&session2);
+			bool result = testling.routeStanza(createMessageTo("foo@bar.com/Baz"));
+
+			CPPUNIT_ASSERT(result);
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(session1.sentStanzas.size()));
+			CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(session2.sentStanzas.size()));
+
+			testling.removeClientSession(&session1);
+			CPPUNIT_ASSERT(!testling.routeStanza(createMessageTo("foo@bar.com")));
+		}
+
+		void testRouteStanza_ManySessions() {
+			ServerStanzaRouter testling;
+			std::vector<MockServerSession*> sessions;
+			for (int i = 0; i < 10000; ++i) {
+				std::string user = "user" + boost::lexical_cast<std::string>(i) + "@bar.com";
+				sessions.push_back(new MockServerSession(JID(user + "/Bla"), 1));
+				testling.addClientSession(sessions.back());
+				sessions.push_back(new MockServerSession(JID(user + "/Baz"), 2));
+				testling.addClientSession(sessions.back());
+			}
+
+			for (int i = 0; i < 10000; ++i) {
+				std::string user = "user" + boost::lexical_cast<std::string>(i) + "@bar.com";
+				CPPUNIT_ASSERT(testling.routeStanza(createMessageTo(user)));
+				CPPUNIT_ASSERT(testling.routeStanza(createMessageTo(user + "/Bla")));
+			}
+
+			for (size_t i = 0; i < sessions.size(); i += 2) {
+				CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(sessions[i]->sentStanzas.size()));
+				CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(sessions[i+1]->sentStanzas.size()));
+			}
+			for (size_t i = 0; i < sessions.size(); ++i) {
+				testling.removeClientSession(sessions[i]);
+				delete sessions[i];
+			}
+		}
+
 	private:
 		boost::shared_ptr<Message> createMessageTo(const std::string& recipient) {
 			boost::shared_ptr<Message> message(new Message());
@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <string>
+#include <iostream>
 #include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -25,12 +26,14 @@
 #include "Swiften/Parser/PayloadParsers/FullPayloadParserFactoryCollection.h"
 #include "Swiften/Parser/PlatformXMLParserFactory.h"
 #include "Swiften/Serializer/PayloadSerializers/FullPayloadSerializerCollection.h"
+#include "Swiften/TLS/PlatformTLSFactories.h"
+#include "Swiften/TLS/PKCS12Certificate.h"
 
 using namespace Swift;
 
 class Server {
 	public:
-		Server(UserRegistry* userRegistry, EventLoop* eventLoop) : userRegistry_(userRegistry) {
+		Server(UserRegistry* userRegistry, EventLoop* eventLoop, CertificateWithKey::ref certificate) : userRegistry_(userRegistry), certificate_(certificate) {
 			serverFromClientConnectionServer_ = BoostConnectionServer::create(5222, boostIOServiceThread_.getIOService(), eventLoop);
 			serverFromClientConnectionServer_->onNewConnection.connect(boost::bind(&Server::handleNewConnection, this, _1));
 			serverFromClientConnectionServer_->start();
@@ -39,6 +42,9 @@ class Server {
 	private:
 		void handleNewConnection(boost::shared_ptr<Connection> c) {
 			boost::shared_ptr<ServerFromClientSession> session(new ServerFromClientSession(idGenerator_.generateID(), c, &payloadParserFactories_, &payloadSerializers_, &xmlParserFactory, userRegistry_));
+			if (certificate_) {
+				session->setAllowStartTLS(tlsFactories_.getTLSContextFactory(), certificate_);
+			}
 			serverFromClientSessions_.push_back(session);
 			session->onElementReceived.connect(boost::bind(&Server::handleElementReceived, this, _1, session));
 			session->onSessionFinished.connect(boost::bind(&Server::handleSessionFinished, this, session));
@@ -84,6 +90,8 @@ class Server {
 		IDGenerator idGenerator_;
 		PlatformXMLParserFactory xmlParserFactory;
 		UserRegistry* userRegistry_;
+		PlatformTLSFactories tlsFactories_;
+		CertificateWithKey::ref certificate_;
 		BoostIOServiceThread boostIOServiceThread_;
 		boost::shared_ptr<BoostConnectionServer> serverFromClientConnectionServer_;
 		std::vector< boost::shared_ptr<ServerFromClientSession> > serverFromClientSessions_;
@@ -91,14 +99,24 @@ class Server {
 		FullPayloadSerializerCollection payloadSerializers_;
 };
 
-int main() {
+int main(int argc, char* argv[]) {
+	CertificateWithKey::ref certificate;
+	if (argc > 1) {
+		// Enables STARTTLS with the given PKCS#12 certificate
+		certificate = boost::make_shared<PKCS12Certificate>(argv[1], createSafeByteArray(argc > 2 ? argv[2] : ""));
+		if (certificate->isNull()) {
+			std::cerr << "Unable to load certificate " << argv[1] << std::endl;
+			return -1;
+		}
+	}
+
 	SimpleEventLoop eventLoop;
 	SimpleUserRegistry userRegistry;
 	userRegistry.addUser(JID("remko@localhost"), "remko");
 	userRegistry.addUser(JID("kevin@localhost"), "kevin");
 	userRegistry.addUser(JID("remko@limber.swift.im"), "remko");
 	userRegistry.addUser(JID("kevin@limber.swift.im"), "kevin");
-	Server server(&userRegistry, &eventLoop);
+	Server server(&userRegistry, &eventLoop, certificate);
 	eventLoop.run();
 	return 0;
 }
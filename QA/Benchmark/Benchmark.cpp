@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cstring>
+#include <iostream>
+
+#include <QA/Benchmark/Benchmarks.h>
+
+using namespace Swift;
+
+namespace {
+	struct Benchmark {
+		const char* name;
+		void (*run)(const BenchmarkArguments&);
+		const char* description;
+	};
+
+	const Benchmark benchmarks[] = {
+		{ "parser", &runParserBenchmark, "Parses stanzas, and counts allocations per stanza" },
+		{ "arena", &runParserArenaBenchmark, "Parses large rosters with or without arenas (on|off), and measures allocations and RSS" },
+		{ "connection", &runConnectionBenchmark, "Writes chunks over a loopback BoostConnection pair, and measures throughput" },
+		{ "eventloop", &runEventLoopBenchmark, "Posts events to a SimpleEventLoop from several threads, and measures throughput" },
+		{ "jid", &runJIDBenchmark, "Constructs ASCII and non-ASCII JIDs from several threads, and measures throughput" },
+		{ "router", &runRouterBenchmark, "Routes messages with 1000, 10000, and 100000 client sessions in ServerStanzaRouter" },
+		{ "filetransfer", &runFileTransferBenchmark, "Sends a file over a loopback SOCKS5 bytestream, and measures throughput and CPU time" },
+		{ "ack", &runStanzaAckBenchmark, "Sends messages over an in-memory stream with stream management, acking every 1, 10, and 100 messages" },
+		{ "id", &runIDGeneratorBenchmark, "Generates IDs from several threads, with shared, per-thread, and per-ID generators" },
+#ifdef HAVE_OPENSSL
+		{ "tls", &runTLSContextBenchmark, "Sets up 1000 OpenSSL client contexts with a shared SSL_CTX or one SSL_CTX each (shared|separate), and measures time and RSS" },
+#endif
+	};
+	const size_t benchmarkCount = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+	void printUsage() {
+		std::cerr << "Usage: Benchmark <benchmark> [arguments]" << std::endl << std::endl;
+		std::cerr << "Benchmarks:" << std::endl;
+		for (size_t i = 0; i < benchmarkCount; ++i) {
+			std::cerr << "  " << benchmarks[i].name << ": " << benchmarks[i].description << std::endl;
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		printUsage();
+		return -1;
+	}
+	for (size_t i = 0; i < benchmarkCount; ++i) {
+		if (std::strcmp(argv[1], benchmarks[i].name) == 0) {
+			std::cout << benchmarks[i].name << ": " << benchmarks[i].description << std::endl;
+			benchmarks[i].run(BenchmarkArguments(argv + 2, argv + argc));
+			return 0;
+		}
+	}
+	printUsage();
+	return -1;
+}
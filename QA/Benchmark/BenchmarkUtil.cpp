@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sys/resource.h>
+#include <boost/atomic.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace {
+	boost::atomic<size_t> allocationCount(0);
+}
+
+// Count every heap allocation of the process
+void* operator new(size_t size) {
+	allocationCount.fetch_add(1, boost::memory_order_relaxed);
+	void* result = std::malloc(size ? size : 1);
+	if (!result) {
+		throw std::bad_alloc();
+	}
+	return result;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* pointer) throw() {
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) throw() {
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) throw() {
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) throw() {
+	std::free(pointer);
+}
+
+namespace Swift {
+
+BenchmarkTimer::BenchmarkTimer() : start(boost::posix_time::microsec_clock::universal_time()) {
+}
+
+double BenchmarkTimer::getSeconds() const {
+	return static_cast<double>((boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()) / 1000000.0;
+}
+
+size_t getAllocationCount() {
+	return allocationCount.load(boost::memory_order_relaxed);
+}
+
+long getPeakRSS() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+double getCPUTime() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+void printResult(const std::string& description, double value, const std::string& unit) {
+	std::cout << "  " << std::left << std::setw(48) << description << std::right << std::setw(14) << std::fixed << std::setprecision(2) << value << " " << unit << std::endl;
+}
+
+}
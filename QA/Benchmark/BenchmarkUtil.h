@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace Swift {
+	/**
+	 * Measures the wall clock time since its construction.
+	 */
+	class BenchmarkTimer {
+		public:
+			BenchmarkTimer();
+
+			double getSeconds() const;
+
+		private:
+			boost::posix_time::ptime start;
+	};
+
+	/**
+	 * Returns the number of heap allocations done by the process so far.
+	 */
+	size_t getAllocationCount();
+
+	/**
+	 * Returns the peak resident set size of the process, in kilobytes.
+	 */
+	long getPeakRSS();
+
+	/**
+	 * Returns the CPU time (user and system) used by the process so far, in
+	 * seconds.
+	 */
+	double getCPUTime();
+
+	void printResult(const std::string& description, double value, const std::string& unit);
+}
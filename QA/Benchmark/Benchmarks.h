@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Swift {
+	typedef std::vector<std::string> BenchmarkArguments;
+
+	void runParserBenchmark(const BenchmarkArguments&);
+	void runParserArenaBenchmark(const BenchmarkArguments&);
+	void runConnectionBenchmark(const BenchmarkArguments&);
+	void runEventLoopBenchmark(const BenchmarkArguments&);
+	void runJIDBenchmark(const BenchmarkArguments&);
+	void runRouterBenchmark(const BenchmarkArguments&);
+	void runFileTransferBenchmark(const BenchmarkArguments&);
+	void runStanzaAckBenchmark(const BenchmarkArguments&);
+	void runIDGeneratorBenchmark(const BenchmarkArguments&);
+#ifdef HAVE_OPENSSL
+	void runTLSContextBenchmark(const BenchmarkArguments&);
+#endif
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <iostream>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <Swiften/Base/SafeByteArray.h>
+#include <Swiften/EventLoop/SimpleEventLoop.h>
+#include <Swiften/Network/BoostConnection.h>
+#include <Swiften/Network/BoostConnectionServer.h>
+#include <Swiften/Network/BoostIOServiceThread.h>
+#include <Swiften/Network/HostAddress.h>
+#include <Swiften/Network/HostAddressPort.h>
+
+#include <QA/Benchmark/Benchmarks.h>
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+namespace Swift {
+
+namespace {
+	// The maximum number of bytes written but not yet received
+	const size_t WINDOW_SIZE = 256 * 1024;
+
+	/**
+	 * Writes chunks from a client connection to a server connection over the
+	 * loopback interface, until the server has received all of them.
+	 */
+	class LoopbackWriter {
+		public:
+			LoopbackWriter(SimpleEventLoop* eventLoop, size_t chunkCount, size_t chunkSize) : eventLoop(eventLoop), chunkCount(chunkCount), chunkSize(chunkSize), writtenChunks(0), receivedBytes(0), seconds(0), chunk(chunkSize, 'a') {
+			}
+
+			void handleNewConnection(boost::shared_ptr<Connection> connection) {
+				serverConnection = connection;
+				serverConnection->onDataRead.connect(boost::bind(&LoopbackWriter::handleDataRead, this, _1));
+			}
+
+			void handleConnectFinished(bool error) {
+				if (error) {
+					std::cerr << "Unable to connect" << std::endl;
+					eventLoop->stop();
+					return;
+				}
+				timer = BenchmarkTimer();
+				writeChunks();
+			}
+
+			void writeChunks() {
+				while (writtenChunks < chunkCount && writtenChunks * chunkSize - receivedBytes < WINDOW_SIZE) {
+					clientConnection->write(chunk);
+					++writtenChunks;
+				}
+			}
+
+			void handleDataRead(boost::shared_ptr<SafeByteArray> data) {
+				receivedBytes += data->size();
+				if (receivedBytes >= chunkCount * chunkSize) {
+					seconds = timer.getSeconds();
+					eventLoop->stop();
+				}
+				else {
+					writeChunks();
+				}
+			}
+
+			SimpleEventLoop* eventLoop;
+			size_t chunkCount;
+			size_t chunkSize;
+			size_t writtenChunks;
+			size_t receivedBytes;
+			BenchmarkTimer timer;
+			double seconds;
+			SafeByteArray chunk;
+			boost::shared_ptr<Connection> clientConnection;
+			boost::shared_ptr<Connection> serverConnection;
+	};
+}
+
+void runConnectionBenchmark(const BenchmarkArguments& arguments) {
+	size_t chunkCount = arguments.size() < 1 ? 100000 : boost::lexical_cast<size_t>(arguments[0]);
+	size_t chunkSize = arguments.size() < 2 ? 100 : boost::lexical_cast<size_t>(arguments[1]);
+
+	SimpleEventLoop eventLoop;
+	BoostIOServiceThread ioServiceThread;
+	LoopbackWriter writer(&eventLoop, chunkCount, chunkSize);
+
+	BoostConnectionServer::ref server = BoostConnectionServer::create(HostAddress("127.0.0.1"), 0, ioServiceThread.getIOService(), &eventLoop);
+	server->onNewConnection.connect(boost::bind(&LoopbackWriter::handleNewConnection, &writer, _1));
+	server->start();
+
+	BoostConnection::ref client = BoostConnection::create(ioServiceThread.getIOService(), &eventLoop);
+	writer.clientConnection = client;
+	client->onConnectFinished.connect(boost::bind(&LoopbackWriter::handleConnectFinished, &writer, _1));
+	client->connect(HostAddressPort(HostAddress("127.0.0.1"), server->getAddressPort().getPort()));
+
+	double cpuTimeBefore = getCPUTime();
+	eventLoop.run();
+	double cpuTime = getCPUTime() - cpuTimeBefore;
+
+	if (writer.receivedBytes >= chunkCount * chunkSize) {
+		double megabytes = static_cast<double>(chunkCount * chunkSize) / (1024.0 * 1024.0);
+		printResult("Chunk size", static_cast<double>(chunkSize), "bytes");
+		printResult("Throughput", megabytes / writer.seconds, "MB/s");
+		printResult("Writes", static_cast<double>(chunkCount) / writer.seconds, "writes/s");
+		printResult("CPU time", cpuTime * 1024.0 / megabytes, "s/GB");
+	}
+
+	client->disconnect();
+	if (writer.serverConnection) {
+		writer.serverConnection->disconnect();
+	}
+	server->stop();
+}
+
+}
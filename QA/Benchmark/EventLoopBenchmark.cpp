@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+#include <boost/thread.hpp>
+
+#include <Swiften/EventLoop/EventOwner.h>
+#include <Swiften/EventLoop/SimpleEventLoop.h>
+
+#include <QA/Benchmark/Benchmarks.h>
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+namespace Swift {
+
+namespace {
+	class BenchmarkEventOwner : public EventOwner {
+	};
+
+	class EventCounter {
+		public:
+			EventCounter(SimpleEventLoop* eventLoop, size_t expectedEvents) : eventLoop(eventLoop), expectedEvents(expectedEvents), handledEvents(0) {
+			}
+
+			void handleEvent() {
+				if (++handledEvents == expectedEvents) {
+					eventLoop->stop();
+				}
+			}
+
+			SimpleEventLoop* eventLoop;
+			size_t expectedEvents;
+			size_t handledEvents;
+	};
+
+	void postEvents(SimpleEventLoop* eventLoop, EventCounter* counter, size_t count, boost::shared_ptr<EventOwner> owner) {
+		for (size_t i = 0; i < count; ++i) {
+			eventLoop->postEvent(boost::bind(&EventCounter::handleEvent, counter), owner);
+		}
+	}
+}
+
+void runEventLoopBenchmark(const BenchmarkArguments& arguments) {
+	size_t producerCount = arguments.size() < 1 ? 4 : boost::lexical_cast<size_t>(arguments[0]);
+	size_t eventsPerProducer = arguments.size() < 2 ? 250000 : boost::lexical_cast<size_t>(arguments[1]);
+
+	SimpleEventLoop eventLoop;
+	EventCounter counter(&eventLoop, producerCount * eventsPerProducer);
+	boost::shared_ptr<EventOwner> owner = boost::make_shared<BenchmarkEventOwner>();
+
+	BenchmarkTimer timer;
+	double cpuTimeBefore = getCPUTime();
+	boost::thread_group producers;
+	for (size_t i = 0; i < producerCount; ++i) {
+		producers.create_thread(boost::bind(&postEvents, &eventLoop, &counter, eventsPerProducer, owner));
+	}
+	eventLoop.run();
+	double seconds = timer.getSeconds();
+	double cpuTime = getCPUTime() - cpuTimeBefore;
+	producers.join_all();
+
+	printResult("Producers", static_cast<double>(producerCount), "threads");
+	printResult("Throughput", static_cast<double>(counter.handledEvents) / seconds, "events/s");
+	printResult("CPU time", cpuTime * 1000000000.0 / static_cast<double>(counter.handledEvents), "ns/event");
+}
+
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+
+#include <Swiften/EventLoop/SimpleEventLoop.h>
+#include <Swiften/FileTransfer/FileReadBytestream.h>
+#include <Swiften/FileTransfer/SOCKS5BytestreamClientSession.h>
+#include <Swiften/FileTransfer/SOCKS5BytestreamRegistry.h>
+#include <Swiften/FileTransfer/SOCKS5BytestreamServerSession.h>
+#include <Swiften/FileTransfer/WriteBytestream.h>
+#include <Swiften/Network/BoostConnection.h>
+#include <Swiften/Network/BoostConnectionServer.h>
+#include <Swiften/Network/BoostIOServiceThread.h>
+#include <Swiften/Network/BoostTimerFactory.h>
+#include <Swiften/Network/HostAddress.h>
+#include <Swiften/Network/HostAddressPort.h>
+
+#include <QA/Benchmark/Benchmarks.h>
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+namespace Swift {
+
+namespace {
+	const std::string destination = "benchmark-destination";
+
+	/**
+	 * Counts the received bytes, and stops the event loop once the whole
+	 * file was received.
+	 */
+	class CountingWriteBytestream : public WriteBytestream {
+		public:
+			CountingWriteBytestream(SimpleEventLoop* eventLoop, boost::uintmax_t size) : eventLoop(eventLoop), size(size), receivedBytes(0), finished(false), seconds(0) {
+			}
+
+			virtual void write(const std::vector<unsigned char>& data) {
+				receivedBytes += data.size();
+				if (receivedBytes >= size && !finished) {
+					finished = true;
+					seconds = timer.getSeconds();
+					eventLoop->stop();
+				}
+			}
+
+			void startTimer() {
+				timer = BenchmarkTimer();
+			}
+
+			SimpleEventLoop* eventLoop;
+			boost::uintmax_t size;
+			boost::uintmax_t receivedBytes;
+			bool finished;
+			BenchmarkTimer timer;
+			double seconds;
+	};
+
+	/**
+	 * Sends a file from a SOCKS5 bytestream server session to a client
+	 * session over the loopback interface.
+	 */
+	class LoopbackTransfer {
+		public:
+			LoopbackTransfer(const boost::filesystem::path& file, SimpleEventLoop* eventLoop, boost::uintmax_t size) : file(file), eventLoop(eventLoop) {
+				receivedStream = boost::make_shared<CountingWriteBytestream>(eventLoop, size);
+				registry.setHasBytestream(destination, true);
+			}
+
+			void handleNewConnection(boost::shared_ptr<Connection> connection) {
+				serverSession = boost::make_shared<SOCKS5BytestreamServerSession>(connection, &registry);
+				serverSession->start();
+			}
+
+			void handleSessionReady(bool error) {
+				if (error || !serverSession) {
+					std::cerr << "Unable to set up the bytestream" << std::endl;
+					eventLoop->stop();
+					return;
+				}
+				receivedStream->startTimer();
+				clientSession->startReceiving(receivedStream);
+				serverSession->startSending(boost::make_shared<FileReadBytestream>(file));
+			}
+
+			boost::filesystem::path file;
+			SimpleEventLoop* eventLoop;
+			SOCKS5BytestreamRegistry registry;
+			boost::shared_ptr<CountingWriteBytestream> receivedStream;
+			boost::shared_ptr<SOCKS5BytestreamServerSession> serverSession;
+			boost::shared_ptr<SOCKS5BytestreamClientSession> clientSession;
+	};
+
+	void createFile(const boost::filesystem::path& file, boost::uintmax_t size) {
+		std::ofstream stream(file.string().c_str(), std::ios_base::out | std::ios_base::binary);
+		std::vector<char> block(1024 * 1024, 'a');
+		for (boost::uintmax_t written = 0; written < size; written += block.size()) {
+			stream.write(&block[0], static_cast<std::streamsize>(std::min<boost::uintmax_t>(block.size(), size - written)));
+		}
+	}
+}
+
+void runFileTransferBenchmark(const BenchmarkArguments& arguments) {
+	boost::uintmax_t megabytes = arguments.empty() ? 256 : boost::lexical_cast<boost::uintmax_t>(arguments[0]);
+	boost::uintmax_t size = megabytes * 1024 * 1024;
+
+	boost::filesystem::path file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+	createFile(file, size);
+
+	{
+		SimpleEventLoop eventLoop;
+		BoostIOServiceThread ioServiceThread;
+		BoostTimerFactory timerFactory(ioServiceThread.getIOService(), &eventLoop);
+		LoopbackTransfer transfer(file, &eventLoop, size);
+
+		BoostConnectionServer::ref server = BoostConnectionServer::create(HostAddress("127.0.0.1"), 0, ioServiceThread.getIOService(), &eventLoop);
+		server->onNewConnection.connect(boost::bind(&LoopbackTransfer::handleNewConnection, &transfer, _1));
+		server->start();
+
+		transfer.clientSession = boost::make_shared<SOCKS5BytestreamClientSession>(
+				BoostConnection::create(ioServiceThread.getIOService(), &eventLoop),
+				HostAddressPort(HostAddress("127.0.0.1"), server->getAddressPort().getPort()),
+				destination,
+				&timerFactory);
+		transfer.clientSession->onSessionReady.connect(boost::bind(&LoopbackTransfer::handleSessionReady, &transfer, _1));
+		transfer.clientSession->start();
+
+		double cpuTimeBefore = getCPUTime();
+		eventLoop.run();
+		double cpuTime = getCPUTime() - cpuTimeBefore;
+
+		if (transfer.receivedStream->finished) {
+			printResult("File size", static_cast<double>(megabytes), "MB");
+			printResult("Throughput", static_cast<double>(megabytes) / transfer.receivedStream->seconds, "MB/s");
+			printResult("CPU time", cpuTime * 1024.0 / static_cast<double>(megabytes), "s/GB");
+		}
+
+		transfer.clientSession->stop();
+		if (transfer.serverSession) {
+			transfer.serverSession->stop();
+		}
+		server->stop();
+	}
+
+	boost::filesystem::remove(file);
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread.hpp>
+
+#include <Swiften/Base/IDGenerator.h>
+
+#include <QA/Benchmark/Benchmarks.h>
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+namespace Swift {
+
+namespace {
+	void generateIDs(IDGenerator* generator, size_t count, size_t* totalSize) {
+		for (size_t i = 0; i < count; ++i) {
+			*totalSize += generator->generateID().size();
+		}
+	}
+
+	void generateIDsWithOwnGenerator(size_t count, size_t* totalSize) {
+		IDGenerator generator;
+		generateIDs(&generator, count, totalSize);
+	}
+
+	void generateIDsWithNewGenerators(size_t count, size_t* totalSize) {
+		for (size_t i = 0; i < count; ++i) {
+			*totalSize += IDGenerator().generateID().size();
+		}
+	}
+
+	void measure(const std::string& description, const boost::function<void (size_t*)>& generate, size_t count, size_t threadCount) {
+		std::vector<size_t> totalSizes(threadCount, 0);
+		double cpuTimeBefore = getCPUTime();
+		BenchmarkTimer timer;
+		boost::thread_group threads;
+		for (size_t i = 0; i < threadCount; ++i) {
+			threads.create_thread(boost::bind(generate, &totalSizes[i]));
+		}
+		threads.join_all();
+		double seconds = timer.getSeconds();
+		double cpuTime = getCPUTime() - cpuTimeBefore;
+		printResult(description + ": throughput", static_cast<double>(count * threadCount) / seconds, "IDs/s");
+		printResult(description + ": CPU time", cpuTime * 1000000000.0 / static_cast<double>(count * threadCount), "ns/ID");
+	}
+}
+
+void runIDGeneratorBenchmark(const BenchmarkArguments& arguments) {
+	size_t count = arguments.size() < 1 ? 1000000 : boost::lexical_cast<size_t>(arguments[0]);
+	size_t threadCount = arguments.size() < 2 ? 1 : boost::lexical_cast<size_t>(arguments[1]);
+	printResult("Threads", static_cast<double>(threadCount), "");
+
+	IDGenerator sharedGenerator;
+	measure("Shared generator", boost::bind(&generateIDs, &sharedGenerator, count, _1), count, threadCount);
+	measure("Generator per thread", boost::bind(&generateIDsWithOwnGenerator, count, _1), count, threadCount);
+	// Some code creates a generator for every ID it needs
+	measure("Generator per ID", boost::bind(&generateIDsWithNewGenerators, count / 10, _1), count / 10, threadCount);
+}
+
+}
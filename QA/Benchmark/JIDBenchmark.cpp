@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread.hpp>
+
+#include <Swiften/JID/JID.h>
+
+#include <QA/Benchmark/Benchmarks.h>
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+namespace Swift {
+
+namespace {
+	void constructJIDs(const std::vector<std::string>* jids, size_t count, size_t* invalidJIDs) {
+		for (size_t i = 0; i < count; ++i) {
+			if (!JID((*jids)[i % jids->size()]).isValid()) {
+				++*invalidJIDs;
+			}
+		}
+	}
+
+	void measure(const std::string& description, const std::vector<std::string>& jids, size_t count, size_t threadCount) {
+		std::vector<size_t> invalidJIDs(threadCount, 0);
+		BenchmarkTimer timer;
+		boost::thread_group threads;
+		for (size_t i = 0; i < threadCount; ++i) {
+			threads.create_thread(boost::bind(&constructJIDs, &jids, count, &invalidJIDs[i]));
+		}
+		threads.join_all();
+		double seconds = timer.getSeconds();
+		printResult(description, static_cast<double>(count * threadCount) / seconds, "JIDs/s");
+	}
+
+	std::vector<std::string> createJIDs(const std::string& node, const std::string& domain, const std::string& resource, size_t count) {
+		std::vector<std::string> result;
+		for (size_t i = 0; i < count; ++i) {
+			std::string suffix = boost::lexical_cast<std::string>(i);
+			result.push_back(node + suffix + "@" + domain + suffix + "/" + resource + suffix);
+		}
+		return result;
+	}
+}
+
+void runJIDBenchmark(const BenchmarkArguments& arguments) {
+	size_t count = arguments.size() < 1 ? 200000 : boost::lexical_cast<size_t>(arguments[0]);
+	size_t threadCount = arguments.size() < 2 ? 1 : boost::lexical_cast<size_t>(arguments[1]);
+	printResult("Threads", static_cast<double>(threadCount), "");
+
+	measure("ASCII", createJIDs("Alice", "Example.com", "Home", 1000), count, threadCount);
+	// Fits in the cache
+	measure("Non-ASCII, 1000 distinct", createJIDs("J\xc3\xbcrgen", "B\xc3\xbc" "cher.example", "K\xc3\xbc" "che", 1000), count, threadCount);
+	// Does not fit in the cache
+	measure("Non-ASCII, 100000 distinct", createJIDs("J\xc3\xbcrgen", "B\xc3\xbc" "cher.example", "K\xc3\xbc" "che", 100000), count, threadCount);
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <Swiften/Elements/ProtocolHeader.h>
+#include <Swiften/Elements/ToplevelElement.h>
+#include <Swiften/Parser/PayloadParsers/FullPayloadParserFactoryCollection.h>
+#include <Swiften/Parser/PlatformXMLParserFactory.h>
+#include <Swiften/Parser/XMPPParser.h>
+#include <Swiften/Parser/XMPPParserClient.h>
+
+#include <QA/Benchmark/Benchmarks.h>
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+namespace Swift {
+
+namespace {
+	const size_t rosterSize = 2000;
+
+	std::string createRoster() {
+		std::ostringstream roster;
+		roster << "<iq type='result' id='roster1' to='alice@example.com/home'><query xmlns='jabber:iq:roster' ver='ver11'>";
+		for (size_t i = 0; i < rosterSize; ++i) {
+			roster << "<item jid='contact" << i << "@example.com' name='Contact " << i << "' subscription='both'>";
+			roster << "<group>" << (i % 2 ? "Friends" : "Work") << "</group>";
+			roster << "</item>";
+		}
+		roster << "</query></iq>";
+		return roster.str();
+	}
+
+	const char* discoInfo =
+		"<iq type='result' id='disco1' from='example.com' to='alice@example.com/home'>"
+			"<query xmlns='http://jabber.org/protocol/disco#info'>"
+				"<identity category='server' type='im' name='Example Server'/>"
+				"<feature var='http://jabber.org/protocol/disco#info'/>"
+				"<feature var='http://jabber.org/protocol/disco#items'/>"
+				"<feature var='jabber:iq:roster'/>"
+				"<feature var='jabber:iq:version'/>"
+				"<feature var='urn:xmpp:ping'/>"
+				"<feature var='urn:xmpp:carbons:2'/>"
+				"<feature var='vcard-temp'/>"
+			"</query>"
+		"</iq>";
+
+	/**
+	 * Keeps every parsed element, so the peak RSS includes the memory held
+	 * by the parsed elements.
+	 */
+	class ElementCollector : public XMPPParserClient {
+		public:
+			virtual void handleStreamStart(const ProtocolHeader&) {}
+			virtual void handleElement(boost::shared_ptr<ToplevelElement> element) {
+				elements.push_back(element);
+			}
+			virtual void handleStreamEnd() {}
+
+			std::vector<boost::shared_ptr<ToplevelElement> > elements;
+	};
+}
+
+void runParserArenaBenchmark(const BenchmarkArguments& arguments) {
+	if (arguments.empty() || (arguments[0] != "on" && arguments[0] != "off")) {
+		std::cerr << "Usage: Benchmark arena on|off [count]" << std::endl;
+		return;
+	}
+	bool useArenas = arguments[0] == "on";
+	size_t count = arguments.size() < 2 ? 200 : boost::lexical_cast<size_t>(arguments[1]);
+	std::string roster = createRoster();
+	std::string description = useArenas ? "Arenas" : "Heap";
+
+	PlatformXMLParserFactory xmlParserFactory;
+	FullPayloadParserFactoryCollection payloadParserFactories;
+	ElementCollector client;
+	XMPPParser parser(&client, &payloadParserFactories, &xmlParserFactory);
+	parser.setUseArenas(useArenas);
+	parser.parse("<stream:stream xmlns='jabber:client' xmlns:stream='http://etherx.jabber.org/streams' from='example.com' id='abc' version='1.0'>");
+
+	long rssBefore = getPeakRSS();
+	size_t allocationsBefore = getAllocationCount();
+	BenchmarkTimer timer;
+	for (size_t i = 0; i < count; ++i) {
+		parser.parse(roster);
+		parser.parse(discoInfo);
+	}
+	double seconds = timer.getSeconds();
+	size_t allocations = getAllocationCount() - allocationsBefore;
+
+	printResult(description + ": allocations per roster and disco#info", static_cast<double>(allocations) / static_cast<double>(count), "");
+	printResult(description + ": throughput", static_cast<double>(count) / seconds, "rosters/s");
+	printResult(description + ": peak RSS growth", static_cast<double>(getPeakRSS() - rssBefore) / 1024.0, "MB");
+	BenchmarkTimer releaseTimer;
+	client.elements.clear();
+	printResult(description + ": release time", releaseTimer.getSeconds() * 1000.0, "ms");
+}
+
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <string>
+#include <vector>
+#include <boost/lexical_cast.hpp>
+
+#include <Swiften/Elements/ProtocolHeader.h>
+#include <Swiften/Parser/PayloadParsers/FullPayloadParserFactoryCollection.h>
+#include <Swiften/Parser/PlatformXMLParserFactory.h>
+#include <Swiften/Parser/XMLParser.h>
+#include <Swiften/Parser/XMLParserClient.h>
+#include <Swiften/Parser/XMPPParser.h>
+#include <Swiften/Parser/XMPPParserClient.h>
+
+#include <QA/Benchmark/Benchmarks.h>
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+namespace Swift {
+
+namespace {
+	const char* streamHeader = "<stream:stream xmlns='jabber:client' xmlns:stream='http://etherx.jabber.org/streams' from='example.com' id='abc' version='1.0'>";
+
+	const char* stanzas[] = {
+		"<message from='alice@example.com/home' to='bob@example.com/work' type='chat' id='m1'>"
+			"<body>Hello Bob, are you coming to the meeting this afternoon?</body>"
+			"<thread>e0ffe42b28561960c6b12b944a092794b9683a38</thread>"
+		"</message>",
+		"<presence from='alice@example.com/home' to='bob@example.com/work'>"
+			"<show>away</show>"
+			"<status>In a meeting</status>"
+			"<priority>5</priority>"
+			"<c xmlns='http://jabber.org/protocol/caps' hash='sha-1' node='http://swift.im' ver='QgayPKawpkPSDYmwT/WM94uAlu0='/>"
+			"<delay xmlns='urn:xmpp:delay' from='example.com' stamp='2015-06-10T16:41:39Z'/>"
+		"</presence>",
+		"<message from='room@conference.example.com/carol' to='bob@example.com/work' type='groupchat' id='m2'>"
+			"<subject>Release planning</subject>"
+			"<body>The release is scheduled for next week.</body>"
+		"</message>",
+		"<iq from='example.com' to='bob@example.com/work' type='result' id='i1'/>",
+	};
+	const size_t stanzaCount = sizeof(stanzas) / sizeof(stanzas[0]);
+
+	/**
+	 * Only handles the owning callbacks, so every name, attribute, and text
+	 * chunk is copied before it is delivered.
+	 */
+	class CopyingClient : public XMLParserClient {
+		public:
+			CopyingClient() : elements(0) {}
+
+			virtual void handleStartElement(const std::string&, const std::string&, const AttributeMap&) {
+				++elements;
+			}
+			virtual void handleEndElement(const std::string&, const std::string&) {}
+			virtual void handleCharacterData(const std::string&) {}
+
+			size_t elements;
+	};
+
+	class ViewClient : public CopyingClient {
+		public:
+			virtual void handleStartElementView(const StringView&, const StringView&, const AttributeViewList&) {
+				++elements;
+			}
+			virtual void handleEndElementView(const StringView&, const StringView&) {}
+			virtual void handleCharacterDataView(const StringView&) {}
+	};
+
+	class ElementCounter : public XMPPParserClient {
+		public:
+			ElementCounter() : elements(0) {}
+
+			virtual void handleStreamStart(const ProtocolHeader&) {}
+			virtual void handleElement(boost::shared_ptr<ToplevelElement>) {
+				++elements;
+			}
+			virtual void handleStreamEnd() {}
+
+			size_t elements;
+	};
+
+	template<typename PARSER>
+	void parseStanzas(PARSER& parser, size_t count, const std::string& description) {
+		parser.parse(streamHeader);
+		size_t allocationsBefore = getAllocationCount();
+		BenchmarkTimer timer;
+		for (size_t i = 0; i < count; ++i) {
+			parser.parse(stanzas[i % stanzaCount]);
+		}
+		double seconds = timer.getSeconds();
+		size_t allocations = getAllocationCount() - allocationsBefore;
+		printResult(description + ": allocations", static_cast<double>(allocations) / static_cast<double>(count), "per stanza");
+		printResult(description + ": throughput", static_cast<double>(count) / seconds, "stanzas/s");
+	}
+}
+
+void runParserBenchmark(const BenchmarkArguments& arguments) {
+	size_t count = arguments.empty() ? 200000 : boost::lexical_cast<size_t>(arguments[0]);
+	PlatformXMLParserFactory xmlParserFactory;
+
+	{
+		CopyingClient client;
+		XMLParser* parser = xmlParserFactory.createXMLParser(&client);
+		parseStanzas(*parser, count, "XML parser, owning callbacks");
+		delete parser;
+	}
+	{
+		ViewClient client;
+		XMLParser* parser = xmlParserFactory.createXMLParser(&client);
+		parseStanzas(*parser, count, "XML parser, view callbacks");
+		delete parser;
+	}
+	{
+		ElementCounter client;
+		FullPayloadParserFactoryCollection payloadParserFactories;
+		XMPPParser parser(&client, &payloadParserFactories, &xmlParserFactory);
+		parseStanzas(parser, count, "XMPPParser");
+	}
+	{
+		ElementCounter client;
+		FullPayloadParserFactoryCollection payloadParserFactories;
+		XMPPParser parser(&client, &payloadParserFactories, &xmlParserFactory);
+		parser.setUseArenas(true);
+		parseStanzas(parser, count, "XMPPParser with arenas");
+	}
+}
+
+}
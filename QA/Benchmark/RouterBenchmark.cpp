@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <string>
+#include <vector>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+
+#include <Swiften/Base/foreach.h>
+#include <Swiften/Elements/Message.h>
+#include <Swiften/JID/JID.h>
+#include <Limber/Server/ServerSession.h>
+#include <Limber/Server/ServerStanzaRouter.h>
+
+#include <QA/Benchmark/Benchmarks.h>
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+namespace Swift {
+
+namespace {
+	const size_t resourcesPerUser = 2;
+
+	class CountingServerSession : public ServerSession {
+		public:
+			CountingServerSession(const JID& jid, int priority) : jid(jid), priority(priority), receivedStanzas(0) {}
+
+			virtual const JID& getJID() const { return jid; }
+			virtual int getPriority() const { return priority; }
+			virtual void sendStanza(boost::shared_ptr<Stanza>) { ++receivedStanzas; }
+
+			JID jid;
+			int priority;
+			size_t receivedStanzas;
+	};
+
+	JID getUserJID(size_t user) {
+		return JID("user" + boost::lexical_cast<std::string>(user), "example.com");
+	}
+
+	void measure(size_t sessionCount, size_t routeCount) {
+		size_t userCount = sessionCount / resourcesPerUser;
+		std::vector<boost::shared_ptr<CountingServerSession> > sessions;
+		ServerStanzaRouter router;
+		for (size_t user = 0; user < userCount; ++user) {
+			for (size_t resource = 0; resource < resourcesPerUser; ++resource) {
+				JID jid = getUserJID(user).withResource("resource" + boost::lexical_cast<std::string>(resource));
+				sessions.push_back(boost::make_shared<CountingServerSession>(jid, static_cast<int>(resource)));
+				router.addClientSession(sessions.back().get());
+			}
+		}
+
+		// Half of the messages go to full JIDs, the other half to bare JIDs
+		std::vector<boost::shared_ptr<Message> > messages;
+		for (size_t i = 0; i < routeCount; ++i) {
+			JID to = getUserJID((i * 7919) % userCount);
+			boost::shared_ptr<Message> message = boost::make_shared<Message>();
+			message->setTo(i % 2 == 0 ? to.withResource("resource0") : to);
+			messages.push_back(message);
+		}
+
+		BenchmarkTimer timer;
+		size_t routedMessages = 0;
+		foreach (const boost::shared_ptr<Message>& message, messages) {
+			if (router.routeStanza(message)) {
+				++routedMessages;
+			}
+		}
+		double seconds = timer.getSeconds();
+
+		printResult(boost::lexical_cast<std::string>(sessionCount) + " sessions", static_cast<double>(routedMessages) / seconds, "stanzas/s");
+	}
+}
+
+void runRouterBenchmark(const BenchmarkArguments& arguments) {
+	size_t routeCount = arguments.size() < 1 ? 100000 : boost::lexical_cast<size_t>(arguments[0]);
+	size_t sessionCounts[] = { 1000, 10000, 100000 };
+	foreach (size_t sessionCount, sessionCounts) {
+		measure(sessionCount, routeCount);
+	}
+}
+
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <string>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+
+#include <Swiften/Base/SafeByteArray.h>
+#include <Swiften/Base/foreach.h>
+#include <Swiften/Elements/Message.h>
+#include <Swiften/Elements/ProtocolHeader.h>
+#include <Swiften/Elements/StanzaAck.h>
+#include <Swiften/Elements/StanzaAckRequest.h>
+#include <Swiften/Parser/PayloadParsers/FullPayloadParserFactoryCollection.h>
+#include <Swiften/Parser/PlatformXMLParserFactory.h>
+#include <Swiften/Parser/XMPPParser.h>
+#include <Swiften/Parser/XMPPParserClient.h>
+#include <Swiften/Serializer/PayloadSerializers/FullPayloadSerializerCollection.h>
+#include <Swiften/Serializer/XMPPSerializer.h>
+#include <Swiften/StreamManagement/StanzaAckRequester.h>
+#include <Swiften/StreamManagement/StanzaAckResponder.h>
+
+#include <QA/Benchmark/Benchmarks.h>
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+namespace Swift {
+
+namespace {
+	const char* streamHeader = "<stream:stream xmlns='jabber:client' xmlns:stream='http://etherx.jabber.org/streams' from='example.com' id='abc' version='1.0'>";
+
+	/**
+	 * Both ends of a stream with stream management, connected in memory.
+	 *
+	 * Everything the client sends is serialized and parsed by the server,
+	 * which acks through a StanzaAckResponder. The acks are serialized and
+	 * parsed by the client again, and handed to its StanzaAckRequester.
+	 */
+	class AckedStream {
+		private:
+			class ElementHandler : public XMPPParserClient {
+				public:
+					ElementHandler(AckedStream* stream) : stream(stream) {}
+
+					virtual void handleStreamStart(const ProtocolHeader&) {}
+					virtual void handleElement(boost::shared_ptr<ToplevelElement> element) {
+						stream->handleElement(element);
+					}
+					virtual void handleStreamEnd() {}
+
+				private:
+					AckedStream* stream;
+			};
+
+		public:
+			AckedStream(const StanzaAckRequestPolicy& policy) :
+					serializer(&payloadSerializers, ClientStreamType, false),
+					clientHandler(this),
+					serverHandler(this),
+					clientParser(&clientHandler, &payloadParserFactories, &xmlParserFactory),
+					serverParser(&serverHandler, &payloadParserFactories, &xmlParserFactory),
+					sentBytes(0),
+					ackRequests(0),
+					ackedMessages(0) {
+				clientParser.parse(streamHeader);
+				serverParser.parse(streamHeader);
+				requester.setPolicy(policy);
+				requester.onRequestAck.connect(boost::bind(&AckedStream::handleRequestAck, this));
+				requester.onStanzaAcked.connect(boost::bind(&AckedStream::handleStanzaAcked, this));
+				responder.onAck.connect(boost::bind(&AckedStream::handleAck, this, _1));
+			}
+
+			void sendMessage(boost::shared_ptr<Message> message) {
+				sendToServer(message);
+				requester.handleStanzaSent(message);
+			}
+
+		private:
+			void sendToServer(boost::shared_ptr<ToplevelElement> element) {
+				std::string data = safeByteArrayToString(serializer.serializeElement(element));
+				sentBytes += data.size();
+				serverParser.parse(data);
+			}
+
+			void handleRequestAck() {
+				++ackRequests;
+				sendToServer(boost::make_shared<StanzaAckRequest>());
+			}
+
+			void handleAck(unsigned int handledStanzasCount) {
+				std::string data = safeByteArrayToString(serializer.serializeElement(boost::make_shared<StanzaAck>(handledStanzasCount)));
+				sentBytes += data.size();
+				clientParser.parse(data);
+			}
+
+			void handleStanzaAcked() {
+				++ackedMessages;
+			}
+
+			void handleElement(boost::shared_ptr<ToplevelElement> element) {
+				if (boost::shared_ptr<StanzaAck> ack = boost::dynamic_pointer_cast<StanzaAck>(element)) {
+					requester.handleAckReceived(ack->getHandledStanzasCount());
+				}
+				else if (boost::dynamic_pointer_cast<StanzaAckRequest>(element)) {
+					responder.handleAckRequestReceived();
+				}
+				else if (boost::dynamic_pointer_cast<Stanza>(element)) {
+					responder.handleStanzaReceived();
+				}
+			}
+
+		private:
+			FullPayloadSerializerCollection payloadSerializers;
+			FullPayloadParserFactoryCollection payloadParserFactories;
+			PlatformXMLParserFactory xmlParserFactory;
+			XMPPSerializer serializer;
+			ElementHandler clientHandler;
+			ElementHandler serverHandler;
+			XMPPParser clientParser;
+			XMPPParser serverParser;
+			StanzaAckRequester requester;
+			StanzaAckResponder responder;
+
+		public:
+			size_t sentBytes;
+			size_t ackRequests;
+			size_t ackedMessages;
+	};
+
+	void measure(unsigned int messageCount, size_t count) {
+		StanzaAckRequestPolicy policy;
+		policy.messageCount = messageCount;
+		AckedStream stream(policy);
+
+		boost::shared_ptr<Message> message = boost::make_shared<Message>();
+		message->setTo(JID("bob@example.com/work"));
+		message->setType(Message::Chat);
+		message->setBody("Hello Bob, are you coming to the meeting this afternoon?");
+
+		double cpuTimeBefore = getCPUTime();
+		BenchmarkTimer timer;
+		for (size_t i = 0; i < count; ++i) {
+			stream.sendMessage(message);
+		}
+		double seconds = timer.getSeconds();
+		double cpuTime = getCPUTime() - cpuTimeBefore;
+
+		std::string description = "ack every " + boost::lexical_cast<std::string>(messageCount) + " messages";
+		printResult(description + ": throughput", static_cast<double>(count) / seconds, "messages/s");
+		printResult(description + ": CPU time", cpuTime * 1000000.0 / static_cast<double>(count), "us/message");
+		printResult(description + ": stream data", static_cast<double>(stream.sentBytes) / static_cast<double>(count), "bytes/message");
+		printResult(description + ": ack requests", static_cast<double>(stream.ackRequests), "requests");
+	}
+}
+
+void runStanzaAckBenchmark(const BenchmarkArguments& arguments) {
+	size_t count = arguments.empty() ? 100000 : boost::lexical_cast<size_t>(arguments[0]);
+	unsigned int messageCounts[] = { 1, 10, 100 };
+	foreach (unsigned int messageCount, messageCounts) {
+		measure(messageCount, count);
+	}
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+
+#include <Swiften/TLS/OpenSSL/OpenSSLContext.h>
+#include <Swiften/TLS/OpenSSL/OpenSSLContextFactory.h>
+
+#include <QA/Benchmark/Benchmarks.h>
+#include <QA/Benchmark/BenchmarkUtil.h>
+
+namespace Swift {
+
+void runTLSContextBenchmark(const BenchmarkArguments& arguments) {
+	if (arguments.empty() || (arguments[0] != "shared" && arguments[0] != "separate")) {
+		std::cerr << "Usage: Benchmark tls shared|separate [count]" << std::endl;
+		return;
+	}
+	bool shared = arguments[0] == "shared";
+	size_t count = arguments.size() < 2 ? 1000 : boost::lexical_cast<size_t>(arguments[1]);
+	std::string description = shared ? "Shared SSL_CTX" : "SSL_CTX per context";
+
+	// Keeps every context (and factory), so the peak RSS includes them all
+	std::vector< boost::shared_ptr<OpenSSLContextFactory> > factories;
+	std::vector< boost::shared_ptr<TLSContext> > contexts;
+
+	long rssBefore = getPeakRSS();
+	BenchmarkTimer timer;
+	for (size_t i = 0; i < count; ++i) {
+		if (factories.empty() || !shared) {
+			// A factory with an SSL_CTX of its own is what every context used to get
+			factories.push_back(shared ? boost::make_shared<OpenSSLContextFactory>() : boost::make_shared<OpenSSLContextFactory>(OpenSSLContext::createContext()));
+		}
+		boost::shared_ptr<TLSContext> context(factories.back()->createTLSContext());
+		context->setServerIdentity("example.com");
+		context->connect();
+		contexts.push_back(context);
+	}
+	double seconds = timer.getSeconds();
+
+	printResult(description + ": contexts", static_cast<double>(count), "");
+	printResult(description + ": setup time", seconds * 1000000.0 / static_cast<double>(count), "us/context");
+	printResult(description + ": peak RSS growth", static_cast<double>(getPeakRSS() - rssBefore) / 1024.0, "MB");
+	printResult(description + ": peak RSS growth per context", static_cast<double>(getPeakRSS() - rssBefore) / static_cast<double>(count), "kB/context");
+}
+
+}
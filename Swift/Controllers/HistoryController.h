@@ -27,6 +27,7 @@ namespace Swift {
 			std::vector<HistoryMessage> getMessagesFromPreviousDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const;
 			std::vector<HistoryMessage> getMessagesFromNextDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const;
 			ContactsMap getContacts(const JID& selfJID, HistoryMessage::Type type, const std::string& keyword = std::string()) const;
+			std::vector<HistoryMessage> searchMessages(const JID& selfJID, HistoryMessage::Type type, const std::string& keywords, int offset, int limit) const;
 			std::vector<HistoryMessage> getMUCContext(const JID& selfJID, const JID& mucJID, const boost::posix_time::ptime& timeStamp) const;
 
 			boost::posix_time::ptime getLastTimeStampFromMUC(const JID& selfJID, const JID& mucJID);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -76,7 +76,7 @@ void PresenceNotifier::handlePresenceReceived(boost::shared_ptr<Presence> presen
 }
 
 void PresenceNotifier::handleStanzaChannelAvailableChanged(bool available) {
-	if (available) {
+	if (available && !stanzaChannel->isStreamResumed()) {
 		availableUsers.clear();
 		justInitialized = true;
 		if (timer) {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,6 +8,7 @@
 
 #include <map>
 #include <string>
+#include <boost/unordered_map.hpp>
 
 #include <Swiften/Base/ByteArray.h>
 #include <Swiften/Avatars/AvatarStorage.h>
@@ -32,12 +33,12 @@ namespace Swift {
 			}
 
 			virtual std::string getAvatarForJID(const JID& jid) const {
-				std::map<JID, std::string>::const_iterator i = jidAvatars.find(jid);
+				boost::unordered_map<JID, std::string>::const_iterator i = jidAvatars.find(jid);
 				return i == jidAvatars.end() ? "" : i->second;
 			}
 
 		private:
 			std::map<std::string, ByteArray> avatars;
-			std::map<JID, std::string> jidAvatars;
+			boost::unordered_map<JID, std::string> jidAvatars;
 	};
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -34,6 +34,7 @@ class VCardUpdateAvatarManagerTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testVCardWithEmptyPhoto);
 		CPPUNIT_TEST(testStanzaChannelReset_ClearsHash);
 		CPPUNIT_TEST(testStanzaChannelReset_ReceiveHashAfterResetUpdatesHash);
+		CPPUNIT_TEST(testStanzaChannelResume_KeepsHash);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -161,6 +162,21 @@ class VCardUpdateAvatarManagerTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT_EQUAL(avatar1Hash, *hash);
 		}
 
+		void testStanzaChannelResume_KeepsHash() {
+			boost::shared_ptr<VCardUpdateAvatarManager> testling = createManager();
+			stanzaChannel->onPresenceReceived(createPresenceWithPhotoHash(user1, avatar1Hash));
+			stanzaChannel->onIQReceived(createVCardResult(avatar1));
+			changes.clear();
+
+			stanzaChannel->setAvailable(false);
+			stanzaChannel->setAvailable(true, true);
+
+			CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(changes.size()));
+			boost::optional<std::string> hash = testling->getAvatarHash(user1.toBare());
+			CPPUNIT_ASSERT(hash);
+			CPPUNIT_ASSERT_EQUAL(avatar1Hash, *hash);
+		}
+
 	private:
 		boost::shared_ptr<VCardUpdateAvatarManager> createManager() {
 			boost::shared_ptr<VCardUpdateAvatarManager> result(new VCardUpdateAvatarManager(vcardManager, stanzaChannel, avatarStorage, crypto.get(), mucRegistry));
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -38,6 +38,7 @@ namespace Swift {
 
 		private:
 			VCardManager* vcardManager_;
+			StanzaChannel* stanzaChannel_;
 			AvatarStorage* avatarStorage_;
 			CryptoProvider* crypto_;
 			MUCRegistry* mucRegistry_;
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/Base/Arena.h>
+
+#include <algorithm>
+
+#include <Swiften/Base/foreach.h>
+
+namespace Swift {
+
+namespace {
+	// Suitable for any of the fundamental types
+	const size_t ALIGNMENT = 16;
+}
+
+Arena::Arena(size_t blockSize) : blockSize_(blockSize), current_(NULL), available_(0), capacity_(0) {
+}
+
+Arena::~Arena() {
+	foreach (char* block, blocks_) {
+		delete[] block;
+	}
+}
+
+void* Arena::allocate(size_t size) {
+	size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	if (size > available_) {
+		size_t newBlockSize = std::max(blockSize_, size);
+		current_ = new char[newBlockSize];
+		blocks_.push_back(current_);
+		available_ = newBlockSize;
+		capacity_ += newBlockSize;
+	}
+	void* result = current_;
+	current_ += size;
+	available_ -= size;
+	return result;
+}
+
+}
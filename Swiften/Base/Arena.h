@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
+
+#include <Swiften/Base/API.h>
+
+namespace Swift {
+	/**
+	 * A memory arena, from which memory is allocated in large blocks.
+	 *
+	 * Memory allocated from the arena is not released individually, but all
+	 * at once when the arena is destroyed. Objects are typically allocated in
+	 * the arena through ArenaAllocator, which keeps the arena alive for as
+	 * long as any of the objects allocated through it exist.
+	 *
+	 * Allocating from an arena is not thread-safe.
+	 */
+	class SWIFTEN_API Arena : public boost::noncopyable, public boost::enable_shared_from_this<Arena> {
+		public:
+			Arena(size_t blockSize = 4096);
+			~Arena();
+
+			void* allocate(size_t size);
+
+			/**
+			 * The total size of the blocks allocated by this arena.
+			 */
+			size_t getCapacity() const {
+				return capacity_;
+			}
+
+		private:
+			size_t blockSize_;
+			std::vector<char*> blocks_;
+			char* current_;
+			size_t available_;
+			size_t capacity_;
+	};
+
+	/**
+	 * An allocator allocating objects in an Arena.
+	 *
+	 * Every copy of the allocator holds a reference to the arena.
+	 */
+	template<typename T>
+	class ArenaAllocator {
+		public:
+			typedef T value_type;
+			typedef T* pointer;
+			typedef const T* const_pointer;
+			typedef T& reference;
+			typedef const T& const_reference;
+			typedef size_t size_type;
+			typedef std::ptrdiff_t difference_type;
+
+			template<typename U> struct rebind {
+				typedef ArenaAllocator<U> other;
+			};
+
+			ArenaAllocator(boost::shared_ptr<Arena> arena) : arena_(arena) {
+			}
+
+			template<typename U> ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.getArena()) {
+			}
+
+			pointer allocate(size_type n, const void* = 0) {
+				return static_cast<pointer>(arena_->allocate(n * sizeof(T)));
+			}
+
+			void deallocate(pointer, size_type) {
+			}
+
+			void construct(pointer p, const T& value) {
+				new (static_cast<void*>(p)) T(value);
+			}
+
+			void destroy(pointer p) {
+				p->~T();
+			}
+
+			size_type max_size() const {
+				return static_cast<size_type>(-1) / sizeof(T);
+			}
+
+			const boost::shared_ptr<Arena>& getArena() const {
+				return arena_;
+			}
+
+			template<typename U> bool operator==(const ArenaAllocator<U>& other) const {
+				return arena_ == other.getArena();
+			}
+
+			template<typename U> bool operator!=(const ArenaAllocator<U>& other) const {
+				return arena_ != other.getArena();
+			}
+
+		private:
+			boost::shared_ptr<Arena> arena_;
+	};
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2011 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,18 +7,54 @@
 #include <Swiften/Base/IDGenerator.h>
 
 #include <boost/uuid/uuid.hpp>
-#include <boost/uuid/uuid_io.hpp>
 #include <boost/uuid/uuid_generators.hpp>
-#include <boost/lexical_cast.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
 
 namespace Swift {
 
-IDGenerator::IDGenerator() {
+namespace {
+	const char hexDigits[] = "0123456789abcdef";
+
+	// Seeding a random generator is expensive, so all generators share one.
+	boost::mutex randomGeneratorMutex;
+
+	boost::uuids::uuid generateRandomUUID() {
+		boost::lock_guard<boost::mutex> lock(randomGeneratorMutex);
+		static boost::uuids::random_generator generator;
+		return generator();
+	}
+}
+
+IDGenerator::IDGenerator() : counter(0) {
+	boost::uuids::uuid uuid = generateRandomUUID();
+	prefix.reserve(2 * uuid.size() + 1);
+	for (boost::uuids::uuid::const_iterator i = uuid.begin(); i != uuid.end(); ++i) {
+		prefix += hexDigits[*i >> 4];
+		prefix += hexDigits[*i & 0xf];
+	}
+	prefix += '-';
+}
+
+IDGenerator::~IDGenerator() {
 }
 
 std::string IDGenerator::generateID() {
-	static boost::uuids::random_generator generator;
-	return boost::lexical_cast<std::string>(generator());
+	boost::uint64_t value = counter.fetch_add(1, boost::memory_order_relaxed);
+
+	char digits[16];
+	char* end = digits + sizeof(digits);
+	char* begin = end;
+	do {
+		*--begin = hexDigits[value & 0xf];
+		value >>= 4;
+	} while (value != 0);
+
+	std::string result;
+	result.reserve(prefix.size() + static_cast<size_t>(end - begin));
+	result += prefix;
+	result.append(begin, end);
+	return result;
 }
 
 }
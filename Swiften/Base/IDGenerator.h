@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,14 +7,28 @@
 #pragma once
 
 #include <string>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
 
 #include <Swiften/Base/API.h>
 
 namespace Swift {
+	/**
+	 * Generates unique IDs.
+	 *
+	 * The IDs consist of a random prefix, which is chosen when the generator
+	 * is created, followed by a counter. generateID() can be called from
+	 * multiple threads at the same time.
+	 */
 	class SWIFTEN_API IDGenerator {
 		public:
 			IDGenerator();
+			virtual ~IDGenerator();
 
-			std::string generateID();
+			virtual std::string generateID();
+
+		private:
+			std::string prefix;
+			boost::atomic<boost::uint64_t> counter;
 	};
 }
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <list>
+#include <utility>
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace Swift {
+	/**
+	 * A map holding a bounded number of entries.
+	 *
+	 * When the cache is full, adding an entry evicts the least recently
+	 * used one. This class is not thread-safe.
+	 */
+	template<typename Key, typename Value, typename Hash = boost::hash<Key> >
+	class LRUCache {
+		private:
+			typedef std::list<std::pair<Key, Value> > EntryList;
+			typedef boost::unordered_map<Key, typename EntryList::iterator, Hash> EntryMap;
+
+		public:
+			explicit LRUCache(size_t capacity) : capacity_(capacity) {
+				assert(capacity_ > 0);
+			}
+
+			/**
+			 * Returns the value for the given key, or NULL if it is not cached.
+			 *
+			 * The returned pointer is valid until the next call that modifies the
+			 * cache.
+			 */
+			const Value* get(const Key& key) {
+				typename EntryMap::iterator i = map_.find(key);
+				if (i == map_.end()) {
+					return NULL;
+				}
+				entries_.splice(entries_.begin(), entries_, i->second);
+				return &i->second->second;
+			}
+
+			void put(const Key& key, const Value& value) {
+				typename EntryMap::iterator i = map_.find(key);
+				if (i != map_.end()) {
+					i->second->second = value;
+					entries_.splice(entries_.begin(), entries_, i->second);
+					return;
+				}
+				if (map_.size() >= capacity_) {
+					map_.erase(entries_.back().first);
+					entries_.pop_back();
+				}
+				entries_.push_front(std::make_pair(key, value));
+				map_.insert(std::make_pair(key, entries_.begin()));
+			}
+
+			void remove(const Key& key) {
+				typename EntryMap::iterator i = map_.find(key);
+				if (i != map_.end()) {
+					entries_.erase(i->second);
+					map_.erase(i);
+				}
+			}
+
+			void clear() {
+				map_.clear();
+				entries_.clear();
+			}
+
+			size_t size() const {
+				return map_.size();
+			}
+
+			size_t getCapacity() const {
+				return capacity_;
+			}
+
+		private:
+			size_t capacity_;
+			EntryList entries_;
+			EntryMap map_;
+	};
+}
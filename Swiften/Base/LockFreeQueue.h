@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+namespace Swift {
+	/**
+	 * An unbounded queue with multiple producers and a single consumer.
+	 *
+	 * push() can be called from any thread, and never blocks. pop() and
+	 * isEmpty() may only be called from the consumer thread. A value becomes
+	 * visible to the consumer once the push() call of its producer completed,
+	 * so a producer that is suspended in the middle of push() temporarily
+	 * hides the values pushed after it.
+	 */
+	template<typename T>
+	class LockFreeQueue : public boost::noncopyable {
+		public:
+			LockFreeQueue() : tail_(new Node()) {
+				head_.store(tail_);
+			}
+
+			~LockFreeQueue() {
+				while (Node* next = tail_->next.load()) {
+					delete tail_;
+					tail_ = next;
+				}
+				delete tail_;
+			}
+
+			void push(const T& value) {
+				Node* node = new Node(value);
+				Node* previous = head_.exchange(node);
+				previous->next.store(node);
+			}
+
+			/**
+			 * Takes the oldest value out of the queue. Returns false if the queue
+			 * is empty.
+			 */
+			bool pop(T& value) {
+				Node* next = tail_->next.load();
+				if (!next) {
+					return false;
+				}
+				value = *next->value;
+				// The node becomes the new stub, which holds no value
+				next->value.reset();
+				delete tail_;
+				tail_ = next;
+				return true;
+			}
+
+			bool isEmpty() const {
+				return !tail_->next.load();
+			}
+
+		private:
+			struct Node {
+				Node() : next(NULL) {}
+				Node(const T& value) : value(value), next(NULL) {}
+
+				boost::optional<T> value;
+				boost::atomic<Node*> next;
+			};
+
+			// The most recently pushed node
+			boost::atomic<Node*> head_;
+			// The stub node before the oldest value, only accessed by the consumer
+			Node* tail_;
+	};
+}
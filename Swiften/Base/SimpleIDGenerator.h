@@ -9,6 +9,7 @@
 #include <string>
 
 #include <Swiften/Base/API.h>
+#include <Swiften/Base/Override.h>
 #include <Swiften/Base/IDGenerator.h>
 
 namespace Swift {
@@ -16,13 +17,15 @@ namespace Swift {
 	/**
 	 * @brief The SimpleIDGenerator class implements a IDGenerator generating consecutive ID strings from
 	 * the lower case latin alphabet.
+	 *
+	 * Unlike IDGenerator, this class is not thread-safe.
 	 */
 
 	class SWIFTEN_API SimpleIDGenerator : public IDGenerator {
 		public:
 			SimpleIDGenerator();
 
-			std::string generateID();
+			virtual std::string generateID() SWIFTEN_OVERRIDE;
 
 		private:
 			std::string currentID;
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <string>
+
+#include <Swiften/Base/API.h>
+
+namespace Swift {
+	/**
+	 * A non-owning reference to a sequence of characters.
+	 *
+	 * The referenced characters are not necessarily null-terminated, and
+	 * are only valid as long as the owner of the data keeps them alive.
+	 */
+	class SWIFTEN_API StringView {
+		public:
+			StringView() : data_(""), size_(0) {
+			}
+
+			StringView(const char* data, size_t size) : data_(data), size_(size) {
+			}
+
+			StringView(const char* data) : data_(data), size_(std::strlen(data)) {
+			}
+
+			StringView(const std::string& s) : data_(s.data()), size_(s.size()) {
+			}
+
+			const char* data() const {
+				return data_;
+			}
+
+			size_t size() const {
+				return size_;
+			}
+
+			bool empty() const {
+				return size_ == 0;
+			}
+
+			const char* begin() const {
+				return data_;
+			}
+
+			const char* end() const {
+				return data_ + size_;
+			}
+
+			std::string toString() const {
+				return std::string(data_, size_);
+			}
+
+			void appendTo(std::string& s) const {
+				s.append(data_, size_);
+			}
+
+			bool operator==(const StringView& o) const {
+				return size_ == o.size_ && std::memcmp(data_, o.data_, size_) == 0;
+			}
+
+			bool operator!=(const StringView& o) const {
+				return !(*this == o);
+			}
+
+		private:
+			const char* data_;
+			size_t size_;
+	};
+
+	inline bool operator==(const std::string& s, const StringView& v) {
+		return v == StringView(s);
+	}
+
+	inline bool operator==(const char* s, const StringView& v) {
+		return v == StringView(s);
+	}
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <Swiften/Base/Arena.h>
+
+using namespace Swift;
+
+class ArenaTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(ArenaTest);
+		CPPUNIT_TEST(testAllocate_Aligned);
+		CPPUNIT_TEST(testAllocate_SharesBlocks);
+		CPPUNIT_TEST(testAllocate_LargerThanBlockSize);
+		CPPUNIT_TEST(testAllocator_KeepsArenaAlive);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void testAllocate_Aligned() {
+			Arena testling;
+
+			testling.allocate(3);
+			void* p = testling.allocate(sizeof(double));
+
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), reinterpret_cast<size_t>(p) % sizeof(double));
+		}
+
+		void testAllocate_SharesBlocks() {
+			Arena testling(1024);
+
+			for (int i = 0; i < 10; ++i) {
+				testling.allocate(32);
+			}
+
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1024), testling.getCapacity());
+		}
+
+		void testAllocate_LargerThanBlockSize() {
+			Arena testling(1024);
+
+			testling.allocate(16);
+			testling.allocate(4096);
+
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1024 + 4096), testling.getCapacity());
+		}
+
+		void testAllocator_KeepsArenaAlive() {
+			boost::shared_ptr<Arena> arena = boost::make_shared<Arena>();
+			boost::weak_ptr<Arena> weakArena(arena);
+			boost::shared_ptr<std::string> s = boost::allocate_shared<std::string>(ArenaAllocator<std::string>(arena), "foo");
+			arena.reset();
+
+			CPPUNIT_ASSERT(!weakArena.expired());
+			CPPUNIT_ASSERT_EQUAL(std::string("foo"), *s);
+
+			s.reset();
+
+			CPPUNIT_ASSERT(weakArena.expired());
+		}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ArenaTest);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,6 +7,10 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <set>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
 
 #include <Swiften/Base/IDGenerator.h>
 
@@ -16,6 +20,8 @@ class IDGeneratorTest : public CppUnit::TestFixture
 {
 		CPPUNIT_TEST_SUITE(IDGeneratorTest);
 		CPPUNIT_TEST(testGenerate);
+		CPPUNIT_TEST(testGenerate_DifferentGenerators);
+		CPPUNIT_TEST(testGenerate_MultipleThreads);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -32,7 +38,42 @@ class IDGeneratorTest : public CppUnit::TestFixture
 				CPPUNIT_ASSERT(generatedIDs_.insert(id).second);
 			}
 		}
+
+		void testGenerate_DifferentGenerators() {
+			IDGenerator testling1;
+			IDGenerator testling2;
+			for (unsigned int i = 0; i < 10; ++i) {
+				CPPUNIT_ASSERT(generatedIDs_.insert(testling1.generateID()).second);
+				CPPUNIT_ASSERT(generatedIDs_.insert(testling2.generateID()).second);
+			}
+		}
+
+		void testGenerate_MultipleThreads() {
+			IDGenerator testling;
+			std::vector< std::vector<std::string> > ids(4);
+			std::vector< boost::shared_ptr<boost::thread> > threads;
+			for (size_t i = 0; i < ids.size(); ++i) {
+				threads.push_back(boost::make_shared<boost::thread>(boost::bind(&IDGeneratorTest::generateIDs, &testling, &ids[i])));
+			}
+			for (size_t i = 0; i < threads.size(); ++i) {
+				threads[i]->join();
+			}
+
+			for (size_t i = 0; i < ids.size(); ++i) {
+				for (size_t j = 0; j < ids[i].size(); ++j) {
+					CPPUNIT_ASSERT(generatedIDs_.insert(ids[i][j]).second);
+				}
+			}
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4 * 10000), generatedIDs_.size());
+		}
 	
+	private:
+		static void generateIDs(IDGenerator* generator, std::vector<std::string>* ids) {
+			for (int i = 0; i < 10000; ++i) {
+				ids->push_back(generator->generateID());
+			}
+		}
+
 	private:
 		std::set<std::string> generatedIDs_;
 };
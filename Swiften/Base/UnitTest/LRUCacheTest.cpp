@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/Base/LRUCache.h>
+
+using namespace Swift;
+
+class LRUCacheTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(LRUCacheTest);
+		CPPUNIT_TEST(testGet);
+		CPPUNIT_TEST(testGet_Missing);
+		CPPUNIT_TEST(testPut_Existing);
+		CPPUNIT_TEST(testPut_Full);
+		CPPUNIT_TEST(testPut_FullAfterGet);
+		CPPUNIT_TEST(testRemove);
+		CPPUNIT_TEST(testClear);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void testGet() {
+			LRUCache<std::string, int> testling(2);
+			testling.put("foo", 1);
+
+			const int* result = testling.get("foo");
+			CPPUNIT_ASSERT(result);
+			CPPUNIT_ASSERT_EQUAL(1, *result);
+		}
+
+		void testGet_Missing() {
+			LRUCache<std::string, int> testling(2);
+			testling.put("foo", 1);
+
+			CPPUNIT_ASSERT(!testling.get("bar"));
+		}
+
+		void testPut_Existing() {
+			LRUCache<std::string, int> testling(2);
+			testling.put("foo", 1);
+			testling.put("foo", 2);
+
+			CPPUNIT_ASSERT_EQUAL(2, *testling.get("foo"));
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), testling.size());
+		}
+
+		void testPut_Full() {
+			LRUCache<std::string, int> testling(2);
+			testling.put("foo", 1);
+			testling.put("bar", 2);
+			testling.put("baz", 3);
+
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), testling.size());
+			CPPUNIT_ASSERT(!testling.get("foo"));
+			CPPUNIT_ASSERT_EQUAL(2, *testling.get("bar"));
+			CPPUNIT_ASSERT_EQUAL(3, *testling.get("baz"));
+		}
+
+		void testPut_FullAfterGet() {
+			LRUCache<std::string, int> testling(2);
+			testling.put("foo", 1);
+			testling.put("bar", 2);
+			testling.get("foo");
+			testling.put("baz", 3);
+
+			CPPUNIT_ASSERT_EQUAL(1, *testling.get("foo"));
+			CPPUNIT_ASSERT(!testling.get("bar"));
+			CPPUNIT_ASSERT_EQUAL(3, *testling.get("baz"));
+		}
+
+		void testRemove() {
+			LRUCache<std::string, int> testling(2);
+			testling.put("foo", 1);
+			testling.put("bar", 2);
+			testling.remove("foo");
+			testling.put("baz", 3);
+
+			CPPUNIT_ASSERT(!testling.get("foo"));
+			CPPUNIT_ASSERT_EQUAL(2, *testling.get("bar"));
+			CPPUNIT_ASSERT_EQUAL(3, *testling.get("baz"));
+		}
+
+		void testClear() {
+			LRUCache<std::string, int> testling(2);
+			testling.put("foo", 1);
+			testling.clear();
+
+			CPPUNIT_ASSERT(!testling.get("foo"));
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), testling.size());
+		}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LRUCacheTest);
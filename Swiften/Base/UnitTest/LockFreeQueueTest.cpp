@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <vector>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include <Swiften/Base/LockFreeQueue.h>
+
+using namespace Swift;
+
+class LockFreeQueueTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(LockFreeQueueTest);
+		CPPUNIT_TEST(testPop_Empty);
+		CPPUNIT_TEST(testPop_InOrder);
+		CPPUNIT_TEST(testPush_MultipleThreads);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void testPop_Empty() {
+			LockFreeQueue<int> testling;
+			int value = 0;
+
+			CPPUNIT_ASSERT(testling.isEmpty());
+			CPPUNIT_ASSERT(!testling.pop(value));
+		}
+
+		void testPop_InOrder() {
+			LockFreeQueue<int> testling;
+			testling.push(1);
+			testling.push(2);
+			int value = 0;
+
+			CPPUNIT_ASSERT(!testling.isEmpty());
+			CPPUNIT_ASSERT(testling.pop(value));
+			CPPUNIT_ASSERT_EQUAL(1, value);
+			CPPUNIT_ASSERT(testling.pop(value));
+			CPPUNIT_ASSERT_EQUAL(2, value);
+			CPPUNIT_ASSERT(testling.isEmpty());
+		}
+
+		void testPush_MultipleThreads() {
+			LockFreeQueue<int> testling;
+			boost::thread_group producers;
+			for (int producer = 0; producer < 4; ++producer) {
+				producers.create_thread(boost::bind(&LockFreeQueueTest::pushValues, &testling, producer));
+			}
+
+			// Values of every producer arrive in the order they were pushed
+			std::vector<int> lastValues(4, -1);
+			int receivedValues = 0;
+			while (receivedValues < 4 * 10000) {
+				int value = 0;
+				if (testling.pop(value)) {
+					int producer = value / 10000;
+					CPPUNIT_ASSERT(value % 10000 > lastValues[producer]);
+					lastValues[producer] = value % 10000;
+					++receivedValues;
+				}
+				else {
+					boost::this_thread::yield();
+				}
+			}
+			producers.join_all();
+
+			CPPUNIT_ASSERT(testling.isEmpty());
+		}
+
+	private:
+		static void pushValues(LockFreeQueue<int>* queue, int producer) {
+			for (int i = 0; i < 10000; ++i) {
+				queue->push(producer * 10000 + i);
+			}
+		}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LockFreeQueueTest);
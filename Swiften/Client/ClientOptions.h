@@ -10,6 +10,7 @@
 
 #include <Swiften/Base/URL.h>
 #include <Swiften/Base/SafeString.h>
+#include <Swiften/StreamManagement/StanzaAckRequestPolicy.h>
 
 namespace Swift {
 	class HTTPTrafficFilter;
@@ -37,6 +38,7 @@ namespace Swift {
 				useAcks(true), 
 				manualHostname(""),
 				manualPort(-1),
+				connectionAttemptDelayMilliseconds(0),
 				proxyType(SystemConfiguredProxy),
 				manualProxyHostname(""),
 				manualProxyPort(-1),
@@ -67,7 +69,13 @@ namespace Swift {
 		bool allowPLAINWithoutTLS;
 
 		/**
-		 * Use XEP-196 stream resumption when available.
+		 * Use XEP-198 stream resumption when available.
+		 *
+		 * When the connection is lost, the next call to CoreClient::connect()
+		 * tries to resume the previous session instead of starting a new one.
+		 *
+		 * \see CoreClient::isStreamResumed()
+		 * \see CoreClient::onStanzaLost
 		 *
 		 * Default: false
 		 */
@@ -89,6 +97,12 @@ namespace Swift {
 		 */
 		bool useAcks;
 
+		/**
+		 * When to request acks for sent messages, if acks are used.
+		 * Default: request an ack for every message
+		 */
+		StanzaAckRequestPolicy stanzaAckRequestPolicy;
+
 		/**
 		 * The hostname to connect to.
 		 * Leave this empty for standard XMPP connection, based on the JID domain.
@@ -102,6 +116,14 @@ namespace Swift {
 		 */
 		int manualPort;
 
+		/**
+		 * If positive, race connection attempts to the candidate hosts and
+		 * addresses, starting a new attempt after this many milliseconds
+		 * while earlier ones are still pending (RFC 8305 recommends 250).
+		 * Default: 0 (try candidates one after the other)
+		 */
+		int connectionAttemptDelayMilliseconds;
+
 		/**
 		 * The type of proxy to use for connecting to the XMPP
 		 * server.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -14,6 +14,7 @@
 
 #include <Swiften/Base/Platform.h>
 #include <Swiften/Base/Log.h>
+#include <Swiften/Base/foreach.h>
 #include <Swiften/Elements/ProtocolHeader.h>
 #include <Swiften/Elements/StreamFeatures.h>
 #include <Swiften/Elements/StreamError.h>
@@ -31,6 +32,8 @@
 #include <Swiften/Elements/EnableStreamManagement.h>
 #include <Swiften/Elements/StreamManagementEnabled.h>
 #include <Swiften/Elements/StreamManagementFailed.h>
+#include <Swiften/Elements/StreamResume.h>
+#include <Swiften/Elements/StreamResumed.h>
 #include <Swiften/Elements/StartSession.h>
 #include <Swiften/Elements/StanzaAck.h>
 #include <Swiften/Elements/StanzaAckRequest.h>
@@ -68,10 +71,13 @@ ClientSession::ClientSession(
 			useStreamCompression(true),
 			useTLS(UseTLSWhenAvailable),
 			useAcks(true),
+			useStreamResumption(false),
+			timerFactory(NULL),
 			needSessionStart(false),
 			needResourceBind(false),
 			needAcking(false),
 			rosterVersioningSupported(false),
+			streamResumed(false),
 			authenticator(NULL),
 			certificateTrustChecker(NULL) {
 #ifdef SWIFTEN_PLATFORM_WIN32
@@ -260,12 +266,16 @@ void ClientSession::handleElement(boost::shared_ptr<ToplevelElement> element) {
 			needSessionStart = streamFeatures->hasSession();
 			needResourceBind = streamFeatures->hasResourceBind();
 			needAcking = streamFeatures->hasStreamManagement() && useAcks;
-			if (!needResourceBind) {
-				// Resource binding is a MUST
-				finishSession(Error::ResourceBindError);
+			if (resumptionState && needAcking) {
+				state = ResumingSession;
+				boost::shared_ptr<StreamResume> resume = boost::make_shared<StreamResume>();
+				resume->setResumeID(resumptionState->id);
+				resume->setHandledStanzasCount(resumptionState->handledStanzasCount);
+				stream->writeElement(resume);
 			}
 			else {
-				continueSessionInitialization();
+				dropResumptionState();
+				bindResource();
 			}
 		}
 	}
@@ -279,17 +289,51 @@ void ClientSession::handleElement(boost::shared_ptr<ToplevelElement> element) {
 	else if (boost::dynamic_pointer_cast<CompressFailure>(element)) {
 		finishSession(Error::CompressionFailedError);
 	}
-	else if (boost::dynamic_pointer_cast<StreamManagementEnabled>(element)) {
-		stanzaAckRequester_ = boost::make_shared<StanzaAckRequester>();
-		stanzaAckRequester_->onRequestAck.connect(boost::bind(&ClientSession::requestAck, shared_from_this()));
-		stanzaAckRequester_->onStanzaAcked.connect(boost::bind(&ClientSession::handleStanzaAcked, shared_from_this(), _1));
-		stanzaAckResponder_ = boost::make_shared<StanzaAckResponder>();
-		stanzaAckResponder_->onAck.connect(boost::bind(&ClientSession::ack, shared_from_this(), _1));
+	else if (boost::shared_ptr<StreamManagementEnabled> enabled = boost::dynamic_pointer_cast<StreamManagementEnabled>(element)) {
+		if (useStreamResumption && enabled->getResumeSupported()) {
+			resumeID = enabled->getResumeID();
+		}
+		setupStreamManagement(boost::make_shared<StanzaAckRequester>(), boost::make_shared<StanzaAckResponder>());
 		needAcking = false;
 		continueSessionInitialization();
 	}
 	else if (boost::dynamic_pointer_cast<StreamManagementFailed>(element)) {
+		if (state == ResumingSession) {
+			SWIFT_LOG(debug) << "Stream resumption failed" << std::endl;
+			dropResumptionState();
+			bindResource();
+		}
+		else {
+			needAcking = false;
+			continueSessionInitialization();
+		}
+	}
+	else if (boost::shared_ptr<StreamResumed> resumed = boost::dynamic_pointer_cast<StreamResumed>(element)) {
+		CHECK_STATE_OR_RETURN(ResumingSession);
+		localJID = resumptionState->jid;
+		resumeID = resumptionState->id;
+		setupStreamManagement(
+				boost::make_shared<StanzaAckRequester>(resumptionState->ackedStanzasCount, resumptionState->unackedStanzas),
+				boost::make_shared<StanzaAckResponder>(resumptionState->handledStanzasCount));
+		resumptionState.reset();
+		if (resumed->getHandledStanzasCount()) {
+			stanzaAckRequester_->handleAckReceived(*resumed->getHandledStanzasCount());
+		}
+
+		// Resend everything the server did not receive. The stanzas stay in
+		// the queue of the requester, so they are acked as usual.
+		std::deque<boost::shared_ptr<Stanza> > unackedStanzas = stanzaAckRequester_->getUnackedStanzas();
+		foreach (boost::shared_ptr<Stanza> stanza, unackedStanzas) {
+			stream->writeElement(stanza);
+		}
+		if (!unackedStanzas.empty()) {
+			requestAck();
+		}
+
 		needAcking = false;
+		needResourceBind = false;
+		needSessionStart = false;
+		streamResumed = true;
 		continueSessionInitialization();
 	}
 	else if (AuthChallenge* challenge = dynamic_cast<AuthChallenge*>(element.get())) {
@@ -334,6 +378,40 @@ void ClientSession::handleElement(boost::shared_ptr<ToplevelElement> element) {
 	}
 }
 
+void ClientSession::bindResource() {
+	if (!needResourceBind) {
+		// Resource binding is a MUST
+		finishSession(Error::ResourceBindError);
+	}
+	else {
+		continueSessionInitialization();
+	}
+}
+
+/**
+ * Forgets the state of the previous stream, and reports its unacked stanzas
+ * as lost.
+ */
+void ClientSession::dropResumptionState() {
+	if (!resumptionState) {
+		return;
+	}
+	boost::shared_ptr<StreamResumptionState> state = resumptionState;
+	resumptionState.reset();
+	foreach (boost::shared_ptr<Stanza> stanza, state->unackedStanzas) {
+		onStanzaLost(stanza);
+	}
+}
+
+void ClientSession::setupStreamManagement(boost::shared_ptr<StanzaAckRequester> requester, boost::shared_ptr<StanzaAckResponder> responder) {
+	stanzaAckRequester_ = requester;
+	stanzaAckRequester_->setPolicy(stanzaAckRequestPolicy, timerFactory);
+	stanzaAckRequester_->onRequestAck.connect(boost::bind(&ClientSession::requestAck, shared_from_this()));
+	stanzaAckRequester_->onStanzaAcked.connect(boost::bind(&ClientSession::handleStanzaAcked, shared_from_this(), _1));
+	stanzaAckResponder_ = responder;
+	stanzaAckResponder_->onAck.connect(boost::bind(&ClientSession::ack, shared_from_this(), _1));
+}
+
 void ClientSession::continueSessionInitialization() {
 	if (needResourceBind) {
 		state = BindingResource;
@@ -345,7 +423,11 @@ void ClientSession::continueSessionInitialization() {
 	}
 	else if (needAcking) {
 		state = EnablingSessionManagement;
-		stream->writeElement(boost::make_shared<EnableStreamManagement>());
+		boost::shared_ptr<EnableStreamManagement> enable = boost::make_shared<EnableStreamManagement>();
+		if (useStreamResumption) {
+			enable->setResumeSupported();
+		}
+		stream->writeElement(enable);
 	}
 	else if (needSessionStart) {
 		state = StartingSession;
@@ -411,6 +493,22 @@ void ClientSession::handleStreamClosed(boost::shared_ptr<Swift::Error> streamErr
 	State previousState = state;
 	state = Finished;
 
+	// Closing the stream ourselves ends the session on the server, so only a
+	// lost connection can be resumed. Neither can a stream of which we no
+	// longer have all unacked stanzas.
+	if (previousState == Initialized && !resumeID.empty() && stanzaAckRequester_ && stanzaAckResponder_ && !stanzaAckRequester_->hasForgottenStanzas()) {
+		resumptionState = boost::make_shared<StreamResumptionState>();
+		resumptionState->id = resumeID;
+		resumptionState->jid = localJID;
+		resumptionState->handledStanzasCount = stanzaAckResponder_->getHandledStanzasCount();
+		resumptionState->ackedStanzasCount = stanzaAckRequester_->getHandledStanzasCount();
+		resumptionState->unackedStanzas = stanzaAckRequester_->getUnackedStanzas();
+	}
+	else {
+		// A stream that was lost while resuming can't be resumed anymore
+		dropResumptionState();
+	}
+
 	if (stanzaAckRequester_) {
 		stanzaAckRequester_->onRequestAck.disconnect(boost::bind(&ClientSession::requestAck, shared_from_this()));
 		stanzaAckRequester_->onStanzaAcked.disconnect(boost::bind(&ClientSession::handleStanzaAcked, shared_from_this(), _1));
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -18,12 +18,14 @@
 #include <Swiften/Elements/ToplevelElement.h>
 #include <Swiften/StreamManagement/StanzaAckRequester.h>
 #include <Swiften/StreamManagement/StanzaAckResponder.h>
+#include <Swiften/StreamManagement/StreamResumptionState.h>
 
 namespace Swift {
 	class ClientAuthenticator;
 	class CertificateTrustChecker;
 	class IDNConverter;
 	class CryptoProvider;
+	class TimerFactory;
 
 	class SWIFTEN_API ClientSession : public boost::enable_shared_from_this<ClientSession> {
 		public:
@@ -37,6 +39,7 @@ namespace Swift {
 				WaitingForCredentials,
 				Authenticating,
 				EnablingSessionManagement,
+				ResumingSession,
 				BindingResource,
 				StartingSession,
 				Initialized,
@@ -92,6 +95,53 @@ namespace Swift {
 				useAcks = b;
 			}
 
+			/**
+			 * Sets whether the server should be asked to make the stream
+			 * resumable when stream management is enabled.
+			 */
+			void setUseStreamResumption(bool b) {
+				useStreamResumption = b;
+			}
+
+			/**
+			 * Sets when acks are requested for sent stanzas. The timer factory
+			 * is only needed if the policy uses delays.
+			 */
+			void setStanzaAckRequestPolicy(const StanzaAckRequestPolicy& policy, TimerFactory* timerFactory) {
+				stanzaAckRequestPolicy = policy;
+				this->timerFactory = timerFactory;
+			}
+
+			/**
+			 * Sets the state of a previous stream to resume, instead of binding
+			 * a new resource. If the server refuses to resume the stream, a new
+			 * resource is bound, and the unacked stanzas of the previous stream
+			 * are dropped.
+			 *
+			 * Must be called before start().
+			 */
+			void setResumptionState(boost::shared_ptr<StreamResumptionState> state) {
+				resumptionState = state;
+			}
+
+			/**
+			 * Returns the state needed to resume this session on a new stream,
+			 * or NULL if the session cannot be resumed.
+			 *
+			 * This is only available after the stream was lost while the session
+			 * was initialized, and if the server allowed resumption.
+			 */
+			boost::shared_ptr<StreamResumptionState> getResumptionState() const {
+				return resumptionState;
+			}
+
+			/**
+			 * Returns whether this session was initialized by resuming a
+			 * previous stream.
+			 */
+			bool isStreamResumed() const {
+				return streamResumed;
+			}
 
 			bool getStreamManagementEnabled() const {
 				// Explicitly convert to bool. In C++11, it would be cleaner to
@@ -131,6 +181,9 @@ namespace Swift {
 			boost::signal<void (boost::shared_ptr<Swift::Error>)> onFinished;
 			boost::signal<void (boost::shared_ptr<Stanza>)> onStanzaReceived;
 			boost::signal<void (boost::shared_ptr<Stanza>)> onStanzaAcked;
+			// Emitted for every unacked stanza of a previous stream that could
+			// not be resumed. The server may or may not have received it.
+			boost::signal<void (boost::shared_ptr<Stanza>)> onStanzaLost;
 		
 		private:
 			ClientSession(
@@ -155,7 +208,10 @@ namespace Swift {
 			void handleTLSEncrypted();
 
 			bool checkState(State);
+			void bindResource();
+			void dropResumptionState();
 			void continueSessionInitialization();
+			void setupStreamManagement(boost::shared_ptr<StanzaAckRequester>, boost::shared_ptr<StanzaAckResponder>);
 
 			void requestAck();
 			void handleStanzaAcked(boost::shared_ptr<Stanza> stanza);
@@ -173,10 +229,16 @@ namespace Swift {
 			bool useStreamCompression;
 			UseTLS useTLS;
 			bool useAcks;
+			bool useStreamResumption;
+			StanzaAckRequestPolicy stanzaAckRequestPolicy;
+			TimerFactory* timerFactory;
 			bool needSessionStart;
 			bool needResourceBind;
 			bool needAcking;
 			bool rosterVersioningSupported;
+			bool streamResumed;
+			std::string resumeID;
+			boost::shared_ptr<StreamResumptionState> resumptionState;
 			ClientAuthenticator* authenticator;
 			boost::shared_ptr<StanzaAckRequester> stanzaAckRequester_;
 			boost::shared_ptr<StanzaAckResponder> stanzaAckResponder_;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -82,6 +82,10 @@ bool ClientSessionStanzaChannel::getStreamManagementEnabled() const {
 	return false;
 }
 
+bool ClientSessionStanzaChannel::isStreamResumed() const {
+	return session && session->isStreamResumed();
+}
+
 std::vector<Certificate::ref> ClientSessionStanzaChannel::getPeerCertificateChain() const {
 	if (session) {
 		return session->getPeerCertificateChain();
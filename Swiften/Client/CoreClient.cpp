@@ -60,6 +60,9 @@ void CoreClient::connect(const ClientOptions& o) {
 	disconnectRequested_ = false;
 
 	options = o;
+	if (!options.useStreamResumption) {
+		dropResumptionState();
+	}
 
 
 	// Determine connection types to use
@@ -118,6 +121,7 @@ void CoreClient::connect(const ClientOptions& o) {
 		connector_ = boost::make_shared<ChainedConnector>(host, port, serviceLookupPrefix, networkFactories->getDomainNameResolver(), connectionFactories, networkFactories->getTimerFactory());
 		connector_->onConnectFinished.connect(boost::bind(&CoreClient::handleConnectorFinished, this, _1, _2));
 		connector_->setTimeoutMilliseconds(2*60*1000);
+		connector_->setConnectionAttemptDelayMilliseconds(o.connectionAttemptDelayMilliseconds);
 		connector_->start();
 	}
 	else {
@@ -163,9 +167,16 @@ void CoreClient::bindSessionToStream() {
 			break;
 	}
 	session_->setUseAcks(options.useAcks);
+	session_->setUseStreamResumption(options.useStreamResumption);
+	session_->setStanzaAckRequestPolicy(options.stanzaAckRequestPolicy, networkFactories->getTimerFactory());
+	if (resumptionState_) {
+		session_->setResumptionState(resumptionState_);
+		resumptionState_.reset();
+	}
 	stanzaChannel_->setSession(session_);
 	session_->onFinished.connect(boost::bind(&CoreClient::handleSessionFinished, this, _1));
 	session_->onNeedCredentials.connect(boost::bind(&CoreClient::handleNeedCredentials, this));
+	session_->onStanzaLost.connect(boost::bind(&CoreClient::handleStanzaLost, this, _1));
 	session_->start();
 }
 
@@ -193,6 +204,7 @@ void CoreClient::handleConnectorFinished(boost::shared_ptr<Connection> connectio
 		if (certificate_ && !certificate_->isNull()) {
 			sessionStream_->setTLSCertificate(certificate_);
 		}
+		sessionStream_->setTLSServerIdentity(jid_.getDomain());
 		sessionStream_->onDataRead.connect(boost::bind(&CoreClient::handleDataRead, this, _1));
 		sessionStream_->onDataWritten.connect(boost::bind(&CoreClient::handleDataWritten, this, _1));
 
@@ -204,6 +216,7 @@ void CoreClient::disconnect() {
 	// FIXME: We should be able to do without this boolean. We just have to make sure we can tell the difference between
 	// connector finishing without a connection due to an error or because of a disconnect.
 	disconnectRequested_ = true;
+	dropResumptionState();
 	if (session_ && !session_->isFinished()) {
 		session_->finish();
 	}
@@ -220,6 +233,12 @@ void CoreClient::handleSessionFinished(boost::shared_ptr<Error> error) {
 	if (options.forgetPassword) {
 		purgePassword();
 	}
+	// Keep the state of the lost stream around, so the next connect() can
+	// resume it
+	resumptionState_ = session_->getResumptionState();
+	if (!options.useStreamResumption || disconnectRequested_) {
+		dropResumptionState();
+	}
 	resetSession();
 
 	boost::optional<ClientError> actualError;
@@ -393,6 +412,21 @@ void CoreClient::handleStanzaAcked(Stanza::ref stanza) {
 	onStanzaAcked(stanza);
 }
 
+void CoreClient::handleStanzaLost(Stanza::ref stanza) {
+	onStanzaLost(stanza);
+}
+
+void CoreClient::dropResumptionState() {
+	if (!resumptionState_) {
+		return;
+	}
+	boost::shared_ptr<StreamResumptionState> state = resumptionState_;
+	resumptionState_.reset();
+	foreach (Stanza::ref stanza, state->unackedStanzas) {
+		onStanzaLost(stanza);
+	}
+}
+
 bool CoreClient::isAvailable() const {
 	return stanzaChannel_->isAvailable();
 }
@@ -401,6 +435,10 @@ bool CoreClient::getStreamManagementEnabled() const {
 	return stanzaChannel_->getStreamManagementEnabled();
 }
 
+bool CoreClient::isStreamResumed() const {
+	return session_ && session_->isStreamResumed();
+}
+
 bool CoreClient::isStreamEncrypted() const {
 	return sessionStream_->isTLSEncrypted();
 }
@@ -434,6 +472,7 @@ void CoreClient::resetConnector() {
 void CoreClient::resetSession() {
 	session_->onFinished.disconnect(boost::bind(&CoreClient::handleSessionFinished, this, _1));
 	session_->onNeedCredentials.disconnect(boost::bind(&CoreClient::handleNeedCredentials, this));
+	session_->onStanzaLost.disconnect(boost::bind(&CoreClient::handleStanzaLost, this, _1));
 
 	sessionStream_->onDataRead.disconnect(boost::bind(&CoreClient::handleDataRead, this, _1));
 	sessionStream_->onDataWritten.disconnect(boost::bind(&CoreClient::handleDataWritten, this, _1));
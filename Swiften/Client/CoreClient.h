@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2012 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -35,6 +35,7 @@ namespace Swift {
 	class CertificateTrustChecker;
 	class NetworkFactories;
 	class ClientSessionStanzaChannel;
+	struct StreamResumptionState;
 
 	/** 
 	 * The central class for communicating with an XMPP server.
@@ -125,6 +126,18 @@ namespace Swift {
 			 */
 			bool getStreamManagementEnabled() const;
 
+			/**
+			 * Checks whether the current session was resumed from the previous
+			 * one (see ClientOptions::useStreamResumption).
+			 *
+			 * A resumed session keeps the bound JID, the roster and presence
+			 * subscriptions of the previous session, and stanzas that were not
+			 * acked on the previous stream are resent. Applications can check
+			 * this when onConnected is emitted, to avoid requesting the roster
+			 * and sending initial presence again.
+			 */
+			bool isStreamResumed() const;
+
 			/**
 			 * Checks whether stream encryption (TLS) is currently active.
 			 */
@@ -191,6 +204,17 @@ namespace Swift {
 			 */
 			boost::signal<void (boost::shared_ptr<Stanza>)> onStanzaAcked;
 
+			/**
+			 * Emitted for every stanza that was sent on a lost stream, but not
+			 * acknowledged, when that stream is not resumed. This happens when
+			 * the server refuses to resume the stream, or when resumption is
+			 * given up by disconnecting. The server may or may not have
+			 * received the stanza.
+			 *
+			 * \see ClientOptions::useStreamResumption
+			 */
+			boost::signal<void (boost::shared_ptr<Stanza>)> onStanzaLost;
+
 		protected:
 			boost::shared_ptr<ClientSession> getSession() const {
 				return session_;
@@ -215,6 +239,8 @@ namespace Swift {
 			void handlePresenceReceived(boost::shared_ptr<Presence>);
 			void handleMessageReceived(boost::shared_ptr<Message>);
 			void handleStanzaAcked(boost::shared_ptr<Stanza>);
+			void handleStanzaLost(boost::shared_ptr<Stanza>);
+			void dropResumptionState();
 			void purgePassword();
 			void bindSessionToStream();
 
@@ -236,6 +262,7 @@ namespace Swift {
 			boost::shared_ptr<ClientSession> session_;
 			CertificateWithKey::ref certificate_;
 			bool disconnectRequested_;
+			boost::shared_ptr<StreamResumptionState> resumptionState_;
 			CertificateTrustChecker* certificateTrustChecker;
 	};
 }
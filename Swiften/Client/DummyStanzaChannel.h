@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,14 +13,15 @@
 namespace Swift {
 	class DummyStanzaChannel : public StanzaChannel {
 		public:
-			DummyStanzaChannel() : available_(true) {}
+			DummyStanzaChannel() : available_(true), streamResumed_(false) {}
 
 			virtual void sendStanza(boost::shared_ptr<Stanza> stanza) {
 				sentStanzas.push_back(stanza);
 			}
 
-			void setAvailable(bool available) {
+			void setAvailable(bool available, bool streamResumed = false) {
 				available_ = available;
+				streamResumed_ = available && streamResumed;
 				onAvailableChanged(available);
 			}
 
@@ -48,6 +49,10 @@ namespace Swift {
 				return false;
 			}
 
+			virtual bool isStreamResumed() const {
+				return streamResumed_;
+			}
+
 			template<typename T> bool isRequestAtIndex(size_t index, const JID& jid, IQ::Type type) {
 				if (index >= sentStanzas.size()) {
 					return false;
@@ -85,5 +90,6 @@ namespace Swift {
 
 			std::vector<boost::shared_ptr<Stanza> > sentStanzas;
 			bool available_;
+			bool streamResumed_;
 	};
 }
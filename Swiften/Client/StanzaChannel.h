@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,6 +21,13 @@ namespace Swift {
 			virtual void sendPresence(boost::shared_ptr<Presence>) = 0;
 			virtual bool isAvailable() const = 0;
 			virtual bool getStreamManagementEnabled() const = 0;
+
+			/**
+			 * Returns whether the current stream resumed the previous one. When
+			 * the channel becomes available on a resumed stream, the presence
+			 * state of the previous stream is still valid.
+			 */
+			virtual bool isStreamResumed() const = 0;
 			virtual std::vector<Certificate::ref> getPeerCertificateChain() const = 0;
 
 			boost::signal<void (bool /* isAvailable */)> onAvailableChanged;
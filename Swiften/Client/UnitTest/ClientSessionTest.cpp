@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -28,6 +28,9 @@
 #include <Swiften/Elements/StreamManagementEnabled.h>
 #include <Swiften/Elements/StreamManagementFailed.h>
 #include <Swiften/Elements/StanzaAck.h>
+#include <Swiften/Elements/StanzaAckRequest.h>
+#include <Swiften/Elements/StreamResume.h>
+#include <Swiften/Elements/StreamResumed.h>
 #include <Swiften/Elements/EnableStreamManagement.h>
 #include <Swiften/Elements/IQ.h>
 #include <Swiften/Elements/ResourceBind.h>
@@ -55,6 +58,12 @@ class ClientSessionTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testAuthenticate_EXTERNAL);
 		CPPUNIT_TEST(testStreamManagement);
 		CPPUNIT_TEST(testStreamManagement_Failed);
+		CPPUNIT_TEST(testStreamResumption_EnableRequestsResumption);
+		CPPUNIT_TEST(testStreamResumption_ConnectionLost);
+		CPPUNIT_TEST(testStreamResumption_FinishIsNotResumable);
+		CPPUNIT_TEST(testStreamResumption_NotSupportedByServer);
+		CPPUNIT_TEST(testStreamResumption_Resume);
+		CPPUNIT_TEST(testStreamResumption_ResumeFailed);
 		CPPUNIT_TEST(testUnexpectedChallenge);
 		CPPUNIT_TEST(testFinishAcksStanzas);
 		/*
@@ -78,6 +87,7 @@ class ClientSessionTest : public CppUnit::TestFixture {
 			server = boost::make_shared<MockSessionStream>();
 			sessionFinishedReceived = false;
 			needCredentials = false;
+			lostStanzas.clear();
 			blindCertificateTrustChecker = new BlindCertificateTrustChecker();
 		}
 
@@ -331,6 +341,140 @@ class ClientSessionTest : public CppUnit::TestFixture {
 			session->finish();
 		}
 
+		void testStreamResumption_EnableRequestsResumption() {
+			boost::shared_ptr<ClientSession> session(createSession());
+			session->setUseStreamResumption(true);
+			session->start();
+			server->receiveStreamStart();
+			server->sendStreamStart();
+			server->sendStreamFeaturesWithPLAINAuthentication();
+			session->sendCredentials(createSafeByteArray("mypass"));
+			server->receiveAuthRequest("PLAIN");
+			server->sendAuthSuccess();
+			server->receiveStreamStart();
+			server->sendStreamStart();
+			server->sendStreamFeaturesWithBindAndStreamManagement();
+			server->receiveBind();
+			server->sendBindResult();
+
+			CPPUNIT_ASSERT(server->receiveStreamManagementEnable()->getResumeSupported());
+		}
+
+		void testStreamResumption_ConnectionLost() {
+			boost::shared_ptr<ClientSession> session(createSession());
+			initializeResumableSession(session);
+			server->sendMessage();
+			server->sendMessage();
+			session->sendStanza(boost::make_shared<Message>());
+			session->sendStanza(boost::make_shared<Message>());
+			server->sendAck(1);
+
+			server->breakConnection();
+
+			boost::shared_ptr<StreamResumptionState> state = session->getResumptionState();
+			CPPUNIT_ASSERT(state);
+			CPPUNIT_ASSERT_EQUAL(std::string("session-1"), state->id);
+			CPPUNIT_ASSERT_EQUAL(JID("foo@bar.com/bla"), state->jid);
+			CPPUNIT_ASSERT_EQUAL(2U, state->handledStanzasCount);
+			CPPUNIT_ASSERT_EQUAL(1U, state->ackedStanzasCount);
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(state->unackedStanzas.size()));
+		}
+
+		void testStreamResumption_FinishIsNotResumable() {
+			boost::shared_ptr<ClientSession> session(createSession());
+			initializeResumableSession(session);
+
+			session->finish();
+
+			CPPUNIT_ASSERT(!session->getResumptionState());
+		}
+
+		void testStreamResumption_NotSupportedByServer() {
+			boost::shared_ptr<ClientSession> session(createSession());
+			session->setUseStreamResumption(true);
+			initializeSession(session);
+
+			server->breakConnection();
+
+			CPPUNIT_ASSERT(!session->getResumptionState());
+		}
+
+		void testStreamResumption_Resume() {
+			boost::shared_ptr<ClientSession> session(createSession());
+			initializeResumableSession(session);
+			server->sendMessage();
+			server->sendMessage();
+			session->sendStanza(boost::make_shared<Message>());
+			session->sendStanza(boost::make_shared<Message>());
+			server->breakConnection();
+
+			server = boost::make_shared<MockSessionStream>();
+			boost::shared_ptr<ClientSession> resumedSession(createSession());
+			resumedSession->setUseStreamResumption(true);
+			resumedSession->setResumptionState(session->getResumptionState());
+			resumedSession->start();
+			server->receiveStreamStart();
+			server->sendStreamStart();
+			server->sendStreamFeaturesWithPLAINAuthentication();
+			resumedSession->sendCredentials(createSafeByteArray("mypass"));
+			server->receiveAuthRequest("PLAIN");
+			server->sendAuthSuccess();
+			server->receiveStreamStart();
+			server->sendStreamStart();
+			server->sendStreamFeaturesWithBindAndStreamManagement();
+			server->receiveStreamResume("session-1", 2);
+			server->sendStreamResumed("session-1", 1);
+
+			// Only the stanza the server did not handle is resent
+			server->receiveMessage();
+			server->receiveAckRequest();
+			CPPUNIT_ASSERT(server->receivedEvents.empty());
+			CPPUNIT_ASSERT_EQUAL(ClientSession::Initialized, resumedSession->getState());
+			CPPUNIT_ASSERT(resumedSession->isStreamResumed());
+			CPPUNIT_ASSERT(resumedSession->getStreamManagementEnabled());
+			CPPUNIT_ASSERT_EQUAL(JID("foo@bar.com/bla"), resumedSession->getLocalJID());
+			CPPUNIT_ASSERT(lostStanzas.empty());
+
+			// Counting continues from the previous stream
+			server->sendMessage();
+			resumedSession->finish();
+			server->receiveAck(3);
+		}
+
+		void testStreamResumption_ResumeFailed() {
+			boost::shared_ptr<ClientSession> session(createSession());
+			initializeResumableSession(session);
+			session->sendStanza(boost::make_shared<Message>());
+			session->sendStanza(boost::make_shared<Message>());
+			server->breakConnection();
+
+			server = boost::make_shared<MockSessionStream>();
+			boost::shared_ptr<ClientSession> resumedSession(createSession());
+			resumedSession->setResumptionState(session->getResumptionState());
+			resumedSession->start();
+			server->receiveStreamStart();
+			server->sendStreamStart();
+			server->sendStreamFeaturesWithPLAINAuthentication();
+			resumedSession->sendCredentials(createSafeByteArray("mypass"));
+			server->receiveAuthRequest("PLAIN");
+			server->sendAuthSuccess();
+			server->receiveStreamStart();
+			server->sendStreamStart();
+			server->sendStreamFeaturesWithBindAndStreamManagement();
+			server->receiveStreamResume("session-1", 0);
+			server->sendStreamManagementFailed();
+
+			// The stanzas of the previous stream are reported as lost
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(lostStanzas.size()));
+
+			server->receiveBind();
+			server->sendBindResult();
+			server->receiveStreamManagementEnable();
+			server->sendStreamManagementEnabled();
+			CPPUNIT_ASSERT_EQUAL(ClientSession::Initialized, resumedSession->getState());
+			CPPUNIT_ASSERT(!resumedSession->isStreamResumed());
+		}
+
 		void testFinishAcksStanzas() {
 			boost::shared_ptr<ClientSession> session(createSession());
 			initializeSession(session);
@@ -348,6 +492,7 @@ class ClientSessionTest : public CppUnit::TestFixture {
 			boost::shared_ptr<ClientSession> session = ClientSession::create(JID("me@foo.com"), server, idnConverter.get(), crypto.get());
 			session->onFinished.connect(boost::bind(&ClientSessionTest::handleSessionFinished, this, _1));
 			session->onNeedCredentials.connect(boost::bind(&ClientSessionTest::handleSessionNeedCredentials, this));
+			session->onStanzaLost.connect(boost::bind(&ClientSessionTest::handleStanzaLost, this, _1));
 			session->setAllowPLAINOverNonTLS(true);
 			return session;
 		}
@@ -369,6 +514,24 @@ class ClientSessionTest : public CppUnit::TestFixture {
 			server->sendStreamManagementEnabled();
 		}
 
+		void initializeResumableSession(boost::shared_ptr<ClientSession> session) {
+			session->setUseStreamResumption(true);
+			session->start();
+			server->receiveStreamStart();
+			server->sendStreamStart();
+			server->sendStreamFeaturesWithPLAINAuthentication();
+			session->sendCredentials(createSafeByteArray("mypass"));
+			server->receiveAuthRequest("PLAIN");
+			server->sendAuthSuccess();
+			server->receiveStreamStart();
+			server->sendStreamStart();
+			server->sendStreamFeaturesWithBindAndStreamManagement();
+			server->receiveBind();
+			server->sendBindResult();
+			server->receiveStreamManagementEnable();
+			server->sendStreamManagementEnabledWithResumption("session-1");
+		}
+
 		void handleSessionFinished(boost::shared_ptr<Error> error) {
 			sessionFinishedReceived = true;
 			sessionFinishedError = error;
@@ -378,6 +541,10 @@ class ClientSessionTest : public CppUnit::TestFixture {
 			needCredentials = true;
 		}
 
+		void handleStanzaLost(boost::shared_ptr<Stanza> stanza) {
+			lostStanzas.push_back(stanza);
+		}
+
 		class MockSessionStream : public SessionStream {
 			public:
 				struct Event {
@@ -546,6 +713,24 @@ class ClientSessionTest : public CppUnit::TestFixture {
 					onElementReceived(boost::make_shared<StreamManagementEnabled>());
 				}
 
+				void sendStreamManagementEnabledWithResumption(const std::string& id) {
+					boost::shared_ptr<StreamManagementEnabled> enabled = boost::make_shared<StreamManagementEnabled>();
+					enabled->setResumeSupported();
+					enabled->setResumeID(id);
+					onElementReceived(enabled);
+				}
+
+				void sendStreamResumed(const std::string& id, unsigned int handledStanzasCount) {
+					boost::shared_ptr<StreamResumed> resumed = boost::make_shared<StreamResumed>();
+					resumed->setResumeID(id);
+					resumed->setHandledStanzasCount(handledStanzasCount);
+					onElementReceived(resumed);
+				}
+
+				void sendAck(unsigned int handledStanzasCount) {
+					onElementReceived(boost::make_shared<StanzaAck>(handledStanzasCount));
+				}
+
 				void sendStreamManagementFailed() {
 					onElementReceived(boost::make_shared<StreamManagementFailed>());
 				}
@@ -582,10 +767,34 @@ class ClientSessionTest : public CppUnit::TestFixture {
 					CPPUNIT_ASSERT_EQUAL(mech, request->getMechanism());
 				}
 
-				void receiveStreamManagementEnable() {
+				boost::shared_ptr<EnableStreamManagement> receiveStreamManagementEnable() {
+					Event event = popEvent();
+					CPPUNIT_ASSERT(event.element);
+					boost::shared_ptr<EnableStreamManagement> enable = boost::dynamic_pointer_cast<EnableStreamManagement>(event.element);
+					CPPUNIT_ASSERT(enable);
+					return enable;
+				}
+
+				void receiveStreamResume(const std::string& id, unsigned int handledStanzasCount) {
+					Event event = popEvent();
+					CPPUNIT_ASSERT(event.element);
+					boost::shared_ptr<StreamResume> resume = boost::dynamic_pointer_cast<StreamResume>(event.element);
+					CPPUNIT_ASSERT(resume);
+					CPPUNIT_ASSERT_EQUAL(id, resume->getResumeID());
+					CPPUNIT_ASSERT(resume->getHandledStanzasCount());
+					CPPUNIT_ASSERT_EQUAL(handledStanzasCount, *resume->getHandledStanzasCount());
+				}
+
+				void receiveMessage() {
+					Event event = popEvent();
+					CPPUNIT_ASSERT(event.element);
+					CPPUNIT_ASSERT(boost::dynamic_pointer_cast<Message>(event.element));
+				}
+
+				void receiveAckRequest() {
 					Event event = popEvent();
 					CPPUNIT_ASSERT(event.element);
-					CPPUNIT_ASSERT(boost::dynamic_pointer_cast<EnableStreamManagement>(event.element));
+					CPPUNIT_ASSERT(boost::dynamic_pointer_cast<StanzaAckRequest>(event.element));
 				}
 
 				void receiveBind() {
@@ -627,6 +836,7 @@ class ClientSessionTest : public CppUnit::TestFixture {
 		bool sessionFinishedReceived;
 		bool needCredentials;
 		boost::shared_ptr<Error> sessionFinishedError;
+		std::vector<boost::shared_ptr<Stanza> > lostStanzas;
 		BlindCertificateTrustChecker* blindCertificateTrustChecker;
 		boost::shared_ptr<CryptoProvider> crypto;
 };
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -31,6 +31,10 @@ namespace Swift {
 				return false;
 			}
 
+			bool isStreamResumed() const {
+				return false;
+			}
+
 			std::vector<Certificate::ref> getPeerCertificateChain() const {
 				// TODO: actually implement this method
 				return std::vector<Certificate::ref>();
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013 Isode Limited.
+ * Copyright (c) 2013-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -99,6 +99,47 @@ namespace {
 			bool finalized;
 	};
 
+	class SHA256Hash : public Hash {
+		public:
+			SHA256Hash() : finalized(false) {
+				if (!CC_SHA256_Init(&context)) {
+					assert(false);
+				}
+			}
+
+			~SHA256Hash() {
+			}
+
+			virtual Hash& update(const ByteArray& data) SWIFTEN_OVERRIDE {
+				return updateInternal(data);
+			}
+
+			virtual Hash& update(const SafeByteArray& data) SWIFTEN_OVERRIDE {
+				return updateInternal(data);
+			}
+
+			virtual std::vector<unsigned char> getHash() SWIFTEN_OVERRIDE {
+				assert(!finalized);
+				std::vector<unsigned char> result(CC_SHA256_DIGEST_LENGTH);
+				CC_SHA256_Final(vecptr(result), &context);
+				return result;
+			}
+
+		private:
+			template<typename ContainerType>
+			Hash& updateInternal(const ContainerType& data) {
+				assert(!finalized);
+				if (!CC_SHA256_Update(&context, vecptr(data), boost::numeric_cast<CC_LONG>(data.size()))) {
+					assert(false);
+				}
+				return *this;
+			}
+
+		private:
+			CC_SHA256_CTX context;
+			bool finalized;
+	};
+
 	template<typename T>
 	ByteArray getHMACSHA1Internal(const T& key, const ByteArray& data) {
 		std::vector<unsigned char> result(CC_SHA1_DIGEST_LENGTH);
@@ -121,6 +162,10 @@ Hash* CommonCryptoCryptoProvider::createMD5() {
 	return new MD5Hash();
 }
 
+Hash* CommonCryptoCryptoProvider::createSHA256() {
+	return new SHA256Hash();
+}
+
 ByteArray CommonCryptoCryptoProvider::getHMACSHA1(const SafeByteArray& key, const ByteArray& data) {
 	return getHMACSHA1Internal(key, data);
 }
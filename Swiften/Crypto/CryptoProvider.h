@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013 Isode Limited.
+ * Copyright (c) 2013-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -20,6 +20,7 @@ namespace Swift {
 
 			virtual Hash* createSHA1() = 0;
 			virtual Hash* createMD5() = 0;
+			virtual Hash* createSHA256() = 0;
 			virtual ByteArray getHMACSHA1(const SafeByteArray& key, const ByteArray& data) = 0;
 			virtual ByteArray getHMACSHA1(const ByteArray& key, const ByteArray& data) = 0;
 			virtual bool isMD5AllowedForCrypto() const = 0;
@@ -32,5 +33,9 @@ namespace Swift {
 			template<typename T> ByteArray getMD5Hash(const T& data) {
 				return boost::shared_ptr<Hash>(createMD5())->update(data).getHash();
 			}
+
+			template<typename T> ByteArray getSHA256Hash(const T& data) {
+				return boost::shared_ptr<Hash>(createSHA256())->update(data).getHash();
+			}
 	};
 }
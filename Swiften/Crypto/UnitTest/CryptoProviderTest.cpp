@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -39,6 +39,10 @@ class CryptoProviderTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testGetMD5Hash_Alphabet);
 		CPPUNIT_TEST(testMD5Incremental);
 
+		CPPUNIT_TEST(testGetSHA256Hash_Empty);
+		CPPUNIT_TEST(testGetSHA256Hash);
+		CPPUNIT_TEST(testSHA256Incremental);
+
 		CPPUNIT_TEST(testGetHMACSHA1);
 		CPPUNIT_TEST(testGetHMACSHA1_KeyLongerThanBlockSize);
 		
@@ -127,6 +131,33 @@ class CryptoProviderTest : public CppUnit::TestFixture {
 		}
 
 
+		////////////////////////////////////////////////////////////	
+		// SHA-256
+		////////////////////////////////////////////////////////////	
+
+		void testGetSHA256Hash_Empty() {
+			ByteArray result(provider->getSHA256Hash(createByteArray("")));
+
+			CPPUNIT_ASSERT_EQUAL(createByteArray("\xe3\xb0\xc4\x42\x98\xfc\x1c\x14\x9a\xfb\xf4\xc8\x99\x6f\xb9\x24\x27\xae\x41\xe4\x64\x9b\x93\x4c\xa4\x95\x99\x1b\x78\x52\xb8\x55", 32), result);
+		}
+
+		void testGetSHA256Hash() {
+			ByteArray result(provider->getSHA256Hash(createByteArray("abc")));
+
+			CPPUNIT_ASSERT_EQUAL(createByteArray("\xba\x78\x16\xbf\x8f\x01\xcf\xea\x41\x41\x40\xde\x5d\xae\x22\x23\xb0\x03\x61\xa3\x96\x17\x7a\x9c\xb4\x10\xff\x61\xf2\x00\x15\xad", 32), result);
+		}
+
+		void testSHA256Incremental() {
+			boost::shared_ptr<Hash> testling = boost::shared_ptr<Hash>(provider->createSHA256());
+			testling->update(createByteArray("a"));
+			testling->update(createByteArray("bc"));
+
+			ByteArray result = testling->getHash();
+
+			CPPUNIT_ASSERT_EQUAL(createByteArray("\xba\x78\x16\xbf\x8f\x01\xcf\xea\x41\x41\x40\xde\x5d\xae\x22\x23\xb0\x03\x61\xa3\x96\x17\x7a\x9c\xb4\x10\xff\x61\xf2\x00\x15\xad", 32), result);
+		}
+
+
 		////////////////////////////////////////////////////////////	
 		// HMAC-SHA1
 		////////////////////////////////////////////////////////////	
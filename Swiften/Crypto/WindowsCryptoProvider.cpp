@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2013 Isode Limited.
+ * Copyright (c) 2013-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -192,8 +192,12 @@ namespace {
 
 WindowsCryptoProvider::WindowsCryptoProvider() {
 	p = boost::make_shared<Private>();
-	if (!CryptAcquireContext(&p->context, NULL, NULL, PROV_RSA_FULL, CRYPT_VERIFYCONTEXT)) {
-		assert(false);
+	// The AES provider also supports the SHA-2 family. Fall back to the full
+	// provider on systems that don't have it.
+	if (!CryptAcquireContext(&p->context, NULL, NULL, PROV_RSA_AES, CRYPT_VERIFYCONTEXT)) {
+		if (!CryptAcquireContext(&p->context, NULL, NULL, PROV_RSA_FULL, CRYPT_VERIFYCONTEXT)) {
+			assert(false);
+		}
 	}
 }
 
@@ -209,6 +213,10 @@ Hash* WindowsCryptoProvider::createMD5() {
 	return new WindowsHash(p->context, CALG_MD5);
 }
 
+Hash* WindowsCryptoProvider::createSHA256() {
+	return new WindowsHash(p->context, CALG_SHA_256);
+}
+
 bool WindowsCryptoProvider::isMD5AllowedForCrypto() const {
 	return !WindowsRegistry::isFIPSEnabled();
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -17,7 +17,9 @@
 
 namespace Swift {
 
-CapsManager::CapsManager(CapsStorage* capsStorage, StanzaChannel* stanzaChannel, IQRouter* iqRouter, CryptoProvider* crypto) : iqRouter(iqRouter), crypto(crypto), capsStorage(capsStorage), warnOnInvalidHash(true) {
+static const size_t cacheSize = 500;
+
+CapsManager::CapsManager(CapsStorage* capsStorage, StanzaChannel* stanzaChannel, IQRouter* iqRouter, CryptoProvider* crypto) : iqRouter(iqRouter), stanzaChannel(stanzaChannel), crypto(crypto), capsStorage(capsStorage), warnOnInvalidHash(true), cache(cacheSize) {
 	stanzaChannel->onPresenceReceived.connect(boost::bind(&CapsManager::handlePresenceReceived, this, _1));
 	stanzaChannel->onAvailableChanged.connect(boost::bind(&CapsManager::handleStanzaChannelAvailableChanged, this, _1));
 }
@@ -28,7 +30,7 @@ void CapsManager::handlePresenceReceived(boost::shared_ptr<Presence> presence) {
 		return;
 	}
 	std::string hash = capsInfo->getVersion();
-	if (capsStorage->getDiscoInfo(hash)) {
+	if (getCaps(hash)) {
 		return;
 	}
 	if (failingCaps.find(std::make_pair(presence->getFrom(), hash)) != failingCaps.end()) {
@@ -42,7 +44,7 @@ void CapsManager::handlePresenceReceived(boost::shared_ptr<Presence> presence) {
 }
 
 void CapsManager::handleStanzaChannelAvailableChanged(bool available) {
-	if (available) {
+	if (available && !stanzaChannel->isStreamResumed()) {
 		failingCaps.clear();
 		fallbacks.clear();
 		requestedDiscoInfos.clear();
@@ -66,6 +68,7 @@ void CapsManager::handleDiscoInfoReceived(const JID& from, const std::string& ha
 	}
 	fallbacks.erase(hash);
 	capsStorage->setDiscoInfo(hash, discoInfo);
+	cache.put(hash, discoInfo);
 	onCapsAvailable(hash);
 }
 
@@ -77,7 +80,21 @@ void CapsManager::requestDiscoInfo(const JID& jid, const std::string& node, cons
 }
 
 DiscoInfo::ref CapsManager::getCaps(const std::string& hash) const {
-	return capsStorage->getDiscoInfo(hash);
+	if (const DiscoInfo::ref* discoInfo = cache.get(hash)) {
+		++cacheStatistics.hits;
+		return *discoInfo;
+	}
+	// Caps that are still being requested cannot be in the storage yet
+	if (requestedDiscoInfos.find(hash) != requestedDiscoInfos.end()) {
+		++cacheStatistics.hits;
+		return DiscoInfo::ref();
+	}
+	++cacheStatistics.misses;
+	DiscoInfo::ref discoInfo = capsStorage->getDiscoInfo(hash);
+	if (discoInfo) {
+		cache.put(hash, discoInfo);
+	}
+	return discoInfo;
 }
 
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -10,6 +10,7 @@
 #include <map>
 
 #include <Swiften/Base/API.h>
+#include <Swiften/Base/LRUCache.h>
 #include <Swiften/Base/boost_bsignals.h>
 #include <Swiften/Elements/Presence.h>
 #include <Swiften/Elements/DiscoInfo.h>
@@ -28,8 +29,29 @@ namespace Swift {
 		public:
 			CapsManager(CapsStorage*, StanzaChannel*, IQRouter*, CryptoProvider*);
 
+			/**
+			 * Returns the disco info for the given caps hash, or NULL if it is
+			 * not known (yet).
+			 *
+			 * Recently used caps are kept in memory, so repeated lookups do not
+			 * go to the storage. Neither do lookups of hashes for which a disco
+			 * request is still pending.
+			 */
 			DiscoInfo::ref getCaps(const std::string&) const;
 
+			struct CacheStatistics {
+				CacheStatistics() : hits(0), misses(0) {}
+
+				/** Lookups answered from memory. */
+				size_t hits;
+				/** Lookups that went to the storage. */
+				size_t misses;
+			};
+
+			const CacheStatistics& getCacheStatistics() const {
+				return cacheStatistics;
+			}
+
 			// Mainly for testing purposes
 			void setWarnOnInvalidHash(bool b) {
 				warnOnInvalidHash = b;
@@ -43,11 +65,14 @@ namespace Swift {
 
 		private:
 			IQRouter* iqRouter;
+			StanzaChannel* stanzaChannel;
 			CryptoProvider* crypto;
 			CapsStorage* capsStorage;
 			bool warnOnInvalidHash;
 			std::set<std::string> requestedDiscoInfos;
 			std::set< std::pair<JID, std::string> > failingCaps;
 			std::map<std::string, std::set< std::pair<JID, std::string> > > fallbacks;
+			mutable LRUCache<std::string, DiscoInfo::ref> cache;
+			mutable CacheStatistics cacheStatistics;
 	};
 }
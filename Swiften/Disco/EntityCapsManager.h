@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -41,6 +41,7 @@ namespace Swift {
 
 		private:
 			CapsProvider* capsProvider;
+			StanzaChannel* stanzaChannel;
 			std::map<JID, std::string> caps;
 	};
 }
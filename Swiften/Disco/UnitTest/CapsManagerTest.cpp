@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,6 +21,20 @@
 
 using namespace Swift;
 
+namespace {
+	class CountingCapsStorage : public CapsMemoryStorage {
+		public:
+			CountingCapsStorage() : lookups(0) {}
+
+			virtual DiscoInfo::ref getDiscoInfo(const std::string& hash) const {
+				++lookups;
+				return CapsMemoryStorage::getDiscoInfo(hash);
+			}
+
+			mutable int lookups;
+	};
+}
+
 class CapsManagerTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST_SUITE(CapsManagerTest);
 		CPPUNIT_TEST(testReceiveNewHashRequestsDisco);
@@ -39,6 +53,11 @@ class CapsManagerTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testReceiveSameHashFromFailingUserAfterReconnectRequestsDisco);
 		CPPUNIT_TEST(testReconnectResetsFallback);
 		CPPUNIT_TEST(testReconnectResetsRequests);
+		CPPUNIT_TEST(testResumeKeepsRequests);
+		CPPUNIT_TEST(testGetCaps_CachesStoredCaps);
+		CPPUNIT_TEST(testGetCaps_CachesReceivedCaps);
+		CPPUNIT_TEST(testGetCaps_RequestedHashDoesNotQueryStorage);
+		CPPUNIT_TEST(testReceiveSameHashAfterSuccesfulDiscoDoesNotQueryStorage);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -46,7 +65,7 @@ class CapsManagerTest : public CppUnit::TestFixture {
 			crypto = boost::shared_ptr<CryptoProvider>(PlatformCryptoProvider::create());
 			stanzaChannel = new DummyStanzaChannel();
 			iqRouter = new IQRouter(stanzaChannel);
-			storage = new CapsMemoryStorage();
+			storage = new CountingCapsStorage();
 			user1 = JID("user1@bar.com/bla");
 			discoInfo1 = boost::make_shared<DiscoInfo>();
 			discoInfo1->addFeature("http://swift.im/feature1");
@@ -247,6 +266,65 @@ class CapsManagerTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT(stanzaChannel->isRequestAtIndex<DiscoInfo>(0, user1, IQ::Get));
 		}
 
+		void testResumeKeepsRequests() {
+			boost::shared_ptr<CapsManager> testling = createManager();
+			sendPresenceWithCaps(user1, capsInfo1);
+			stanzaChannel->sentStanzas.clear();
+			stanzaChannel->setAvailable(false);
+			stanzaChannel->setAvailable(true, true);
+			sendPresenceWithCaps(user1, capsInfo1);
+
+			CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(stanzaChannel->sentStanzas.size()));
+		}
+
+		void testGetCaps_CachesStoredCaps() {
+			storage->setDiscoInfo(capsInfo1->getVersion(), discoInfo1);
+			boost::shared_ptr<CapsManager> testling = createManager();
+
+			CPPUNIT_ASSERT(testling->getCaps(capsInfo1->getVersion()));
+			CPPUNIT_ASSERT(testling->getCaps(capsInfo1->getVersion()));
+
+			CPPUNIT_ASSERT_EQUAL(1, storage->lookups);
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), testling->getCacheStatistics().hits);
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), testling->getCacheStatistics().misses);
+		}
+
+		void testGetCaps_CachesReceivedCaps() {
+			boost::shared_ptr<CapsManager> testling = createManager();
+			sendPresenceWithCaps(user1, capsInfo1);
+			sendDiscoInfoResult(discoInfo1);
+			storage->lookups = 0;
+
+			DiscoInfo::ref discoInfo = testling->getCaps(capsInfo1->getVersion());
+
+			CPPUNIT_ASSERT(discoInfo);
+			CPPUNIT_ASSERT(discoInfo->hasFeature("http://swift.im/feature1"));
+			CPPUNIT_ASSERT_EQUAL(0, storage->lookups);
+		}
+
+		void testGetCaps_RequestedHashDoesNotQueryStorage() {
+			boost::shared_ptr<CapsManager> testling = createManager();
+			sendPresenceWithCaps(user1, capsInfo1);
+			storage->lookups = 0;
+
+			CPPUNIT_ASSERT(!testling->getCaps(capsInfo1->getVersion()));
+			sendPresenceWithCaps(user2, capsInfo1);
+
+			CPPUNIT_ASSERT_EQUAL(0, storage->lookups);
+		}
+
+		void testReceiveSameHashAfterSuccesfulDiscoDoesNotQueryStorage() {
+			boost::shared_ptr<CapsManager> testling = createManager();
+			sendPresenceWithCaps(user1, capsInfo1);
+			sendDiscoInfoResult(discoInfo1);
+			storage->lookups = 0;
+
+			sendPresenceWithCaps(user1, capsInfo1);
+			sendPresenceWithCaps(user2, capsInfo1);
+
+			CPPUNIT_ASSERT_EQUAL(0, storage->lookups);
+		}
+
 	private:
 		boost::shared_ptr<CapsManager> createManager() {
 			boost::shared_ptr<CapsManager> manager(new CapsManager(storage, stanzaChannel, iqRouter, crypto.get()));
@@ -273,7 +351,7 @@ class CapsManagerTest : public CppUnit::TestFixture {
 	private:
 		DummyStanzaChannel* stanzaChannel;
 		IQRouter* iqRouter;
-		CapsStorage* storage;
+		CountingCapsStorage* storage;
 		std::vector<JID> changes;
 		JID user1;
 		boost::shared_ptr<DiscoInfo> discoInfo1;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -27,6 +27,7 @@ class EntityCapsManagerTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testReceiveUnknownHashAfterKnownHashTriggersChangeAndClearsCaps);
 		CPPUNIT_TEST(testReceiveUnavailablePresenceAfterKnownHashTriggersChangeAndClearsCaps);
 		CPPUNIT_TEST(testReconnectTriggersChangeAndClearsCaps);
+		CPPUNIT_TEST(testResumeKeepsCaps);
 		CPPUNIT_TEST(testHashAvailable);
 		CPPUNIT_TEST_SUITE_END();
 
@@ -136,6 +137,18 @@ class EntityCapsManagerTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT(!testling->getCaps(user2));
 		}
 
+		void testResumeKeepsCaps() {
+			boost::shared_ptr<EntityCapsManager> testling = createManager();
+			capsProvider->caps[capsInfo1->getVersion()] = discoInfo1;
+			sendPresenceWithCaps(user1, capsInfo1);
+			changes.clear();
+			stanzaChannel->setAvailable(false);
+			stanzaChannel->setAvailable(true, true);
+
+			CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(changes.size()));
+			CPPUNIT_ASSERT_EQUAL(discoInfo1, testling->getCaps(user1));
+		}
+
 	private:
 		boost::shared_ptr<EntityCapsManager> createManager() {
 			boost::shared_ptr<EntityCapsManager> manager(new EntityCapsManager(capsProvider, stanzaChannel));
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,6 +12,17 @@
 namespace Swift {
 	class EnableStreamManagement : public ToplevelElement {
 		public:
-			EnableStreamManagement() {}
+			EnableStreamManagement() : resumeSupported(false) {}
+
+			void setResumeSupported() {
+				resumeSupported = true;
+			}
+
+			bool getResumeSupported() const {
+				return resumeSupported;
+			}
+
+		private:
+			bool resumeSupported;
 	};
 }
@@ -23,22 +23,19 @@ namespace Swift {
 			void processEvents() {
 				while (hasEvents()) {
 					/* 
-					  Creating a copy of the to-be-handled Event object because handling
-					  it can result in a DummyEventLoop::post() call.
-					  This call would also try to lock the eventsMutex_, resulting in a 
-					  deadlock. 
+					  Taking the to-be-handled Event object out of the queue before
+					  handling it, because handling it can result in a
+					  DummyEventLoop::post() call (which would try to lock the
+					  eventsMutex_, resulting in a deadlock), or in a recursive
+					  processEvents() call.
 					*/
 
 					eventsMutex_.lock();
 					Event eventCopy = events_[0];
+					events_.pop_front();
 					eventsMutex_.unlock();
 
 					handleEvent(eventCopy);
-
-					{
-						boost::lock_guard<boost::mutex> lock(eventsMutex_);
-						events_.pop_front();
-					}
 				}
 			}
 
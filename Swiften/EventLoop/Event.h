@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -14,7 +14,7 @@
 namespace Swift {
 	class Event {
 		public:
-			Event(boost::shared_ptr<EventOwner> owner, const boost::function<void()>& callback) : id(~0U), owner(owner), callback(callback) {
+			Event(boost::shared_ptr<EventOwner> owner, const boost::function<void()>& callback) : id(~0U), generation(0), owner(owner), callback(callback) {
 			}
 
 			bool operator==(const Event& o) const {
@@ -22,6 +22,8 @@ namespace Swift {
 			}
 
 			unsigned int id;
+			// The generation of the owner when the event was posted
+			unsigned int generation;
 			boost::shared_ptr<EventOwner> owner;
 			boost::function<void()> callback;
 	};
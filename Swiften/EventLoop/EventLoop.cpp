@@ -1,22 +1,17 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/EventLoop/EventLoop.h>
 
-#include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <boost/bind.hpp>
-#include <boost/lambda/lambda.hpp>
-#include <boost/lambda/bind.hpp>
-#include <boost/thread/locks.hpp>
 
 #include <Swiften/Base/Log.h>
-
-namespace lambda = boost::lambda;
+#include <Swiften/EventLoop/EventOwner.h>
 
 namespace Swift {
 
@@ -49,16 +44,7 @@ void EventLoop::handleEvent(const Event& event) {
 		return;
 	}
 
-	bool doCallback = false;
-	{
-		boost::lock_guard<boost::mutex> lock(eventsMutex_);
-		std::list<Event>::iterator i = std::find(events_.begin(), events_.end(), event);
-		if (i != events_.end()) {
-			doCallback = true;
-			events_.erase(i);
-		}
-	}
-	if (doCallback) {
+	if (!isRemoved(event)) {
 		handlingEvents_ = true;
 		invokeCallback(event);
 
@@ -67,27 +53,34 @@ void EventLoop::handleEvent(const Event& event) {
 		while (!eventsToHandle_.empty()) {
 			Event nextEvent = eventsToHandle_.front();
 			eventsToHandle_.pop_front();
-			invokeCallback(nextEvent);
+			if (!isRemoved(nextEvent)) {
+				invokeCallback(nextEvent);
+			}
 		}
 		handlingEvents_ = false;
 	}
 }
 
+/**
+ * Returns whether the events of the owner of the event were removed after
+ * the event was posted.
+ */
+bool EventLoop::isRemoved(const Event& event) {
+	return event.owner && event.owner->generation_.load(boost::memory_order_acquire) != event.generation;
+}
+
 void EventLoop::postEvent(boost::function<void ()> callback, boost::shared_ptr<EventOwner> owner) {
 	Event event(owner, callback);
-	{
-		boost::lock_guard<boost::mutex> lock(eventsMutex_);
-		event.id = nextEventID_;
-		nextEventID_++;
-		events_.push_back(event);
+	event.id = nextEventID_.fetch_add(1, boost::memory_order_relaxed);
+	if (owner) {
+		event.generation = owner->generation_.load(boost::memory_order_acquire);
 	}
 	//SWIFT_LOG(debug) << "Posting event " << event.id << std::endl;
 	post(event);
 }
 
 void EventLoop::removeEventsFromOwner(boost::shared_ptr<EventOwner> owner) {
-		boost::lock_guard<boost::mutex> lock(eventsMutex_);
-		events_.remove_if(lambda::bind(&Event::owner, lambda::_1) == owner);
+	owner->generation_.fetch_add(1, boost::memory_order_acq_rel);
 }
 
 }
@@ -1,14 +1,13 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <boost/atomic.hpp>
 #include <boost/function.hpp>
-#include <boost/thread.hpp>
-#include <list>
 #include <deque>
 
 #include <Swiften/Base/API.h>
@@ -17,12 +16,25 @@
 namespace Swift {
 	class EventOwner;
 
+	/**
+	 * Dispatches events on the thread of the event loop.
+	 *
+	 * Events can be posted from any thread. Posting and removing events does
+	 * not take any locks; the queue of pending events is managed by the
+	 * concrete event loop.
+	 */
 	class SWIFTEN_API EventLoop {
 		public:
 			EventLoop();
 			virtual ~EventLoop();
 
 			void postEvent(boost::function<void ()> event, boost::shared_ptr<EventOwner> owner = boost::shared_ptr<EventOwner>());
+
+			/**
+			 * Drops all pending events of the owner. Events posted afterwards are
+			 * dispatched as usual. This applies to the pending events of the owner
+			 * in every event loop.
+			 */
 			void removeEventsFromOwner(boost::shared_ptr<EventOwner> owner);
 
 		protected:
@@ -35,9 +47,10 @@ namespace Swift {
 			void handleEvent(const Event& event);
 
 		private:
-			boost::mutex eventsMutex_;
-			unsigned int nextEventID_;
-			std::list<Event> events_;
+			static bool isRemoved(const Event& event);
+
+		private:
+			boost::atomic<unsigned int> nextEventID_;
 			bool handlingEvents_;
 			std::deque<Event> eventsToHandle_;
 	};
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,6 +8,9 @@
 
 namespace Swift {
 
+EventOwner::EventOwner() : generation_(0) {
+}
+
 EventOwner::~EventOwner() {
 }
 
@@ -1,16 +1,28 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <boost/atomic.hpp>
+
 #include <Swiften/Base/API.h>
 
 namespace Swift {
+	class EventLoop;
+
 	class SWIFTEN_API EventOwner {
 		public:
+			EventOwner();
 			virtual ~EventOwner();
+
+		private:
+			friend class EventLoop;
+
+			// Incremented when the events of the owner are removed. Events that
+			// were posted under an older generation are dropped.
+			boost::atomic<unsigned int> generation_;
 	};
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -14,28 +14,19 @@
 
 namespace Swift {
 
-SimpleEventLoop::SimpleEventLoop() : isRunning_(true) {
+SimpleEventLoop::SimpleEventLoop() : isRunning_(true), waiting_(false) {
 }
 
 SimpleEventLoop::~SimpleEventLoop() {
-	if (!events_.empty()) {
+	if (!events_.isEmpty()) {
 		std::cerr << "Warning: Pending events in SimpleEventLoop at destruction time" << std::endl;
 	}
 }
 
 void SimpleEventLoop::doRun(bool breakAfterEvents) {
 	while (isRunning_) {
-		std::vector<Event> events;
-		{
-			boost::unique_lock<boost::mutex> lock(eventsMutex_);
-			while (events_.empty()) {
-				eventsAvailable_.wait(lock);
-			}
-			events.swap(events_);
-		}
-		foreach(const Event& event, events) {
-			handleEvent(event);
-		}
+		waitForEvents();
+		handleEvents();
 		if (breakAfterEvents) {
 			return;
 		}
@@ -43,13 +34,33 @@ void SimpleEventLoop::doRun(bool breakAfterEvents) {
 }
 
 void SimpleEventLoop::runOnce() {
+	handleEvents();
+}
+
+void SimpleEventLoop::waitForEvents() {
+	if (!events_.isEmpty()) {
+		return;
+	}
+	boost::unique_lock<boost::mutex> lock(waitMutex_);
+	// Either post() sees that the loop is waiting, or the loop sees the
+	// event of post() (both use sequentially consistent operations).
+	waiting_.store(true);
+	while (events_.isEmpty()) {
+		eventsAvailable_.wait(lock);
+	}
+	waiting_.store(false);
+}
+
+void SimpleEventLoop::handleEvents() {
+	// Only handle the events that are already queued, so that events posted
+	// by the handlers are left for the next round.
 	std::vector<Event> events;
-	{
-		boost::unique_lock<boost::mutex> lock(eventsMutex_);
-		events.swap(events_);
+	Event event((boost::shared_ptr<EventOwner>()), boost::function<void()>());
+	while (events_.pop(event)) {
+		events.push_back(event);
 	}
-	foreach(const Event& event, events) {
-		handleEvent(event);
+	foreach(const Event& queuedEvent, events) {
+		handleEvent(queuedEvent);
 	}
 }
 
@@ -62,11 +73,11 @@ void SimpleEventLoop::doStop() {
 }
 
 void SimpleEventLoop::post(const Event& event) {
-	{
-		boost::lock_guard<boost::mutex> lock(eventsMutex_);
-		events_.push_back(event);
+	events_.push(event);
+	if (waiting_.load()) {
+		boost::lock_guard<boost::mutex> lock(waitMutex_);
+		eventsAvailable_.notify_one();
 	}
-	eventsAvailable_.notify_one();
 }
 
 
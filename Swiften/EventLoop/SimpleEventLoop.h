@@ -7,11 +7,13 @@
 #pragma once
 
 #include <vector>
+#include <boost/atomic.hpp>
 #include <boost/function.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/condition_variable.hpp>
 
 #include <Swiften/Base/API.h>
+#include <Swiften/Base/LockFreeQueue.h>
 #include <Swiften/EventLoop/EventLoop.h>
 
 namespace Swift {
@@ -37,11 +39,15 @@ namespace Swift {
 		private:
 			void doRun(bool breakAfterEvents);
 			void doStop();
+			void waitForEvents();
+			void handleEvents();
 
 		private:
 			bool isRunning_;
-			std::vector<Event> events_;
-			boost::mutex eventsMutex_;
+			LockFreeQueue<Event> events_;
+			// Producers only take the mutex to wake up the loop while it waits
+			boost::atomic<bool> waiting_;
+			boost::mutex waitMutex_;
 			boost::condition_variable eventsAvailable_;
 	};
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -20,7 +20,10 @@ class EventLoopTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST_SUITE(EventLoopTest);
 		CPPUNIT_TEST(testPost);
 		CPPUNIT_TEST(testRemove);
+		CPPUNIT_TEST(testRemove_FromEvent);
+		CPPUNIT_TEST(testRemove_PostAfterRemove);
 		CPPUNIT_TEST(testHandleEvent_Recursive);
+		CPPUNIT_TEST(testPost_MultipleThreads);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -59,6 +62,33 @@ class EventLoopTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT_EQUAL(3, events_[1]);
 		}
 
+		void testRemove_FromEvent() {
+			DummyEventLoop testling;
+			boost::shared_ptr<MyEventOwner> eventOwner1(new MyEventOwner());
+			boost::shared_ptr<MyEventOwner> eventOwner2(new MyEventOwner());
+
+			testling.postEvent(boost::bind(&EventLoop::removeEventsFromOwner, &testling, eventOwner2), eventOwner1);
+			testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, 1), eventOwner2);
+			testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, 2), eventOwner1);
+			testling.processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(events_.size()));
+			CPPUNIT_ASSERT_EQUAL(2, events_[0]);
+		}
+
+		void testRemove_PostAfterRemove() {
+			DummyEventLoop testling;
+			boost::shared_ptr<MyEventOwner> eventOwner(new MyEventOwner());
+
+			testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, 1), eventOwner);
+			testling.removeEventsFromOwner(eventOwner);
+			testling.postEvent(boost::bind(&EventLoopTest::logEvent, this, 2), eventOwner);
+			testling.processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(events_.size()));
+			CPPUNIT_ASSERT_EQUAL(2, events_[0]);
+		}
+
 		void testHandleEvent_Recursive() {
 			DummyEventLoop testling;
 			boost::shared_ptr<MyEventOwner> eventOwner(new MyEventOwner());
@@ -72,8 +102,36 @@ class EventLoopTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT_EQUAL(1, events_[1]);
 		}
 	
+		void testPost_MultipleThreads() {
+			SimpleEventLoop testling;
+			boost::shared_ptr<MyEventOwner> eventOwner(new MyEventOwner());
+			counter_ = 0;
+
+			boost::thread eventLoopThread(boost::bind(&SimpleEventLoop::run, &testling));
+			std::vector<boost::thread*> threads;
+			for (int i = 0; i < 4; ++i) {
+				threads.push_back(new boost::thread(boost::bind(&EventLoopTest::postEvents, this, &testling, eventOwner, 10000)));
+			}
+			for (size_t i = 0; i < threads.size(); ++i) {
+				threads[i]->join();
+				delete threads[i];
+			}
+			testling.stop();
+			eventLoopThread.join();
+
+			CPPUNIT_ASSERT_EQUAL(40000, counter_);
+		}
+	
 	private:
 		struct MyEventOwner : public EventOwner {};
+		void postEvents(EventLoop* loop, boost::shared_ptr<MyEventOwner> eventOwner, int count) {
+			for (int i = 0; i < count; ++i) {
+				loop->postEvent(boost::bind(&EventLoopTest::incrementCounter, this), i % 2 ? eventOwner : boost::shared_ptr<MyEventOwner>());
+			}
+		}
+		void incrementCounter() {
+			counter_++;
+		}
 		void logEvent(int i) {
 			events_.push_back(i);
 		}
@@ -85,6 +143,7 @@ class EventLoopTest : public CppUnit::TestFixture {
 
 	private:
 		std::vector<int> events_;
+		int counter_;
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(EventLoopTest);
@@ -1,16 +1,17 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <boost/bind.hpp>
 #include <boost/thread.hpp>
+#include <boost/lexical_cast.hpp>
 #include <iostream>
 
 #include <Swiften/Client/Client.h>
 #include <Swiften/Network/TimerFactory.h>
-#include <Swiften/Network/BoostNetworkFactories.h>
+#include <Swiften/Network/BoostIOServicePool.h>
 #include <Swiften/EventLoop/EventLoop.h>
 #include <Swiften/EventLoop/SimpleEventLoop.h>
 #include <Swiften/Roster/GetRosterRequest.h>
@@ -21,7 +22,6 @@
 using namespace Swift;
 
 static SimpleEventLoop eventLoop;
-static BoostNetworkFactories networkFactories(&eventLoop);
 static int numberOfConnectedClients = 0;
 static int numberOfInstances = 100;
 
@@ -31,6 +31,23 @@ static void handleConnected() {
 	std::cout << "Connected " << numberOfConnectedClients << std::endl;
 }
 
+// Called on the event loop of the client's shard. Every shard has its own
+// list of clients, which is only accessed from the shard's thread.
+static void createClient(const JID& jid, const SafeByteArray& password, NetworkFactories* networkFactories, CertificateTrustChecker* trustChecker, std::vector<CoreClient*>* shardClients) {
+	CoreClient* client = new Swift::CoreClient(jid, password, networkFactories);
+	client->setCertificateTrustChecker(trustChecker);
+	client->onConnected.connect(boost::bind(&EventLoop::postEvent, &eventLoop, &handleConnected, boost::shared_ptr<EventOwner>()));
+	client->connect();
+	shardClients->push_back(client);
+}
+
+static void deleteClients(std::vector<CoreClient*>* shardClients) {
+	for (size_t i = 0; i < shardClients->size(); ++i) {
+		delete (*shardClients)[i];
+	}
+	shardClients->clear();
+}
+
 int main(int, char**) {
 	char* jid = getenv("SWIFT_BENCHTOOL_JID");
 	if (!jid) {
@@ -42,24 +59,25 @@ int main(int, char**) {
 		std::cerr << "Please set the SWIFT_BENCHTOOL_PASS environment variable" << std::endl;
 		return -1;
 	}
+	size_t numberOfThreads = 1;
+	if (char* threads = getenv("SWIFT_BENCHTOOL_THREADS")) {
+		numberOfThreads = boost::lexical_cast<size_t>(threads);
+	}
 
 	BlindCertificateTrustChecker trustChecker;
-	std::vector<CoreClient*> clients;
+	// Declared before the pool, so it outlives the shards deleting the clients
+	std::vector<std::vector<CoreClient*> > clients;
+	BoostIOServicePool pool(numberOfThreads);
+	clients.resize(pool.getShardCount());
 	for (int i = 0; i < numberOfInstances; ++i) {
-		CoreClient* client = new Swift::CoreClient(JID(jid), createSafeByteArray(std::string(pass)), &networkFactories);
-		client->setCertificateTrustChecker(&trustChecker);
-		client->onConnected.connect(&handleConnected);
-		clients.push_back(client);
-	}
-	
-	for (size_t i = 0; i < clients.size(); ++i) {
-		clients[i]->connect();
+		size_t shard = pool.getNextShard();
+		pool.post(shard, boost::bind(&createClient, JID(jid), createSafeByteArray(std::string(pass)), pool.getNetworkFactories(shard), &trustChecker, &clients[shard]));
 	}
 
 	eventLoop.run();
 
-	for (size_t i = 0; i < clients.size(); ++i) {
-		delete clients[i];
+	for (size_t shard = 0; shard < clients.size(); ++shard) {
+		pool.post(shard, boost::bind(&deleteClients, &clients[shard]));
 	}
 
 	return 0;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -27,6 +27,14 @@ boost::shared_ptr<ByteArray> ByteArrayReadBytestream::read(size_t size) {
 	return result;
 }
 
+bool ByteArrayReadBytestream::seek(boost::uintmax_t offset) {
+	if (offset > data.size()) {
+		return false;
+	}
+	position = boost::numeric_cast<size_t>(offset);
+	return true;
+}
+
 void ByteArrayReadBytestream::addData(const std::vector<unsigned char>& moreData) {
 	append(data, moreData);
 	onDataAvailable();
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -27,6 +27,12 @@ namespace Swift {
 				dataComplete = b;
 			}
 
+			virtual bool isSeekable() const {
+				return true;
+			}
+
+			virtual bool seek(boost::uintmax_t offset);
+
 			void addData(const std::vector<unsigned char>& moreData);
 
 		private:
@@ -1,11 +1,16 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <cassert>
+
+#include <boost/smart_ptr/make_shared.hpp>
+
+#include <Swiften/FileTransfer/ByteArrayReadBytestream.h>
 #include <Swiften/FileTransfer/WriteBytestream.h>
 
 namespace Swift {
@@ -14,11 +19,27 @@ namespace Swift {
 			ByteArrayWriteBytestream() {
 			}
 
+			ByteArrayWriteBytestream(const std::vector<unsigned char>& data) : data(data) {
+			}
+
 			virtual void write(const std::vector<unsigned char>& bytes) {
 				data.insert(data.end(), bytes.begin(), bytes.end());
 				onWrite(bytes);
 			}
 
+			virtual boost::uintmax_t getExistingSize() const {
+				return data.size();
+			}
+
+			virtual void setWriteOffset(boost::uintmax_t offset) {
+				assert(offset <= data.size());
+				data.resize(static_cast<size_t>(offset));
+			}
+
+			virtual boost::shared_ptr<ReadBytestream> createExistingDataReadBytestream() const {
+				return boost::make_shared<ByteArrayReadBytestream>(data);
+			}
+
 			const std::vector<unsigned char>& getData() const {
 				return data;
 			}
@@ -7,6 +7,7 @@
 #include <Swiften/FileTransfer/DefaultFileTransferTransporter.h>
 
 #include <boost/bind.hpp>
+#include <boost/numeric/conversion/cast.hpp>
 #include <boost/smart_ptr/make_shared.hpp>
 
 #include <Swiften/Base/Log.h>
@@ -52,7 +53,9 @@ DefaultFileTransferTransporter::DefaultFileTransferTransporter(
 			s5bServerManager(s5bServerManager),
 			s5bProxy(s5bProxy),
 			crypto(crypto),
-			router(router) {
+			router(router),
+			ibbMaxBlockSize(options.getMaxInBandBlockSize()),
+			ibbWindowSize(options.getInBandWindowSize()) {
 
 	localCandidateGenerator = new LocalJingleTransportCandidateGenerator(
 			s5bServerManager,
@@ -152,6 +155,7 @@ boost::shared_ptr<TransportSession> DefaultFileTransferTransporter::createIBBSen
 	boost::shared_ptr<IBBSendSession> ibbSession = boost::make_shared<IBBSendSession>(
 			sessionID, initiator, responder, stream, router);
 	ibbSession->setBlockSize(blockSize);
+	ibbSession->setWindowSize(ibbWindowSize);
 	return boost::make_shared<IBBSendTransportSession>(ibbSession);
 }
 
@@ -163,6 +167,7 @@ boost::shared_ptr<TransportSession> DefaultFileTransferTransporter::createIBBRec
 	closeRemoteSession();
 	boost::shared_ptr<IBBReceiveSession> ibbSession = boost::make_shared<IBBReceiveSession>(
 			sessionID, initiator, responder, size, stream, router);
+	ibbSession->setMaxBlockSize(boost::numeric_cast<int>(ibbMaxBlockSize));
 	return boost::make_shared<IBBReceiveTransportSession>(ibbSession);
 }
 
@@ -103,6 +103,8 @@ namespace Swift {
 			SOCKS5BytestreamProxiesManager* s5bProxy;
 			CryptoProvider* crypto;
 			IQRouter* router;
+			unsigned int ibbMaxBlockSize;
+			unsigned int ibbWindowSize;
 			LocalJingleTransportCandidateGenerator* localCandidateGenerator;
 			RemoteJingleTransportCandidateSelector* remoteCandidateSelector;
 			std::string s5bSessionID;
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/FileTransfer/FileHashCache.h>
+
+#include <Swiften/Base/Path.h>
+
+namespace Swift {
+
+FileHashCache::FileHashCache(size_t capacity) : entries(capacity) {
+}
+
+boost::optional<JingleFileTransferFileInfo::HashElementMap> FileHashCache::getHashes(const boost::filesystem::path& file, boost::uintmax_t size, std::time_t lastModified) {
+	const Entry* entry = entries.get(pathToString(file));
+	if (!entry || entry->size != size || entry->lastModified != lastModified) {
+		return boost::optional<JingleFileTransferFileInfo::HashElementMap>();
+	}
+	return entry->hashes;
+}
+
+void FileHashCache::setHashes(const boost::filesystem::path& file, boost::uintmax_t size, std::time_t lastModified, const JingleFileTransferFileInfo::HashElementMap& hashes) {
+	Entry entry;
+	entry.size = size;
+	entry.lastModified = lastModified;
+	entry.hashes = hashes;
+	entries.put(pathToString(file), entry);
+}
+
+}
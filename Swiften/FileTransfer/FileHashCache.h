@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include <Swiften/Base/API.h>
+#include <Swiften/Base/LRUCache.h>
+#include <Swiften/Elements/JingleFileTransferFileInfo.h>
+
+namespace Swift {
+	/**
+	 * Remembers the hashes of recently sent files, so sending the same file
+	 * again doesn't require hashing it again.
+	 *
+	 * Entries are keyed by the path of the file, and are only valid as long
+	 * as the size and modification time of the file stay the same.
+	 */
+	class SWIFTEN_API FileHashCache {
+		public:
+			FileHashCache(size_t capacity = 100);
+
+			boost::optional<JingleFileTransferFileInfo::HashElementMap> getHashes(const boost::filesystem::path& file, boost::uintmax_t size, std::time_t lastModified);
+			void setHashes(const boost::filesystem::path& file, boost::uintmax_t size, std::time_t lastModified, const JingleFileTransferFileInfo::HashElementMap& hashes);
+
+		private:
+			struct Entry {
+				boost::uintmax_t size;
+				std::time_t lastModified;
+				JingleFileTransferFileInfo::HashElementMap hashes;
+			};
+
+			LRUCache<std::string, Entry> entries;
+	};
+}
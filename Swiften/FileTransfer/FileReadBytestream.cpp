@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <cassert>
 #include <boost/smart_ptr/make_shared.hpp>
 #include <boost/numeric/conversion/cast.hpp>
@@ -24,10 +25,18 @@ FileReadBytestream::~FileReadBytestream() {
 	}
 }
 
-boost::shared_ptr<ByteArray> FileReadBytestream::read(size_t size)  {
+void FileReadBytestream::openStream() {
 	if (!stream) {
-		stream = new boost::filesystem::ifstream(file, std::ios_base::in|std::ios_base::binary);
+		stream = new boost::filesystem::ifstream();
+		// Data is read in large chunks, so read it straight into the result
+		// instead of going through the stream buffer.
+		stream->rdbuf()->pubsetbuf(NULL, 0);
+		stream->open(file, std::ios_base::in|std::ios_base::binary);
 	}
+}
+
+boost::shared_ptr<ByteArray> FileReadBytestream::read(size_t size)  {
+	openStream();
 	boost::shared_ptr<ByteArray> result = boost::make_shared<ByteArray>();
 	result->resize(size);
 	assert(stream->good());
@@ -41,4 +50,19 @@ bool FileReadBytestream::isFinished() const {
 	return stream && !stream->good();
 }
 
+bool FileReadBytestream::isSeekable() const {
+	return true;
+}
+
+bool FileReadBytestream::seek(boost::uintmax_t offset) {
+	boost::system::error_code error;
+	boost::uintmax_t size = boost::filesystem::file_size(file, error);
+	if (error || offset > size) {
+		return false;
+	}
+	openStream();
+	stream->seekg(boost::numeric_cast<std::streamoff>(offset));
+	return stream->good();
+}
+
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -20,6 +20,11 @@ namespace Swift {
 
 			virtual boost::shared_ptr< std::vector<unsigned char> > read(size_t size);
 			virtual bool isFinished() const;
+			virtual bool isSeekable() const;
+			virtual bool seek(boost::uintmax_t offset);
+
+		private:
+			void openStream();
 
 		private:
 			boost::filesystem::path file;
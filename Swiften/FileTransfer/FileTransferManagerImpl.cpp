@@ -12,9 +12,11 @@
 
 #include <Swiften/FileTransfer/FileTransferManagerImpl.h>
 
+#include <ctime>
 #include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
 
 #include <Swiften/Base/foreach.h>
 #include <Swiften/Base/Log.h>
@@ -23,7 +25,9 @@
 #include <Swiften/JID/JID.h>
 #include <Swiften/Elements/JingleFileTransferFileInfo.h>
 #include <Swiften/FileTransfer/SOCKS5BytestreamServerManager.h>
+#include <Swiften/FileTransfer/FileHashCache.h>
 #include <Swiften/FileTransfer/OutgoingFileTransferManager.h>
+#include <Swiften/FileTransfer/OutgoingJingleFileTransfer.h>
 #include <Swiften/FileTransfer/IncomingFileTransferManager.h>
 #include <Swiften/FileTransfer/DefaultFileTransferTransporterFactory.h>
 #include <Swiften/FileTransfer/SOCKS5BytestreamRegistry.h>
@@ -48,6 +52,7 @@ FileTransferManagerImpl::FileTransferManagerImpl(
 		ConnectionFactory* connectionFactory, 
 		ConnectionServerFactory* connectionServerFactory, 
 		TimerFactory* timerFactory, 
+		EventLoop* eventLoop,
 		DomainNameResolver* domainNameResolver,
 		NetworkEnvironment* networkEnvironment,
 		NATTraverser* natTraverser,
@@ -55,7 +60,8 @@ FileTransferManagerImpl::FileTransferManagerImpl(
 			ownJID(ownFullJID), 
 			iqRouter(router), 
 			capsProvider(capsProvider), 
-			presenceOracle(presOracle) {
+			presenceOracle(presOracle),
+			hashCache(boost::make_shared<FileHashCache>()) {
 	assert(!ownFullJID.isBare());
 
 	bytestreamRegistry = new SOCKS5BytestreamRegistry();
@@ -77,12 +83,14 @@ FileTransferManagerImpl::FileTransferManagerImpl(
 			iqRouter, 
 			transporterFactory,
 			timerFactory,
+			eventLoop,
 			crypto);
 	incomingFTManager = new IncomingFileTransferManager(
 			jingleSessionManager, 
 			iqRouter, 
 			transporterFactory,
 			timerFactory,
+			eventLoop,
 			crypto);
 	incomingFTManager->onIncomingFileTransfer.connect(onIncomingFileTransfer);
 }
@@ -138,8 +146,28 @@ OutgoingFileTransfer::ref FileTransferManagerImpl::createOutgoingFileTransfer(
 #endif
 
 	boost::uintmax_t sizeInBytes = boost::filesystem::file_size(filepath);
-	boost::posix_time::ptime lastModified = boost::posix_time::from_time_t(boost::filesystem::last_write_time(filepath));
-	return createOutgoingFileTransfer(to, filename, description, sizeInBytes, lastModified, bytestream, config);
+	std::time_t lastWriteTime = boost::filesystem::last_write_time(filepath);
+
+	JingleFileTransferFileInfo fileInfo;
+	fileInfo.setDate(boost::posix_time::from_time_t(lastWriteTime));
+	fileInfo.setSize(sizeInBytes);
+	fileInfo.setName(filename);
+	fileInfo.setDescription(description);
+
+	// Reuse the hashes of the file if it was sent before
+	if (boost::optional<JingleFileTransferFileInfo::HashElementMap> hashes = hashCache->getHashes(filepath, sizeInBytes, lastWriteTime)) {
+		foreach (const JingleFileTransferFileInfo::HashElementMap::value_type& hash, *hashes) {
+			fileInfo.addHash(HashElement(hash.first, hash.second));
+		}
+	}
+
+	OutgoingFileTransfer::ref transfer = createOutgoingFileTransfer(to, fileInfo, bytestream, config);
+	if (boost::shared_ptr<OutgoingJingleFileTransfer> jingleTransfer = boost::dynamic_pointer_cast<OutgoingJingleFileTransfer>(transfer)) {
+		// The cache is shared with the transfer, since it may outlive this manager
+		jingleTransfer->onHashesCalculated.connect(
+				boost::bind(&FileHashCache::setHashes, hashCache, filepath, sizeInBytes, lastWriteTime, _1));
+	}
+	return transfer;
 }
 
 OutgoingFileTransfer::ref FileTransferManagerImpl::createOutgoingFileTransfer(
@@ -155,7 +183,14 @@ OutgoingFileTransfer::ref FileTransferManagerImpl::createOutgoingFileTransfer(
 	fileInfo.setSize(sizeInBytes);
 	fileInfo.setName(filename);
 	fileInfo.setDescription(description);
-	
+	return createOutgoingFileTransfer(to, fileInfo, bytestream, config);
+}
+
+OutgoingFileTransfer::ref FileTransferManagerImpl::createOutgoingFileTransfer(
+		const JID& to,
+		const JingleFileTransferFileInfo& fileInfo,
+		boost::shared_ptr<ReadBytestream> bytestream,
+		const FileTransferOptions& config) {
 	JID receipient = to;
 	
 	if(receipient.isBare()) {
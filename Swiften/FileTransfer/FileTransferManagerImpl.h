@@ -36,9 +36,12 @@ namespace Swift {
 	class CryptoProvider;
 	class DomainNameResolver;
 	class EntityCapsProvider;
+	class EventLoop;
+	class FileHashCache;
 	class FileTransferTransporterFactory;
 	class IQRouter;
 	class IncomingFileTransferManager;
+	class JingleFileTransferFileInfo;
 	class JingleSessionManager;
 	class NATTraverser;
 	class NetworkEnvironment;
@@ -61,6 +64,7 @@ namespace Swift {
 					ConnectionFactory* connectionFactory,
 					ConnectionServerFactory* connectionServerFactory,
 					TimerFactory* timerFactory, 
+					EventLoop* eventLoop,
 					DomainNameResolver* domainNameResolver,
 					NetworkEnvironment* networkEnvironment,
 					NATTraverser* natTraverser,
@@ -87,6 +91,11 @@ namespace Swift {
 			
 		private:
 			boost::optional<JID> highestPriorityJIDSupportingFileTransfer(const JID& bareJID);
+			OutgoingFileTransfer::ref createOutgoingFileTransfer(
+					const JID& to,
+					const JingleFileTransferFileInfo& fileInfo,
+					boost::shared_ptr<ReadBytestream> bytestream,
+					const FileTransferOptions&);
 			
 		private:
 			JID ownJID;
@@ -101,5 +110,6 @@ namespace Swift {
 			SOCKS5BytestreamRegistry* bytestreamRegistry;
 			SOCKS5BytestreamProxiesManager* bytestreamProxy;
 			SOCKS5BytestreamServerManager* s5bServerManager;
+			boost::shared_ptr<FileHashCache> hashCache;
 	};
 }
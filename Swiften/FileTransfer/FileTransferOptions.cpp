@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013 Isode Limited.
+ * Copyright (c) 2013-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,5 +8,7 @@
 
 using namespace Swift;
 
+const unsigned int FileTransferOptions::MAX_IN_BAND_BLOCK_SIZE;
+
 FileTransferOptions::~FileTransferOptions() {
 }
@@ -6,13 +6,20 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include <Swiften/Base/Override.h>
 #include <Swiften/Base/API.h>
 
 namespace Swift {
 	class SWIFTEN_API FileTransferOptions {
 		public:
-			FileTransferOptions() : allowInBand_(true), allowAssisted_(true), allowProxied_(true), allowDirect_(true) {
+			/**
+			 * The largest block size XEP-0047 allows.
+			 */
+			static const unsigned int MAX_IN_BAND_BLOCK_SIZE = 65535;
+
+			FileTransferOptions() : allowInBand_(true), allowAssisted_(true), allowProxied_(true), allowDirect_(true), inBandBlockSize_(4096), maxInBandBlockSize_(MAX_IN_BAND_BLOCK_SIZE), inBandWindowSize_(1) {
 			}
 			SWIFTEN_DEFAULT_COPY_CONSTRUCTOR(FileTransferOptions)
 			~FileTransferOptions();
@@ -53,6 +60,46 @@ namespace Swift {
 				return allowDirect_;
 			}
 
+			/**
+			 * Sets the block size to offer for in-band transfers. Larger
+			 * values than MAX_IN_BAND_BLOCK_SIZE are capped.
+			 */
+			FileTransferOptions& withInBandBlockSize(unsigned int blockSize) {
+				inBandBlockSize_ = std::min(blockSize, MAX_IN_BAND_BLOCK_SIZE);
+				return *this;
+			}
+
+			unsigned int getInBandBlockSize() const {
+				return inBandBlockSize_;
+			}
+
+			/**
+			 * Sets the largest block size to accept for incoming in-band
+			 * transfers. Larger offers are answered with this block size.
+			 * Larger values than MAX_IN_BAND_BLOCK_SIZE are capped.
+			 */
+			FileTransferOptions& withMaxInBandBlockSize(unsigned int blockSize) {
+				maxInBandBlockSize_ = std::min(blockSize, MAX_IN_BAND_BLOCK_SIZE);
+				return *this;
+			}
+
+			unsigned int getMaxInBandBlockSize() const {
+				return maxInBandBlockSize_;
+			}
+
+			/**
+			 * Sets the number of in-band data blocks that can be sent before
+			 * the previous ones are acknowledged.
+			 */
+			FileTransferOptions& withInBandWindowSize(unsigned int windowSize) {
+				inBandWindowSize_ = windowSize;
+				return *this;
+			}
+
+			unsigned int getInBandWindowSize() const {
+				return inBandWindowSize_;
+			}
+
 
 
 			SWIFTEN_DEFAULT_COPY_ASSIGMNENT_OPERATOR(FileTransferOptions)
@@ -62,5 +109,8 @@ namespace Swift {
 			bool allowAssisted_;
 			bool allowProxied_;
 			bool allowDirect_;
+			unsigned int inBandBlockSize_;
+			unsigned int maxInBandBlockSize_;
+			unsigned int inBandWindowSize_;
 	};
 }
@@ -1,18 +1,28 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <cassert>
 #include <boost/numeric/conversion/cast.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
 
 #include <Swiften/FileTransfer/FileWriteBytestream.h>
+#include <Swiften/FileTransfer/FileReadBytestream.h>
 
 namespace Swift {
 
-FileWriteBytestream::FileWriteBytestream(const boost::filesystem::path& file) : file(file), stream(NULL) {
+FileWriteBytestream::FileWriteBytestream(const boost::filesystem::path& file, bool resume) : file(file), stream(NULL), existingSize(0), writeOffset(0) {
+	if (resume) {
+		boost::system::error_code error;
+		existingSize = boost::filesystem::file_size(file, error);
+		if (error) {
+			existingSize = 0;
+		}
+	}
 }
 
 FileWriteBytestream::~FileWriteBytestream() {
@@ -27,13 +37,39 @@ void FileWriteBytestream::write(const std::vector<unsigned char>& data) {
 		return;
 	}
 	if (!stream) {
-		stream = new boost::filesystem::ofstream(file, std::ios_base::out|std::ios_base::binary);
+		if (writeOffset > 0) {
+			if (writeOffset < existingSize) {
+				boost::filesystem::resize_file(file, writeOffset);
+			}
+			stream = new boost::filesystem::ofstream(file, std::ios_base::out|std::ios_base::binary|std::ios_base::app);
+		}
+		else {
+			stream = new boost::filesystem::ofstream(file, std::ios_base::out|std::ios_base::binary);
+		}
 	}
 	assert(stream->good());
 	stream->write(reinterpret_cast<const char*>(&data[0]), boost::numeric_cast<std::streamsize>(data.size()));
 	onWrite(data);
 }
 
+boost::uintmax_t FileWriteBytestream::getExistingSize() const {
+	return existingSize;
+}
+
+void FileWriteBytestream::setWriteOffset(boost::uintmax_t offset) {
+	assert(!stream);
+	assert(offset <= existingSize);
+	writeOffset = offset;
+}
+
+boost::shared_ptr<ReadBytestream> FileWriteBytestream::createExistingDataReadBytestream() const {
+	assert(!stream);
+	if (existingSize == 0) {
+		return boost::shared_ptr<ReadBytestream>();
+	}
+	return boost::make_shared<FileReadBytestream>(file);
+}
+
 void FileWriteBytestream::close() {
 	if (stream) {
 		stream->close();
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -15,14 +15,24 @@
 namespace Swift {
 	class SWIFTEN_API FileWriteBytestream : public WriteBytestream {
 		public:
-			FileWriteBytestream(const boost::filesystem::path& file);
+			/**
+			 * If resume is true, the existing contents of the file can be kept,
+			 * so an interrupted transfer can continue where it stopped.
+			 * Otherwise, the file is overwritten.
+			 */
+			FileWriteBytestream(const boost::filesystem::path& file, bool resume = false);
 			~FileWriteBytestream();
 
 			virtual void write(const std::vector<unsigned char>&);
+			virtual boost::uintmax_t getExistingSize() const;
+			virtual void setWriteOffset(boost::uintmax_t offset);
+			virtual boost::shared_ptr<ReadBytestream> createExistingDataReadBytestream() const;
 			void close();
 
 		private:
 			boost::filesystem::path file;
 			boost::filesystem::ofstream* stream;
+			boost::uintmax_t existingSize;
+			boost::uintmax_t writeOffset;
 	};
 }
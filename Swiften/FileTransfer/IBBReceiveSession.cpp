@@ -18,6 +18,8 @@
 
 namespace Swift {
 
+static const int MAX_SEQUENCE_NUMBER = 65535;
+
 class IBBReceiveSession::IBBResponder : public SetResponder<IBB> {
 	public:
 		IBBResponder(IBBReceiveSession* session, IQRouter* router) : SetResponder<IBB>(router), session(session), sequenceNumber(0), receivedSize(0) {
@@ -26,11 +28,14 @@ class IBBReceiveSession::IBBResponder : public SetResponder<IBB> {
 
 		virtual bool handleSetRequest(const JID& from, const JID&, const std::string& id, IBB::ref ibb) {
 			if (from == session->from && ibb->getStreamID() == session->id) {
+				// Writing the data can make the owner of the session delete it
+				boost::shared_ptr<IBBReceiveSession> protectedSession = session->shared_from_this();
 				if (ibb->getAction() == IBB::Data) {
+					// Blocks can be pipelined by the sender, but always arrive in order
 					if (sequenceNumber == ibb->getSequenceNumber()) {
 						session->bytestream->write(ibb->getData());
 						receivedSize += ibb->getData().size();
-						sequenceNumber++;
+						sequenceNumber = (sequenceNumber == MAX_SEQUENCE_NUMBER ? 0 : sequenceNumber + 1);
 						sendResponse(from, id, IBB::ref());
 						if (receivedSize >= session->size) {
 							if (receivedSize > session->size) {
@@ -47,7 +52,13 @@ class IBBReceiveSession::IBBResponder : public SetResponder<IBB> {
 				}
 				else if (ibb->getAction() == IBB::Open) {
 					SWIFT_LOG(debug) << "IBB open received";
-					sendResponse(from, id, IBB::ref());
+					if (ibb->getBlockSize() > session->maxBlockSize) {
+						SWIFT_LOG(debug) << "Refusing block size " << ibb->getBlockSize();
+						sendError(from, id, ErrorPayload::ResourceConstraint, ErrorPayload::Modify);
+					}
+					else {
+						sendResponse(from, id, IBB::ref());
+					}
 				}
 				else if (ibb->getAction() == IBB::Close) {
 					SWIFT_LOG(debug) << "IBB close received";
@@ -80,6 +91,7 @@ IBBReceiveSession::IBBReceiveSession(
 			size(size), 
 			bytestream(bytestream),
 			router(router), 
+			maxBlockSize(65535), 
 			active(false) {
 	assert(!id.empty());
 	assert(from.isValid());
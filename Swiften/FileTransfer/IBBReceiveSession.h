@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <boost/shared_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
 #include <boost/optional/optional_fwd.hpp>
 
 #include <Swiften/Base/API.h>
@@ -19,7 +20,13 @@
 namespace Swift {
 	class IQRouter;
 
-	class SWIFTEN_API IBBReceiveSession {
+	/**
+	 * Receives a file over an in-band bytestream.
+	 *
+	 * The session must be owned by a boost::shared_ptr, because it keeps
+	 * itself alive while it handles an incoming request.
+	 */
+	class SWIFTEN_API IBBReceiveSession : public boost::enable_shared_from_this<IBBReceiveSession> {
 		public:
 			IBBReceiveSession(
 					const std::string& id, 
@@ -33,6 +40,16 @@ namespace Swift {
 			void start();
 			void stop();
 
+			/**
+			 * Sets the largest block size the sender may use. Larger block
+			 * sizes are refused, so the sender can retry with a smaller one.
+			 *
+			 * Default: 65535
+			 */
+			void setMaxBlockSize(int maxBlockSize) {
+				this->maxBlockSize = maxBlockSize;
+			}
+
 			const JID& getSender() const {
 				return from;
 			}
@@ -58,6 +75,7 @@ namespace Swift {
 			boost::shared_ptr<WriteBytestream> bytestream;
 			IQRouter* router;
 			IBBResponder* responder;
+			int maxBlockSize;
 			bool active;
 	};
 }
@@ -1,11 +1,13 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/FileTransfer/IBBSendSession.h>
 
+#include <algorithm>
+#include <cassert>
 #include <boost/bind.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 
@@ -16,6 +18,11 @@
 
 namespace Swift {
 
+static const unsigned int MIN_BLOCK_SIZE = 4096;
+// The block size is an xs:unsignedShort
+static const unsigned int MAX_BLOCK_SIZE = 65535;
+static const int MAX_SEQUENCE_NUMBER = 65535;
+
 IBBSendSession::IBBSendSession(
 		const std::string& id, 
 		const JID& from, 
@@ -27,7 +34,9 @@ IBBSendSession::IBBSendSession(
 			to(to), 
 			bytestream(bytestream), 
 			router(router), 
-			blockSize(4096), 
+			blockSize(MIN_BLOCK_SIZE), 
+			windowSize(1), 
+			pendingRequests(0), 
 			sequenceNumber(0), 
 			active(false), 
 			waitingForData(false) {
@@ -38,11 +47,25 @@ IBBSendSession::~IBBSendSession() {
 	bytestream->onDataAvailable.disconnect(boost::bind(&IBBSendSession::handleDataAvailable, this));
 }
 
+void IBBSendSession::setBlockSize(unsigned int blockSize) {
+	assert(blockSize > 0);
+	this->blockSize = std::min(blockSize, MAX_BLOCK_SIZE);
+}
+
+void IBBSendSession::setWindowSize(unsigned int windowSize) {
+	assert(windowSize > 0);
+	this->windowSize = windowSize;
+}
+
 void IBBSendSession::start() {
+	active = true;
+	sendOpen();
+}
+
+void IBBSendSession::sendOpen() {
 	IBBRequest::ref request = IBBRequest::create(
 			from, to, IBB::createIBBOpen(id, boost::numeric_cast<int>(blockSize)), router);
-	request->onResponse.connect(boost::bind(&IBBSendSession::handleIBBResponse, this, _1, _2));
-	active = true;
+	request->onResponse.connect(boost::bind(&IBBSendSession::handleIBBOpenResponse, this, _1, _2));
 	request->send();
 }
 
@@ -53,34 +76,61 @@ void IBBSendSession::stop() {
 	finish(boost::optional<FileTransferError>());
 }
 
-void IBBSendSession::handleIBBResponse(IBB::ref, ErrorPayload::ref error) {
-	if (!error && active) {
-		if (!bytestream->isFinished()) {
-			sendMoreData();
+void IBBSendSession::handleIBBOpenResponse(IBB::ref, ErrorPayload::ref error) {
+	if (!active) {
+		return;
+	}
+	if (error) {
+		if (error->getCondition() == ErrorPayload::ResourceConstraint && blockSize > MIN_BLOCK_SIZE) {
+			// The receiver wants smaller blocks
+			blockSize = std::max(blockSize / 2, MIN_BLOCK_SIZE);
+			sendOpen();
 		}
 		else {
-			finish(boost::optional<FileTransferError>());
+			finish(FileTransferError(FileTransferError::PeerError));
 		}
 	}
+	else if (!bytestream->isFinished()) {
+		sendMoreData();
+	}
 	else {
+		finish(boost::optional<FileTransferError>());
+	}
+}
+
+void IBBSendSession::handleIBBDataResponse(IBB::ref, ErrorPayload::ref error) {
+	if (!active) {
+		return;
+	}
+	assert(pendingRequests > 0);
+	pendingRequests--;
+	if (error) {
 		finish(FileTransferError(FileTransferError::PeerError));
 	}
+	else if (!bytestream->isFinished()) {
+		sendMoreData();
+	}
+	else if (pendingRequests == 0) {
+		finish(boost::optional<FileTransferError>());
+	}
 }
 
 void IBBSendSession::sendMoreData() {
 	try {
-		boost::shared_ptr<ByteArray> data = bytestream->read(blockSize);
-		if (!data->empty()) {
+		while (active && pendingRequests < windowSize && !bytestream->isFinished()) {
+			boost::shared_ptr<ByteArray> data = bytestream->read(blockSize);
+			if (data->empty()) {
+				waitingForData = true;
+				return;
+			}
 			waitingForData = false;
 			IBBRequest::ref request = IBBRequest::create(from, to, IBB::createIBBData(id, sequenceNumber, *data), router);
-			sequenceNumber++;
-			request->onResponse.connect(boost::bind(&IBBSendSession::handleIBBResponse, this, _1, _2));
+			sequenceNumber = (sequenceNumber == MAX_SEQUENCE_NUMBER ? 0 : sequenceNumber + 1);
+			request->onResponse.connect(boost::bind(&IBBSendSession::handleIBBDataResponse, this, _1, _2));
+			pendingRequests++;
 			request->send();
 			onBytesSent(data->size());
 		}
-		else {
-			waitingForData = true;
-		}
 	}
 	catch (const BytestreamException&) {
 		finish(FileTransferError(FileTransferError::ReadError));
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -41,15 +41,31 @@ namespace Swift {
 				return to;
 			}
 
-			void setBlockSize(unsigned int blockSize) {
-				this->blockSize = blockSize;
-			}
+			/**
+			 * Sets the size of the data blocks to send.
+			 *
+			 * If the receiver refuses the block size, the session retries
+			 * with smaller ones, down to 4096 bytes.
+			 *
+			 * Default: 4096. The maximum is 65535.
+			 */
+			void setBlockSize(unsigned int blockSize);
+
+			/**
+			 * Sets the number of data blocks that can be sent before the
+			 * receiver has acknowledged the previous ones.
+			 *
+			 * Default: 1
+			 */
+			void setWindowSize(unsigned int windowSize);
 
 			boost::signal<void (boost::optional<FileTransferError>)> onFinished;
 			boost::signal<void (size_t)> onBytesSent;
 
 		private:
-			void handleIBBResponse(IBB::ref, ErrorPayload::ref);
+			void sendOpen();
+			void handleIBBOpenResponse(IBB::ref, ErrorPayload::ref);
+			void handleIBBDataResponse(IBB::ref, ErrorPayload::ref);
 			void finish(boost::optional<FileTransferError>);
 			void sendMoreData();
 			void handleDataAvailable();
@@ -61,6 +77,8 @@ namespace Swift {
 			boost::shared_ptr<ReadBytestream> bytestream;
 			IQRouter* router;
 			unsigned int blockSize;
+			unsigned int windowSize;
+			unsigned int pendingRequests;
 			int sequenceNumber;
 			bool active;
 			bool waitingForData;
@@ -24,11 +24,13 @@ IncomingFileTransferManager::IncomingFileTransferManager(
 		IQRouter* router,
 		FileTransferTransporterFactory* transporterFactory,
 		TimerFactory* timerFactory, 
+		EventLoop* eventLoop,
 		CryptoProvider* crypto) : 
 			jingleSessionManager(jingleSessionManager), 
 			router(router), 
 			transporterFactory(transporterFactory),
 			timerFactory(timerFactory), 
+			eventLoop(eventLoop),
 			crypto(crypto) {
 	jingleSessionManager->addIncomingSessionHandler(this);
 }
@@ -46,7 +48,7 @@ bool IncomingFileTransferManager::handleIncomingJingleSession(
 			JingleFileTransferDescription::ref description = content->getDescription<JingleFileTransferDescription>();
 			if (description) {
 				IncomingJingleFileTransfer::ref transfer = boost::make_shared<IncomingJingleFileTransfer>(
-						recipient, session, content, transporterFactory, timerFactory, crypto);
+						recipient, session, content, transporterFactory, timerFactory, eventLoop, crypto);
 				onIncomingFileTransfer(transfer);
 			} 
 			else {
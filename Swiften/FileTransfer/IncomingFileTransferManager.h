@@ -17,6 +17,7 @@ namespace Swift {
 	class JingleSessionManager;
 	class FileTransferTransporterFactory;
 	class TimerFactory;
+	class EventLoop;
 	class CryptoProvider;
 
 	class IncomingFileTransferManager : public IncomingJingleSessionHandler {
@@ -25,7 +26,8 @@ namespace Swift {
 					JingleSessionManager* jingleSessionManager, 
 					IQRouter* router, 
 					FileTransferTransporterFactory* transporterFactory,
-					TimerFactory* timerFactory, 
+					TimerFactory* timerFactory,
+					EventLoop* eventLoop,
 					CryptoProvider* crypto);
 			~IncomingFileTransferManager();
 
@@ -42,6 +44,7 @@ namespace Swift {
 			IQRouter* router;
 			FileTransferTransporterFactory* transporterFactory;
 			TimerFactory* timerFactory;
+			EventLoop* eventLoop;
 			CryptoProvider* crypto;
 	};
 }
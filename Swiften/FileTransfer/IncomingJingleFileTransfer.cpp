@@ -6,6 +6,7 @@
 
 #include <Swiften/FileTransfer/IncomingJingleFileTransfer.h>
 
+#include <algorithm>
 #include <set>
 
 #include <boost/bind.hpp>
@@ -21,6 +22,7 @@
 #include <Swiften/FileTransfer/IncrementalBytestreamHashCalculator.h>
 #include <Swiften/FileTransfer/FileTransferTransporter.h>
 #include <Swiften/FileTransfer/FileTransferTransporterFactory.h>
+#include <Swiften/FileTransfer/ReadBytestream.h>
 #include <Swiften/FileTransfer/WriteBytestream.h>
 #include <Swiften/Elements/JingleFileTransferDescription.h>
 #include <Swiften/Network/TimerFactory.h>
@@ -29,6 +31,11 @@
 
 using namespace Swift;
 
+namespace {
+	// The size of the blocks in which existing data is read for hashing
+	const size_t EXISTING_DATA_BLOCK_SIZE = 65536;
+}
+
 // TODO: ALlow terminate when already terminated.
 
 IncomingJingleFileTransfer::IncomingJingleFileTransfer(
@@ -37,11 +44,14 @@ IncomingJingleFileTransfer::IncomingJingleFileTransfer(
 		JingleContentPayload::ref content,
 		FileTransferTransporterFactory* transporterFactory,
 		TimerFactory* timerFactory,
+		EventLoop* eventLoop,
 		CryptoProvider* crypto) :
 			JingleFileTransfer(session, toJID, transporterFactory),
 			initialContent(content),
+			eventLoop(eventLoop),
 			crypto(crypto),
 			state(Initial),
+			rangeOffset(0),
 			receivedBytes(0),
 			hashCalculator(NULL) {
 	description = initialContent->getDescription<JingleFileTransferDescription>();
@@ -70,8 +80,27 @@ void IncomingJingleFileTransfer::accept(
 
 	assert(!hashCalculator);
 
-	hashCalculator = new IncrementalBytestreamHashCalculator(
-			hashes.find("md5") != hashes.end(), hashes.find("sha-1") != hashes.end(), crypto);
+	// Continue after the data the stream already has, if the sender supports it
+	if (description->getFileInfo().getSupportsRangeRequests() && stream->getExistingSize() < getFileSizeInBytes()) {
+		rangeOffset = stream->getExistingSize();
+	}
+	createHashCalculator();
+	if (rangeOffset > 0 && !hashExistingData()) {
+		// The hashes cover the whole file, so it can't be verified without the existing data
+		SWIFT_LOG(debug) << "Unable to read the existing data, restarting from the beginning" << std::endl;
+		rangeOffset = 0;
+		delete hashCalculator;
+		createHashCalculator();
+	}
+	stream->setWriteOffset(rangeOffset);
+	if (rangeOffset > 0) {
+		SWIFT_LOG(debug) << "Requesting data from offset " << rangeOffset << std::endl;
+		JingleFileTransferFileInfo fileInfo = description->getFileInfo();
+		fileInfo.setRangeOffset(rangeOffset);
+		description = boost::make_shared<JingleFileTransferDescription>(*description);
+		description->setFileInfo(fileInfo);
+		receivedBytes = rangeOffset;
+	}
 
 	writeStreamDataReceivedConnection = stream->onWrite.connect(
 			boost::bind(&IncomingJingleFileTransfer::handleWriteStreamDataReceived, this, _1));
@@ -91,10 +120,10 @@ void IncomingJingleFileTransfer::accept(
 
 		startTransferring(transporter->createIBBReceiveSession(
 			ibbTransport->getSessionID(),
-			description->getFileInfo().getSize(),
+			getFileSizeInBytes() - rangeOffset,
 			stream));
 
-		session->sendAccept(getContentID(), initialContent->getDescriptions()[0], ibbTransport);
+		session->sendAccept(getContentID(), description, getAcceptedIBBTransport(ibbTransport));
 	}
 	else {
 		// Can't happen, because the transfer would have been rejected automatically
@@ -102,6 +131,32 @@ void IncomingJingleFileTransfer::accept(
 	}
 }
 
+void IncomingJingleFileTransfer::createHashCalculator() {
+	hashCalculator = new IncrementalBytestreamHashCalculator(
+			hashes.find("md5") != hashes.end(), hashes.find("sha-1") != hashes.end(), hashes.find("sha-256") != hashes.end(), crypto, eventLoop);
+	hashCalculator->onHashesCalculated.connect(boost::bind(&IncomingJingleFileTransfer::handleHashesCalculated, this));
+}
+
+bool IncomingJingleFileTransfer::hashExistingData() {
+	boost::shared_ptr<ReadBytestream> existingData = stream->createExistingDataReadBytestream();
+	if (!existingData) {
+		return false;
+	}
+	boost::uintmax_t remaining = rangeOffset;
+	while (remaining > 0) {
+		if (existingData->isFinished()) {
+			return false;
+		}
+		boost::shared_ptr<ByteArray> data = existingData->read(static_cast<size_t>(std::min<boost::uintmax_t>(remaining, EXISTING_DATA_BLOCK_SIZE)));
+		if (data->empty()) {
+			return false;
+		}
+		hashCalculator->feedData(*data);
+		remaining -= data->size();
+	}
+	return true;
+}
+
 void IncomingJingleFileTransfer::cancel() {
 	SWIFT_LOG(debug) << std::endl;
 	terminate(state == Initial ? JinglePayload::Reason::Decline : JinglePayload::Reason::Cancel);
@@ -123,7 +178,7 @@ void IncomingJingleFileTransfer::handleLocalTransportCandidatesGenerated(
 	foreach(JingleS5BTransportPayload::Candidate candidate, candidates) {
 		transport->addCandidate(candidate);	
 	}
-	session->sendAccept(getContentID(), initialContent->getDescriptions()[0], transport);
+	session->sendAccept(getContentID(), description, transport);
 
 	setState(TryingCandidates);
 	transporter->startTryingRemoteCandidates();
@@ -143,7 +198,11 @@ void IncomingJingleFileTransfer::handleSessionInfoReceived(JinglePayload::ref ji
 		if (transferHash->getFileInfo().getHashes().find("md5") != transferHash->getFileInfo().getHashes().end()) {
 			hashes["md5"] = transferHash->getFileInfo().getHash("md5").get();
 		}
-		if (state == WaitingForHash) {
+		// SHA-256 is only calculated if it was announced in the offer
+		if (hashes.find("sha-256") != hashes.end() && transferHash->getFileInfo().getHashes().find("sha-256") != transferHash->getFileInfo().getHashes().end()) {
+			hashes["sha-256"] = transferHash->getFileInfo().getHash("sha-256").get();
+		}
+		if (state == WaitingForHash && hashCalculator->isFinished()) {
 			checkHashAndTerminate();
 		}
 	}
@@ -186,19 +245,9 @@ void IncomingJingleFileTransfer::checkHashAndTerminate() {
 void IncomingJingleFileTransfer::checkIfAllDataReceived() {
 	if (receivedBytes == getFileSizeInBytes()) {
 		SWIFT_LOG(debug) << "All data received." << std::endl;
-		bool hashInfoAvailable = false;
-		foreach(const JingleFileTransferFileInfo::HashElementMap::value_type& hashElement, hashes) {
-			hashInfoAvailable |= !hashElement.second.empty();
-		}
-
-		if (!hashInfoAvailable) {
-			SWIFT_LOG(debug) << "No hash information yet. Waiting a while on hash info." << std::endl;
-			setState(WaitingForHash);
-			waitOnHashTimer->start();
-		} 
-		else {
-			checkHashAndTerminate();
-		}
+		// The data is verified once the hashes of all of it are calculated
+		setState(WaitingForHash);
+		hashCalculator->finish();
 	}
 	else if (receivedBytes > getFileSizeInBytes()) {
 		SWIFT_LOG(debug) << "We got more than we could handle!" << std::endl;
@@ -206,6 +255,24 @@ void IncomingJingleFileTransfer::checkIfAllDataReceived() {
 	}
 }
 
+void IncomingJingleFileTransfer::handleHashesCalculated() {
+	if (state != WaitingForHash) {
+		return;
+	}
+	bool hashInfoAvailable = false;
+	foreach(const JingleFileTransferFileInfo::HashElementMap::value_type& hashElement, hashes) {
+		hashInfoAvailable |= !hashElement.second.empty();
+	}
+
+	if (!hashInfoAvailable) {
+		SWIFT_LOG(debug) << "No hash information yet. Waiting a while on hash info." << std::endl;
+		waitOnHashTimer->start();
+	} 
+	else {
+		checkHashAndTerminate();
+	}
+}
+
 void IncomingJingleFileTransfer::handleWriteStreamDataReceived(
 		const std::vector<unsigned char>& data) {
 	hashCalculator->feedData(data);
@@ -227,9 +294,9 @@ void IncomingJingleFileTransfer::handleTransportReplaceReceived(
 
 		startTransferring(transporter->createIBBReceiveSession(
 			ibbTransport->getSessionID(), 
-			description->getFileInfo().getSize(),
+			getFileSizeInBytes() - rangeOffset,
 			stream));
-		session->sendTransportAccept(content, ibbTransport);
+		session->sendTransportAccept(content, getAcceptedIBBTransport(ibbTransport));
 	} 
 	else {
 		SWIFT_LOG(debug) << "Unknown replace transport" << std::endl;
@@ -246,7 +313,11 @@ bool IncomingJingleFileTransfer::verifyData() {
 		SWIFT_LOG(debug) << "no verification possible, skipping" << std::endl;
 		return true;
 	} 
-	if (hashes.find("sha-1") != hashes.end()) {
+	if (hashes.find("sha-256") != hashes.end()) {
+		SWIFT_LOG(debug) << "Verify SHA-256 hash: " << (hashes["sha-256"] == hashCalculator->getSHA256Hash()) << std::endl;
+		return hashes["sha-256"] == hashCalculator->getSHA256Hash();
+	}
+	else if (hashes.find("sha-1") != hashes.end()) {
 		SWIFT_LOG(debug) << "Verify SHA-1 hash: " << (hashes["sha-1"] == hashCalculator->getSHA1Hash()) << std::endl;
 		return hashes["sha-1"] == hashCalculator->getSHA1Hash();
 	}
@@ -288,6 +359,16 @@ void IncomingJingleFileTransfer::setFinishedState(
 	onFinished(error);
 }
 
+JingleIBBTransportPayload::ref IncomingJingleFileTransfer::getAcceptedIBBTransport(JingleIBBTransportPayload::ref offeredTransport) const {
+	// A responder may lower the offered block size (XEP-0261)
+	if (offeredTransport->getBlockSize() && *offeredTransport->getBlockSize() <= options.getMaxInBandBlockSize()) {
+		return offeredTransport;
+	}
+	JingleIBBTransportPayload::ref acceptedTransport = boost::make_shared<JingleIBBTransportPayload>(*offeredTransport);
+	acceptedTransport->setBlockSize(options.getMaxInBandBlockSize());
+	return acceptedTransport;
+}
+
 void IncomingJingleFileTransfer::handleTransferFinished(boost::optional<FileTransferError> error) {
 	if (error && state != WaitingForHash) {
 		terminate(JinglePayload::Reason::MediaError);
@@ -27,9 +27,11 @@ namespace Swift {
 	class FileTransferTransporterFactory;
 	class TimerFactory;
 	class Timer;
+	class EventLoop;
 	class CryptoProvider;
 	class IncrementalBytestreamHashCalculator;
 	class JingleFileTransferDescription;
+	class JingleIBBTransportPayload;
 	class HashElement;
 
 	/**
@@ -49,6 +51,7 @@ namespace Swift {
 				boost::shared_ptr<JingleContentPayload> content,
 				FileTransferTransporterFactory*,
 				TimerFactory*,
+				EventLoop*,
 				CryptoProvider*);
 			~IncomingJingleFileTransfer();
 
@@ -79,12 +82,15 @@ namespace Swift {
 					const std::vector<JingleS5BTransportPayload::Candidate>&,
 					const std::string& dstAddr) SWIFTEN_OVERRIDE;
 
+			void createHashCalculator();
+			bool hashExistingData();
 			void handleWriteStreamDataReceived(const std::vector<unsigned char>& data);
 			void stopActiveTransport();
 			void checkCandidateSelected();
 			virtual JingleContentID getContentID() const SWIFTEN_OVERRIDE;
 			void checkIfAllDataReceived();
 			bool verifyData();
+			void handleHashesCalculated();
 			void handleWaitOnHashTimerTicked();
 			void handleTransferFinished(boost::optional<FileTransferError>);
 
@@ -95,6 +101,7 @@ namespace Swift {
 			void stopAll();
 			void setState(State state);
 			void setFinishedState(FileTransfer::State::Type, const boost::optional<FileTransferError>& error);
+			boost::shared_ptr<JingleIBBTransportPayload> getAcceptedIBBTransport(boost::shared_ptr<JingleIBBTransportPayload> offeredTransport) const;
 			const JID& getSender() const SWIFTEN_OVERRIDE;
 			const JID& getRecipient() const SWIFTEN_OVERRIDE;
 			static FileTransfer::State::Type getExternalState(State state);
@@ -111,10 +118,12 @@ namespace Swift {
 
 		private:
 			boost::shared_ptr<JingleContentPayload> initialContent;
+			EventLoop* eventLoop;
 			CryptoProvider* crypto;
 			State state;
 			boost::shared_ptr<JingleFileTransferDescription> description;
 			boost::shared_ptr<WriteBytestream> stream;
+			boost::uintmax_t rangeOffset;
 			boost::uintmax_t receivedBytes;
 			IncrementalBytestreamHashCalculator* hashCalculator;
 			boost::shared_ptr<Timer> waitOnHashTimer;
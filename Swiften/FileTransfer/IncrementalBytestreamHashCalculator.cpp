@@ -5,71 +5,294 @@
  */
 
 /*
- * Copyright (c) 2013-2014 Isode Limited.
+ * Copyright (c) 2013-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
-
 #include <Swiften/FileTransfer/IncrementalBytestreamHashCalculator.h>
 
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/optional.hpp>
+#include <boost/smart_ptr/enable_shared_from_this.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/once.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <Swiften/Base/foreach.h>
 #include <Swiften/StringCodecs/Hexify.h>
 #include <Swiften/Crypto/CryptoProvider.h>
+#include <Swiften/Crypto/Hash.h>
+#include <Swiften/EventLoop/EventLoop.h>
+#include <Swiften/EventLoop/EventOwner.h>
 
 namespace Swift {
 
-IncrementalBytestreamHashCalculator::IncrementalBytestreamHashCalculator(bool doMD5, bool doSHA1, CryptoProvider* crypto) {
-	md5Hasher = doMD5 ? crypto->createMD5() : NULL;
-	sha1Hasher = doSHA1 ? crypto->createSHA1() : NULL;
+namespace {
+	// The amount of data that can be queued for a hash before feeding blocks
+	const size_t MAX_QUEUED_BYTES = 4 * 1024 * 1024;
+
+	/**
+	 * The threads that calculate the hashes of all calculators.
+	 */
+	class HashThreadPool {
+		public:
+			HashThreadPool() : stopRequested(false) {
+				unsigned int threadCount = std::max(1U, boost::thread::hardware_concurrency());
+				for (unsigned int i = 0; i < threadCount; ++i) {
+					threads.create_thread(boost::bind(&HashThreadPool::run, this));
+				}
+			}
+
+			~HashThreadPool() {
+				{
+					boost::lock_guard<boost::mutex> lock(tasksMutex);
+					stopRequested = true;
+				}
+				tasksAvailable.notify_all();
+				threads.join_all();
+			}
+
+			void post(const boost::function<void ()>& task) {
+				{
+					boost::lock_guard<boost::mutex> lock(tasksMutex);
+					tasks.push_back(task);
+				}
+				tasksAvailable.notify_one();
+			}
+
+			static HashThreadPool& getInstance() {
+				boost::call_once(instanceFlag, &createInstance);
+				return *instance;
+			}
+
+		private:
+			static void createInstance() {
+				static HashThreadPool pool;
+				instance = &pool;
+			}
+
+			void run() {
+				while (true) {
+					boost::function<void ()> task;
+					{
+						boost::unique_lock<boost::mutex> lock(tasksMutex);
+						while (tasks.empty() && !stopRequested) {
+							tasksAvailable.wait(lock);
+						}
+						if (tasks.empty()) {
+							return;
+						}
+						task = tasks.front();
+						tasks.pop_front();
+					}
+					task();
+				}
+			}
+
+		private:
+			static boost::once_flag instanceFlag;
+			static HashThreadPool* instance;
+
+			boost::thread_group threads;
+			boost::mutex tasksMutex;
+			boost::condition_variable tasksAvailable;
+			std::deque< boost::function<void ()> > tasks;
+			bool stopRequested;
+	};
+
+	boost::once_flag HashThreadPool::instanceFlag = BOOST_ONCE_INIT;
+	HashThreadPool* HashThreadPool::instance = NULL;
+}
+
+/**
+ * Feeds queued data into a single hash.
+ *
+ * At most one task of a worker is scheduled on the thread pool at any time,
+ * so the data is hashed in the order in which it was fed.
+ */
+class IncrementalBytestreamHashCalculator::Worker : public boost::enable_shared_from_this<Worker> {
+	public:
+		Worker(Hash* hash, EventLoop* eventLoop, boost::shared_ptr<EventOwner> eventOwner) : hash(hash), eventLoop(eventLoop), eventOwner(eventOwner), queuedBytes(0), scheduled(false), processing(false), finishRequested(false), stopRequested(false) {
+		}
+
+		~Worker() {
+			delete hash;
+		}
+
+		void feedData(boost::shared_ptr<const ByteArray> data) {
+			boost::unique_lock<boost::mutex> lock(mutex);
+			assert(!finishRequested);
+			while (queuedBytes >= MAX_QUEUED_BYTES && !stopRequested) {
+				queueChanged.wait(lock);
+			}
+			queue.push_back(data);
+			queuedBytes += data->size();
+			schedule();
+		}
+
+		/**
+		 * Posts the given event once all data is hashed.
+		 */
+		void finish(const boost::function<void ()>& finishedEvent) {
+			boost::lock_guard<boost::mutex> lock(mutex);
+			finishRequested = true;
+			this->finishedEvent = finishedEvent;
+			schedule();
+		}
+
+		/**
+		 * Drops the queued data. When this returns, the worker does not touch
+		 * the hash or post any events anymore.
+		 */
+		void stop() {
+			boost::unique_lock<boost::mutex> lock(mutex);
+			stopRequested = true;
+			queue.clear();
+			queuedBytes = 0;
+			queueChanged.notify_all();
+			while (processing) {
+				queueChanged.wait(lock);
+			}
+		}
+
+		ByteArray getHash() const {
+			boost::lock_guard<boost::mutex> lock(mutex);
+			assert(result);
+			return *result;
+		}
+
+	private:
+		void schedule() {
+			if (!scheduled) {
+				scheduled = true;
+				HashThreadPool::getInstance().post(boost::bind(&Worker::process, shared_from_this()));
+			}
+		}
+
+		void process() {
+			boost::unique_lock<boost::mutex> lock(mutex);
+			while (!queue.empty() && !stopRequested) {
+				boost::shared_ptr<const ByteArray> data = queue.front();
+				queue.pop_front();
+				processing = true;
+				lock.unlock();
+				hash->update(*data);
+				lock.lock();
+				processing = false;
+				queuedBytes -= std::min(queuedBytes, data->size());
+				queueChanged.notify_all();
+			}
+			scheduled = false;
+			if (finishRequested && !stopRequested && !result) {
+				result = hash->getHash();
+				eventLoop->postEvent(finishedEvent, eventOwner);
+			}
+		}
+
+	private:
+		Hash* hash;
+		EventLoop* eventLoop;
+		boost::shared_ptr<EventOwner> eventOwner;
+		mutable boost::mutex mutex;
+		boost::condition_variable queueChanged;
+		std::deque< boost::shared_ptr<const ByteArray> > queue;
+		size_t queuedBytes;
+		bool scheduled;
+		bool processing;
+		bool finishRequested;
+		bool stopRequested;
+		boost::function<void ()> finishedEvent;
+		boost::optional<ByteArray> result;
+};
+
+IncrementalBytestreamHashCalculator::IncrementalBytestreamHashCalculator(bool doMD5, bool doSHA1, bool doSHA256, CryptoProvider* crypto, EventLoop* eventLoop) : eventLoop(eventLoop), finishedWorkers(0), finishRequested(false) {
+	eventOwner = boost::make_shared<EventOwner>();
+	if (doMD5) {
+		md5Worker = boost::make_shared<Worker>(crypto->createMD5(), eventLoop, eventOwner);
+		workers.push_back(md5Worker);
+	}
+	if (doSHA1) {
+		sha1Worker = boost::make_shared<Worker>(crypto->createSHA1(), eventLoop, eventOwner);
+		workers.push_back(sha1Worker);
+	}
+	if (doSHA256) {
+		sha256Worker = boost::make_shared<Worker>(crypto->createSHA256(), eventLoop, eventOwner);
+		workers.push_back(sha256Worker);
+	}
 }
 
 IncrementalBytestreamHashCalculator::~IncrementalBytestreamHashCalculator() {
-	delete md5Hasher;
-	delete sha1Hasher;
+	// A worker may still have a task scheduled on the pool, which keeps it
+	// alive, but it won't post events after it is stopped.
+	foreach (boost::shared_ptr<Worker> worker, workers) {
+		worker->stop();
+	}
+	eventLoop->removeEventsFromOwner(eventOwner);
 }
 
 void IncrementalBytestreamHashCalculator::feedData(const ByteArray& data) {
-	if (md5Hasher) {
-		md5Hasher->update(data);
+	assert(!finishRequested);
+	if (workers.empty() || data.empty()) {
+		return;
 	}
-	if (sha1Hasher) {
-		sha1Hasher->update(data);
+	// All workers share a single copy of the data
+	boost::shared_ptr<const ByteArray> sharedData = boost::make_shared<ByteArray>(data);
+	foreach (boost::shared_ptr<Worker> worker, workers) {
+		worker->feedData(sharedData);
 	}
 }
-/*
-void IncrementalBytestreamHashCalculator::feedData(const SafeByteArray& data) {
-	if (md5Hasher) {
-		md5Hasher->update(createByteArray(data.data(), data.size()));
+
+void IncrementalBytestreamHashCalculator::finish() {
+	assert(!finishRequested);
+	finishRequested = true;
+	if (workers.empty()) {
+		eventLoop->postEvent(boost::ref(onHashesCalculated), eventOwner);
 	}
-	if (sha1Hasher) {
-		sha1Hasher->update(createByteArray(data.data(), data.size()));
+	foreach (boost::shared_ptr<Worker> worker, workers) {
+		worker->finish(boost::bind(&IncrementalBytestreamHashCalculator::handleWorkerFinished, this));
 	}
-}*/
+}
 
-ByteArray IncrementalBytestreamHashCalculator::getSHA1Hash() {
-	assert(sha1Hasher);
-	if (!sha1Hash) {
-		sha1Hash = sha1Hasher->getHash();
+void IncrementalBytestreamHashCalculator::handleWorkerFinished() {
+	++finishedWorkers;
+	if (finishedWorkers == workers.size()) {
+		onHashesCalculated();
 	}
-	return *sha1Hash;
 }
 
-ByteArray IncrementalBytestreamHashCalculator::getMD5Hash() {
-	assert(md5Hasher);
-	if (!md5Hash) {
-		md5Hash = md5Hasher->getHash();
-	}
-	return *md5Hash;
+ByteArray IncrementalBytestreamHashCalculator::getSHA1Hash() const {
+	assert(sha1Worker);
+	return sha1Worker->getHash();
+}
+
+ByteArray IncrementalBytestreamHashCalculator::getMD5Hash() const {
+	assert(md5Worker);
+	return md5Worker->getHash();
+}
+
+ByteArray IncrementalBytestreamHashCalculator::getSHA256Hash() const {
+	assert(sha256Worker);
+	return sha256Worker->getHash();
+}
+
+std::string IncrementalBytestreamHashCalculator::getSHA1String() const {
+	return Hexify::hexify(getSHA1Hash());
 }
 
-std::string IncrementalBytestreamHashCalculator::getSHA1String() {
-	assert(sha1Hasher);
-	return Hexify::hexify(getSHA1Hash());;
+std::string IncrementalBytestreamHashCalculator::getMD5String() const {
+	return Hexify::hexify(getMD5Hash());
 }
 
-std::string IncrementalBytestreamHashCalculator::getMD5String() {
-	assert(md5Hasher);
-	return Hexify::hexify(getMD5Hash());;
+std::string IncrementalBytestreamHashCalculator::getSHA256String() const {
+	return Hexify::hexify(getSHA256Hash());
 }
 
 }
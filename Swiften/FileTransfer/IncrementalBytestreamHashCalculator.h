@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (c) 2013-2014 Isode Limited.
+ * Copyright (c) 2013-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,34 +13,74 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <Swiften/Base/ByteArray.h>
-#include <Swiften/Base/SafeByteArray.h>
-#include <boost/optional.hpp>
+#include <Swiften/Base/boost_bsignals.h>
 
 namespace Swift {
-	class Hash;
 	class CryptoProvider;
+	class EventLoop;
+	class EventOwner;
 
-	class IncrementalBytestreamHashCalculator {
+	/**
+	 * Calculates hashes of a bytestream while it is being transferred.
+	 *
+	 * The hashes are calculated on a thread pool that is shared by all
+	 * calculators, and different hashes are calculated in parallel. Feeding
+	 * data only queues it, unless the hashes fall too far behind, in which case
+	 * feeding blocks until the queue has room again.
+	 *
+	 * Once all data is fed, call finish(). onHashesCalculated is emitted on
+	 * the event loop when all hashes are calculated, after which the hashes can
+	 * be retrieved.
+	 */
+	class IncrementalBytestreamHashCalculator : public boost::noncopyable {
 	public:
-		IncrementalBytestreamHashCalculator(bool doMD5, bool doSHA1, CryptoProvider* crypto);
+		IncrementalBytestreamHashCalculator(bool doMD5, bool doSHA1, bool doSHA256, CryptoProvider* crypto, EventLoop* eventLoop);
 		~IncrementalBytestreamHashCalculator();
 
 		void feedData(const ByteArray& data);
-		//void feedData(const SafeByteArray& data);
 
-		ByteArray getSHA1Hash();
-		ByteArray getMD5Hash();
+		/**
+		 * Indicates that all data was fed. No more data can be fed afterwards.
+		 */
+		void finish();
 
-		std::string getSHA1String();
-		std::string getMD5String();
+		/**
+		 * Returns whether all hashes are calculated.
+		 */
+		bool isFinished() const {
+			return finishedWorkers == workers.size() && finishRequested;
+		}
+
+		ByteArray getSHA1Hash() const;
+		ByteArray getMD5Hash() const;
+		ByteArray getSHA256Hash() const;
+
+		std::string getSHA1String() const;
+		std::string getMD5String() const;
+		std::string getSHA256String() const;
+
+	public:
+		boost::signal<void ()> onHashesCalculated;
+
+	private:
+		class Worker;
+
+		void handleWorkerFinished();
 
 	private:
-		Hash* md5Hasher;
-		Hash* sha1Hasher;
-		boost::optional<ByteArray> md5Hash;
-		boost::optional<ByteArray> sha1Hash;
+		EventLoop* eventLoop;
+		boost::shared_ptr<EventOwner> eventOwner;
+		boost::shared_ptr<Worker> md5Worker;
+		boost::shared_ptr<Worker> sha1Worker;
+		boost::shared_ptr<Worker> sha256Worker;
+		std::vector< boost::shared_ptr<Worker> > workers;
+		size_t finishedWorkers;
+		bool finishRequested;
 	};
 
 }
@@ -28,11 +28,13 @@ OutgoingFileTransferManager::OutgoingFileTransferManager(
 		IQRouter* router,
 		FileTransferTransporterFactory* transporterFactory,
 		TimerFactory* timerFactory,
+		EventLoop* eventLoop,
 		CryptoProvider* crypto) : 
 			jingleSessionManager(jingleSessionManager), 
 			iqRouter(router), 
 			transporterFactory(transporterFactory),
 			timerFactory(timerFactory),
+			eventLoop(eventLoop),
 			crypto(crypto) {
 	idGenerator = new IDGenerator();
 }
@@ -56,6 +58,7 @@ boost::shared_ptr<OutgoingFileTransfer> OutgoingFileTransferManager::createOutgo
 				readBytestream, 
 				transporterFactory,
 				timerFactory,
+				eventLoop,
 				idGenerator, 
 				fileInfo, 
 				config,
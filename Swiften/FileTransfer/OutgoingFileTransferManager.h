@@ -26,6 +26,7 @@ namespace Swift {
 	class CryptoProvider;
 	class FileTransferOptions;
 	class TimerFactory;
+	class EventLoop;
 
 	class OutgoingFileTransferManager {
 		public:
@@ -34,6 +35,7 @@ namespace Swift {
 					IQRouter* router, 
 					FileTransferTransporterFactory* transporterFactory,
 					TimerFactory* timerFactory,
+					EventLoop* eventLoop,
 					CryptoProvider* crypto);
 			~OutgoingFileTransferManager();
 			
@@ -49,6 +51,7 @@ namespace Swift {
 			IQRouter* iqRouter;
 			FileTransferTransporterFactory* transporterFactory;
 			TimerFactory* timerFactory;
+			EventLoop* eventLoop;
 			IDGenerator* idGenerator;
 			CryptoProvider* crypto;
 	};
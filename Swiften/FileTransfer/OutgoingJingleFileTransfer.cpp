@@ -17,6 +17,8 @@
 
 #include <Swiften/FileTransfer/OutgoingJingleFileTransfer.h>
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 #include <boost/smart_ptr/make_shared.hpp>
 #include <boost/typeof/typeof.hpp>
@@ -42,7 +44,21 @@
 
 using namespace Swift;
 
-static const int DEFAULT_BLOCK_SIZE = 4096;
+namespace {
+	// The size of the blocks in which data before a requested range is read for hashing
+	const size_t SKIPPED_DATA_BLOCK_SIZE = 65536;
+
+	bool isHashKnown(const JingleFileTransferFileInfo& fileInfo, const std::string& algorithm) {
+		boost::optional<ByteArray> hash = fileInfo.getHash(algorithm);
+		return hash && !hash->empty();
+	}
+
+	void addHashPlaceholder(JingleFileTransferFileInfo& fileInfo, const std::string& algorithm) {
+		if (!fileInfo.getHash(algorithm)) {
+			fileInfo.addHash(HashElement(algorithm, ByteArray()));
+		}
+	}
+}
 
 OutgoingJingleFileTransfer::OutgoingJingleFileTransfer(
 		const JID& toJID,
@@ -50,6 +66,7 @@ OutgoingJingleFileTransfer::OutgoingJingleFileTransfer(
 		boost::shared_ptr<ReadBytestream> stream,
 		FileTransferTransporterFactory* transporterFactory,
 		TimerFactory* timerFactory,
+		EventLoop* eventLoop,
 		IDGenerator* idGenerator,
 		const JingleFileTransferFileInfo& fileInfo,
 		const FileTransferOptions& options,
@@ -60,24 +77,34 @@ OutgoingJingleFileTransfer::OutgoingJingleFileTransfer(
 			fileInfo(fileInfo),
 			options(options),
 			contentID(idGenerator->generateID(), JingleContentPayload::InitiatorCreator),
+			hashCalculator(NULL),
 			state(Initial),
 			candidateAcknowledged(false) {
 
 	setFileInfo(fileInfo.getName(), fileInfo.getSize());
 
-	// calculate both, MD5 and SHA-1 since we don't know which one the other side supports
-	hashCalculator = new IncrementalBytestreamHashCalculator(true, true, crypto);
-	stream->onRead.connect(
-			boost::bind(&IncrementalBytestreamHashCalculator::feedData, hashCalculator, _1));
+	// Calculate all hashes that aren't known yet, since we don't know which one the other side supports.
+	// They are calculated in the background while the data is being sent.
+	bool calculateMD5 = !isHashKnown(fileInfo, "md5");
+	bool calculateSHA1 = !isHashKnown(fileInfo, "sha-1");
+	bool calculateSHA256 = !isHashKnown(fileInfo, "sha-256");
+	if (calculateMD5 || calculateSHA1 || calculateSHA256) {
+		hashCalculator = new IncrementalBytestreamHashCalculator(calculateMD5, calculateSHA1, calculateSHA256, crypto, eventLoop);
+		hashCalculator->onHashesCalculated.connect(boost::bind(&OutgoingJingleFileTransfer::handleHashesCalculated, this));
+		stream->onRead.connect(
+				boost::bind(&IncrementalBytestreamHashCalculator::feedData, hashCalculator, _1));
+	}
 
 	waitForRemoteTermination = timerFactory->createTimer(5000);
 	waitForRemoteTermination->onTick.connect(boost::bind(&OutgoingJingleFileTransfer::handleWaitForRemoteTerminationTimeout, this));
 }
 
 OutgoingJingleFileTransfer::~OutgoingJingleFileTransfer() {
-	stream->onRead.disconnect(
-			boost::bind(&IncrementalBytestreamHashCalculator::feedData, hashCalculator, _1));
-	delete hashCalculator;
+	if (hashCalculator) {
+		stream->onRead.disconnect(
+				boost::bind(&IncrementalBytestreamHashCalculator::feedData, hashCalculator, _1));
+		delete hashCalculator;
+	}
 }
 	
 void OutgoingJingleFileTransfer::start() {
@@ -105,11 +132,23 @@ void OutgoingJingleFileTransfer::terminate(JinglePayload::Reason::Type reason) {
 
 void OutgoingJingleFileTransfer::handleSessionAcceptReceived(
 		const JingleContentID&, 
-		JingleDescription::ref, 
+		JingleDescription::ref description, 
 		JingleTransportPayload::ref transportPayload) {
 	SWIFT_LOG(debug) << std::endl;
 	if (state != WaitingForAccept) { SWIFT_LOG(warning) << "Incorrect state" << std::endl; return; }
 
+	if (JingleFileTransferDescription::ref fileTransferDescription = boost::dynamic_pointer_cast<JingleFileTransferDescription>(description)) {
+		boost::uintmax_t rangeOffset = fileTransferDescription->getFileInfo().getRangeOffset();
+		if (rangeOffset > 0) {
+			SWIFT_LOG(debug) << "Sending data from offset " << rangeOffset << std::endl;
+			if (rangeOffset > fileInfo.getSize() || !skipTo(rangeOffset)) {
+				SWIFT_LOG(debug) << "Unable to start at the requested offset" << std::endl;
+				terminate(JinglePayload::Reason::MediaError);
+				return;
+			}
+		}
+	}
+
 	if (JingleS5BTransportPayload::ref s5bPayload = boost::dynamic_pointer_cast<JingleS5BTransportPayload>(transportPayload)) {
 		transporter->addRemoteCandidates(s5bPayload->getCandidates(), s5bPayload->getDstAddr());
 		setState(TryingCandidates);
@@ -121,6 +160,26 @@ void OutgoingJingleFileTransfer::handleSessionAcceptReceived(
 	}
 }
 
+bool OutgoingJingleFileTransfer::skipTo(boost::uintmax_t offset) {
+	if (!hashCalculator) {
+		return stream->seek(offset);
+	}
+	// The hashes cover the whole file, so the data before the offset is read
+	// instead of skipped, which feeds it to the hash calculator.
+	boost::uintmax_t remaining = offset;
+	while (remaining > 0) {
+		if (stream->isFinished()) {
+			return false;
+		}
+		boost::shared_ptr<ByteArray> data = stream->read(static_cast<size_t>(std::min<boost::uintmax_t>(remaining, SKIPPED_DATA_BLOCK_SIZE)));
+		if (data->empty()) {
+			return false;
+		}
+		remaining -= data->size();
+	}
+	return true;
+}
+
 void OutgoingJingleFileTransfer::handleSessionTerminateReceived(boost::optional<JinglePayload::Reason> reason) {
 	SWIFT_LOG(debug) << std::endl;
 	if (state == Finished) { SWIFT_LOG(warning) << "Incorrect state: " << state << std::endl; return; }
@@ -145,7 +204,9 @@ void OutgoingJingleFileTransfer::handleTransportAcceptReceived(const JingleConte
 	if (state != FallbackRequested) { SWIFT_LOG(warning) << "Incorrect state" << std::endl; return; }
 
 	if (JingleIBBTransportPayload::ref ibbPayload = boost::dynamic_pointer_cast<JingleIBBTransportPayload>(transport)) {
-		startTransferring(transporter->createIBBSendSession(ibbPayload->getSessionID(), ibbPayload->getBlockSize().get_value_or(DEFAULT_BLOCK_SIZE), stream));
+		// The responder may only lower the block size we offered
+		unsigned int blockSize = std::min(ibbPayload->getBlockSize().get_value_or(options.getInBandBlockSize()), options.getInBandBlockSize());
+		startTransferring(transporter->createIBBSendSession(ibbPayload->getSessionID(), blockSize, stream));
 	} 
 	else {
 		SWIFT_LOG(debug) << "Unknown transport replacement" << std::endl;
@@ -162,10 +223,41 @@ void OutgoingJingleFileTransfer::handleTransportRejectReceived(const JingleConte
 void OutgoingJingleFileTransfer::sendSessionInfoHash() {
 	SWIFT_LOG(debug) << std::endl;
 
+	JingleFileTransferFileInfo::HashElementMap hashes = getHashes();
 	JingleFileTransferHash::ref hashElement = boost::make_shared<JingleFileTransferHash>();
-	hashElement->getFileInfo().addHash(HashElement("sha-1", hashCalculator->getSHA1Hash()));
-	hashElement->getFileInfo().addHash(HashElement("md5", hashCalculator->getMD5Hash()));
-	session->sendInfo(hashElement);
+	foreach (const JingleFileTransferFileInfo::HashElementMap::value_type& hash, hashes) {
+		if (!hash.second.empty()) {
+			hashElement->getFileInfo().addHash(HashElement(hash.first, hash.second));
+		}
+	}
+	if (!hashElement->getFileInfo().getHashes().empty()) {
+		session->sendInfo(hashElement);
+	}
+
+	if (hashCalculator) {
+		onHashesCalculated(hashes);
+	}
+}
+
+/**
+ * Returns the known hashes, completed with the calculated ones.
+ *
+ * The hash calculator must be finished.
+ */
+JingleFileTransferFileInfo::HashElementMap OutgoingJingleFileTransfer::getHashes() const {
+	JingleFileTransferFileInfo::HashElementMap hashes = fileInfo.getHashes();
+	if (hashCalculator) {
+		if (hashes["md5"].empty()) {
+			hashes["md5"] = hashCalculator->getMD5Hash();
+		}
+		if (hashes["sha-1"].empty()) {
+			hashes["sha-1"] = hashCalculator->getSHA1Hash();
+		}
+		if (hashes["sha-256"].empty()) {
+			hashes["sha-256"] = hashCalculator->getSHA256Hash();
+		}
+	}
+	return hashes;
 }
 
 void OutgoingJingleFileTransfer::handleLocalTransportCandidatesGenerated(
@@ -176,8 +268,11 @@ void OutgoingJingleFileTransfer::handleLocalTransportCandidatesGenerated(
 	fillCandidateMap(localCandidates, candidates);
 
 	JingleFileTransferDescription::ref description = boost::make_shared<JingleFileTransferDescription>();
-	fileInfo.addHash(HashElement("sha-1", ByteArray()));
-	fileInfo.addHash(HashElement("md5", ByteArray()));
+	// Announce the hashes we will send, including the ones we already know
+	addHashPlaceholder(fileInfo, "sha-1");
+	addHashPlaceholder(fileInfo, "md5");
+	addHashPlaceholder(fileInfo, "sha-256");
+	fileInfo.setSupportsRangeRequests(stream->isSeekable());
 	description->setFileInfo(fileInfo);
 
 	JingleS5BTransportPayload::ref transport = boost::make_shared<JingleS5BTransportPayload>();
@@ -195,7 +290,7 @@ void OutgoingJingleFileTransfer::fallback() {
 	if (options.isInBandAllowed()) {
 		SWIFT_LOG(debug) << "Trying to fallback to IBB transport." << std::endl;
 		JingleIBBTransportPayload::ref ibbTransport = boost::make_shared<JingleIBBTransportPayload>();
-		ibbTransport->setBlockSize(DEFAULT_BLOCK_SIZE);
+		ibbTransport->setBlockSize(options.getInBandBlockSize());
 		ibbTransport->setSessionID(idGenerator->generateID());
 		setState(FallbackRequested);
 		session->sendTransportReplace(contentID, ibbTransport);
@@ -214,12 +309,25 @@ void OutgoingJingleFileTransfer::handleTransferFinished(boost::optional<FileTran
 		terminate(JinglePayload::Reason::ConnectivityError);
 	} 
 	else {
-		sendSessionInfoHash();
-
 		// wait for other party to terminate session after they have verified the hash
 		setState(WaitForTermination);
-		waitForRemoteTermination->start();
+		if (hashCalculator) {
+			hashCalculator->finish();
+		}
+		else {
+			sendSessionInfoHash();
+			waitForRemoteTermination->start();
+		}
+	}
+}
+
+void OutgoingJingleFileTransfer::handleHashesCalculated() {
+	SWIFT_LOG(debug) << std::endl;
+	if (state != WaitForTermination) {
+		return;
 	}
+	sendSessionInfoHash();
+	waitForRemoteTermination->start();
 }
 
 void OutgoingJingleFileTransfer::startTransferring(boost::shared_ptr<TransportSession> transportSession) {
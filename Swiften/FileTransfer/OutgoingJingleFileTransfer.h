@@ -33,6 +33,7 @@ namespace Swift {
 	class FileTransferTransporterFactory;
 	class TransportSession;
 	class TimerFactory;
+	class EventLoop;
 
 	class SWIFTEN_API OutgoingJingleFileTransfer : public OutgoingFileTransfer, public JingleFileTransfer {
 		public:
@@ -42,6 +43,7 @@ namespace Swift {
 				boost::shared_ptr<ReadBytestream>,
 				FileTransferTransporterFactory*,
 				TimerFactory*,
+				EventLoop*,
 				IDGenerator*,
 				const JingleFileTransferFileInfo&,
 				const FileTransferOptions&,
@@ -51,6 +53,15 @@ namespace Swift {
 			virtual void start() SWIFTEN_OVERRIDE;
 			virtual void cancel() SWIFTEN_OVERRIDE;
 
+		public:
+			/**
+			 * Emitted with all hashes of the file when they were calculated
+			 * during the transfer, so they can be reused for later transfers.
+			 *
+			 * Hashes that were passed in the file info are not calculated again.
+			 */
+			boost::signal<void (const JingleFileTransferFileInfo::HashElementMap&)> onHashesCalculated;
+
 		private:
 			enum State {
 				Initial,
@@ -82,9 +93,13 @@ namespace Swift {
 			virtual void terminate(JinglePayload::Reason::Type reason) SWIFTEN_OVERRIDE;
 
 			virtual void fallback() SWIFTEN_OVERRIDE;
+			bool skipTo(boost::uintmax_t offset);
+
 			void handleTransferFinished(boost::optional<FileTransferError>);
 
+			void handleHashesCalculated();
 			void sendSessionInfoHash();
+			JingleFileTransferFileInfo::HashElementMap getHashes() const;
 
 			virtual void startTransferring(boost::shared_ptr<TransportSession>) SWIFTEN_OVERRIDE;
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,4 +11,12 @@ namespace Swift {
 ReadBytestream::~ReadBytestream() {
 }
 
+bool ReadBytestream::isSeekable() const {
+	return false;
+}
+
+bool ReadBytestream::seek(boost::uintmax_t) {
+	return false;
+}
+
 }
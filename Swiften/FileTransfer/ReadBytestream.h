@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 #include <vector>
 
 #include <Swiften/Base/API.h>
@@ -25,6 +26,17 @@ namespace Swift {
 
 			virtual bool isFinished() const = 0;
 
+			/**
+			 * Returns whether seek() is supported.
+			 */
+			virtual bool isSeekable() const;
+
+			/**
+			 * Continues reading at the given offset from the start of the stream.
+			 * Returns false if the stream can't seek to the offset.
+			 */
+			virtual bool seek(boost::uintmax_t offset);
+
 		public:
 			boost::signal<void ()> onDataAvailable;
 			boost::signal<void (const std::vector<unsigned char>&)> onRead;
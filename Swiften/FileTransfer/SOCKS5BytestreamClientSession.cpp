@@ -190,7 +190,7 @@ void SOCKS5BytestreamClientSession::sendData() {
 	if (!readBytestream->isFinished()) {
 		try {
 			boost::shared_ptr<ByteArray> dataToSend = readBytestream->read(boost::numeric_cast<size_t>(chunkSize));
-			connection->write(createSafeByteArray(*dataToSend));
+			connection->writeShared(dataToSend);
 			onBytesSent(dataToSend->size());
 		}
 		catch (const BytestreamException&) {
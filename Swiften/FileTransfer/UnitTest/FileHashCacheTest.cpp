@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <QA/Checker/IO.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/Base/ByteArray.h>
+#include <Swiften/FileTransfer/FileHashCache.h>
+
+using namespace Swift;
+
+class FileHashCacheTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(FileHashCacheTest);
+		CPPUNIT_TEST(testGetHashes);
+		CPPUNIT_TEST(testGetHashes_Unknown);
+		CPPUNIT_TEST(testGetHashes_SizeChanged);
+		CPPUNIT_TEST(testGetHashes_Modified);
+		CPPUNIT_TEST(testSetHashes_Evicts);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void setUp() {
+			hashes["sha-1"] = createByteArray("sha1hash");
+			hashes["md5"] = createByteArray("md5hash");
+		}
+
+		void testGetHashes() {
+			FileHashCache testling;
+			testling.setHashes("/tmp/foo.bin", 1024, 1000, hashes);
+
+			boost::optional<JingleFileTransferFileInfo::HashElementMap> result = testling.getHashes("/tmp/foo.bin", 1024, 1000);
+
+			CPPUNIT_ASSERT(result);
+			CPPUNIT_ASSERT_EQUAL(createByteArray("sha1hash"), (*result)["sha-1"]);
+			CPPUNIT_ASSERT_EQUAL(createByteArray("md5hash"), (*result)["md5"]);
+		}
+
+		void testGetHashes_Unknown() {
+			FileHashCache testling;
+			testling.setHashes("/tmp/foo.bin", 1024, 1000, hashes);
+
+			CPPUNIT_ASSERT(!testling.getHashes("/tmp/bar.bin", 1024, 1000));
+		}
+
+		void testGetHashes_SizeChanged() {
+			FileHashCache testling;
+			testling.setHashes("/tmp/foo.bin", 1024, 1000, hashes);
+
+			CPPUNIT_ASSERT(!testling.getHashes("/tmp/foo.bin", 2048, 1000));
+		}
+
+		void testGetHashes_Modified() {
+			FileHashCache testling;
+			testling.setHashes("/tmp/foo.bin", 1024, 1000, hashes);
+
+			CPPUNIT_ASSERT(!testling.getHashes("/tmp/foo.bin", 1024, 1001));
+		}
+
+		void testSetHashes_Evicts() {
+			FileHashCache testling(2);
+			testling.setHashes("/tmp/1.bin", 1024, 1000, hashes);
+			testling.setHashes("/tmp/2.bin", 1024, 1000, hashes);
+			testling.setHashes("/tmp/3.bin", 1024, 1000, hashes);
+
+			CPPUNIT_ASSERT(!testling.getHashes("/tmp/1.bin", 1024, 1000));
+			CPPUNIT_ASSERT(testling.getHashes("/tmp/3.bin", 1024, 1000));
+		}
+
+	private:
+		JingleFileTransferFileInfo::HashElementMap hashes;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FileHashCacheTest);
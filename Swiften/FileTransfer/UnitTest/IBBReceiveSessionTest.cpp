@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -22,10 +22,12 @@ using namespace Swift;
 class IBBReceiveSessionTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST_SUITE(IBBReceiveSessionTest);
 		CPPUNIT_TEST(testOpen);
+		CPPUNIT_TEST(testOpen_BlockSizeTooLarge);
 		CPPUNIT_TEST(testReceiveData);
 		CPPUNIT_TEST(testReceiveMultipleData);
 		CPPUNIT_TEST(testReceiveDataForOtherSession);
 		CPPUNIT_TEST(testReceiveDataOutOfOrder);
+		CPPUNIT_TEST(testReceiveData_SequenceNumberWrapsAround);
 		CPPUNIT_TEST(testReceiveLastData);
 		CPPUNIT_TEST(testReceiveClose);
 		CPPUNIT_TEST(testStopWhileActive);
@@ -55,6 +57,19 @@ class IBBReceiveSessionTest : public CppUnit::TestFixture {
 			testling->stop();
 		}
 
+		void testOpen_BlockSizeTooLarge() {
+			boost::shared_ptr<IBBReceiveSession> testling(createSession("foo@bar.com/baz", "mysession"));
+			testling->setMaxBlockSize(4096);
+			testling->start();
+			stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBOpen("mysession", 8192), "foo@bar.com/baz", "id-open"));
+
+			CPPUNIT_ASSERT(stanzaChannel->isErrorAtIndex(0, "id-open"));
+			CPPUNIT_ASSERT_EQUAL(ErrorPayload::ResourceConstraint, stanzaChannel->sentStanzas[0]->getPayload<ErrorPayload>()->getCondition());
+			CPPUNIT_ASSERT(!finished);
+
+			testling->stop();
+		}
+
 		void testReceiveData() {
 			boost::shared_ptr<IBBReceiveSession> testling(createSession("foo@bar.com/baz", "mysession"));
 			testling->start();
@@ -155,6 +170,22 @@ class IBBReceiveSessionTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT(!error);
 		}
 
+		void testReceiveData_SequenceNumberWrapsAround() {
+			boost::shared_ptr<IBBReceiveSession> testling(createSession("foo@bar.com/baz", "mysession", 65537));
+			testling->start();
+			stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBOpen("mysession", 0x10), "foo@bar.com/baz", "id-open"));
+
+			for (int i = 0; i <= 65535; ++i) {
+				stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBData("mysession", i, createByteArray("a")), "foo@bar.com/baz", "id-a"));
+			}
+			stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBData("mysession", 0, createByteArray("b")), "foo@bar.com/baz", "id-b"));
+
+			CPPUNIT_ASSERT(stanzaChannel->isResultAtIndex(65537, "id-b"));
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(65537), bytestream->getData().size());
+			CPPUNIT_ASSERT(finished);
+			CPPUNIT_ASSERT(!error);
+		}
+
 	private:
 		IQ::ref createIBBRequest(IBB::ref ibb, const JID& from, const std::string& id) {
 			IQ::ref request = IQ::createRequest(IQ::Set, JID("baz@fum.com/dum"), id, ibb);
@@ -162,8 +193,8 @@ class IBBReceiveSessionTest : public CppUnit::TestFixture {
 			return request;
 		}
 
-		IBBReceiveSession* createSession(const std::string& from, const std::string& id, size_t size = 0x1000) {
-			IBBReceiveSession* session = new IBBReceiveSession(id, JID(from), JID(), size, bytestream, iqRouter);
+		boost::shared_ptr<IBBReceiveSession> createSession(const std::string& from, const std::string& id, size_t size = 0x1000) {
+			boost::shared_ptr<IBBReceiveSession> session = boost::make_shared<IBBReceiveSession>(id, JID(from), JID(), size, bytestream, iqRouter);
 			session->onFinished.connect(boost::bind(&IBBReceiveSessionTest::handleFinished, this, _1));
 			return session;
 		}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -20,6 +20,9 @@ using namespace Swift;
 class IBBSendSessionTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST_SUITE(IBBSendSessionTest);
 		CPPUNIT_TEST(testStart);
+		CPPUNIT_TEST(testStart_BlockSizeIsLimited);
+		CPPUNIT_TEST(testStart_ResourceConstraintRetriesWithSmallerBlockSize);
+		CPPUNIT_TEST(testStart_ResourceConstraintWithMinimumBlockSizeFails);
 		CPPUNIT_TEST(testStart_ResponseStartsSending);
 		CPPUNIT_TEST(testResponseContinuesSending);
 		CPPUNIT_TEST(testRespondToAllFinishes);
@@ -30,6 +33,10 @@ class IBBSendSessionTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testDataStreamResumeAfterPauseSendsData);
 		CPPUNIT_TEST(testDataStreamResumeBeforePauseDoesNotSendData);
 		CPPUNIT_TEST(testDataStreamResumeAfterResumeDoesNotSendData);
+		CPPUNIT_TEST(testWindow_SendsMultipleBlocks);
+		CPPUNIT_TEST(testWindow_ResponseContinuesSending);
+		CPPUNIT_TEST(testWindow_FinishesAfterAllResponses);
+		CPPUNIT_TEST(testWindow_ErrorResponseFinishesOnce);
 
 		CPPUNIT_TEST_SUITE_END();
 
@@ -60,6 +67,39 @@ class IBBSendSessionTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT_EQUAL(std::string("myid"), ibb->getStreamID());
 		}
 
+		void testStart_BlockSizeIsLimited() {
+			boost::shared_ptr<IBBSendSession> testling = createSession("foo@bar.com/baz");
+			testling->setBlockSize(100000);
+
+			testling->start();
+
+			CPPUNIT_ASSERT_EQUAL(65535, stanzaChannel->sentStanzas[0]->getPayload<IBB>()->getBlockSize());
+		}
+
+		void testStart_ResourceConstraintRetriesWithSmallerBlockSize() {
+			boost::shared_ptr<IBBSendSession> testling = createSession("foo@bar.com/baz");
+			testling->setBlockSize(16384);
+			testling->start();
+
+			stanzaChannel->onIQReceived(createIBBError(0, ErrorPayload::ResourceConstraint));
+
+			CPPUNIT_ASSERT(!finished);
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(stanzaChannel->sentStanzas.size()));
+			IBB::ref ibb = stanzaChannel->sentStanzas[1]->getPayload<IBB>();
+			CPPUNIT_ASSERT_EQUAL(IBB::Open, ibb->getAction());
+			CPPUNIT_ASSERT_EQUAL(8192, ibb->getBlockSize());
+		}
+
+		void testStart_ResourceConstraintWithMinimumBlockSizeFails() {
+			boost::shared_ptr<IBBSendSession> testling = createSession("foo@bar.com/baz");
+			testling->start();
+
+			stanzaChannel->onIQReceived(createIBBError(0, ErrorPayload::ResourceConstraint));
+
+			CPPUNIT_ASSERT(finished);
+			CPPUNIT_ASSERT(error);
+		}
+
 		void testStart_ResponseStartsSending() {
 			boost::shared_ptr<IBBSendSession> testling = createSession("foo@bar.com/baz");
 			testling->setBlockSize(3);
@@ -202,7 +242,77 @@ class IBBSendSessionTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT_EQUAL(5, static_cast<int>(stanzaChannel->sentStanzas.size()));
 		}
 
+		void testWindow_SendsMultipleBlocks() {
+			boost::shared_ptr<IBBSendSession> testling = createSession("foo@bar.com/baz");
+			testling->setBlockSize(3);
+			testling->setWindowSize(2);
+			testling->start();
+
+			stanzaChannel->onIQReceived(createIBBResult());
+
+			CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(stanzaChannel->sentStanzas.size()));
+			CPPUNIT_ASSERT(createByteArray("abc") == stanzaChannel->sentStanzas[1]->getPayload<IBB>()->getData());
+			CPPUNIT_ASSERT_EQUAL(0, stanzaChannel->sentStanzas[1]->getPayload<IBB>()->getSequenceNumber());
+			CPPUNIT_ASSERT(createByteArray("def") == stanzaChannel->sentStanzas[2]->getPayload<IBB>()->getData());
+			CPPUNIT_ASSERT_EQUAL(1, stanzaChannel->sentStanzas[2]->getPayload<IBB>()->getSequenceNumber());
+		}
+
+		void testWindow_ResponseContinuesSending() {
+			boost::shared_ptr<IBBSendSession> testling = createSession("foo@bar.com/baz");
+			testling->setBlockSize(3);
+			testling->setWindowSize(2);
+			testling->start();
+			stanzaChannel->onIQReceived(createIBBResult());
+
+			stanzaChannel->onIQReceived(createIBBResult(1));
+
+			CPPUNIT_ASSERT_EQUAL(4, static_cast<int>(stanzaChannel->sentStanzas.size()));
+			CPPUNIT_ASSERT(createByteArray("g") == stanzaChannel->sentStanzas[3]->getPayload<IBB>()->getData());
+			CPPUNIT_ASSERT_EQUAL(2, stanzaChannel->sentStanzas[3]->getPayload<IBB>()->getSequenceNumber());
+		}
+
+		void testWindow_FinishesAfterAllResponses() {
+			boost::shared_ptr<IBBSendSession> testling = createSession("foo@bar.com/baz");
+			testling->setBlockSize(3);
+			testling->setWindowSize(4);
+			testling->start();
+			stanzaChannel->onIQReceived(createIBBResult());
+			CPPUNIT_ASSERT_EQUAL(4, static_cast<int>(stanzaChannel->sentStanzas.size()));
+
+			stanzaChannel->onIQReceived(createIBBResult(1));
+			stanzaChannel->onIQReceived(createIBBResult(2));
+			CPPUNIT_ASSERT(!finished);
+
+			stanzaChannel->onIQReceived(createIBBResult(3));
+			CPPUNIT_ASSERT(finished);
+			CPPUNIT_ASSERT(!error);
+		}
+
+		void testWindow_ErrorResponseFinishesOnce() {
+			boost::shared_ptr<IBBSendSession> testling = createSession("foo@bar.com/baz");
+			testling->setBlockSize(3);
+			testling->setWindowSize(2);
+			testling->start();
+			stanzaChannel->onIQReceived(createIBBResult());
+
+			stanzaChannel->onIQReceived(createIBBError(1, ErrorPayload::NotAcceptable));
+			finished = false;
+			stanzaChannel->onIQReceived(createIBBResult(2));
+
+			CPPUNIT_ASSERT(!finished);
+			CPPUNIT_ASSERT(error);
+			CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(stanzaChannel->sentStanzas.size()));
+		}
+
 	private:
+		IQ::ref createIBBResult(size_t index) {
+			return IQ::createResult(JID("baz@fum.com/dum"), stanzaChannel->sentStanzas[index]->getTo(), stanzaChannel->sentStanzas[index]->getID(), boost::shared_ptr<IBB>());
+		}
+
+		IQ::ref createIBBError(size_t index, ErrorPayload::Condition condition) {
+			return IQ::createError(JID("baz@fum.com/dum"), stanzaChannel->sentStanzas[index]->getTo(), stanzaChannel->sentStanzas[index]->getID(), condition);
+		}
+
 		IQ::ref createIBBResult() {
 			return IQ::createResult(JID("baz@fum.com/dum"), stanzaChannel->sentStanzas[stanzaChannel->sentStanzas.size()-1]->getTo(), stanzaChannel->sentStanzas[stanzaChannel->sentStanzas.size()-1]->getID(), boost::shared_ptr<IBB>());
 		}
@@ -18,6 +18,7 @@
 #include <Swiften/Base/ByteArray.h>
 #include <Swiften/Base/Override.h>
 #include <Swiften/Base/Log.h>
+#include <Swiften/Base/sleep.h>
 #include <Swiften/Client/DummyStanzaChannel.h>
 #include <Swiften/Elements/IBB.h>
 #include <Swiften/Elements/JingleIBBTransportPayload.h>
@@ -51,12 +52,18 @@ class IncomingJingleFileTransferTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST_SUITE(IncomingJingleFileTransferTest);
 		CPPUNIT_TEST(test_AcceptOnyIBBSendsSessionAccept);
 		CPPUNIT_TEST(test_OnlyIBBTransferReceiveWorks);
+		CPPUNIT_TEST(test_AcceptIBBWithLargeBlockSizeLowersBlockSize);
+		CPPUNIT_TEST(test_AcceptWithExistingDataRequestsRange);
+		CPPUNIT_TEST(test_AcceptWithExistingDataWithoutRangeSupportRestarts);
+		CPPUNIT_TEST(test_ReceiveWithWrongHashTerminatesAfterHashesCalculated);
+		CPPUNIT_TEST(test_ResumedReceiveVerifiesHashOfWholeFile);
+		CPPUNIT_TEST(test_AcceptWithUnreadableExistingDataRestarts);
 		//CPPUNIT_TEST(test_AcceptFailingS5BFallsBackToIBB);
 		CPPUNIT_TEST_SUITE_END();
 public:
 		shared_ptr<IncomingJingleFileTransfer> createTestling() {
 			JID ourJID("our@jid.org/full");
-			return boost::make_shared<IncomingJingleFileTransfer>(ourJID, shared_ptr<JingleSession>(session), jingleContentPayload, ftTransporterFactory, timerFactory, crypto.get());
+			return boost::make_shared<IncomingJingleFileTransfer>(ourJID, shared_ptr<JingleSession>(session), jingleContentPayload, ftTransporterFactory, timerFactory, eventLoop, crypto.get());
 		}
 
 		IQ::ref createIBBRequest(IBB::ref ibb, const JID& from, const std::string& id) {
@@ -143,6 +150,144 @@ public:
 			CPPUNIT_ASSERT(createByteArray("abc") == byteStream->getData());
 		}
 
+		void test_AcceptIBBWithLargeBlockSizeLowersBlockSize() {
+			shared_ptr<JingleFileTransferDescription> desc = make_shared<JingleFileTransferDescription>();
+			desc->setFileInfo(JingleFileTransferFileInfo("file.txt", "", 10));
+			jingleContentPayload->addDescription(desc);
+			JingleIBBTransportPayload::ref tpRef = make_shared<JingleIBBTransportPayload>();
+			tpRef->setSessionID("mysession");
+			tpRef->setBlockSize(65535);
+			jingleContentPayload->addTransport(tpRef);
+
+			shared_ptr<IncomingJingleFileTransfer> fileTransfer = createTestling();
+
+			shared_ptr<ByteArrayWriteBytestream> byteStream = make_shared<ByteArrayWriteBytestream>();
+			fileTransfer->accept(byteStream, FileTransferOptions().withMaxInBandBlockSize(4096));
+
+			FakeJingleSession::AcceptCall acceptCall = getCall<FakeJingleSession::AcceptCall>(0);
+			JingleIBBTransportPayload::ref acceptTransport = boost::dynamic_pointer_cast<JingleIBBTransportPayload>(acceptCall.payload);
+			CPPUNIT_ASSERT(acceptTransport);
+			CPPUNIT_ASSERT_EQUAL(4096U, acceptTransport->getBlockSize().get_value_or(0));
+			CPPUNIT_ASSERT_EQUAL(65535U, tpRef->getBlockSize().get_value_or(0));
+
+			stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBOpen("mysession", 65535), "foo@bar.com/baz", "id-open"));
+			CPPUNIT_ASSERT(stanzaChannel->isErrorAtIndex(0, "id-open"));
+		}
+
+		void test_AcceptWithExistingDataRequestsRange() {
+			shared_ptr<JingleFileTransferDescription> desc = make_shared<JingleFileTransferDescription>();
+			JingleFileTransferFileInfo fileInfo("file.txt", "", 7);
+			fileInfo.setSupportsRangeRequests(true);
+			desc->setFileInfo(fileInfo);
+			jingleContentPayload->addDescription(desc);
+			JingleIBBTransportPayload::ref tpRef = make_shared<JingleIBBTransportPayload>();
+			tpRef->setSessionID("mysession");
+			jingleContentPayload->addTransport(tpRef);
+
+			shared_ptr<IncomingJingleFileTransfer> fileTransfer = createTestling();
+
+			shared_ptr<ByteArrayWriteBytestream> byteStream = boost::make_shared<ByteArrayWriteBytestream>(createByteArray("abc"));
+			fileTransfer->accept(byteStream);
+
+			FakeJingleSession::AcceptCall acceptCall = getCall<FakeJingleSession::AcceptCall>(0);
+			JingleFileTransferDescription::ref acceptDescription = boost::dynamic_pointer_cast<JingleFileTransferDescription>(acceptCall.description);
+			CPPUNIT_ASSERT(acceptDescription);
+			CPPUNIT_ASSERT_EQUAL(static_cast<boost::uintmax_t>(3), acceptDescription->getFileInfo().getRangeOffset());
+			CPPUNIT_ASSERT_EQUAL(static_cast<boost::uintmax_t>(0), desc->getFileInfo().getRangeOffset());
+
+			stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBOpen("mysession", 0x10), "foo@bar.com/baz", "id-open"));
+			stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBData("mysession", 0, createByteArray("defg")), "foo@bar.com/baz", "id-a"));
+			CPPUNIT_ASSERT(createByteArray("abcdefg") == byteStream->getData());
+		}
+
+		void test_AcceptWithExistingDataWithoutRangeSupportRestarts() {
+			shared_ptr<JingleFileTransferDescription> desc = make_shared<JingleFileTransferDescription>();
+			desc->setFileInfo(JingleFileTransferFileInfo("file.txt", "", 7));
+			jingleContentPayload->addDescription(desc);
+			JingleIBBTransportPayload::ref tpRef = make_shared<JingleIBBTransportPayload>();
+			tpRef->setSessionID("mysession");
+			jingleContentPayload->addTransport(tpRef);
+
+			shared_ptr<IncomingJingleFileTransfer> fileTransfer = createTestling();
+
+			shared_ptr<ByteArrayWriteBytestream> byteStream = boost::make_shared<ByteArrayWriteBytestream>(createByteArray("abc"));
+			fileTransfer->accept(byteStream);
+
+			FakeJingleSession::AcceptCall acceptCall = getCall<FakeJingleSession::AcceptCall>(0);
+			JingleFileTransferDescription::ref acceptDescription = boost::dynamic_pointer_cast<JingleFileTransferDescription>(acceptCall.description);
+			CPPUNIT_ASSERT(acceptDescription);
+			CPPUNIT_ASSERT_EQUAL(static_cast<boost::uintmax_t>(0), acceptDescription->getFileInfo().getRangeOffset());
+			CPPUNIT_ASSERT(byteStream->getData().empty());
+		}
+
+		void test_ReceiveWithWrongHashTerminatesAfterHashesCalculated() {
+			shared_ptr<JingleFileTransferDescription> desc = make_shared<JingleFileTransferDescription>();
+			JingleFileTransferFileInfo fileInfo("file.txt", "", 3);
+			fileInfo.addHash(HashElement("sha-1", crypto->getSHA1Hash(createByteArray("abd"))));
+			desc->setFileInfo(fileInfo);
+			jingleContentPayload->addDescription(desc);
+			JingleIBBTransportPayload::ref tpRef = make_shared<JingleIBBTransportPayload>();
+			tpRef->setSessionID("mysession");
+			jingleContentPayload->addTransport(tpRef);
+
+			shared_ptr<IncomingJingleFileTransfer> fileTransfer = createTestling();
+			shared_ptr<ByteArrayWriteBytestream> byteStream = make_shared<ByteArrayWriteBytestream>();
+			fileTransfer->accept(byteStream);
+
+			stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBOpen("mysession", 0x10), "foo@bar.com/baz", "id-open"));
+			stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBData("mysession", 0, createByteArray("abc")), "foo@bar.com/baz", "id-a"));
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), session->calledCommands.size());
+
+			waitForCalls(2);
+
+			FakeJingleSession::TerminateCall terminateCall = getCall<FakeJingleSession::TerminateCall>(1);
+			CPPUNIT_ASSERT_EQUAL(JinglePayload::Reason::MediaError, terminateCall.reason);
+		}
+
+		void test_ResumedReceiveVerifiesHashOfWholeFile() {
+			shared_ptr<JingleFileTransferDescription> desc = make_shared<JingleFileTransferDescription>();
+			JingleFileTransferFileInfo fileInfo("file.txt", "", 7);
+			fileInfo.setSupportsRangeRequests(true);
+			fileInfo.addHash(HashElement("sha-1", crypto->getSHA1Hash(createByteArray("abcdefg"))));
+			desc->setFileInfo(fileInfo);
+			jingleContentPayload->addDescription(desc);
+			JingleIBBTransportPayload::ref tpRef = make_shared<JingleIBBTransportPayload>();
+			tpRef->setSessionID("mysession");
+			jingleContentPayload->addTransport(tpRef);
+
+			shared_ptr<IncomingJingleFileTransfer> fileTransfer = createTestling();
+			shared_ptr<ByteArrayWriteBytestream> byteStream = boost::make_shared<ByteArrayWriteBytestream>(createByteArray("abc"));
+			fileTransfer->accept(byteStream);
+
+			stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBOpen("mysession", 0x10), "foo@bar.com/baz", "id-open"));
+			stanzaChannel->onIQReceived(createIBBRequest(IBB::createIBBData("mysession", 0, createByteArray("defg")), "foo@bar.com/baz", "id-a"));
+			waitForCalls(2);
+
+			FakeJingleSession::TerminateCall terminateCall = getCall<FakeJingleSession::TerminateCall>(1);
+			CPPUNIT_ASSERT_EQUAL(JinglePayload::Reason::Success, terminateCall.reason);
+		}
+
+		void test_AcceptWithUnreadableExistingDataRestarts() {
+			shared_ptr<JingleFileTransferDescription> desc = make_shared<JingleFileTransferDescription>();
+			JingleFileTransferFileInfo fileInfo("file.txt", "", 7);
+			fileInfo.setSupportsRangeRequests(true);
+			desc->setFileInfo(fileInfo);
+			jingleContentPayload->addDescription(desc);
+			JingleIBBTransportPayload::ref tpRef = make_shared<JingleIBBTransportPayload>();
+			tpRef->setSessionID("mysession");
+			jingleContentPayload->addTransport(tpRef);
+
+			shared_ptr<IncomingJingleFileTransfer> fileTransfer = createTestling();
+			shared_ptr<UnreadableWriteBytestream> byteStream = boost::make_shared<UnreadableWriteBytestream>(createByteArray("abc"));
+			fileTransfer->accept(byteStream);
+
+			FakeJingleSession::AcceptCall acceptCall = getCall<FakeJingleSession::AcceptCall>(0);
+			JingleFileTransferDescription::ref acceptDescription = boost::dynamic_pointer_cast<JingleFileTransferDescription>(acceptCall.description);
+			CPPUNIT_ASSERT(acceptDescription);
+			CPPUNIT_ASSERT_EQUAL(static_cast<boost::uintmax_t>(0), acceptDescription->getFileInfo().getRangeOffset());
+			CPPUNIT_ASSERT(byteStream->getData().empty());
+		}
+
 		void test_AcceptFailingS5BFallsBackToIBB() {
 			//1. create your test incoming file transfer
 			addFileTransferDescription();
@@ -184,6 +329,23 @@ public:
 		}
 #endif
 private:
+	class UnreadableWriteBytestream : public ByteArrayWriteBytestream {
+		public:
+			UnreadableWriteBytestream(const std::vector<unsigned char>& data) : ByteArrayWriteBytestream(data) {
+			}
+
+			virtual boost::shared_ptr<ReadBytestream> createExistingDataReadBytestream() const SWIFTEN_OVERRIDE {
+				return boost::shared_ptr<ReadBytestream>();
+			}
+	};
+
+	void waitForCalls(size_t count) {
+		for (int i = 0; i < 500 && session->calledCommands.size() < count; ++i) {
+			Swift::sleep(10);
+			eventLoop->processEvents();
+		}
+	}
+
 	void addFileTransferDescription() {
 		shared_ptr<JingleFileTransferDescription> desc = make_shared<JingleFileTransferDescription>();
 		desc->setFileInfo(JingleFileTransferFileInfo("file.txt", "", 10));
@@ -217,7 +379,7 @@ private:
 	}
 
 private:
-	EventLoop* eventLoop;
+	DummyEventLoop* eventLoop;
 	boost::shared_ptr<CryptoProvider> crypto;
 	boost::shared_ptr<FakeJingleSession> session;
 	shared_ptr<JingleContentPayload> jingleContentPayload;
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <QA/Checker/IO.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <Swiften/Base/ByteArray.h>
+#include <Swiften/Base/sleep.h>
+#include <Swiften/Crypto/CryptoProvider.h>
+#include <Swiften/Crypto/PlatformCryptoProvider.h>
+#include <Swiften/EventLoop/DummyEventLoop.h>
+#include <Swiften/FileTransfer/IncrementalBytestreamHashCalculator.h>
+
+using namespace Swift;
+
+class IncrementalBytestreamHashCalculatorTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(IncrementalBytestreamHashCalculatorTest);
+		CPPUNIT_TEST(testGetHashes);
+		CPPUNIT_TEST(testGetHashes_NoData);
+		CPPUNIT_TEST(testGetHashes_ManyChunks);
+		CPPUNIT_TEST(testGetHash_Twice);
+		CPPUNIT_TEST(testFinish_EmitsHashesCalculatedOnEventLoop);
+		CPPUNIT_TEST(testFinish_NoHashes);
+		CPPUNIT_TEST(testDestructor_PendingData);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void setUp() {
+			crypto = boost::shared_ptr<CryptoProvider>(PlatformCryptoProvider::create());
+			eventLoop = new DummyEventLoop();
+			hashesCalculated = 0;
+		}
+
+		void tearDown() {
+			delete eventLoop;
+		}
+
+		void testGetHashes() {
+			IncrementalBytestreamHashCalculator testling(true, true, true, crypto.get(), eventLoop);
+
+			testling.feedData(createByteArray("a"));
+			testling.feedData(createByteArray("bc"));
+			finish(testling);
+
+			CPPUNIT_ASSERT_EQUAL(std::string("900150983cd24fb0d6963f7d28e17f72"), testling.getMD5String());
+			CPPUNIT_ASSERT_EQUAL(std::string("a9993e364706816aba3e25717850c26c9cd0d89d"), testling.getSHA1String());
+			CPPUNIT_ASSERT_EQUAL(std::string("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"), testling.getSHA256String());
+		}
+
+		void testGetHashes_NoData() {
+			IncrementalBytestreamHashCalculator testling(true, true, false, crypto.get(), eventLoop);
+			finish(testling);
+
+			CPPUNIT_ASSERT_EQUAL(std::string("d41d8cd98f00b204e9800998ecf8427e"), testling.getMD5String());
+			CPPUNIT_ASSERT_EQUAL(std::string("da39a3ee5e6b4b0d3255bfef95601890afd80709"), testling.getSHA1String());
+		}
+
+		void testGetHashes_ManyChunks() {
+			IncrementalBytestreamHashCalculator testling(true, true, true, crypto.get(), eventLoop);
+
+			ByteArray data;
+			for (int i = 0; i < 1000; ++i) {
+				ByteArray chunk(4096, static_cast<unsigned char>(i));
+				data.insert(data.end(), chunk.begin(), chunk.end());
+				testling.feedData(chunk);
+			}
+			finish(testling);
+
+			CPPUNIT_ASSERT_EQUAL(crypto->getMD5Hash(data), testling.getMD5Hash());
+			CPPUNIT_ASSERT_EQUAL(crypto->getSHA1Hash(data), testling.getSHA1Hash());
+			CPPUNIT_ASSERT_EQUAL(crypto->getSHA256Hash(data), testling.getSHA256Hash());
+		}
+
+		void testGetHash_Twice() {
+			IncrementalBytestreamHashCalculator testling(false, true, false, crypto.get(), eventLoop);
+			testling.feedData(createByteArray("abc"));
+			finish(testling);
+
+			ByteArray hash = testling.getSHA1Hash();
+
+			CPPUNIT_ASSERT_EQUAL(hash, testling.getSHA1Hash());
+		}
+
+		void testFinish_EmitsHashesCalculatedOnEventLoop() {
+			IncrementalBytestreamHashCalculator testling(false, true, true, crypto.get(), eventLoop);
+			testling.onHashesCalculated.connect(boost::bind(&IncrementalBytestreamHashCalculatorTest::handleHashesCalculated, this));
+			testling.feedData(createByteArray("abc"));
+
+			testling.finish();
+			CPPUNIT_ASSERT_EQUAL(0, hashesCalculated);
+			waitUntilFinished(testling);
+
+			CPPUNIT_ASSERT_EQUAL(1, hashesCalculated);
+			CPPUNIT_ASSERT_EQUAL(std::string("a9993e364706816aba3e25717850c26c9cd0d89d"), testling.getSHA1String());
+		}
+
+		void testFinish_NoHashes() {
+			IncrementalBytestreamHashCalculator testling(false, false, false, crypto.get(), eventLoop);
+			testling.onHashesCalculated.connect(boost::bind(&IncrementalBytestreamHashCalculatorTest::handleHashesCalculated, this));
+			testling.feedData(createByteArray("abc"));
+
+			testling.finish();
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, hashesCalculated);
+			CPPUNIT_ASSERT(testling.isFinished());
+		}
+
+		void testDestructor_PendingData() {
+			IncrementalBytestreamHashCalculator* testling = new IncrementalBytestreamHashCalculator(true, true, true, crypto.get(), eventLoop);
+			for (int i = 0; i < 100; ++i) {
+				testling->feedData(ByteArray(65536, 'x'));
+			}
+
+			testling->finish();
+
+			delete testling;
+			eventLoop->processEvents();
+		}
+
+	private:
+		void finish(IncrementalBytestreamHashCalculator& testling) {
+			testling.finish();
+			waitUntilFinished(testling);
+		}
+
+		void waitUntilFinished(IncrementalBytestreamHashCalculator& testling) {
+			for (int i = 0; i < 500 && !testling.isFinished(); ++i) {
+				Swift::sleep(10);
+				eventLoop->processEvents();
+			}
+			CPPUNIT_ASSERT(testling.isFinished());
+		}
+
+		void handleHashesCalculated() {
+			++hashesCalculated;
+		}
+
+	private:
+		boost::shared_ptr<CryptoProvider> crypto;
+		DummyEventLoop* eventLoop;
+		int hashesCalculated;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(IncrementalBytestreamHashCalculatorTest);
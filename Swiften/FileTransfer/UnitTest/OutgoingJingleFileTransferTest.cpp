@@ -10,6 +10,8 @@
  * See the COPYING file for more information.
  */
 
+#include <QA/Checker/IO.h>
+
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
 
@@ -54,7 +56,10 @@ using namespace Swift;
 class OutgoingJingleFileTransferTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST_SUITE(OutgoingJingleFileTransferTest);
 		CPPUNIT_TEST(test_SendSessionInitiateOnStart);
+		CPPUNIT_TEST(test_SendSessionInitiateOnStart_KnownHash);
 		CPPUNIT_TEST(test_FallbackToIBBAfterFailingS5B);
+		CPPUNIT_TEST(test_SessionAcceptWithRangeOffsetSeeksStream);
+		CPPUNIT_TEST(test_SessionAcceptWithInvalidRangeOffsetTerminates);
 		CPPUNIT_TEST(test_ReceiveSessionTerminateAfterSessionInitiate);
 		CPPUNIT_TEST_SUITE_END();
 
@@ -69,12 +74,12 @@ class OutgoingJingleFileTransferTest : public CppUnit::TestFixture {
 		};
 public:
 
-		boost::shared_ptr<OutgoingJingleFileTransfer> createTestling() {
+		boost::shared_ptr<OutgoingJingleFileTransfer> createTestling(const ByteArray& sha1Hash = ByteArray()) {
 			JID to("test@foo.com/bla");
 			JingleFileTransferFileInfo fileInfo;
 			fileInfo.setDescription("some file");
 			fileInfo.setName("test.bin");
-			fileInfo.addHash(HashElement("sha-1", ByteArray()));
+			fileInfo.addHash(HashElement("sha-1", sha1Hash));
 			fileInfo.setSize(1024 * 1024);
 			return boost::shared_ptr<OutgoingJingleFileTransfer>(new OutgoingJingleFileTransfer(
 				to,
@@ -82,6 +87,7 @@ public:
 				stream,
 				ftTransportFactory,
 				timerFactory,
+				eventLoop,
 				idGen,
 				fileInfo,
 				FileTransferOptions().withAssistedAllowed(false).withDirectAllowed(false).withProxiedAllowed(false),
@@ -143,10 +149,23 @@ public:
 			JingleFileTransferDescription::ref description = boost::dynamic_pointer_cast<JingleFileTransferDescription>(call.description);
 			CPPUNIT_ASSERT(description);
 			CPPUNIT_ASSERT(static_cast<size_t>(1048576) == description->getFileInfo().getSize());
+			CPPUNIT_ASSERT(description->getFileInfo().getSupportsRangeRequests());
 
 			JingleS5BTransportPayload::ref transport = boost::dynamic_pointer_cast<JingleS5BTransportPayload>(call.payload);
 			CPPUNIT_ASSERT(transport);
 		}
+
+		void test_SendSessionInitiateOnStart_KnownHash() {
+			boost::shared_ptr<OutgoingJingleFileTransfer> transfer = createTestling(createByteArray("known"));
+			transfer->start();
+
+			FakeJingleSession::InitiateCall call = getCall<FakeJingleSession::InitiateCall>(0);
+			JingleFileTransferDescription::ref description = boost::dynamic_pointer_cast<JingleFileTransferDescription>(call.description);
+			CPPUNIT_ASSERT(description);
+			CPPUNIT_ASSERT_EQUAL(createByteArray("known"), description->getFileInfo().getHash("sha-1").get());
+			CPPUNIT_ASSERT_EQUAL(ByteArray(), description->getFileInfo().getHash("md5").get());
+			CPPUNIT_ASSERT_EQUAL(ByteArray(), description->getFileInfo().getHash("sha-256").get());
+		}
 		
 		void test_FallbackToIBBAfterFailingS5B() {
 			boost::shared_ptr<OutgoingJingleFileTransfer> transfer = createTestling();
@@ -176,6 +195,27 @@ public:
 			CPPUNIT_ASSERT_EQUAL(IBB::Open, ibbOpen->getAction());
 		}
 		
+		void test_SessionAcceptWithRangeOffsetSeeksStream() {
+			boost::shared_ptr<OutgoingJingleFileTransfer> transfer = createTestling();
+			transfer->start();
+
+			FakeJingleSession::InitiateCall call = getCall<FakeJingleSession::InitiateCall>(0);
+			fakeJingleSession->handleSessionAcceptReceived(call.id, createRangeDescription(call.description, 1024 * 1024 - 10), call.payload);
+
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(10), stream->read(100)->size());
+		}
+
+		void test_SessionAcceptWithInvalidRangeOffsetTerminates() {
+			boost::shared_ptr<OutgoingJingleFileTransfer> transfer = createTestling();
+			transfer->start();
+
+			FakeJingleSession::InitiateCall call = getCall<FakeJingleSession::InitiateCall>(0);
+			fakeJingleSession->handleSessionAcceptReceived(call.id, createRangeDescription(call.description, 1024 * 1024 + 1), call.payload);
+
+			FakeJingleSession::TerminateCall terminateCall = getCall<FakeJingleSession::TerminateCall>(1);
+			CPPUNIT_ASSERT(JinglePayload::Reason::MediaError == terminateCall.reason);
+		}
+
 		void test_ReceiveSessionTerminateAfterSessionInitiate() {
 			boost::shared_ptr<OutgoingJingleFileTransfer> transfer = createTestling();
 			transfer->start();
@@ -194,6 +234,15 @@ public:
 //TODO: some more testcases
 
 private:
+	JingleDescription::ref createRangeDescription(JingleDescription::ref offer, boost::uintmax_t offset) {
+		JingleFileTransferDescription::ref description = boost::make_shared<JingleFileTransferDescription>(
+				*boost::dynamic_pointer_cast<JingleFileTransferDescription>(offer));
+		JingleFileTransferFileInfo fileInfo = description->getFileInfo();
+		fileInfo.setRangeOffset(offset);
+		description->setFileInfo(fileInfo);
+		return description;
+	}
+
 	void addFileTransferDescription() {
 		boost::shared_ptr<JingleFileTransferDescription> desc = boost::make_shared<JingleFileTransferDescription>();
 		desc->setFileInfo(JingleFileTransferFileInfo());
@@ -1,14 +1,30 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/FileTransfer/WriteBytestream.h>
 
+#include <cassert>
+
+#include <Swiften/FileTransfer/ReadBytestream.h>
+
 namespace Swift {
 
 WriteBytestream::~WriteBytestream() {
 }
 
+boost::uintmax_t WriteBytestream::getExistingSize() const {
+	return 0;
+}
+
+void WriteBytestream::setWriteOffset(boost::uintmax_t offset) {
+	assert(offset == 0);
+}
+
+boost::shared_ptr<ReadBytestream> WriteBytestream::createExistingDataReadBytestream() const {
+	return boost::shared_ptr<ReadBytestream>();
+}
+
 }
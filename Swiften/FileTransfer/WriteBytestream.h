@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,12 +7,15 @@
 #pragma once
 
 #include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
 #include <vector>
 
 #include <Swiften/Base/API.h>
 #include <Swiften/Base/boost_bsignals.h>
 
 namespace Swift {
+	class ReadBytestream;
+
 	class SWIFTEN_API WriteBytestream {
 		public:
 			typedef boost::shared_ptr<WriteBytestream> ref;
@@ -21,6 +24,29 @@ namespace Swift {
 
 			virtual void write(const std::vector<unsigned char>&) = 0;
 
+			/**
+			 * Returns the size of the data the stream already holds, e.g. from
+			 * an earlier, interrupted transfer.
+			 */
+			virtual boost::uintmax_t getExistingSize() const;
+
+			/**
+			 * Makes writing continue at the given offset, keeping the existing
+			 * data before it and discarding the rest.
+			 *
+			 * The offset must not be larger than getExistingSize(), and this
+			 * must be called before anything is written.
+			 */
+			virtual void setWriteOffset(boost::uintmax_t offset);
+
+			/**
+			 * Returns a stream that reads the data the stream already holds, or
+			 * a null pointer if that data can't be read back.
+			 *
+			 * This must be called before anything is written.
+			 */
+			virtual boost::shared_ptr<ReadBytestream> createExistingDataReadBytestream() const;
+
 			boost::signal<void (const std::vector<unsigned char>&)> onWrite;
 	};
 }
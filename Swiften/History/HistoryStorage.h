@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -29,5 +29,15 @@ namespace Swift {
 			virtual std::vector<HistoryMessage> getMessagesFromPreviousDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const = 0;
 			virtual ContactsMap getContacts(const JID& selfJID, HistoryMessage::Type type, const std::string& keyword) const = 0;
 			virtual boost::posix_time::ptime getLastTimeStampFromMUC(const JID& selfJID, const JID& mucJID) const = 0;
+
+			/**
+			 * Returns the messages of the given type sent or received by selfJID
+			 * that contain all words of the keywords, most relevant first.
+			 *
+			 * Keywords match words starting with them, so "hel" matches "hello".
+			 * At most limit messages are returned, after skipping the first offset
+			 * matches.
+			 */
+			virtual std::vector<HistoryMessage> searchMessages(const JID& selfJID, HistoryMessage::Type type, const std::string& keywords, int offset, int limit) const = 0;
 	};
 }
@@ -1,156 +1,454 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
+#include <Swiften/History/SQLiteHistoryStorage.h>
+
+#include <algorithm>
+#include <cctype>
 #include <iostream>
+#include <map>
+#include <set>
+#include <boost/bind.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/numeric/conversion/cast.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
 
 #include <sqlite3.h>
-#include <Swiften/History/SQLiteHistoryStorage.h>
-#include <boost/date_time/gregorian/gregorian.hpp>
+#include <Swiften/Base/foreach.h>
 #include <Swiften/Base/Path.h>
 
-inline std::string getEscapedString(const std::string& s) {
-	std::string result(s);
+namespace {
+	/**
+	 * Resets a cached statement when it goes out of scope, so it can be reused.
+	 */
+	class ScopedStatement {
+		public:
+			ScopedStatement(sqlite3_stmt* statement) : statement_(statement) {
+			}
+
+			~ScopedStatement() {
+				if (statement_) {
+					sqlite3_reset(statement_);
+					sqlite3_clear_bindings(statement_);
+				}
+			}
 
-	size_t pos = result.find('\'');
-	while (pos != std::string::npos) {
-		result.insert(pos, "'");
-		pos = result.find('\'', pos + 2);
+			operator sqlite3_stmt*() const {
+				return statement_;
+			}
+
+		private:
+			sqlite3_stmt* statement_;
+	};
+
+	int getSecondsSinceEpoch(const boost::posix_time::ptime& time) {
+		return (time - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_seconds();
 	}
-	return result;
-}
 
-namespace Swift {
+	boost::posix_time::ptime getTimeFromSecondsSinceEpoch(int secondsSinceEpoch) {
+		return boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1), boost::posix_time::seconds(secondsSinceEpoch));
+	}
 
-SQLiteHistoryStorage::SQLiteHistoryStorage(const boost::filesystem::path& file) : db_(0) {
-	thread_ = new boost::thread(boost::bind(&SQLiteHistoryStorage::run, this));
+	void bindText(sqlite3_stmt* statement, int index, const std::string& value) {
+		sqlite3_bind_text(statement, index, value.c_str(), boost::numeric_cast<int>(value.size()), SQLITE_TRANSIENT);
+	}
 
-	sqlite3_open(pathToString(file).c_str(), &db_);
-	if (!db_) {
-		std::cerr << "Error opening database " << pathToString(file) << std::endl;
+	std::string getColumnText(sqlite3_stmt* statement, int column) {
+		const unsigned char* text = sqlite3_column_text(statement, column);
+		return text ? std::string(reinterpret_cast<const char*>(text)) : std::string();
 	}
 
-	char* errorMessage;
-	int result = sqlite3_exec(db_, "CREATE TABLE IF NOT EXISTS messages('message' STRING, 'fromBare' INTEGER, 'fromResource' STRING, 'toBare' INTEGER, 'toResource' STRING, 'type' INTEGER, 'time' INTEGER, 'offset' INTEGER)", 0, 0, &errorMessage);
-	if (result != SQLITE_OK) {
-		std::cerr << "SQL Error: " << errorMessage << std::endl;
-		sqlite3_free(errorMessage);
+	/**
+	 * Returns the condition matching the messages exchanged between the JIDs
+	 * bound to ?1 (self) and ?2 (contact). If matchResource is set, the
+	 * contact resource bound to ?3 is matched as well.
+	 */
+	std::string getConversationCondition(bool matchResource) {
+		if (matchResource) {
+			return "((fromBare=?1 AND toBare=?2 AND toResource=?3) OR (fromBare=?2 AND fromResource=?3 AND toBare=?1))";
+		}
+		else {
+			return "((fromBare=?1 AND toBare=?2) OR (fromBare=?2 AND toBare=?1))";
+		}
 	}
 
-	result = sqlite3_exec(db_, "CREATE TABLE IF NOT EXISTS jids('id' INTEGER PRIMARY KEY ASC AUTOINCREMENT, 'jid' STRING UNIQUE NOT NULL)", 0, 0, &errorMessage);
-	if (result != SQLITE_OK) {
-		std::cerr << "SQL Error: " << errorMessage << std::endl;
-		sqlite3_free(errorMessage);
+	/**
+	 * Splits text into lowercase words for the search index. Non-ASCII bytes
+	 * are treated as word characters, so UTF-8 sequences are kept intact.
+	 */
+	std::vector<std::string> getWords(const std::string& text) {
+		std::vector<std::string> result;
+		std::string word;
+		for (size_t i = 0; i <= text.size(); ++i) {
+			unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : 0;
+			if (c >= 0x80 || std::isalnum(c)) {
+				word += static_cast<char>(c < 0x80 ? std::tolower(c) : c);
+			}
+			else if (!word.empty()) {
+				result.push_back(word);
+				word.clear();
+			}
+		}
+		return result;
+	}
+
+	/**
+	 * Returns the distinct words of a search query.
+	 */
+	std::vector<std::string> getSearchWords(const std::string& keywords) {
+		static const size_t maxSearchWords = 16;
+		std::vector<std::string> words = getWords(keywords);
+		std::set<std::string> uniqueWords(words.begin(), words.end());
+		std::vector<std::string> result(uniqueWords.begin(), uniqueWords.end());
+		if (result.size() > maxSearchWords) {
+			result.resize(maxSearchWords);
+		}
+		return result;
+	}
+
+	/**
+	 * Returns the condition matching indexed words starting with the search
+	 * word whose bounds are bound to parameter and parameter + 1.
+	 */
+	std::string getWordCondition(int parameter) {
+		return "word>=?" + boost::lexical_cast<std::string>(parameter) + " AND word<?" + boost::lexical_cast<std::string>(parameter + 1);
+	}
+
+	/**
+	 * Returns the condition matching the messages containing all search words,
+	 * bound with bindSearchWords() starting at firstParameter.
+	 */
+	std::string getSearchCondition(size_t wordCount, int firstParameter) {
+		std::string result = "messages.rowid IN (";
+		for (size_t i = 0; i < wordCount; ++i) {
+			if (i > 0) {
+				result += " INTERSECT ";
+			}
+			result += "SELECT message FROM words WHERE " + getWordCondition(firstParameter + 2 * static_cast<int>(i));
+		}
+		return result + ")";
+	}
+
+	void bindSearchWords(sqlite3_stmt* statement, const std::vector<std::string>& words, int firstParameter) {
+		for (size_t i = 0; i < words.size(); ++i) {
+			int parameter = firstParameter + 2 * static_cast<int>(i);
+			bindText(statement, parameter, words[i]);
+			// Words never contain 0xff, so this is an upper bound for all words
+			// starting with the search word.
+			bindText(statement, parameter + 1, words[i] + '\xff');
+		}
 	}
 }
 
+namespace Swift {
+
+SQLiteHistoryStorage::SQLiteHistoryStorage(const boost::filesystem::path& file) : db_(0), indexingBacklog_(true), writing_(false), stopRequested_(false) {
+	if (sqlite3_open(pathToString(file).c_str(), &db_) != SQLITE_OK) {
+		std::cerr << "Error opening database " << pathToString(file) << ": " << (db_ ? sqlite3_errmsg(db_) : "out of memory") << std::endl;
+		sqlite3_close(db_);
+		db_ = 0;
+	}
+
+	// Write-ahead logging needs SQLite 3.7.0 or newer. Older versions, such
+	// as the bundled 3.6.14, ignore this and keep their default journal.
+	execute("PRAGMA journal_mode=WAL");
+	execute("PRAGMA synchronous=NORMAL");
+	execute("CREATE TABLE IF NOT EXISTS messages('message' STRING, 'fromBare' INTEGER, 'fromResource' STRING, 'toBare' INTEGER, 'toResource' STRING, 'type' INTEGER, 'time' INTEGER, 'offset' INTEGER)");
+	execute("CREATE TABLE IF NOT EXISTS jids('id' INTEGER PRIMARY KEY ASC AUTOINCREMENT, 'jid' STRING UNIQUE NOT NULL)");
+	execute("CREATE INDEX IF NOT EXISTS messages_from_to ON messages('type', 'fromBare', 'toBare', 'time')");
+	execute("CREATE INDEX IF NOT EXISTS messages_to ON messages('type', 'toBare', 'time')");
+	execute("CREATE TABLE IF NOT EXISTS words('word' TEXT NOT NULL, 'message' INTEGER NOT NULL, 'count' INTEGER)");
+	execute("CREATE INDEX IF NOT EXISTS words_word ON words('word', 'message')");
+
+	thread_ = new boost::thread(boost::bind(&SQLiteHistoryStorage::run, this));
+}
+
 SQLiteHistoryStorage::~SQLiteHistoryStorage() {
-	sqlite3_close(db_);
+	{
+		boost::lock_guard<boost::mutex> lock(queueMutex_);
+		stopRequested_ = true;
+	}
+	queueNonEmpty_.notify_one();
+	thread_->join();
 	delete thread_;
+
+	for (std::map<std::string, sqlite3_stmt*>::const_iterator i = statements_.begin(); i != statements_.end(); ++i) {
+		sqlite3_finalize(i->second);
+	}
+	sqlite3_close(db_);
 }
 
-void SQLiteHistoryStorage::addMessage(const HistoryMessage& message) {
-	int secondsSinceEpoch = (message.getTime() - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_seconds();
-
-	std::string statement = std::string("INSERT INTO messages('message', 'fromBare', 'fromResource', 'toBare', 'toResource', 'type', 'time', 'offset') VALUES(") +
-					"'" + getEscapedString(message.getMessage()) + "', " +
-					boost::lexical_cast<std::string>(getIDForJID(message.getFromJID().toBare())) + ", '" +
-					getEscapedString(message.getFromJID().getResource()) + "', " +
-					boost::lexical_cast<std::string>(getIDForJID(message.getToJID().toBare())) + ", '" +
-					getEscapedString(message.getToJID().getResource()) + "', " +
-					boost::lexical_cast<std::string>(message.getType()) + ", " +
-					boost::lexical_cast<std::string>(secondsSinceEpoch) + ", " +
-					boost::lexical_cast<std::string>(message.getOffset()) + ")";
+bool SQLiteHistoryStorage::isOpen() const {
+	return db_ != 0;
+}
+
+void SQLiteHistoryStorage::execute(const char* statement) {
+	if (!db_) {
+		return;
+	}
 	char* errorMessage;
-	int result = sqlite3_exec(db_, statement.c_str(), 0, 0, &errorMessage);
+	int result = sqlite3_exec(db_, statement, 0, 0, &errorMessage);
 	if (result != SQLITE_OK) {
 		std::cerr << "SQL Error: " << errorMessage << std::endl;
 		sqlite3_free(errorMessage);
 	}
 }
 
-std::vector<HistoryMessage> SQLiteHistoryStorage::getMessagesFromDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const {
-	sqlite3_stmt* selectStatement;
-
-	boost::optional<long long> selfID = getIDFromJID(selfJID.toBare());
-	boost::optional<long long> contactID = getIDFromJID(contactJID.toBare());
+sqlite3_stmt* SQLiteHistoryStorage::getStatement(const std::string& query) const {
+	std::map<std::string, sqlite3_stmt*>::const_iterator i = statements_.find(query);
+	if (i != statements_.end()) {
+		return i->second;
+	}
+	if (!db_) {
+		return NULL;
+	}
+	sqlite3_stmt* statement = NULL;
+	int r = sqlite3_prepare_v2(db_, query.c_str(), boost::numeric_cast<int>(query.size()), &statement, NULL);
+	if (r != SQLITE_OK) {
+		std::cerr << "Error: " << sqlite3_errmsg(db_) << std::endl;
+		return NULL;
+	}
+	statements_[query] = statement;
+	return statement;
+}
 
-	if (!selfID || !contactID) {
-		// JIDs missing from the database
-		return std::vector<HistoryMessage>();
+void SQLiteHistoryStorage::addMessage(const HistoryMessage& message) {
+	if (!db_) {
+		return;
+	}
+	{
+		boost::lock_guard<boost::mutex> lock(queueMutex_);
+		queue_.push_back(message);
 	}
+	queueNonEmpty_.notify_one();
+}
 
-	std::string selectQuery = "SELECT * FROM messages WHERE (type=" + boost::lexical_cast<std::string>(type);
-	if (contactJID.isBare()) {
-		// match only bare jid
-		selectQuery += " AND ((fromBare=" + boost::lexical_cast<std::string>(*selfID) + " AND toBare=" +
-				boost::lexical_cast<std::string>(*contactID) + ") OR (fromBare=" +
-				boost::lexical_cast<std::string>(*contactID) + " AND toBare=" + boost::lexical_cast<std::string>(*selfID) + ")))";
+void SQLiteHistoryStorage::flush() const {
+	boost::unique_lock<boost::mutex> lock(queueMutex_);
+	while (!queue_.empty() || writing_) {
+		queueFlushed_.wait(lock);
 	}
-	else {
-		// match resource too
-		selectQuery += " AND ((fromBare=" + boost::lexical_cast<std::string>(*selfID) + " AND (toBare=" +
-				boost::lexical_cast<std::string>(*contactID) +" AND toResource='" +
-				getEscapedString(contactJID.getResource()) + "')) OR ((fromBare=" +
-				boost::lexical_cast<std::string>(*contactID) + " AND fromResource='" +
-				getEscapedString(contactJID.getResource()) + "') AND toBare=" +
-				boost::lexical_cast<std::string>(*selfID) + ")))";
+}
+
+void SQLiteHistoryStorage::run() {
+	std::vector<HistoryMessage> messages;
+	while (true) {
+		// Older messages are indexed one batch at a time between writes, so
+		// that neither writes nor queries wait for the whole backlog.
+		if (indexingBacklog_) {
+			boost::lock_guard<boost::mutex> lock(dbMutex_);
+			indexingBacklog_ = indexNextBatch();
+		}
+
+		{
+			boost::unique_lock<boost::mutex> lock(queueMutex_);
+			while (queue_.empty() && !stopRequested_ && !indexingBacklog_) {
+				queueNonEmpty_.wait(lock);
+			}
+			if (queue_.empty() && stopRequested_) {
+				return;
+			}
+			// Everything that was queued while the previous batch was being
+			// written goes into the next transaction.
+			messages.swap(queue_);
+			writing_ = !messages.empty();
+		}
+
+		if (!messages.empty()) {
+			{
+				boost::lock_guard<boost::mutex> lock(dbMutex_);
+				writeMessages(messages);
+			}
+			messages.clear();
+
+			{
+				boost::lock_guard<boost::mutex> lock(queueMutex_);
+				writing_ = false;
+			}
+			queueFlushed_.notify_all();
+		}
 	}
+}
 
-	if (!date.is_not_a_date()) {
-		int lowerBound = (boost::posix_time::ptime(date) - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_seconds();
-		int upperBound = lowerBound + 86400;
+void SQLiteHistoryStorage::writeMessages(const std::vector<HistoryMessage>& messages) {
+	execute("BEGIN TRANSACTION");
+	foreach (const HistoryMessage& message, messages) {
+		writeMessage(message);
+	}
+	execute("COMMIT TRANSACTION");
+}
 
-		selectQuery += " AND (time>=" + boost::lexical_cast<std::string>(lowerBound) +
-				" AND time<" + boost::lexical_cast<std::string>(upperBound) + ")";
+void SQLiteHistoryStorage::writeMessage(const HistoryMessage& message) {
+	long long fromID = getIDForJID(message.getFromJID().toBare());
+	long long toID = getIDForJID(message.getToJID().toBare());
+
+	ScopedStatement statement(getStatement("INSERT INTO messages('message', 'fromBare', 'fromResource', 'toBare', 'toResource', 'type', 'time', 'offset') VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8)"));
+	if (!statement) {
+		return;
+	}
+	bindText(statement, 1, message.getMessage());
+	sqlite3_bind_int64(statement, 2, fromID);
+	bindText(statement, 3, message.getFromJID().getResource());
+	sqlite3_bind_int64(statement, 4, toID);
+	bindText(statement, 5, message.getToJID().getResource());
+	sqlite3_bind_int(statement, 6, message.getType());
+	sqlite3_bind_int(statement, 7, getSecondsSinceEpoch(message.getTime()));
+	sqlite3_bind_int(statement, 8, message.getOffset());
+	if (sqlite3_step(statement) != SQLITE_DONE) {
+		std::cerr << "Error: " << sqlite3_errmsg(db_) << std::endl;
+		return;
+	}
+	// While the backlog is being indexed, new messages are left to it, so
+	// that the indexed messages always precede the unindexed ones.
+	if (!indexingBacklog_) {
+		indexMessage(sqlite3_last_insert_rowid(db_), message.getMessage());
 	}
+}
 
-	int r = sqlite3_prepare(db_, selectQuery.c_str(), boost::numeric_cast<int>(selectQuery.size()), &selectStatement, NULL);
-	if (r != SQLITE_OK) {
-		std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+void SQLiteHistoryStorage::indexMessage(long long id, const std::string& message) {
+	std::vector<std::string> words = getWords(message);
+	if (words.empty()) {
+		return;
+	}
+	std::map<std::string, int> wordCounts;
+	foreach (const std::string& word, words) {
+		++wordCounts[word];
 	}
-	r = sqlite3_step(selectStatement);
 
-	// Retrieve result
-	std::vector<HistoryMessage> result;
-	while (r == SQLITE_ROW) {
-		std::string message(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 0)));
+	ScopedStatement statement(getStatement("INSERT INTO words('word', 'message', 'count') VALUES(?1, ?2, ?3)"));
+	if (!statement) {
+		return;
+	}
+	for (std::map<std::string, int>::const_iterator i = wordCounts.begin(); i != wordCounts.end(); ++i) {
+		bindText(statement, 1, i->first);
+		sqlite3_bind_int64(statement, 2, id);
+		sqlite3_bind_int(statement, 3, i->second);
+		if (sqlite3_step(statement) != SQLITE_DONE) {
+			std::cerr << "Error: " << sqlite3_errmsg(db_) << std::endl;
+		}
+		sqlite3_reset(statement);
+	}
+}
 
-		// fromJID
-		boost::optional<JID> fromJID(getJIDFromID(sqlite3_column_int(selectStatement, 1)));
-		std::string fromResource(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 2)));
-		if (fromJID) {
-			fromJID = boost::optional<JID>(JID(fromJID->getNode(), fromJID->getDomain(), fromResource));
+/**
+ * Indexes the next batch of messages that were stored before the search
+ * index existed, or while the backlog was being indexed. Returns whether
+ * there are more messages left to index.
+ *
+ * Must be called with dbMutex_ locked.
+ */
+bool SQLiteHistoryStorage::indexNextBatch() {
+	static const int batchSize = 1000;
+	if (!lastIndexedID_) {
+		ScopedStatement selectStatement(getStatement("SELECT IFNULL(MAX(message), 0) FROM words"));
+		if (!selectStatement || sqlite3_step(selectStatement) != SQLITE_ROW) {
+			return false;
 		}
+		lastIndexedID_ = sqlite3_column_int64(selectStatement, 0);
+	}
 
-		// toJID
-		boost::optional<JID> toJID(getJIDFromID(sqlite3_column_int(selectStatement, 3)));
-		std::string toResource(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 4)));
-		if (toJID) {
-			toJID = boost::optional<JID>(JID(toJID->getNode(), toJID->getDomain(), toResource));
+	std::vector<std::pair<long long, std::string> > messages;
+	{
+		ScopedStatement selectStatement(getStatement("SELECT rowid, message FROM messages WHERE rowid>?1 ORDER BY rowid LIMIT ?2"));
+		if (!selectStatement) {
+			return false;
 		}
+		sqlite3_bind_int64(selectStatement, 1, *lastIndexedID_);
+		sqlite3_bind_int(selectStatement, 2, batchSize);
+		while (sqlite3_step(selectStatement) == SQLITE_ROW) {
+			messages.push_back(std::make_pair(sqlite3_column_int64(selectStatement, 0), getColumnText(selectStatement, 1)));
+		}
+	}
+	if (messages.empty()) {
+		return false;
+	}
+
+	execute("BEGIN TRANSACTION");
+	for (size_t i = 0; i < messages.size(); ++i) {
+		indexMessage(messages[i].first, messages[i].second);
+	}
+	execute("COMMIT TRANSACTION");
+
+	lastIndexedID_ = messages.back().first;
+	return messages.size() == static_cast<size_t>(batchSize);
+}
+
+HistoryMessage SQLiteHistoryStorage::getMessage(sqlite3_stmt* statement) const {
+	std::string message(getColumnText(statement, 0));
+
+	// fromJID
+	boost::optional<JID> fromJID(getJIDFromID(sqlite3_column_int64(statement, 1)));
+	std::string fromResource(getColumnText(statement, 2));
+	if (fromJID) {
+		fromJID = boost::optional<JID>(JID(fromJID->getNode(), fromJID->getDomain(), fromResource));
+	}
+
+	// toJID
+	boost::optional<JID> toJID(getJIDFromID(sqlite3_column_int64(statement, 3)));
+	std::string toResource(getColumnText(statement, 4));
+	if (toJID) {
+		toJID = boost::optional<JID>(JID(toJID->getNode(), toJID->getDomain(), toResource));
+	}
+
+	// message type
+	HistoryMessage::Type type = static_cast<HistoryMessage::Type>(sqlite3_column_int(statement, 5));
+
+	// timestamp
+	boost::posix_time::ptime time(getTimeFromSecondsSinceEpoch(sqlite3_column_int(statement, 6)));
+
+	// offset from utc
+	int offset = sqlite3_column_int(statement, 7);
 
-		// message type
-		HistoryMessage::Type type = static_cast<HistoryMessage::Type>(sqlite3_column_int(selectStatement, 5));
+	return HistoryMessage(message, (fromJID ? *fromJID : JID()), (toJID ? *toJID : JID()), type, time, offset);
+}
 
-		// timestamp
-		int secondsSinceEpoch(sqlite3_column_int(selectStatement, 6));
-		boost::posix_time::ptime time(boost::gregorian::date(1970, 1, 1), boost::posix_time::seconds(secondsSinceEpoch));
+std::vector<HistoryMessage> SQLiteHistoryStorage::getMessagesFromDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const {
+	flush();
+	boost::lock_guard<boost::mutex> lock(dbMutex_);
 
-		// offset from utc
-		int offset = sqlite3_column_int(selectStatement, 7);
+	boost::optional<long long> selfID = getIDFromJID(selfJID.toBare());
+	boost::optional<long long> contactID = getIDFromJID(contactJID.toBare());
 
-		result.push_back(HistoryMessage(message, (fromJID ? *fromJID : JID()), (toJID ? *toJID : JID()), type, time, offset));
+	if (!selfID || !contactID) {
+		// JIDs missing from the database
+		return std::vector<HistoryMessage>();
+	}
+
+	std::string selectQuery = "SELECT message, fromBare, fromResource, toBare, toResource, type, time, offset FROM messages WHERE type=?4 AND " + getConversationCondition(!contactJID.isBare());
+	if (!date.is_not_a_date()) {
+		selectQuery += " AND time>=?5 AND time<?6";
+	}
+	selectQuery += " ORDER BY rowid";
+
+	ScopedStatement selectStatement(getStatement(selectQuery));
+	if (!selectStatement) {
+		return std::vector<HistoryMessage>();
+	}
+	sqlite3_bind_int64(selectStatement, 1, *selfID);
+	sqlite3_bind_int64(selectStatement, 2, *contactID);
+	if (!contactJID.isBare()) {
+		bindText(selectStatement, 3, contactJID.getResource());
+	}
+	sqlite3_bind_int(selectStatement, 4, type);
+	if (!date.is_not_a_date()) {
+		int lowerBound = getSecondsSinceEpoch(boost::posix_time::ptime(date));
+		sqlite3_bind_int(selectStatement, 5, lowerBound);
+		sqlite3_bind_int(selectStatement, 6, lowerBound + 86400);
+	}
+
+	// Retrieve result
+	std::vector<HistoryMessage> result;
+	int r = sqlite3_step(selectStatement);
+	while (r == SQLITE_ROW) {
+		result.push_back(getMessage(selectStatement));
 		r = sqlite3_step(selectStatement);
 	}
 	if (r != SQLITE_DONE) {
-		std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+		std::cerr << "Error: " << sqlite3_errmsg(db_) << std::endl;
 	}
-	sqlite3_finalize(selectStatement);
 
 	return result;
 }
@@ -166,51 +464,69 @@ long long SQLiteHistoryStorage::getIDForJID(const JID& jid) {
 }
 
 long long SQLiteHistoryStorage::addJID(const JID& jid) {
-	std::string statement = std::string("INSERT INTO jids('jid') VALUES('") + getEscapedString(jid.toString()) + "')";
-	char* errorMessage;
-	int result = sqlite3_exec(db_, statement.c_str(), 0, 0, &errorMessage);
-	if (result != SQLITE_OK) {
-		std::cerr << "SQL Error: " << errorMessage << std::endl;
-		sqlite3_free(errorMessage);
-	}
-	return sqlite3_last_insert_rowid(db_);
+	ScopedStatement statement(getStatement("INSERT INTO jids('jid') VALUES(?1)"));
+	if (!statement) {
+		return -1;
+	}
+	std::string jidString = jid.toString();
+	bindText(statement, 1, jidString);
+	if (sqlite3_step(statement) != SQLITE_DONE) {
+		std::cerr << "Error: " << sqlite3_errmsg(db_) << std::endl;
+		return -1;
+	}
+	long long id = sqlite3_last_insert_rowid(db_);
+	jidIDs_[jidString] = id;
+	idJIDs_[id] = jid;
+	return id;
 }
 
 boost::optional<JID> SQLiteHistoryStorage::getJIDFromID(long long id) const {
+	boost::unordered_map<long long, JID>::const_iterator i = idJIDs_.find(id);
+	if (i != idJIDs_.end()) {
+		return i->second;
+	}
+
 	boost::optional<JID> result;
-	sqlite3_stmt* selectStatement;
-	std::string selectQuery("SELECT jid FROM jids WHERE id=" + boost::lexical_cast<std::string>(id));
-	int r = sqlite3_prepare(db_, selectQuery.c_str(), boost::numeric_cast<int>(selectQuery.size()), &selectStatement, NULL);
-	if (r != SQLITE_OK) {
-		std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+	ScopedStatement selectStatement(getStatement("SELECT jid FROM jids WHERE id=?1"));
+	if (!selectStatement) {
+		return result;
 	}
-	r = sqlite3_step(selectStatement);
-	if (r == SQLITE_ROW) {
-		result = boost::optional<JID>(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 0)));
+	sqlite3_bind_int64(selectStatement, 1, id);
+	if (sqlite3_step(selectStatement) == SQLITE_ROW) {
+		std::string jidString(getColumnText(selectStatement, 0));
+		result = JID(jidString);
+		idJIDs_[id] = *result;
+		jidIDs_[jidString] = id;
 	}
-	sqlite3_finalize(selectStatement);
 	return result;
 }
 
 boost::optional<long long> SQLiteHistoryStorage::getIDFromJID(const JID& jid) const {
+	std::string jidString = jid.toString();
+	boost::unordered_map<std::string, long long>::const_iterator i = jidIDs_.find(jidString);
+	if (i != jidIDs_.end()) {
+		return i->second;
+	}
+
 	boost::optional<long long> result;
-	sqlite3_stmt* selectStatement;
-	std::string selectQuery("SELECT id FROM jids WHERE jid='" + jid.toString() + "'");
-	long long r = sqlite3_prepare(db_, selectQuery.c_str(), boost::numeric_cast<int>(selectQuery.size()), &selectStatement, NULL);
-	if (r != SQLITE_OK) {
-		std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+	ScopedStatement selectStatement(getStatement("SELECT id FROM jids WHERE jid=?1"));
+	if (!selectStatement) {
+		return result;
 	}
-	r = sqlite3_step(selectStatement);
-	if (r == SQLITE_ROW) {
-		result = boost::optional<long long>(sqlite3_column_int(selectStatement, 0));
+	bindText(selectStatement, 1, jidString);
+	if (sqlite3_step(selectStatement) == SQLITE_ROW) {
+		result = sqlite3_column_int64(selectStatement, 0);
+		jidIDs_[jidString] = *result;
+		idJIDs_[*result] = jid;
 	}
-	sqlite3_finalize(selectStatement);
 	return result;
 }
 
 ContactsMap SQLiteHistoryStorage::getContacts(const JID& selfJID, HistoryMessage::Type type, const std::string& keyword) const {
+	flush();
+	boost::lock_guard<boost::mutex> lock(dbMutex_);
+
 	ContactsMap result;
-	sqlite3_stmt* selectStatement;
 
 	// get id
 	boost::optional<long long> id = getIDFromJID(selfJID);
@@ -219,31 +535,39 @@ ContactsMap SQLiteHistoryStorage::getContacts(const JID& selfJID, HistoryMessage
 	}
 
 	// get contacts
-	std::string query = "SELECT DISTINCT messages.'fromBare', messages.'fromResource', messages.'toBare', messages.'toResource', messages.'time' "
-		"FROM messages WHERE (type="
-		+ boost::lexical_cast<std::string>(type) + " AND (toBare="
-		+ boost::lexical_cast<std::string>(*id) + " OR fromBare=" + boost::lexical_cast<std::string>(*id) + "))";
+	std::string query = "SELECT DISTINCT fromBare, fromResource, toBare, toResource, time FROM messages WHERE type=?1 AND (toBare=?2 OR fromBare=?2)";
 
-	// match keyword
-	if (getEscapedString(keyword).length()) {
-		query += " AND message LIKE '%" + getEscapedString(keyword) + "%'";
+	// match keyword, using the search index if the keyword contains words
+	std::vector<std::string> words = getSearchWords(keyword);
+	if (!words.empty()) {
+		query += " AND " + getSearchCondition(words.size(), 3);
+	}
+	else if (!keyword.empty()) {
+		query += " AND message LIKE ?3";
 	}
 
-	int r = sqlite3_prepare(db_, query.c_str(), boost::numeric_cast<int>(query.size()), &selectStatement, NULL);
-	if (r != SQLITE_OK) {
-		std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+	ScopedStatement selectStatement(getStatement(query));
+	if (!selectStatement) {
+		return result;
+	}
+	sqlite3_bind_int(selectStatement, 1, type);
+	sqlite3_bind_int64(selectStatement, 2, *id);
+	if (!words.empty()) {
+		bindSearchWords(selectStatement, words, 3);
+	}
+	else if (!keyword.empty()) {
+		bindText(selectStatement, 3, "%" + keyword + "%");
 	}
 
-	r = sqlite3_step(selectStatement);
+	int r = sqlite3_step(selectStatement);
 	while (r == SQLITE_ROW) {
-		int fromBareID = sqlite3_column_int(selectStatement, 0);
-		std::string fromResource(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 1)));
-		int toBareID = sqlite3_column_int(selectStatement, 2);
-		std::string toResource(reinterpret_cast<const char*>(sqlite3_column_text(selectStatement, 3)));
+		long long fromBareID = sqlite3_column_int64(selectStatement, 0);
+		std::string fromResource(getColumnText(selectStatement, 1));
+		long long toBareID = sqlite3_column_int64(selectStatement, 2);
+		std::string toResource(getColumnText(selectStatement, 3));
 		std::string resource;
 
-		int secondsSinceEpoch(sqlite3_column_int(selectStatement, 4));
-		boost::posix_time::ptime time(boost::gregorian::date(1970, 1, 1), boost::posix_time::seconds(secondsSinceEpoch));
+		boost::posix_time::ptime time(getTimeFromSecondsSinceEpoch(sqlite3_column_int(selectStatement, 4)));
 
 		boost::optional<JID> contactJID;
 
@@ -257,7 +581,7 @@ ContactsMap SQLiteHistoryStorage::getContacts(const JID& selfJID, HistoryMessage
 		}
 
 		// check if it is a MUC contact (from a private conversation)
-		if (type == HistoryMessage::PrivateMessage) {
+		if (contactJID && type == HistoryMessage::PrivateMessage) {
 			contactJID = boost::optional<JID>(JID(contactJID->getNode(), contactJID->getDomain(), resource));
 		}
 
@@ -269,15 +593,16 @@ ContactsMap SQLiteHistoryStorage::getContacts(const JID& selfJID, HistoryMessage
 	}
 
 	if (r != SQLITE_DONE) {
-		std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+		std::cerr << "Error: " << sqlite3_errmsg(db_) << std::endl;
 	}
-	sqlite3_finalize(selectStatement);
 
 	return result;
 }
 
 boost::gregorian::date SQLiteHistoryStorage::getNextDateWithLogs(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date, bool reverseOrder) const {
-	sqlite3_stmt* selectStatement;
+	flush();
+	boost::lock_guard<boost::mutex> lock(dbMutex_);
+
 	boost::optional<long long> selfID = getIDFromJID(selfJID.toBare());
 	boost::optional<long long> contactID = getIDFromJID(contactJID.toBare());
 
@@ -286,39 +611,23 @@ boost::gregorian::date SQLiteHistoryStorage::getNextDateWithLogs(const JID& self
 		return boost::gregorian::date(boost::gregorian::not_a_date_time);
 	}
 
-	std::string selectQuery = "SELECT time FROM messages WHERE (type=" + boost::lexical_cast<std::string>(type);
-	if (contactJID.isBare()) {
-		// match only bare jid
-		selectQuery += " AND ((fromBare=" + boost::lexical_cast<std::string>(*selfID) + " AND toBare=" +
-				boost::lexical_cast<std::string>(*contactID) + ") OR (fromBare=" +
-				boost::lexical_cast<std::string>(*contactID) + " AND toBare=" + boost::lexical_cast<std::string>(*selfID) + ")))";
-	}
-	else {
-		// match resource too
-		selectQuery += " AND ((fromBare=" + boost::lexical_cast<std::string>(*selfID) + " AND (toBare=" +
-				boost::lexical_cast<std::string>(*contactID) +" AND toResource='" +
-				getEscapedString(contactJID.getResource()) + "')) OR ((fromBare=" +
-				boost::lexical_cast<std::string>(*contactID) + " AND fromResource='" +
-				getEscapedString(contactJID.getResource()) + "') AND toBare=" +
-				boost::lexical_cast<std::string>(*selfID) + ")))";
-	}
+	std::string selectQuery = "SELECT time FROM messages WHERE type=?4 AND " + getConversationCondition(!contactJID.isBare());
+	selectQuery += reverseOrder ? " AND time<?5 ORDER BY time DESC LIMIT 1" : " AND time>?5 ORDER BY time ASC LIMIT 1";
 
-	int timeStamp = (boost::posix_time::ptime(date) - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_seconds() + (reverseOrder ? 0 : 86400);
-
-	selectQuery += " AND time" + (reverseOrder ? std::string("<") : std::string(">")) + boost::lexical_cast<std::string>(timeStamp);
-	selectQuery += " ORDER BY time " + (reverseOrder ? std::string("DESC") : std::string("ASC")) + " LIMIT 1";
-
-	int r = sqlite3_prepare(db_, selectQuery.c_str(), boost::numeric_cast<int>(selectQuery.size()), &selectStatement, NULL);
-	if (r != SQLITE_OK) {
-		std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+	ScopedStatement selectStatement(getStatement(selectQuery));
+	if (!selectStatement) {
+		return boost::gregorian::date(boost::gregorian::not_a_date_time);
+	}
+	sqlite3_bind_int64(selectStatement, 1, *selfID);
+	sqlite3_bind_int64(selectStatement, 2, *contactID);
+	if (!contactJID.isBare()) {
+		bindText(selectStatement, 3, contactJID.getResource());
 	}
+	sqlite3_bind_int(selectStatement, 4, type);
+	sqlite3_bind_int(selectStatement, 5, getSecondsSinceEpoch(boost::posix_time::ptime(date)) + (reverseOrder ? 0 : 86400));
 
-	r = sqlite3_step(selectStatement);
-	if (r == SQLITE_ROW) {
-		int secondsSinceEpoch(sqlite3_column_int(selectStatement, 0));
-		boost::posix_time::ptime time(boost::gregorian::date(1970, 1, 1), boost::posix_time::seconds(secondsSinceEpoch));
-		std::cout << "next day is: " << time.date() << "\n";
-		return time.date();
+	if (sqlite3_step(selectStatement) == SQLITE_ROW) {
+		return getTimeFromSecondsSinceEpoch(sqlite3_column_int(selectStatement, 0)).date();
 	}
 
 	return boost::gregorian::date(boost::gregorian::not_a_date_time);
@@ -345,6 +654,9 @@ std::vector<HistoryMessage> SQLiteHistoryStorage::getMessagesFromPreviousDate(co
 }
 
 boost::posix_time::ptime SQLiteHistoryStorage::getLastTimeStampFromMUC(const JID& selfJID, const JID& mucJID) const {
+	flush();
+	boost::lock_guard<boost::mutex> lock(dbMutex_);
+
 	boost::optional<long long> selfID = getIDFromJID(selfJID.toBare());
 	boost::optional<long long> mucID = getIDFromJID(mucJID.toBare());
 
@@ -353,21 +665,16 @@ boost::posix_time::ptime SQLiteHistoryStorage::getLastTimeStampFromMUC(const JID
 		return boost::posix_time::ptime(boost::posix_time::not_a_date_time);
 	}
 
-
-	sqlite3_stmt* selectStatement;
-	std::string selectQuery = "SELECT messages.'time', messages.'offset' from messages WHERE type=1 AND (toBare=" +
-				boost::lexical_cast<std::string>(*selfID) + " AND fromBare=" +
-				boost::lexical_cast<std::string>(*mucID) + ") ORDER BY time DESC LIMIT 1";
-
-	int r = sqlite3_prepare(db_, selectQuery.c_str(), boost::numeric_cast<int>(selectQuery.size()), &selectStatement, NULL);
-	if (r != SQLITE_OK) {
-		std::cout << "Error: " << sqlite3_errmsg(db_) << std::endl;
+	ScopedStatement selectStatement(getStatement("SELECT time, offset FROM messages WHERE type=?1 AND toBare=?2 AND fromBare=?3 ORDER BY time DESC LIMIT 1"));
+	if (!selectStatement) {
+		return boost::posix_time::ptime(boost::posix_time::not_a_date_time);
 	}
+	sqlite3_bind_int(selectStatement, 1, HistoryMessage::Groupchat);
+	sqlite3_bind_int64(selectStatement, 2, *selfID);
+	sqlite3_bind_int64(selectStatement, 3, *mucID);
 
-	r = sqlite3_step(selectStatement);
-	if (r == SQLITE_ROW) {
-		int secondsSinceEpoch(sqlite3_column_int(selectStatement, 0));
-		boost::posix_time::ptime time(boost::gregorian::date(1970, 1, 1), boost::posix_time::seconds(secondsSinceEpoch));
+	if (sqlite3_step(selectStatement) == SQLITE_ROW) {
+		boost::posix_time::ptime time(getTimeFromSecondsSinceEpoch(sqlite3_column_int(selectStatement, 0)));
 		int offset = sqlite3_column_int(selectStatement, 1);
 
 		return time - boost::posix_time::hours(offset);
@@ -376,7 +683,53 @@ boost::posix_time::ptime SQLiteHistoryStorage::getLastTimeStampFromMUC(const JID
 	return boost::posix_time::ptime(boost::posix_time::not_a_date_time);
 }
 
-void SQLiteHistoryStorage::run() {
+std::vector<HistoryMessage> SQLiteHistoryStorage::searchMessages(const JID& selfJID, HistoryMessage::Type type, const std::string& keywords, int offset, int limit) const {
+	std::vector<std::string> words = getSearchWords(keywords);
+	if (words.empty() || limit <= 0) {
+		return std::vector<HistoryMessage>();
+	}
+
+	flush();
+	boost::lock_guard<boost::mutex> lock(dbMutex_);
+
+	boost::optional<long long> selfID = getIDFromJID(selfJID.toBare());
+	if (!selfID) {
+		// JID missing from the database
+		return std::vector<HistoryMessage>();
+	}
+
+	// Messages are ranked by the number of occurrences of the search words,
+	// and the most recent ones come first when they are equally relevant.
+	std::string scoreCondition;
+	for (size_t i = 0; i < words.size(); ++i) {
+		scoreCondition += (i > 0 ? " OR (" : "(") + getWordCondition(5 + 2 * static_cast<int>(i)) + ")";
+	}
+	std::string selectQuery = "SELECT messages.message, fromBare, fromResource, toBare, toResource, type, time, offset FROM messages "
+			"JOIN (SELECT message AS id, SUM(count) AS score FROM words WHERE " + scoreCondition + " GROUP BY message) AS scores ON messages.rowid=scores.id "
+			"WHERE type=?2 AND (fromBare=?1 OR toBare=?1) AND " + getSearchCondition(words.size(), 5) + " "
+			"ORDER BY score DESC, time DESC, messages.rowid DESC LIMIT ?3 OFFSET ?4";
+
+	ScopedStatement selectStatement(getStatement(selectQuery));
+	if (!selectStatement) {
+		return std::vector<HistoryMessage>();
+	}
+	sqlite3_bind_int64(selectStatement, 1, *selfID);
+	sqlite3_bind_int(selectStatement, 2, type);
+	sqlite3_bind_int(selectStatement, 3, limit);
+	sqlite3_bind_int(selectStatement, 4, std::max(offset, 0));
+	bindSearchWords(selectStatement, words, 5);
+
+	std::vector<HistoryMessage> result;
+	int r = sqlite3_step(selectStatement);
+	while (r == SQLITE_ROW) {
+		result.push_back(getMessage(selectStatement));
+		r = sqlite3_step(selectStatement);
+	}
+	if (r != SQLITE_DONE) {
+		std::cerr << "Error: " << sqlite3_errmsg(db_) << std::endl;
+	}
+
+	return result;
 }
 
 }
@@ -1,35 +1,74 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <map>
+#include <vector>
 #include <boost/optional.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/filesystem/path.hpp>
 
 #include <Swiften/Base/API.h>
 #include <Swiften/History/HistoryStorage.h>
-#include <boost/thread.hpp>
-#include <boost/filesystem/path.hpp>
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace Swift {
+	/**
+	 * History storage backed by an SQLite database.
+	 *
+	 * Messages passed to addMessage() are queued, and written by a background
+	 * thread, which commits all queued messages in a single transaction.
+	 * Queries wait for pending messages to be written before they run.
+	 *
+	 * Messages are indexed by word as they are written, so that keyword
+	 * searches do not need to scan all messages. Messages that were stored
+	 * before the index existed are indexed in the background, in batches
+	 * between writes. Until that has finished, keyword searches only find
+	 * the messages that are already indexed.
+	 */
 	class SWIFTEN_API SQLiteHistoryStorage : public HistoryStorage {
 		public:
 			SQLiteHistoryStorage(const boost::filesystem::path& file);
 			~SQLiteHistoryStorage();
 
+			/**
+			 * Returns whether the database was opened. If it could not be opened,
+			 * messages are dropped, and all queries return empty results.
+			 */
+			bool isOpen() const;
+
 			void addMessage(const HistoryMessage& message);
 			ContactsMap getContacts(const JID& selfJID, HistoryMessage::Type type, const std::string& keyword) const;
 			std::vector<HistoryMessage> getMessagesFromDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const;
 			std::vector<HistoryMessage> getMessagesFromNextDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const;
 			std::vector<HistoryMessage> getMessagesFromPreviousDate(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date) const;
 			boost::posix_time::ptime getLastTimeStampFromMUC(const JID& selfJID, const JID& mucJID) const;
+			std::vector<HistoryMessage> searchMessages(const JID& selfJID, HistoryMessage::Type type, const std::string& keywords, int offset, int limit) const;
+
+			/**
+			 * Blocks until all messages added so far have been written to the database.
+			 */
+			void flush() const;
 
 		private:
 			void run();
+			void writeMessages(const std::vector<HistoryMessage>& messages);
+			void writeMessage(const HistoryMessage& message);
+			void indexMessage(long long id, const std::string& message);
+			bool indexNextBatch();
+			void execute(const char* statement);
+			sqlite3_stmt* getStatement(const std::string& query) const;
+			HistoryMessage getMessage(sqlite3_stmt* statement) const;
+
 			boost::gregorian::date getNextDateWithLogs(const JID& selfJID, const JID& contactJID, HistoryMessage::Type type, const boost::gregorian::date& date, bool reverseOrder) const;
 			long long getIDForJID(const JID&);
 			long long addJID(const JID&);
@@ -38,6 +77,25 @@ namespace Swift {
 			boost::optional<long long> getIDFromJID(const JID& jid) const;
 
 			sqlite3* db_;
+
+			// Only accessed by the writer thread
+			bool indexingBacklog_;
+			boost::optional<long long> lastIndexedID_;
+
+			// Guarded by dbMutex_
+			mutable boost::mutex dbMutex_;
+			mutable std::map<std::string, sqlite3_stmt*> statements_;
+			mutable boost::unordered_map<std::string, long long> jidIDs_;
+			mutable boost::unordered_map<long long, JID> idJIDs_;
+
+			// Guarded by queueMutex_
+			mutable boost::mutex queueMutex_;
+			boost::condition_variable queueNonEmpty_;
+			mutable boost::condition_variable queueFlushed_;
+			std::vector<HistoryMessage> queue_;
+			bool writing_;
+			bool stopRequested_;
+
 			boost::thread* thread_;
 	};
 }
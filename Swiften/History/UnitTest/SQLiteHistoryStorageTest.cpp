@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <sqlite3.h>
+#include <Swiften/Base/sleep.h>
+#include <Swiften/History/SQLiteHistoryStorage.h>
+
+using namespace Swift;
+
+class SQLiteHistoryStorageTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(SQLiteHistoryStorageTest);
+		CPPUNIT_TEST(testAddMessage);
+		CPPUNIT_TEST(testAddMessage_Quotes);
+		CPPUNIT_TEST(testAddMessage_ManyMessages);
+		CPPUNIT_TEST(testGetMessagesFromDate_OtherDate);
+		CPPUNIT_TEST(testGetMessagesFromDate_WithResource);
+		CPPUNIT_TEST(testGetMessagesFromNextDate);
+		CPPUNIT_TEST(testGetMessagesFromPreviousDate);
+		CPPUNIT_TEST(testGetContacts);
+		CPPUNIT_TEST(testGetContacts_Keyword);
+		CPPUNIT_TEST(testGetContacts_KeywordWithoutWords);
+		CPPUNIT_TEST(testGetLastTimeStampFromMUC);
+		CPPUNIT_TEST(testDestroy_WritesPendingMessages);
+		CPPUNIT_TEST(testOpen_Fails);
+		CPPUNIT_TEST(testSearchMessages);
+		CPPUNIT_TEST(testSearchMessages_AllWords);
+		CPPUNIT_TEST(testSearchMessages_Ranking);
+		CPPUNIT_TEST(testSearchMessages_Pages);
+		CPPUNIT_TEST(testSearchMessages_OtherUserAndType);
+		CPPUNIT_TEST(testSearchMessages_IndexesExistingMessages);
+		CPPUNIT_TEST(testSearchMessages_IndexesExistingMessagesWhileWriting);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void setUp() {
+			self = JID("foo@bar.com/baz");
+			contact = JID("fum@baz.org/fum");
+			day = boost::gregorian::date(2015, 1, 21);
+		}
+
+		void testAddMessage() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			CPPUNIT_ASSERT(testling->isOpen());
+			HistoryMessage message("Test", self, contact, HistoryMessage::Chat, time(22, 3));
+			testling->addMessage(message);
+
+			std::vector<HistoryMessage> messages = testling->getMessagesFromDate(self, contact.toBare(), HistoryMessage::Chat, day);
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT(message == messages[0]);
+		}
+
+		void testAddMessage_Quotes() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			HistoryMessage message("It's a 'test'\"; DROP TABLE messages; --", JID("o'hara@bar.com/it's"), contact, HistoryMessage::Chat, time(22, 3));
+			testling->addMessage(message);
+
+			std::vector<HistoryMessage> messages = testling->getMessagesFromDate(JID("o'hara@bar.com"), contact.toBare(), HistoryMessage::Chat, day);
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT(message == messages[0]);
+		}
+
+		void testAddMessage_ManyMessages() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			for (int i = 0; i < 1000; ++i) {
+				testling->addMessage(HistoryMessage(boost::lexical_cast<std::string>(i), (i % 2 ? self : contact), (i % 2 ? contact : self), HistoryMessage::Chat, time(12, i % 60)));
+			}
+
+			std::vector<HistoryMessage> messages = testling->getMessagesFromDate(self, contact.toBare(), HistoryMessage::Chat, day);
+			CPPUNIT_ASSERT_EQUAL(1000, static_cast<int>(messages.size()));
+			for (int i = 0; i < 1000; ++i) {
+				CPPUNIT_ASSERT_EQUAL(boost::lexical_cast<std::string>(i), messages[i].getMessage());
+			}
+		}
+
+		void testGetMessagesFromDate_OtherDate() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("Test", self, contact, HistoryMessage::Chat, time(22, 3)));
+
+			CPPUNIT_ASSERT(testling->getMessagesFromDate(self, contact.toBare(), HistoryMessage::Chat, day + boost::gregorian::days(1)).empty());
+			CPPUNIT_ASSERT(testling->getMessagesFromDate(self, contact.toBare(), HistoryMessage::Groupchat, day).empty());
+		}
+
+		void testGetMessagesFromDate_WithResource() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("Test1", self, contact, HistoryMessage::PrivateMessage, time(22, 3)));
+			testling->addMessage(HistoryMessage("Test2", self, JID("fum@baz.org/other"), HistoryMessage::PrivateMessage, time(22, 4)));
+			testling->addMessage(HistoryMessage("Test3", contact, self, HistoryMessage::PrivateMessage, time(22, 5)));
+
+			std::vector<HistoryMessage> messages = testling->getMessagesFromDate(self, contact, HistoryMessage::PrivateMessage, day);
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("Test1"), messages[0].getMessage());
+			CPPUNIT_ASSERT_EQUAL(std::string("Test3"), messages[1].getMessage());
+		}
+
+		void testGetMessagesFromNextDate() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("Test1", self, contact, HistoryMessage::Chat, time(22, 3)));
+			testling->addMessage(HistoryMessage("Test2", self, contact, HistoryMessage::Chat, time(22, 3) + boost::gregorian::days(3)));
+
+			std::vector<HistoryMessage> messages = testling->getMessagesFromNextDate(self, contact.toBare(), HistoryMessage::Chat, day);
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("Test2"), messages[0].getMessage());
+			CPPUNIT_ASSERT(testling->getMessagesFromNextDate(self, contact.toBare(), HistoryMessage::Chat, day + boost::gregorian::days(3)).empty());
+		}
+
+		void testGetMessagesFromPreviousDate() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("Test1", self, contact, HistoryMessage::Chat, time(22, 3)));
+			testling->addMessage(HistoryMessage("Test2", self, contact, HistoryMessage::Chat, time(22, 3) + boost::gregorian::days(3)));
+
+			std::vector<HistoryMessage> messages = testling->getMessagesFromPreviousDate(self, contact.toBare(), HistoryMessage::Chat, day + boost::gregorian::days(3));
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("Test1"), messages[0].getMessage());
+			CPPUNIT_ASSERT(testling->getMessagesFromPreviousDate(self, contact.toBare(), HistoryMessage::Chat, day).empty());
+		}
+
+		void testGetContacts() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("Test1", self, contact, HistoryMessage::Chat, time(22, 3)));
+			testling->addMessage(HistoryMessage("Test2", JID("other@baz.org"), self, HistoryMessage::Chat, time(22, 3) + boost::gregorian::days(1)));
+			testling->addMessage(HistoryMessage("Test3", JID("other@baz.org"), JID("third@baz.org"), HistoryMessage::Chat, time(22, 3)));
+
+			ContactsMap contacts = testling->getContacts(self.toBare(), HistoryMessage::Chat, "");
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(contacts.size()));
+			CPPUNIT_ASSERT(contacts[contact.toBare()].count(day));
+			CPPUNIT_ASSERT(contacts[JID("other@baz.org")].count(day + boost::gregorian::days(1)));
+		}
+
+		void testGetContacts_Keyword() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("Don't panic", self, contact, HistoryMessage::Chat, time(22, 3)));
+			testling->addMessage(HistoryMessage("Hello", self, JID("other@baz.org"), HistoryMessage::Chat, time(22, 3)));
+
+			ContactsMap contacts = testling->getContacts(self.toBare(), HistoryMessage::Chat, "don't PAN");
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(contacts.size()));
+			CPPUNIT_ASSERT(contacts.find(contact.toBare()) != contacts.end());
+		}
+
+		void testGetContacts_KeywordWithoutWords() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage(":-)", self, contact, HistoryMessage::Chat, time(22, 3)));
+			testling->addMessage(HistoryMessage("Hello", self, JID("other@baz.org"), HistoryMessage::Chat, time(22, 3)));
+
+			ContactsMap contacts = testling->getContacts(self.toBare(), HistoryMessage::Chat, ":-)");
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(contacts.size()));
+			CPPUNIT_ASSERT(contacts.find(contact.toBare()) != contacts.end());
+		}
+
+		void testGetLastTimeStampFromMUC() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("Test1", JID("room@conference.bar.com/a"), self, HistoryMessage::Groupchat, time(22, 3)));
+			testling->addMessage(HistoryMessage("Test2", JID("room@conference.bar.com/b"), self, HistoryMessage::Groupchat, time(22, 5), 1));
+
+			CPPUNIT_ASSERT_EQUAL(time(21, 5), testling->getLastTimeStampFromMUC(self, JID("room@conference.bar.com")));
+			CPPUNIT_ASSERT(testling->getLastTimeStampFromMUC(self, JID("other@conference.bar.com")).is_not_a_date_time());
+		}
+
+		void testDestroy_WritesPendingMessages() {
+			boost::filesystem::path file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+			{
+				SQLiteHistoryStorage testling(file);
+				for (int i = 0; i < 100; ++i) {
+					testling.addMessage(HistoryMessage("Test", self, contact, HistoryMessage::Chat, time(22, 3)));
+				}
+			}
+
+			std::vector<HistoryMessage> messages;
+			{
+				SQLiteHistoryStorage testling(file);
+				messages = testling.getMessagesFromDate(self, contact.toBare(), HistoryMessage::Chat, day);
+			}
+			boost::filesystem::remove(file);
+
+			CPPUNIT_ASSERT_EQUAL(100, static_cast<int>(messages.size()));
+		}
+
+		void testOpen_Fails() {
+			boost::filesystem::path file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path() / "history.db";
+			SQLiteHistoryStorage testling(file);
+
+			CPPUNIT_ASSERT(!testling.isOpen());
+			testling.addMessage(HistoryMessage("Test", self, contact, HistoryMessage::Chat, time(22, 3)));
+			CPPUNIT_ASSERT(testling.getMessagesFromDate(self, contact.toBare(), HistoryMessage::Chat, day).empty());
+			CPPUNIT_ASSERT(testling.getContacts(self, HistoryMessage::Chat, "").empty());
+		}
+
+		void testSearchMessages() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("Hello there", self, contact, HistoryMessage::Chat, time(22, 3)));
+			testling->addMessage(HistoryMessage("Goodbye", contact, self, HistoryMessage::Chat, time(22, 4)));
+			testling->addMessage(HistoryMessage("Say HELLO to Ren\xc3\xa9", contact, self, HistoryMessage::Chat, time(22, 5)));
+
+			std::vector<HistoryMessage> messages = testling->searchMessages(self, HistoryMessage::Chat, "hel", 0, 10);
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("Say HELLO to Ren\xc3\xa9"), messages[0].getMessage());
+			CPPUNIT_ASSERT_EQUAL(std::string("Hello there"), messages[1].getMessage());
+
+			messages = testling->searchMessages(self, HistoryMessage::Chat, "ren\xc3\xa9", 0, 10);
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT(testling->searchMessages(self, HistoryMessage::Chat, "ello", 0, 10).empty());
+			CPPUNIT_ASSERT(testling->searchMessages(self, HistoryMessage::Chat, "!!", 0, 10).empty());
+		}
+
+		void testSearchMessages_AllWords() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("The quick brown fox", self, contact, HistoryMessage::Chat, time(22, 3)));
+			testling->addMessage(HistoryMessage("The lazy dog", self, contact, HistoryMessage::Chat, time(22, 4)));
+
+			std::vector<HistoryMessage> messages = testling->searchMessages(self, HistoryMessage::Chat, "the fox", 0, 10);
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("The quick brown fox"), messages[0].getMessage());
+		}
+
+		void testSearchMessages_Ranking() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("tea", self, contact, HistoryMessage::Chat, time(22, 3)));
+			testling->addMessage(HistoryMessage("tea, tea and more tea", self, contact, HistoryMessage::Chat, time(22, 4)));
+			testling->addMessage(HistoryMessage("more tea", self, contact, HistoryMessage::Chat, time(22, 5)));
+
+			std::vector<HistoryMessage> messages = testling->searchMessages(self, HistoryMessage::Chat, "tea", 0, 10);
+			CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("tea, tea and more tea"), messages[0].getMessage());
+			CPPUNIT_ASSERT_EQUAL(std::string("more tea"), messages[1].getMessage());
+			CPPUNIT_ASSERT_EQUAL(std::string("tea"), messages[2].getMessage());
+		}
+
+		void testSearchMessages_Pages() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			for (int i = 0; i < 25; ++i) {
+				testling->addMessage(HistoryMessage("Message " + boost::lexical_cast<std::string>(i), self, contact, HistoryMessage::Chat, time(12, i)));
+			}
+
+			std::vector<HistoryMessage> messages = testling->searchMessages(self, HistoryMessage::Chat, "message", 10, 10);
+			CPPUNIT_ASSERT_EQUAL(10, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("Message 14"), messages[0].getMessage());
+			CPPUNIT_ASSERT_EQUAL(std::string("Message 5"), messages[9].getMessage());
+
+			messages = testling->searchMessages(self, HistoryMessage::Chat, "message", 20, 10);
+			CPPUNIT_ASSERT_EQUAL(5, static_cast<int>(messages.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("Message 0"), messages[4].getMessage());
+		}
+
+		void testSearchMessages_OtherUserAndType() {
+			boost::shared_ptr<SQLiteHistoryStorage> testling(createStorage());
+			testling->addMessage(HistoryMessage("Hello", JID("other@baz.org"), contact, HistoryMessage::Chat, time(22, 3)));
+			testling->addMessage(HistoryMessage("Hello", contact, self, HistoryMessage::Groupchat, time(22, 3)));
+
+			CPPUNIT_ASSERT(testling->searchMessages(self, HistoryMessage::Chat, "hello", 0, 10).empty());
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(testling->searchMessages(self, HistoryMessage::Groupchat, "hello", 0, 10).size()));
+		}
+
+		void testSearchMessages_IndexesExistingMessages() {
+			boost::filesystem::path file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+			{
+				SQLiteHistoryStorage testling(file);
+				testling.addMessage(HistoryMessage("Hello", self, contact, HistoryMessage::Chat, time(22, 3)));
+			}
+			sqlite3* db = NULL;
+			sqlite3_open(file.string().c_str(), &db);
+			sqlite3_exec(db, "DELETE FROM words", 0, 0, 0);
+			sqlite3_close(db);
+
+			size_t results = 0;
+			{
+				SQLiteHistoryStorage testling(file);
+				results = waitForSearchResults(testling, "hello", 1);
+			}
+			boost::filesystem::remove(file);
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(results));
+		}
+
+		void testSearchMessages_IndexesExistingMessagesWhileWriting() {
+			boost::filesystem::path file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+			{
+				SQLiteHistoryStorage testling(file);
+				for (int i = 0; i < 2500; ++i) {
+					testling.addMessage(HistoryMessage("Hello " + boost::lexical_cast<std::string>(i), self, contact, HistoryMessage::Chat, time(22, 3)));
+				}
+			}
+			sqlite3* db = NULL;
+			sqlite3_open(file.string().c_str(), &db);
+			sqlite3_exec(db, "DELETE FROM words", 0, 0, 0);
+			sqlite3_close(db);
+
+			size_t helloResults = 0;
+			size_t goodbyeResults = 0;
+			{
+				SQLiteHistoryStorage testling(file);
+				testling.addMessage(HistoryMessage("Goodbye", self, contact, HistoryMessage::Chat, time(22, 4)));
+				CPPUNIT_ASSERT_EQUAL(2501, static_cast<int>(testling.getMessagesFromDate(self, contact.toBare(), HistoryMessage::Chat, day).size()));
+				helloResults = waitForSearchResults(testling, "hello", 2500);
+				goodbyeResults = waitForSearchResults(testling, "goodbye", 1);
+			}
+			boost::filesystem::remove(file);
+
+			CPPUNIT_ASSERT_EQUAL(2500, static_cast<int>(helloResults));
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(goodbyeResults));
+		}
+
+	private:
+		SQLiteHistoryStorage* createStorage() {
+			return new SQLiteHistoryStorage(":memory:");
+		}
+
+		// Existing messages are indexed in the background
+		size_t waitForSearchResults(const SQLiteHistoryStorage& storage, const std::string& keyword, size_t expectedResults) {
+			size_t results = 0;
+			for (int i = 0; i < 1000 && results < expectedResults; ++i) {
+				results = storage.searchMessages(self, HistoryMessage::Chat, keyword, 0, 10000).size();
+				if (results < expectedResults) {
+					Swift::sleep(10);
+				}
+			}
+			return results;
+		}
+
+		boost::posix_time::ptime time(int hours, int minutes) {
+			return boost::posix_time::ptime(day, boost::posix_time::hours(hours) + boost::posix_time::minutes(minutes));
+		}
+
+	private:
+		JID self;
+		JID contact;
+		boost::gregorian::date day;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SQLiteHistoryStorageTest);
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/JID/InternedJID.h>
+
+#include <ostream>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/weak_ptr.hpp>
+
+namespace Swift {
+
+struct InternedJID::Data {
+	Data(const JID& jid, boost::shared_ptr<const Data> bare) :
+			node(jid.getNode()),
+			domain(jid.getDomain()),
+			resource(jid.getResource()),
+			hasResource(!jid.isBare()),
+			string(jid.toString()),
+			hash(hash_value(jid)),
+			bare(bare) {
+	}
+
+	std::string node;
+	std::string domain;
+	std::string resource;
+	bool hasResource;
+	std::string string;
+	size_t hash;
+
+	// The data of the bare JID, or NULL if this is a bare JID
+	boost::shared_ptr<const Data> bare;
+};
+
+namespace {
+	/**
+	 * The set of JIDs that have live handles, keyed by their string form.
+	 */
+	class InternedJIDPool {
+		public:
+			template<typename Data>
+			boost::shared_ptr<const Data> intern(const JID& jid) {
+				boost::lock_guard<boost::mutex> lock(mutex);
+				return internLocked<Data>(jid);
+			}
+
+		private:
+			template<typename Data>
+			boost::shared_ptr<const Data> internLocked(const JID& jid) {
+				std::string key = jid.toString();
+				Entries::iterator i = entries.find(key);
+				if (i != entries.end()) {
+					if (boost::shared_ptr<const void> data = i->second.lock()) {
+						return boost::static_pointer_cast<const Data>(data);
+					}
+				}
+				boost::shared_ptr<const Data> bare;
+				if (!jid.isBare()) {
+					bare = internLocked<Data>(jid.toBare());
+				}
+				boost::shared_ptr<const Data> data(new Data(jid, bare), Deleter<Data>(this, key));
+				entries[key] = data;
+				return data;
+			}
+
+			void release(const std::string& key) {
+				boost::lock_guard<boost::mutex> lock(mutex);
+				Entries::iterator i = entries.find(key);
+				// The entry may already have been replaced by a new one
+				if (i != entries.end() && i->second.expired()) {
+					entries.erase(i);
+				}
+			}
+
+			template<typename Data>
+			struct Deleter {
+				Deleter(InternedJIDPool* pool, const std::string& key) : pool(pool), key(key) {
+				}
+
+				void operator()(const Data* data) {
+					pool->release(key);
+					// Deleting the data may release its bare JID, so this must
+					// happen after the pool is unlocked.
+					delete data;
+				}
+
+				InternedJIDPool* pool;
+				std::string key;
+			};
+
+		private:
+			typedef boost::unordered_map<std::string, boost::weak_ptr<const void> > Entries;
+			boost::mutex mutex;
+			Entries entries;
+	};
+
+	InternedJIDPool& getPool() {
+		// Never destroyed, so that handles can outlive static destruction
+		static InternedJIDPool* pool = new InternedJIDPool();
+		return *pool;
+	}
+
+	const std::string emptyString;
+}
+
+InternedJID::InternedJID() {
+}
+
+InternedJID::InternedJID(const JID& jid) {
+	if (jid.isValid()) {
+		data_ = getPool().intern<Data>(jid);
+	}
+}
+
+InternedJID::InternedJID(boost::shared_ptr<const Data> data) : data_(data) {
+}
+
+bool InternedJID::isBare() const {
+	return !data_ || !data_->hasResource;
+}
+
+const std::string& InternedJID::getNode() const {
+	return data_ ? data_->node : emptyString;
+}
+
+const std::string& InternedJID::getDomain() const {
+	return data_ ? data_->domain : emptyString;
+}
+
+const std::string& InternedJID::getResource() const {
+	return data_ ? data_->resource : emptyString;
+}
+
+InternedJID InternedJID::toBare() const {
+	if (!data_ || !data_->bare) {
+		return *this;
+	}
+	return InternedJID(data_->bare);
+}
+
+const std::string& InternedJID::toString() const {
+	return data_ ? data_->string : emptyString;
+}
+
+JID InternedJID::toJID() const {
+	if (!data_) {
+		return JID();
+	}
+	if (data_->hasResource) {
+		return JID(data_->node, data_->domain, data_->resource);
+	}
+	return JID(data_->node, data_->domain);
+}
+
+size_t InternedJID::getHash() const {
+	return data_ ? data_->hash : 0;
+}
+
+int InternedJID::compare(const InternedJID& o, JID::CompareType compareType) const {
+	if (data_ == o.data_) {
+		return 0;
+	}
+	if (getNode() < o.getNode()) { return -1; }
+	if (getNode() > o.getNode()) { return 1; }
+	if (getDomain() < o.getDomain()) { return -1; }
+	if (getDomain() > o.getDomain()) { return 1; }
+	if (compareType == JID::WithResource) {
+		if (isBare() != o.isBare()) {
+			return isBare() ? -1 : 1;
+		}
+		if (getResource() < o.getResource()) { return -1; }
+		if (getResource() > o.getResource()) { return 1; }
+	}
+	return 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const InternedJID& jid) {
+	os << jid.toString();
+	return os;
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <iosfwd>
+#include <boost/shared_ptr.hpp>
+#if __cplusplus >= 201103L
+#include <functional>
+#endif
+
+#include <Swiften/Base/API.h>
+#include <Swiften/JID/JID.h>
+
+namespace Swift {
+	/**
+	 * A compact, immutable handle to a JID.
+	 *
+	 * All handles to the same JID share a single reference-counted copy of
+	 * its data, which holds the string form and the hash of the JID, and a
+	 * handle to its bare JID. This makes copying, comparing, hashing and
+	 * toBare() cheap, which is useful for keys of large or hot maps.
+	 *
+	 * The shared data is released when the last handle to it goes away.
+	 */
+	class SWIFTEN_API InternedJID {
+		public:
+			/**
+			 * Creates an invalid JID.
+			 */
+			InternedJID();
+
+			explicit InternedJID(const JID& jid);
+
+			bool isValid() const {
+				return data_.get() != NULL;
+			}
+
+			bool isBare() const;
+
+			const std::string& getNode() const;
+			const std::string& getDomain() const;
+			const std::string& getResource() const;
+
+			/**
+			 * Returns the bare JID. This does not allocate.
+			 */
+			InternedJID toBare() const;
+
+			const std::string& toString() const;
+			JID toJID() const;
+
+			size_t getHash() const;
+
+			int compare(const InternedJID& o, JID::CompareType compareType) const;
+
+			bool operator<(const InternedJID& b) const {
+				return compare(b, JID::WithResource) < 0;
+			}
+
+			friend bool operator==(const InternedJID& a, const InternedJID& b) {
+				// Equal JIDs share their data
+				return a.data_ == b.data_;
+			}
+
+			friend bool operator!=(const InternedJID& a, const InternedJID& b) {
+				return a.data_ != b.data_;
+			}
+
+		private:
+			struct Data;
+			explicit InternedJID(boost::shared_ptr<const Data> data);
+
+			boost::shared_ptr<const Data> data_;
+	};
+
+	SWIFTEN_API std::ostream& operator<<(std::ostream& os, const InternedJID& jid);
+
+	inline size_t hash_value(const InternedJID& jid) {
+		return jid.getHash();
+	}
+}
+
+#if __cplusplus >= 201103L
+namespace std {
+	template<> struct hash<Swift::InternedJID> {
+		size_t operator()(const Swift::InternedJID& jid) const {
+			return jid.getHash();
+		}
+	};
+}
+#endif
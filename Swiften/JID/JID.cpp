@@ -1,20 +1,19 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
-#define SWIFTEN_CACHE_JID_PREP
-
 #include <vector>
 #include <list>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 
 #include <string>
-#ifdef SWIFTEN_CACHE_JID_PREP
 #include <boost/thread/mutex.hpp>
-#include <boost/unordered_map.hpp>
-#endif
+#include <boost/thread/locks.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/assign/list_of.hpp>
 #include <boost/algorithm/string/find_format.hpp>
 #include <boost/algorithm/string/finder.hpp>
@@ -23,6 +22,7 @@
 #include <sstream>
 
 #include <Swiften/Base/String.h>
+#include <Swiften/Base/LRUCache.h>
 #include <Swiften/JID/JID.h>
 #include <Swiften/IDN/IDNConverter.h>
 #ifndef SWIFTEN_JID_NO_DEFAULT_IDN_CONVERTER
@@ -32,19 +32,183 @@
 
 using namespace Swift;
 
-#ifdef SWIFTEN_CACHE_JID_PREP
-typedef boost::unordered_map<std::string, std::string> PrepCache;
-
-static boost::mutex namePrepCacheMutex;
-static PrepCache nodePrepCache;
-static PrepCache domainPrepCache;
-static PrepCache resourcePrepCache;
-#endif
-
 static const std::list<char> escapedChars = boost::assign::list_of(' ')('"')('&')('\'')('/')('<')('>')('@')(':');
 
 static IDNConverter* idnConverter = NULL;
 
+namespace {
+	bool isASCIIAlphaNumeric(char c) {
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+	}
+
+	char toASCIILower(char c) {
+		return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+	}
+
+	/**
+	 * Checks whether a domain consists of labels that are valid host names
+	 * (RFC 1123), which pass IDNA encoding and nameprep unchanged, apart from
+	 * case.
+	 */
+	bool isASCIIHostName(const std::string& domain) {
+		if (domain.size() > 253) {
+			return false;
+		}
+		size_t labelSize = 0;
+		for (size_t i = 0; i < domain.size(); ++i) {
+			char c = domain[i];
+			if (c == '.') {
+				if (labelSize == 0 || domain[i - 1] == '-') {
+					return false;
+				}
+				labelSize = 0;
+			}
+			else if (isASCIIAlphaNumeric(c) || (c == '-' && labelSize > 0)) {
+				if (++labelSize > 63) {
+					return false;
+				}
+			}
+			else {
+				return false;
+			}
+		}
+		return labelSize > 0 && domain[domain.size() - 1] != '-';
+	}
+
+	/**
+	 * Prepares strings consisting of printable ASCII characters, without
+	 * going through the IDN converter.
+	 *
+	 * For these strings, the XMPP stringprep profiles only fold case, or
+	 * reject prohibited characters. Returns false if the string can not be
+	 * prepared this way, in which case the IDN converter has to handle it.
+	 */
+	bool getASCIIPrepared(const std::string& s, IDNConverter::StringPrepProfile profile, std::string& result) {
+		switch (profile) {
+			case IDNConverter::NamePrep:
+				if (!isASCIIHostName(s)) {
+					return false;
+				}
+				break;
+			case IDNConverter::XMPPNodePrep:
+				for (std::string::const_iterator i = s.begin(); i != s.end(); ++i) {
+					// Spaces, controls, and characters prohibited in nodes (RFC 3920, Appendix A.5)
+					unsigned char c = static_cast<unsigned char>(*i);
+					if (c <= ' ' || c >= 0x7F || std::strchr("\"&'/:<>@", c)) {
+						return false;
+					}
+				}
+				break;
+			case IDNConverter::XMPPResourcePrep:
+				for (std::string::const_iterator i = s.begin(); i != s.end(); ++i) {
+					unsigned char c = static_cast<unsigned char>(*i);
+					if (c < ' ' || c >= 0x7F) {
+						return false;
+					}
+				}
+				result = s;
+				return true;
+			default:
+				return false;
+		}
+		result.resize(s.size());
+		std::transform(s.begin(), s.end(), result.begin(), toASCIILower);
+		return true;
+	}
+
+	/**
+	 * A bounded cache of stringprep results for one profile.
+	 *
+	 * The cache is split into shards with their own lock, so that threads
+	 * preparing different strings rarely contend.
+	 */
+	class PrepCache {
+		public:
+			PrepCache(IDNConverter::StringPrepProfile profile) : profile(profile) {
+			}
+
+			/**
+			 * Prepares the given string, and returns false if it is invalid.
+			 */
+			bool prepare(const std::string& s, std::string& result) {
+				if (getASCIIPrepared(s, profile, result)) {
+					return true;
+				}
+
+				Shard& shard = shards[boost::hash<std::string>()(s) % ShardCount];
+				IDNConverter* converter;
+				unsigned int generation;
+				{
+					boost::lock_guard<boost::mutex> lock(shard.mutex);
+					if (const std::string* cachedResult = shard.cache.get(s)) {
+						result = *cachedResult;
+						return true;
+					}
+					converter = idnConverter;
+					generation = shard.generation;
+				}
+
+				if (profile == IDNConverter::NamePrep && !converter->getIDNAEncoded(s)) {
+					return false;
+				}
+				try {
+					result = converter->getStringPrepared(s, profile);
+				}
+				catch (...) {
+					return false;
+				}
+
+				boost::lock_guard<boost::mutex> lock(shard.mutex);
+				// Don't cache results of a converter that was replaced in the meantime
+				if (shard.generation == generation) {
+					shard.cache.put(s, result);
+				}
+				return true;
+			}
+
+			void lock() {
+				for (size_t i = 0; i < ShardCount; ++i) {
+					shards[i].mutex.lock();
+				}
+			}
+
+			void unlock() {
+				for (size_t i = 0; i < ShardCount; ++i) {
+					shards[i].mutex.unlock();
+				}
+			}
+
+			/**
+			 * Drops all cached results. Must be called with the cache locked.
+			 */
+			void clearLocked() {
+				for (size_t i = 0; i < ShardCount; ++i) {
+					shards[i].cache.clear();
+					++shards[i].generation;
+				}
+			}
+
+		private:
+			enum { ShardCount = 16, ShardCapacity = 1024 };
+
+			struct Shard {
+				Shard() : cache(ShardCapacity), generation(0) {}
+
+				boost::mutex mutex;
+				LRUCache<std::string, std::string> cache;
+				// Incremented whenever the converter changes
+				unsigned int generation;
+			};
+
+			IDNConverter::StringPrepProfile profile;
+			Shard shards[ShardCount];
+	};
+
+	PrepCache nodePrepCache(IDNConverter::XMPPNodePrep);
+	PrepCache domainPrepCache(IDNConverter::NamePrep);
+	PrepCache resourcePrepCache(IDNConverter::XMPPResourcePrep);
+}
+
 #ifndef SWIFTEN_JID_NO_DEFAULT_IDN_CONVERTER
 namespace {
 	struct IDNInitializer {
@@ -177,60 +341,11 @@ void JID::initializeFromString(const std::string& jid) {
 
 
 void JID::nameprepAndSetComponents(const std::string& node, const std::string& domain, const std::string& resource) {
-	if (domain.empty() || !idnConverter->getIDNAEncoded(domain)) {
-		valid_ = false;
-		return;
-	}
-#ifndef SWIFTEN_CACHE_JID_PREP
-	node_ = idnConverter->getStringPrepared(node, IDNConverter::XMPPNodePrep);
-	domain_ = idnConverter->getStringPrepared(domain, IDNConverter::NamePrep);
-	resource_ = idnConverter->getStringPrepared(resource, IDNConverter::XMPPResourcePrep);
-#else
-	boost::mutex::scoped_lock lock(namePrepCacheMutex);
-
-	std::pair<PrepCache::iterator, bool> r;
-
-	r = nodePrepCache.insert(std::make_pair(node, std::string()));
-	if (r.second) {
-		try {
-			r.first->second = idnConverter->getStringPrepared(node, IDNConverter::XMPPNodePrep);
-		}
-		catch (...) {
-			nodePrepCache.erase(r.first);
-			valid_ = false;
-			return;
-		}
-	}
-	node_ = r.first->second;
-
-	r = domainPrepCache.insert(std::make_pair(domain, std::string()));
-	if (r.second) {
-		try {
-			r.first->second = idnConverter->getStringPrepared(domain, IDNConverter::NamePrep);
-		}
-		catch (...) {
-			domainPrepCache.erase(r.first);
-			valid_ = false;
-			return;
-		}
-	}
-	domain_ = r.first->second;
-
-	r = resourcePrepCache.insert(std::make_pair(resource, std::string()));
-	if (r.second) {
-		try {
-			r.first->second = idnConverter->getStringPrepared(resource, IDNConverter::XMPPResourcePrep);
-		}
-		catch (...) {
-			resourcePrepCache.erase(r.first);
-			valid_ = false;
-			return;
-		}
-	}
-	resource_ = r.first->second;
-#endif
-
-	if (domain_.empty()) {
+	if (domain.empty()
+			|| !nodePrepCache.prepare(node, node_)
+			|| !domainPrepCache.prepare(domain, domain_)
+			|| !resourcePrepCache.prepare(resource, resource_)
+			|| domain_.empty()) {
 		valid_ = false;
 		return;
 	}
@@ -310,7 +425,18 @@ std::string JID::getUnescapedNode() const {
 }
 
 void JID::setIDNConverter(IDNConverter* converter) {
+	// The converter is only read with a cache shard locked, so holding all
+	// locks keeps other threads from using or caching results of the old one.
+	nodePrepCache.lock();
+	domainPrepCache.lock();
+	resourcePrepCache.lock();
 	idnConverter = converter;
+	nodePrepCache.clearLocked();
+	domainPrepCache.clearLocked();
+	resourcePrepCache.clearLocked();
+	resourcePrepCache.unlock();
+	domainPrepCache.unlock();
+	nodePrepCache.unlock();
 }
 
 std::ostream& operator<<(std::ostream& os, const JID& j) {
@@ -318,6 +444,15 @@ std::ostream& operator<<(std::ostream& os, const JID& j) {
 	return os;
 }
 
+size_t hash_value(const JID& jid) {
+	size_t seed = boost::hash_value(jid.getNode());
+	boost::hash_combine(seed, jid.getDomain());
+	if (!jid.isBare()) {
+		boost::hash_combine(seed, jid.getResource());
+	}
+	return seed;
+}
+
 boost::optional<JID> JID::parse(const std::string& s) {
 	JID jid(s);
 	return jid.isValid() ? jid : boost::optional<JID>();
@@ -1,13 +1,17 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <iosfwd>
+#if __cplusplus >= 201103L
+#include <functional>
+#endif
 
 #include <Swiften/Base/API.h>
 #include <boost/optional/optional_fwd.hpp>
@@ -194,5 +198,20 @@ namespace Swift {
 	};
 	
 	SWIFTEN_API std::ostream& operator<<(std::ostream& os, const Swift::JID& j);
+
+	/**
+	 * Hashes a JID, for use in hashed containers such as boost::unordered_map.
+	 */
+	SWIFTEN_API size_t hash_value(const JID& jid);
+}
+
+#if __cplusplus >= 201103L
+namespace std {
+	template<> struct hash<Swift::JID> {
+		size_t operator()(const Swift::JID& jid) const {
+			return Swift::hash_value(jid);
+		}
+	};
 }
+#endif
 
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <Swiften/JID/InternedJID.h>
+
+using namespace Swift;
+
+class InternedJIDTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(InternedJIDTest);
+		CPPUNIT_TEST(testConstructor);
+		CPPUNIT_TEST(testConstructor_Bare);
+		CPPUNIT_TEST(testConstructor_Invalid);
+		CPPUNIT_TEST(testToBare);
+		CPPUNIT_TEST(testToBare_Bare);
+		CPPUNIT_TEST(testToJID);
+		CPPUNIT_TEST(testEquals);
+		CPPUNIT_TEST(testEquals_EmptyResource);
+		CPPUNIT_TEST(testEquals_AfterRelease);
+		CPPUNIT_TEST(testCompare);
+		CPPUNIT_TEST(testHash);
+		CPPUNIT_TEST(testUnorderedMap);
+		CPPUNIT_TEST(testJIDHash);
+		CPPUNIT_TEST(testConstructor_MultipleThreads);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void testConstructor() {
+			InternedJID testling(JID("Foo@Bar/Baz"));
+
+			CPPUNIT_ASSERT(testling.isValid());
+			CPPUNIT_ASSERT(!testling.isBare());
+			CPPUNIT_ASSERT_EQUAL(std::string("foo"), testling.getNode());
+			CPPUNIT_ASSERT_EQUAL(std::string("bar"), testling.getDomain());
+			CPPUNIT_ASSERT_EQUAL(std::string("Baz"), testling.getResource());
+			CPPUNIT_ASSERT_EQUAL(std::string("foo@bar/Baz"), testling.toString());
+		}
+
+		void testConstructor_Bare() {
+			InternedJID testling(JID("foo@bar"));
+
+			CPPUNIT_ASSERT(testling.isBare());
+			CPPUNIT_ASSERT_EQUAL(std::string("foo@bar"), testling.toString());
+		}
+
+		void testConstructor_Invalid() {
+			InternedJID testling(JID("@bar"));
+
+			CPPUNIT_ASSERT(!testling.isValid());
+			CPPUNIT_ASSERT(testling == InternedJID());
+			CPPUNIT_ASSERT_EQUAL(std::string(""), testling.toString());
+		}
+
+		void testToBare() {
+			InternedJID testling(JID("foo@bar/baz"));
+
+			InternedJID bare = testling.toBare();
+			CPPUNIT_ASSERT(bare.isBare());
+			CPPUNIT_ASSERT_EQUAL(std::string("foo@bar"), bare.toString());
+			CPPUNIT_ASSERT(bare == InternedJID(JID("foo@bar")));
+		}
+
+		void testToBare_Bare() {
+			InternedJID testling(JID("foo@bar"));
+
+			CPPUNIT_ASSERT(testling.toBare() == testling);
+		}
+
+		void testToJID() {
+			CPPUNIT_ASSERT_EQUAL(JID("foo@bar/baz"), InternedJID(JID("foo@bar/baz")).toJID());
+			CPPUNIT_ASSERT_EQUAL(JID("foo@bar"), InternedJID(JID("foo@bar")).toJID());
+			CPPUNIT_ASSERT_EQUAL(JID("bar/"), InternedJID(JID("bar/")).toJID());
+		}
+
+		void testEquals() {
+			CPPUNIT_ASSERT(InternedJID(JID("foo@bar/baz")) == InternedJID(JID("FOO@bar/baz")));
+			CPPUNIT_ASSERT(InternedJID(JID("foo@bar/baz")) != InternedJID(JID("foo@bar/Baz")));
+			CPPUNIT_ASSERT(InternedJID(JID("foo@bar/baz")) != InternedJID(JID("foo@bar")));
+		}
+
+		void testEquals_EmptyResource() {
+			CPPUNIT_ASSERT(InternedJID(JID("bar/")) != InternedJID(JID("bar")));
+		}
+
+		void testEquals_AfterRelease() {
+			std::string string;
+			{
+				InternedJID testling(JID("foo@bar/baz"));
+				string = testling.toString();
+			}
+
+			InternedJID testling(JID("foo@bar/baz"));
+			CPPUNIT_ASSERT_EQUAL(string, testling.toString());
+			CPPUNIT_ASSERT(testling.toBare() == InternedJID(JID("foo@bar")));
+		}
+
+		void testCompare() {
+			CPPUNIT_ASSERT(InternedJID(JID("a@bar")) < InternedJID(JID("b@bar")));
+			CPPUNIT_ASSERT(InternedJID(JID("a@bar")) < InternedJID(JID("a@bar/baz")));
+			CPPUNIT_ASSERT(!(InternedJID(JID("a@bar/baz")) < InternedJID(JID("a@bar/baz"))));
+			CPPUNIT_ASSERT_EQUAL(0, InternedJID(JID("a@bar/baz")).compare(InternedJID(JID("a@bar/fum")), JID::WithoutResource));
+		}
+
+		void testHash() {
+			CPPUNIT_ASSERT_EQUAL(InternedJID(JID("foo@bar/baz")).getHash(), InternedJID(JID("FOO@bar/baz")).getHash());
+			CPPUNIT_ASSERT_EQUAL(hash_value(JID("foo@bar/baz")), InternedJID(JID("foo@bar/baz")).getHash());
+		}
+
+		void testUnorderedMap() {
+			boost::unordered_map<InternedJID, int> testling;
+			testling[InternedJID(JID("foo@bar/baz"))] = 1;
+			testling[InternedJID(JID("foo@bar"))] = 2;
+
+			CPPUNIT_ASSERT_EQUAL(1, testling[InternedJID(JID("foo@bar/baz"))]);
+			CPPUNIT_ASSERT_EQUAL(2, testling[InternedJID(JID("foo@bar/baz")).toBare()]);
+			CPPUNIT_ASSERT(testling.find(InternedJID(JID("foo@bar/fum"))) == testling.end());
+		}
+
+		void testJIDHash() {
+			boost::unordered_map<JID, int> testling;
+			testling[JID("foo@bar/baz")] = 1;
+			testling[JID("foo@bar")] = 2;
+
+			CPPUNIT_ASSERT_EQUAL(1, testling[JID("FOO@bar/baz")]);
+			CPPUNIT_ASSERT_EQUAL(2, testling[JID("foo@bar")]);
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), testling.size());
+		}
+
+		void testConstructor_MultipleThreads() {
+			std::vector<boost::shared_ptr<boost::thread> > threads;
+			std::vector<int> failures(4, 0);
+			for (size_t i = 0; i < failures.size(); ++i) {
+				threads.push_back(boost::make_shared<boost::thread>(boost::bind(&InternedJIDTest::internJIDs, &failures[i])));
+			}
+			for (size_t i = 0; i < threads.size(); ++i) {
+				threads[i]->join();
+			}
+			for (size_t i = 0; i < failures.size(); ++i) {
+				CPPUNIT_ASSERT_EQUAL(0, failures[i]);
+			}
+		}
+
+	private:
+		static void internJIDs(int* failures) {
+			for (int i = 0; i < 10000; ++i) {
+				std::string index = boost::lexical_cast<std::string>(i % 100);
+				InternedJID jid(JID("user" + index + "@example.com/resource" + index));
+				if (jid.toString() != "user" + index + "@example.com/resource" + index || jid.toBare().toString() != "user" + index + "@example.com") {
+					++*failures;
+				}
+			}
+		}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(InternedJIDTest);
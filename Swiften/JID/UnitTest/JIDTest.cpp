@@ -1,13 +1,20 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
 
 #include <Swiften/JID/JID.h>
+#include <Swiften/IDN/IDNConverter.h>
+#include <Swiften/IDN/PlatformIDNConverter.h>
 
 using namespace Swift;
 
@@ -28,6 +35,9 @@ class JIDTest : public CppUnit::TestFixture
 		CPPUNIT_TEST(testConstructorWithString_SpacesInNode);
 		CPPUNIT_TEST(testConstructorWithStrings);
 		CPPUNIT_TEST(testConstructorWithStrings_EmptyDomain);
+		CPPUNIT_TEST(testConstructorWithStrings_ASCII);
+		CPPUNIT_TEST(testConstructorWithStrings_LongDomainLabel);
+		CPPUNIT_TEST(testConstructorWithStrings_MultipleThreads);
 		CPPUNIT_TEST(testIsBare);
 		CPPUNIT_TEST(testIsBare_NotBare);
 		CPPUNIT_TEST(testToBare);
@@ -162,6 +172,56 @@ class JIDTest : public CppUnit::TestFixture
 			CPPUNIT_ASSERT(!testling.isValid());
 		}
 
+		void testConstructorWithStrings_ASCII() {
+			boost::shared_ptr<IDNConverter> idnConverter(PlatformIDNConverter::create());
+			for (int c = 1; c < 0x80; ++c) {
+				std::string s = "a" + std::string(1, static_cast<char>(c)) + "B";
+
+				JID nodeJID(s, "example.com");
+				boost::optional<std::string> node = getStringPrepared(idnConverter, s, IDNConverter::XMPPNodePrep);
+				CPPUNIT_ASSERT_EQUAL(static_cast<bool>(node), nodeJID.isValid());
+				if (node) {
+					CPPUNIT_ASSERT_EQUAL(*node, nodeJID.getNode());
+				}
+
+				JID domainJID("", s + ".example.com");
+				boost::optional<std::string> domain;
+				if (idnConverter->getIDNAEncoded(s + ".example.com")) {
+					domain = getStringPrepared(idnConverter, s + ".example.com", IDNConverter::NamePrep);
+				}
+				CPPUNIT_ASSERT_EQUAL(static_cast<bool>(domain), domainJID.isValid());
+				if (domain) {
+					CPPUNIT_ASSERT_EQUAL(*domain, domainJID.getDomain());
+				}
+
+				JID resourceJID("", "example.com", s);
+				boost::optional<std::string> resource = getStringPrepared(idnConverter, s, IDNConverter::XMPPResourcePrep);
+				CPPUNIT_ASSERT_EQUAL(static_cast<bool>(resource), resourceJID.isValid());
+				if (resource) {
+					CPPUNIT_ASSERT_EQUAL(*resource, resourceJID.getResource());
+				}
+			}
+		}
+
+		void testConstructorWithStrings_LongDomainLabel() {
+			CPPUNIT_ASSERT(JID("foo", std::string(63, 'a') + ".com").isValid());
+			CPPUNIT_ASSERT(!JID("foo", std::string(64, 'a') + ".com").isValid());
+		}
+
+		void testConstructorWithStrings_MultipleThreads() {
+			std::vector<boost::shared_ptr<boost::thread> > threads;
+			std::vector<int> failures(4, 0);
+			for (size_t i = 0; i < failures.size(); ++i) {
+				threads.push_back(boost::make_shared<boost::thread>(boost::bind(&JIDTest::constructJIDs, &failures[i])));
+			}
+			for (size_t i = 0; i < threads.size(); ++i) {
+				threads[i]->join();
+			}
+			for (size_t i = 0; i < failures.size(); ++i) {
+				CPPUNIT_ASSERT_EQUAL(0, failures[i]);
+			}
+		}
+
 		void testIsBare() {
 			CPPUNIT_ASSERT(JID("foo@bar").isBare());
 		}
@@ -396,6 +456,27 @@ class JIDTest : public CppUnit::TestFixture
 			CPPUNIT_ASSERT_EQUAL(std::string("c:\\cool stuff"), JID("c\\3a\\cool\\20stuff@example.com").getUnescapedNode());
 			CPPUNIT_ASSERT_EQUAL(std::string("c:\\5commas"), JID("c\\3a\\5c5commas@example.com").getUnescapedNode());
 		}
+
+	private:
+		static boost::optional<std::string> getStringPrepared(boost::shared_ptr<IDNConverter> idnConverter, const std::string& s, IDNConverter::StringPrepProfile profile) {
+			try {
+				return idnConverter->getStringPrepared(s, profile);
+			}
+			catch (...) {
+				return boost::optional<std::string>();
+			}
+		}
+
+		static void constructJIDs(int* failures) {
+			// Use more distinct strings than fit in the cache, to exercise eviction
+			for (int i = 0; i < 20000; ++i) {
+				std::string index = boost::lexical_cast<std::string>(i % 5000);
+				JID jid("Fo\xCE\xA9" + index + "@Bar\xCE\xA9/Fo\xCE\xA9" + index);
+				if (jid.getNode() != "fo\xCF\x89" + index || jid.getDomain() != "bar\xCF\x89" || jid.getResource() != "Fo\xCE\xA9" + index) {
+					++*failures;
+				}
+			}
+		}
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(JIDTest);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011 Isode Limited.
+ * Copyright (c) 2011-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -40,7 +40,7 @@ BOSHConnectionPool::BOSHConnectionPool(const URL& boshURL, DomainNameResolver* r
 		connectionFactory = new TLSConnectionFactory(tlsFactory, connectionFactory);
 		myConnectionFactories.push_back(connectionFactory);
 	}
-	resolver = new CachingDomainNameResolver(realResolver, eventLoop);
+	resolver = new CachingDomainNameResolver(realResolver, timerFactory, eventLoop);
 	createConnection();
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -17,6 +17,7 @@
 #include <boost/numeric/conversion/cast.hpp>
 
 #include <Swiften/Base/Log.h>
+#include <Swiften/Base/foreach.h>
 #include <Swiften/Base/Algorithm.h>
 #include <Swiften/EventLoop/EventLoop.h>
 #include <Swiften/Base/ByteArray.h>
@@ -26,33 +27,57 @@
 
 namespace Swift {
 
-static const size_t BUFFER_SIZE = 4096;
+static const size_t MIN_READ_BUFFER_SIZE = 4096;
+static const size_t MAX_READ_BUFFER_SIZE = 65536;
+static const size_t READ_BUFFER_POOL_SIZE = 4;
+static const size_t WRITE_BUFFER_POOL_SIZE = 2;
+
+// Batches with more buffers than this are coalesced into a single buffer,
+// since the system won't write more buffers at once anyway.
+static const size_t MAX_WRITE_BUFFERS = 64;
 
 // -----------------------------------------------------------------------------
 
-// A reference-counted non-modifiable buffer class.
-class SharedBuffer {
+// A reference-counted sequence of non-modifiable buffers.
+template<typename WriteBuffer>
+class SharedBufferSequence {
 	public:
-		SharedBuffer(const SafeByteArray& data) :
-				data_(new std::vector<char, SafeAllocator<char> >(data.begin(), data.end())),
-				buffer_(boost::asio::buffer(*data_)) {
+		// Takes over the buffers in data.
+		SharedBufferSequence(std::vector<WriteBuffer>& data) :
+				data_(boost::make_shared< std::vector<WriteBuffer> >()),
+				buffers_(boost::make_shared< std::vector<boost::asio::const_buffer> >()) {
+			data_->swap(data);
+			if (data_->size() > MAX_WRITE_BUFFERS) {
+				boost::shared_ptr<SafeByteArray> coalescedData = boost::make_shared<SafeByteArray>();
+				foreach (const WriteBuffer& buffer, *data_) {
+					const unsigned char* bytes = boost::asio::buffer_cast<const unsigned char*>(buffer.buffer);
+					coalescedData->insert(coalescedData->end(), bytes, bytes + boost::asio::buffer_size(buffer.buffer));
+				}
+				data_->assign(1, WriteBuffer(coalescedData, vecptr(*coalescedData), coalescedData->size()));
+			}
+			buffers_->reserve(data_->size());
+			foreach (const WriteBuffer& buffer, *data_) {
+				if (boost::asio::buffer_size(buffer.buffer) > 0) {
+					buffers_->push_back(buffer.buffer);
+				}
+			}
 		}
 
 		// ConstBufferSequence requirements.
 		typedef boost::asio::const_buffer value_type;
-		typedef const boost::asio::const_buffer* const_iterator;
-		const boost::asio::const_buffer* begin() const { return &buffer_; }
-		const boost::asio::const_buffer* end() const { return &buffer_ + 1; }
+		typedef std::vector<boost::asio::const_buffer>::const_iterator const_iterator;
+		const_iterator begin() const { return buffers_->begin(); }
+		const_iterator end() const { return buffers_->end(); }
 
 	private:
-		boost::shared_ptr< std::vector<char, SafeAllocator<char> > > data_;
-		boost::asio::const_buffer buffer_;
+		boost::shared_ptr< std::vector<WriteBuffer> > data_;
+		boost::shared_ptr< std::vector<boost::asio::const_buffer> > buffers_;
 };
 
 // -----------------------------------------------------------------------------
 
 BoostConnection::BoostConnection(boost::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop) :
-	eventLoop(eventLoop), ioService(ioService), socket_(*ioService), writing_(false), closeSocketAfterNextWrite_(false) {
+	eventLoop(eventLoop), ioService(ioService), socket_(*ioService), readBufferSize_(MIN_READ_BUFFER_SIZE), writing_(false), closeSocketAfterNextWrite_(false) {
 }
 
 BoostConnection::~BoostConnection() {
@@ -92,17 +117,36 @@ void BoostConnection::closeSocket() {
 
 void BoostConnection::write(const SafeByteArray& data) {
 	boost::lock_guard<boost::mutex> lock(writeMutex_);
+	// Consecutive copied writes share one buffer, instead of allocating one per write
+	if (writeQueue_.empty() || writeQueue_.back().data != pendingCopy_) {
+		pendingCopy_ = getWriteBuffer();
+		writeQueue_.push_back(WriteBuffer(pendingCopy_, NULL, 0));
+	}
+	append(*pendingCopy_, data);
+	writeQueue_.back().buffer = boost::asio::const_buffer(vecptr(*pendingCopy_), pendingCopy_->size());
 	if (!writing_) {
 		writing_ = true;
-		doWrite(data);
+		doWrite();
 	}
-	else {
-		append(writeQueue_, data);
+}
+
+void BoostConnection::writeShared(boost::shared_ptr<const ByteArray> data) {
+	queueWrite(WriteBuffer(data, vecptr(*data), data->size()));
+}
+
+void BoostConnection::queueWrite(const WriteBuffer& buffer) {
+	boost::lock_guard<boost::mutex> lock(writeMutex_);
+	writeQueue_.push_back(buffer);
+	if (!writing_) {
+		writing_ = true;
+		doWrite();
 	}
 }
 
-void BoostConnection::doWrite(const SafeByteArray& data) {
-	boost::asio::async_write(socket_, SharedBuffer(data),
+// Writes all queued data at once. Must be called with writeMutex_ locked.
+void BoostConnection::doWrite() {
+	pendingCopy_.reset();
+	boost::asio::async_write(socket_, SharedBufferSequence<WriteBuffer>(writeQueue_),
 			boost::bind(&BoostConnection::handleDataWritten, shared_from_this(), boost::asio::placeholders::error));
 }
 
@@ -118,7 +162,7 @@ void BoostConnection::handleConnectFinished(const boost::system::error_code& err
 }
 
 void BoostConnection::doRead() {
-	readBuffer_ = boost::make_shared<SafeByteArray>(BUFFER_SIZE);
+	readBuffer_ = getReadBuffer();
 	socket_.async_read_some(
 			boost::asio::buffer(*readBuffer_),
 			boost::bind(&BoostConnection::handleSocketRead, shared_from_this(), boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred));
@@ -127,6 +171,13 @@ void BoostConnection::doRead() {
 void BoostConnection::handleSocketRead(const boost::system::error_code& error, size_t bytesTransferred) {
 	SWIFT_LOG(debug) << "Socket read " << error << std::endl;
 	if (!error) {
+		// Adapt the size of the next read to the amount of data that is coming in
+		if (bytesTransferred == readBuffer_->size()) {
+			readBufferSize_ = std::min(2 * readBufferSize_, MAX_READ_BUFFER_SIZE);
+		}
+		else if (bytesTransferred < readBufferSize_ / 4) {
+			readBufferSize_ = std::max(readBufferSize_ / 2, MIN_READ_BUFFER_SIZE);
+		}
 		readBuffer_->resize(bytesTransferred);
 		eventLoop->postEvent(boost::bind(boost::ref(onDataRead), readBuffer_), shared_from_this());
 		doRead();
@@ -159,12 +210,51 @@ void BoostConnection::handleDataWritten(const boost::system::error_code& error)
 			}
 		}
 		else {
-			doWrite(writeQueue_);
-			writeQueue_.clear();
+			doWrite();
 		}
 	}
 }
 
+/**
+ * Returns a buffer for the next read.
+ *
+ * Buffers are handed out to onDataRead, so a pooled buffer is only reused
+ * once nobody else holds a reference to it anymore.
+ */
+boost::shared_ptr<SafeByteArray> BoostConnection::getReadBuffer() {
+	foreach (const boost::shared_ptr<SafeByteArray>& buffer, readBufferPool_) {
+		if (buffer.unique()) {
+			buffer->resize(readBufferSize_);
+			return buffer;
+		}
+	}
+	boost::shared_ptr<SafeByteArray> buffer = boost::make_shared<SafeByteArray>(readBufferSize_);
+	if (readBufferPool_.size() < READ_BUFFER_POOL_SIZE) {
+		readBufferPool_.push_back(buffer);
+	}
+	return buffer;
+}
+
+/**
+ * Returns an empty buffer to copy written data into.
+ *
+ * Pooled buffers keep their capacity, and are only reused once the write
+ * they were part of has finished.
+ */
+boost::shared_ptr<SafeByteArray> BoostConnection::getWriteBuffer() {
+	foreach (const boost::shared_ptr<SafeByteArray>& buffer, writeBufferPool_) {
+		if (buffer.unique()) {
+			buffer->clear();
+			return buffer;
+		}
+	}
+	boost::shared_ptr<SafeByteArray> buffer = boost::make_shared<SafeByteArray>();
+	if (writeBufferPool_.size() < WRITE_BUFFER_POOL_SIZE) {
+		writeBufferPool_.push_back(buffer);
+	}
+	return buffer;
+}
+
 HostAddressPort BoostConnection::getLocalAddress() const {
 	return HostAddressPort(socket_.local_endpoint());
 }
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <vector>
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/enable_shared_from_this.hpp>
@@ -40,6 +41,7 @@ namespace Swift {
 			virtual void connect(const HostAddressPort& address);
 			virtual void disconnect();
 			virtual void write(const SafeByteArray& data);
+			virtual void writeShared(boost::shared_ptr<const ByteArray> data);
 
 			boost::asio::ip::tcp::socket& getSocket() {
 				return socket_;
@@ -48,23 +50,40 @@ namespace Swift {
 			HostAddressPort getLocalAddress() const;
 
 		private:
+			// A queued buffer, together with the data keeping it alive.
+			struct WriteBuffer {
+				WriteBuffer(boost::shared_ptr<const void> data, const unsigned char* bytes, size_t size) : data(data), buffer(bytes, size) {
+				}
+
+				boost::shared_ptr<const void> data;
+				boost::asio::const_buffer buffer;
+			};
+
 			BoostConnection(boost::shared_ptr<boost::asio::io_service> ioService, EventLoop* eventLoop);
 
+			void queueWrite(const WriteBuffer& buffer);
+
 			void handleConnectFinished(const boost::system::error_code& error);
 			void handleSocketRead(const boost::system::error_code& error, size_t bytesTransferred);
 			void handleDataWritten(const boost::system::error_code& error);
 			void doRead();
-			void doWrite(const SafeByteArray& data);
+			void doWrite();
 			void closeSocket();
+			boost::shared_ptr<SafeByteArray> getReadBuffer();
+			boost::shared_ptr<SafeByteArray> getWriteBuffer();
 
 		private:
 			EventLoop* eventLoop;
 			boost::shared_ptr<boost::asio::io_service> ioService;
 			boost::asio::ip::tcp::socket socket_;
 			boost::shared_ptr<SafeByteArray> readBuffer_;
+			std::vector< boost::shared_ptr<SafeByteArray> > readBufferPool_;
+			size_t readBufferSize_;
 			boost::mutex writeMutex_;
 			bool writing_;
-			SafeByteArray writeQueue_;
+			std::vector<WriteBuffer> writeQueue_;
+			boost::shared_ptr<SafeByteArray> pendingCopy_;
+			std::vector< boost::shared_ptr<SafeByteArray> > writeBufferPool_;
 			bool closeSocketAfterNextWrite_;
 	};
 }
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/Network/BoostIOServicePool.h>
+
+#include <cassert>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <Swiften/Base/foreach.h>
+#include <Swiften/EventLoop/SimpleEventLoop.h>
+#include <Swiften/Network/BoostNetworkFactories.h>
+
+namespace Swift {
+
+BoostIOServicePool::BoostIOServicePool(size_t shardCount) : nextShard_(0) {
+	if (shardCount == 0) {
+		shardCount = std::max(1U, boost::thread::hardware_concurrency());
+	}
+	for (size_t i = 0; i < shardCount; ++i) {
+		Shard shard;
+		shard.eventLoop = new SimpleEventLoop();
+		shard.networkFactories = new BoostNetworkFactories(shard.eventLoop);
+		shard.thread = new boost::thread(boost::bind(&SimpleEventLoop::run, shard.eventLoop));
+		shards_.push_back(shard);
+	}
+}
+
+BoostIOServicePool::~BoostIOServicePool() {
+	foreach (Shard& shard, shards_) {
+		shard.eventLoop->stop();
+	}
+	foreach (Shard& shard, shards_) {
+		shard.thread->join();
+		delete shard.thread;
+		delete shard.networkFactories;
+		delete shard.eventLoop;
+	}
+}
+
+size_t BoostIOServicePool::getNextShard() {
+	size_t result = nextShard_;
+	nextShard_ = (nextShard_ + 1) % shards_.size();
+	return result;
+}
+
+NetworkFactories* BoostIOServicePool::getNetworkFactories(size_t shard) const {
+	assert(shard < shards_.size());
+	return shards_[shard].networkFactories;
+}
+
+EventLoop* BoostIOServicePool::getEventLoop(size_t shard) const {
+	assert(shard < shards_.size());
+	return shards_[shard].eventLoop;
+}
+
+void BoostIOServicePool::post(size_t shard, const boost::function<void()>& function) {
+	assert(shard < shards_.size());
+	shards_[shard].eventLoop->postEvent(function);
+}
+
+}
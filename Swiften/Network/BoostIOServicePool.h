@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <Swiften/Base/API.h>
+
+namespace boost {
+	class thread;
+}
+
+namespace Swift {
+	class EventLoop;
+	class SimpleEventLoop;
+	class NetworkFactories;
+	class BoostNetworkFactories;
+
+	/**
+	 * A pool of shards, each of which runs its own io_service thread and its
+	 * own event loop thread.
+	 *
+	 * All connections and timers created from the network factories of a shard
+	 * run on that shard's threads, and all their callbacks are handled on the
+	 * shard's event loop. Clients that are assigned to different shards
+	 * therefore do not share any threads or locks, which allows a large
+	 * number of independent clients to scale over multiple cores.
+	 *
+	 * Since callbacks of a shard are handled on its own thread, objects that
+	 * use a shard's network factories should only be accessed from that
+	 * shard's event loop (e.g. using post()).
+	 */
+	class SWIFTEN_API BoostIOServicePool : public boost::noncopyable {
+		public:
+			/**
+			 * Creates a pool with the given number of shards.
+			 * If the number of shards is 0, one shard per hardware thread is
+			 * created.
+			 */
+			BoostIOServicePool(size_t shardCount = 0);
+			~BoostIOServicePool();
+
+			size_t getShardCount() const {
+				return shards_.size();
+			}
+
+			/**
+			 * Returns the shard that the next connection should be assigned to.
+			 * Shards are handed out round-robin.
+			 */
+			size_t getNextShard();
+
+			NetworkFactories* getNetworkFactories(size_t shard) const;
+			EventLoop* getEventLoop(size_t shard) const;
+
+			/**
+			 * Runs the given function on the event loop of the given shard.
+			 */
+			void post(size_t shard, const boost::function<void()>& function);
+
+		private:
+			struct Shard {
+				SimpleEventLoop* eventLoop;
+				BoostNetworkFactories* networkFactories;
+				boost::thread* thread;
+			};
+
+			std::vector<Shard> shards_;
+			size_t nextShard_;
+	};
+}
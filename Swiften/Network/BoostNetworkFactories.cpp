@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -19,6 +19,7 @@
 #include <Swiften/IDN/IDNConverter.h>
 #include <Swiften/Crypto/PlatformCryptoProvider.h>
 #include <Swiften/Crypto/CryptoProvider.h>
+#include <Swiften/Network/CachingDomainNameResolver.h>
 
 #ifdef USE_UNBOUND
 #include <Swiften/Network/UnboundDomainNameResolver.h>
@@ -44,16 +45,18 @@ BoostNetworkFactories::BoostNetworkFactories(EventLoop* eventLoop) : eventLoop(e
 	idnConverter = PlatformIDNConverter::create();
 #ifdef USE_UNBOUND
 	// TODO: What to do about idnConverter.
-	domainNameResolver = new UnboundDomainNameResolver(idnConverter, ioServiceThread.getIOService(), eventLoop);
+	platformDomainNameResolver = new UnboundDomainNameResolver(idnConverter, ioServiceThread.getIOService(), eventLoop);
 #else
-	domainNameResolver = new PlatformDomainNameResolver(idnConverter, eventLoop);
+	platformDomainNameResolver = new PlatformDomainNameResolver(idnConverter, eventLoop);
 #endif
+	domainNameResolver = new CachingDomainNameResolver(platformDomainNameResolver, timerFactory, eventLoop);
 	cryptoProvider = PlatformCryptoProvider::create();
 }
 
 BoostNetworkFactories::~BoostNetworkFactories() {
 	delete cryptoProvider;
 	delete domainNameResolver;
+	delete platformDomainNameResolver;
 	delete idnConverter;
 	delete proxyProvider;
 	delete tlsFactories;
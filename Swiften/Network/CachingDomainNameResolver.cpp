@@ -1,30 +1,246 @@
 /*
- * Copyright (c) 2012 Isode Limited.
+ * Copyright (c) 2012-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Network/CachingDomainNameResolver.h>
 
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/function.hpp>
 #include <boost/smart_ptr/make_shared.hpp>
 
+#include <Swiften/Base/foreach.h>
+#include <Swiften/Base/Log.h>
+#include <Swiften/EventLoop/EventLoop.h>
+#include <Swiften/EventLoop/EventOwner.h>
+#include <Swiften/Network/Timer.h>
+#include <Swiften/Network/TimerFactory.h>
+
+namespace {
+	const int DEFAULT_TTL = 300;
+	const int MAXIMUM_TTL = 3600;
+	const int NEGATIVE_TTL = 30;
+	const size_t CACHE_SIZE = 1000;
+
+	class CachingDomainNameResolverEventOwner : public Swift::EventOwner {
+	};
+}
+
 namespace Swift {
 
-CachingDomainNameResolver::CachingDomainNameResolver(DomainNameResolver* realResolver, EventLoop*) : realResolver(realResolver) {
+class CachingDomainNameResolver::CachedServiceQuery : public DomainNameServiceQuery, public boost::enable_shared_from_this<CachedServiceQuery> {
+	public:
+		CachedServiceQuery(const std::string& serviceLookupPrefix, const std::string& domain, CachingDomainNameResolver* resolver) : serviceLookupPrefix(serviceLookupPrefix), domain(domain), resolver(resolver) {
+		}
+
+		virtual void run() {
+			resolver->runServiceQuery(shared_from_this());
+		}
+
+		void emitResult(const std::vector<DomainNameServiceQuery::Result>& result) {
+			onResult(result);
+		}
+
+		std::string getService() const {
+			return serviceLookupPrefix + domain;
+		}
+
+		std::string serviceLookupPrefix;
+		std::string domain;
+		CachingDomainNameResolver* resolver;
+};
+
+class CachingDomainNameResolver::CachedAddressQuery : public DomainNameAddressQuery, public boost::enable_shared_from_this<CachedAddressQuery> {
+	public:
+		CachedAddressQuery(const std::string& name, CachingDomainNameResolver* resolver) : name(name), resolver(resolver) {
+		}
+
+		virtual void run() {
+			resolver->runAddressQuery(shared_from_this());
+		}
+
+		void emitResult(const std::vector<HostAddress>& addresses, boost::optional<DomainNameResolveError> error) {
+			onResult(addresses, error);
+		}
+
+		std::string name;
+		CachingDomainNameResolver* resolver;
+};
+
+/**
+ * Calls a callback when a cache entry expires, unless the entry was
+ * removed from the cache before.
+ */
+class CachingDomainNameResolver::Expiry {
+	public:
+		Expiry(Timer::ref timer, const boost::function<void ()>& callback) : timer(timer) {
+			connection = timer->onTick.connect(callback);
+			timer->start();
+		}
+
+		~Expiry() {
+			connection.disconnect();
+			timer->stop();
+		}
+
+	private:
+		Timer::ref timer;
+		boost::bsignals::connection connection;
+};
+
+CachingDomainNameResolver::CachingDomainNameResolver(DomainNameResolver* realResolver, TimerFactory* timerFactory, EventLoop* eventLoop) :
+		realResolver(realResolver),
+		timerFactory(timerFactory),
+		eventLoop(eventLoop),
+		owner(boost::make_shared<CachingDomainNameResolverEventOwner>()),
+		defaultTTL(DEFAULT_TTL),
+		maximumTTL(MAXIMUM_TTL),
+		negativeTTL(NEGATIVE_TTL),
+		serviceCache(CACHE_SIZE),
+		addressCache(CACHE_SIZE) {
 }
 
 CachingDomainNameResolver::~CachingDomainNameResolver() {
-
+	eventLoop->removeEventsFromOwner(owner);
+	for (std::map<std::string, PendingServiceQuery>::iterator i = pendingServiceQueries.begin(); i != pendingServiceQueries.end(); ++i) {
+		i->second.query->onResult.disconnect_all_slots();
+	}
+	for (std::map<std::string, PendingAddressQuery>::iterator i = pendingAddressQueries.begin(); i != pendingAddressQueries.end(); ++i) {
+		i->second.query->onResult.disconnect_all_slots();
+	}
 }
 
 DomainNameServiceQuery::ref CachingDomainNameResolver::createServiceQuery(const std::string& serviceLookupPrefix, const std::string& domain) {
-	//TODO: Cache
-	return realResolver->createServiceQuery(serviceLookupPrefix, domain);
+	return boost::make_shared<CachedServiceQuery>(serviceLookupPrefix, domain, this);
 }
 
 DomainNameAddressQuery::ref CachingDomainNameResolver::createAddressQuery(const std::string& name) {
-	//TODO: Cache
-	return realResolver->createAddressQuery(name);
+	return boost::make_shared<CachedAddressQuery>(name, this);
+}
+
+void CachingDomainNameResolver::clear() {
+	serviceCache.clear();
+	addressCache.clear();
+}
+
+void CachingDomainNameResolver::runServiceQuery(boost::shared_ptr<CachedServiceQuery> query) {
+	std::string service = query->getService();
+	if (const ServiceEntry* entry = serviceCache.get(service)) {
+		SWIFT_LOG(debug) << "Using cached result for " << service << std::endl;
+		// Shuffle the cached records again, to keep spreading the load
+		// over records with the same priority.
+		ServiceResult result = entry->result;
+		DomainNameServiceQuery::sortResults(result, randomGenerator);
+		eventLoop->postEvent(boost::bind(&CachedServiceQuery::emitResult, query, result), owner);
+		return;
+	}
+
+	std::map<std::string, PendingServiceQuery>::iterator i = pendingServiceQueries.find(service);
+	if (i != pendingServiceQueries.end()) {
+		i->second.waiters.push_back(query);
+		return;
+	}
+
+	DomainNameServiceQuery::ref realQuery = realResolver->createServiceQuery(query->serviceLookupPrefix, query->domain);
+	PendingServiceQuery& pending = pendingServiceQueries[service];
+	pending.query = realQuery;
+	pending.waiters.push_back(query);
+	realQuery->onResult.connect(boost::bind(&CachingDomainNameResolver::handleServiceQueryResult, this, service, _1));
+	realQuery->run();
+}
+
+void CachingDomainNameResolver::runAddressQuery(boost::shared_ptr<CachedAddressQuery> query) {
+	if (const AddressEntry* entry = addressCache.get(query->name)) {
+		SWIFT_LOG(debug) << "Using cached result for " << query->name << std::endl;
+		eventLoop->postEvent(boost::bind(&CachedAddressQuery::emitResult, query, entry->result.first, entry->result.second), owner);
+		return;
+	}
+
+	std::map<std::string, PendingAddressQuery>::iterator i = pendingAddressQueries.find(query->name);
+	if (i != pendingAddressQueries.end()) {
+		i->second.waiters.push_back(query);
+		return;
+	}
+
+	DomainNameAddressQuery::ref realQuery = realResolver->createAddressQuery(query->name);
+	PendingAddressQuery& pending = pendingAddressQueries[query->name];
+	pending.query = realQuery;
+	pending.waiters.push_back(query);
+	realQuery->onResult.connect(boost::bind(&CachingDomainNameResolver::handleAddressQueryResult, this, query->name, _1, _2));
+	realQuery->run();
+}
+
+void CachingDomainNameResolver::handleServiceQueryResult(const std::string& service, const ServiceResult& result) {
+	std::map<std::string, PendingServiceQuery>::iterator i = pendingServiceQueries.find(service);
+	if (i == pendingServiceQueries.end()) {
+		return;
+	}
+	// Keep the real query alive while it is emitting its result
+	PendingServiceQuery pending = i->second;
+	pendingServiceQueries.erase(i);
+
+	int ttl = clampTTL(result.empty() ? negativeTTL : getServiceTTL(result));
+	if (ttl > 0) {
+		ServiceEntry entry;
+		entry.result = result;
+		entry.expiry = boost::make_shared<Expiry>(timerFactory->createTimer(ttl * 1000), boost::bind(&CachingDomainNameResolver::handleServiceExpired, this, service));
+		serviceCache.put(service, entry);
+	}
+
+	foreach (const boost::weak_ptr<CachedServiceQuery>& waiter, pending.waiters) {
+		if (boost::shared_ptr<CachedServiceQuery> query = waiter.lock()) {
+			query->emitResult(result);
+		}
+	}
+}
+
+void CachingDomainNameResolver::handleAddressQueryResult(const std::string& name, const std::vector<HostAddress>& addresses, boost::optional<DomainNameResolveError> error) {
+	std::map<std::string, PendingAddressQuery>::iterator i = pendingAddressQueries.find(name);
+	if (i == pendingAddressQueries.end()) {
+		return;
+	}
+	// Keep the real query alive while it is emitting its result
+	PendingAddressQuery pending = i->second;
+	pendingAddressQueries.erase(i);
+
+	int ttl = clampTTL(error || addresses.empty() ? negativeTTL : defaultTTL);
+	if (ttl > 0) {
+		AddressEntry entry;
+		entry.result = std::make_pair(addresses, error);
+		entry.expiry = boost::make_shared<Expiry>(timerFactory->createTimer(ttl * 1000), boost::bind(&CachingDomainNameResolver::handleAddressExpired, this, name));
+		addressCache.put(name, entry);
+	}
+
+	foreach (const boost::weak_ptr<CachedAddressQuery>& waiter, pending.waiters) {
+		if (boost::shared_ptr<CachedAddressQuery> query = waiter.lock()) {
+			query->emitResult(addresses, error);
+		}
+	}
+}
+
+void CachingDomainNameResolver::handleServiceExpired(std::string service) {
+	serviceCache.remove(service);
+}
+
+void CachingDomainNameResolver::handleAddressExpired(std::string name) {
+	addressCache.remove(name);
+}
+
+int CachingDomainNameResolver::getServiceTTL(const ServiceResult& result) const {
+	boost::optional<int> ttl;
+	foreach (const DomainNameServiceQuery::Result& record, result) {
+		if (record.ttl >= 0 && (!ttl || record.ttl < *ttl)) {
+			ttl = record.ttl;
+		}
+	}
+	return ttl ? *ttl : defaultTTL;
+}
+
+int CachingDomainNameResolver::clampTTL(int ttl) const {
+	return std::max(0, std::min(ttl, maximumTTL));
 }
 
 }
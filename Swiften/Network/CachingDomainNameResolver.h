@@ -1,31 +1,129 @@
 /*
- * Copyright (c) 2012 Isode Limited.
+ * Copyright (c) 2012-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <boost/optional.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 
+#include <Swiften/Base/API.h>
+#include <Swiften/Base/BoostRandomGenerator.h>
+#include <Swiften/Base/LRUCache.h>
 #include <Swiften/Network/DomainNameResolver.h>
-#include <Swiften/Network/StaticDomainNameResolver.h>
+#include <Swiften/Network/DomainNameServiceQuery.h>
+#include <Swiften/Network/DomainNameAddressQuery.h>
+#include <Swiften/Network/HostAddress.h>
 
-/*
- * FIXME: Does not do any caching yet.
- */
 namespace Swift {
 	class EventLoop;
+	class EventOwner;
+	class TimerFactory;
 
-	class CachingDomainNameResolver : public DomainNameResolver {
+	/**
+	 * A resolver that caches the results of another resolver.
+	 *
+	 * Service results are kept for the smallest TTL of their records, and
+	 * address results (for which the platform resolvers don't report a TTL)
+	 * for the default TTL. Failed lookups are cached for the negative TTL.
+	 * Concurrent queries for the same name share a single query to the
+	 * underlying resolver.
+	 *
+	 * Results are always delivered asynchronously through the event loop.
+	 * This class is not thread-safe.
+	 */
+	class SWIFTEN_API CachingDomainNameResolver : public DomainNameResolver {
 		public:
-			CachingDomainNameResolver(DomainNameResolver* realResolver, EventLoop* eventLoop);
+			CachingDomainNameResolver(DomainNameResolver* realResolver, TimerFactory* timerFactory, EventLoop* eventLoop);
 			~CachingDomainNameResolver();
 
 			virtual DomainNameServiceQuery::ref createServiceQuery(const std::string& serviceLookupPrefix, const std::string& domain);
 			virtual DomainNameAddressQuery::ref createAddressQuery(const std::string& name);
 
+			/**
+			 * Sets the time (in seconds) to cache results without a TTL.
+			 */
+			void setDefaultTTL(int seconds) {
+				defaultTTL = seconds;
+			}
+
+			/**
+			 * Sets the maximum time (in seconds) to cache a result, regardless
+			 * of its TTL.
+			 */
+			void setMaximumTTL(int seconds) {
+				maximumTTL = seconds;
+			}
+
+			/**
+			 * Sets the time (in seconds) to cache failed lookups.
+			 * Setting this to 0 disables negative caching.
+			 */
+			void setNegativeTTL(int seconds) {
+				negativeTTL = seconds;
+			}
+
+			/**
+			 * Removes all cached results.
+			 */
+			void clear();
+
+		private:
+			class CachedServiceQuery;
+			class CachedAddressQuery;
+			class Expiry;
+
+			typedef std::vector<DomainNameServiceQuery::Result> ServiceResult;
+			typedef std::pair<std::vector<HostAddress>, boost::optional<DomainNameResolveError> > AddressResult;
+
+			struct ServiceEntry {
+				ServiceResult result;
+				boost::shared_ptr<Expiry> expiry;
+			};
+
+			struct AddressEntry {
+				AddressResult result;
+				boost::shared_ptr<Expiry> expiry;
+			};
+
+			struct PendingServiceQuery {
+				DomainNameServiceQuery::ref query;
+				std::vector<boost::weak_ptr<CachedServiceQuery> > waiters;
+			};
+
+			struct PendingAddressQuery {
+				DomainNameAddressQuery::ref query;
+				std::vector<boost::weak_ptr<CachedAddressQuery> > waiters;
+			};
+
+			void runServiceQuery(boost::shared_ptr<CachedServiceQuery> query);
+			void runAddressQuery(boost::shared_ptr<CachedAddressQuery> query);
+			void handleServiceQueryResult(const std::string& service, const ServiceResult& result);
+			void handleAddressQueryResult(const std::string& name, const std::vector<HostAddress>& addresses, boost::optional<DomainNameResolveError> error);
+			void handleServiceExpired(std::string service);
+			void handleAddressExpired(std::string name);
+			int getServiceTTL(const ServiceResult& result) const;
+			int clampTTL(int ttl) const;
+
 		private:
 			DomainNameResolver* realResolver;
+			TimerFactory* timerFactory;
+			EventLoop* eventLoop;
+			boost::shared_ptr<EventOwner> owner;
+			int defaultTTL;
+			int maximumTTL;
+			int negativeTTL;
+			BoostRandomGenerator randomGenerator;
+			LRUCache<std::string, ServiceEntry> serviceCache;
+			LRUCache<std::string, AddressEntry> addressCache;
+			std::map<std::string, PendingServiceQuery> pendingServiceQueries;
+			std::map<std::string, PendingAddressQuery> pendingAddressQueries;
 	};
 }
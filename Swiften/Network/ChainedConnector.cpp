@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011 Isode Limited.
+ * Copyright (c) 2011-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -29,13 +29,18 @@ ChainedConnector::ChainedConnector(
 			resolver(resolver), 
 			connectionFactories(connectionFactories), 
 			timerFactory(timerFactory), 
-			timeoutMilliseconds(0) {
+			timeoutMilliseconds(0),
+			connectionAttemptDelayMilliseconds(0) {
 }
 
 void ChainedConnector::setTimeoutMilliseconds(int milliseconds) {
 	timeoutMilliseconds = milliseconds;
 }
 
+void ChainedConnector::setConnectionAttemptDelayMilliseconds(int milliseconds) {
+	connectionAttemptDelayMilliseconds = milliseconds;
+}
+
 void ChainedConnector::start() {
 	SWIFT_LOG(debug) << "Starting queued connector for " << hostname << std::endl;
 
@@ -64,6 +69,7 @@ void ChainedConnector::tryNextConnectionFactory() {
 		connectionFactoryQueue.pop_front();
 		currentConnector = Connector::create(hostname, port, serviceLookupPrefix, resolver, connectionFactory, timerFactory);
 		currentConnector->setTimeoutMilliseconds(timeoutMilliseconds);
+		currentConnector->setConnectionAttemptDelayMilliseconds(connectionAttemptDelayMilliseconds);
 		currentConnector->onConnectFinished.connect(boost::bind(&ChainedConnector::handleConnectorFinished, this, _1, _2));
 		currentConnector->start();
 	}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011 Isode Limited.
+ * Copyright (c) 2011-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -28,6 +28,7 @@ namespace Swift {
 			ChainedConnector(const std::string& hostname, int port, const boost::optional<std::string>& serviceLookupPrefix, DomainNameResolver*, const std::vector<ConnectionFactory*>&, TimerFactory*);
 
 			void setTimeoutMilliseconds(int milliseconds);
+			void setConnectionAttemptDelayMilliseconds(int milliseconds);
 			void start();
 			void stop();
 
@@ -46,6 +47,7 @@ namespace Swift {
 			std::vector<ConnectionFactory*> connectionFactories;
 			TimerFactory* timerFactory;
 			int timeoutMilliseconds;
+			int connectionAttemptDelayMilliseconds;
 			std::deque<ConnectionFactory*> connectionFactoryQueue;
 			boost::shared_ptr<Connector> currentConnector;
 			boost::shared_ptr<Error> lastError;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,3 +13,7 @@ Connection::Connection() {
 
 Connection::~Connection() {
 }
+
+void Connection::writeShared(boost::shared_ptr<const ByteArray> data) {
+	write(createSafeByteArray(*data));
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -32,6 +32,15 @@ namespace Swift {
 			virtual void disconnect() = 0;
 			virtual void write(const SafeByteArray& data) = 0;
 
+			/**
+			 * Writes a buffer that is shared with the caller.
+			 *
+			 * The caller must not modify the buffer afterwards. Connections that
+			 * write straight to a socket can send it without copying it; the
+			 * default implementation copies it and calls write().
+			 */
+			virtual void writeShared(boost::shared_ptr<const ByteArray> data);
+
 			virtual HostAddressPort getLocalAddress() const = 0;
 
 		public:
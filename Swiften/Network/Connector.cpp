@@ -7,8 +7,10 @@
 #include <Swiften/Network/Connector.h>
 
 #include <boost/bind.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
 
 #include <Swiften/Base/Log.h>
+#include <Swiften/Base/foreach.h>
 #include <Swiften/Network/ConnectionFactory.h>
 #include <Swiften/Network/DomainNameAddressQuery.h>
 #include <Swiften/Network/DomainNameResolver.h>
@@ -17,20 +19,29 @@
 
 namespace Swift {
 
-Connector::Connector(const std::string& hostname, int port, const boost::optional<std::string>& serviceLookupPrefix, DomainNameResolver* resolver, ConnectionFactory* connectionFactory, TimerFactory* timerFactory) : hostname(hostname), port(port), serviceLookupPrefix(serviceLookupPrefix), resolver(resolver), connectionFactory(connectionFactory), timerFactory(timerFactory), timeoutMilliseconds(0), queriedAllServices(true), foundSomeDNS(false) {
+Connector::Connector(const std::string& hostname, int port, const boost::optional<std::string>& serviceLookupPrefix, DomainNameResolver* resolver, ConnectionFactory* connectionFactory, TimerFactory* timerFactory) : hostname(hostname), port(port), serviceLookupPrefix(serviceLookupPrefix), resolver(resolver), connectionFactory(connectionFactory), timerFactory(timerFactory), timeoutMilliseconds(0), queriedAllServices(true), foundSomeDNS(false), connectionAttemptDelayMilliseconds(0) {
 }
 
 void Connector::setTimeoutMilliseconds(int milliseconds) {
 	timeoutMilliseconds = milliseconds;
 }
 
+void Connector::setConnectionAttemptDelayMilliseconds(int milliseconds) {
+	connectionAttemptDelayMilliseconds = milliseconds;
+}
+
+bool Connector::isRacing() const {
+	return connectionAttemptDelayMilliseconds > 0;
+}
+
 void Connector::start() {
 	SWIFT_LOG(debug) << "Starting connector for " << hostname << std::endl;
 	assert(!currentConnection);
 	assert(!serviceQuery);
 	assert(!timer);
+	assert(attempts.empty());
 	queriedAllServices = false;
-	if (timeoutMilliseconds > 0) {
+	if (timeoutMilliseconds > 0 && !isRacing()) {
 		timer = timerFactory->createTimer(timeoutMilliseconds);
 		timer->onTick.connect(boost::bind(&Connector::handleTimeout, shared_from_this()));
 	}
@@ -42,9 +53,23 @@ void Connector::start() {
 	else if (HostAddress(hostname).isValid()) {
 		// hostname is already a valid address; skip name lookup.
 		foundSomeDNS = true;
-		addressQueryResults.push_back(HostAddress(hostname));
-		tryNextAddress();
-	} else {
+		if (isRacing()) {
+			queriedAllServices = true;
+			boost::shared_ptr<Target> target = boost::make_shared<Target>(hostname, port == -1 ? 5222 : port);
+			target->addresses.push_back(HostAddress(hostname));
+			targets.push_back(target);
+			startNextAttempt();
+		}
+		else {
+			addressQueryResults.push_back(HostAddress(hostname));
+			tryNextAddress();
+		}
+	}
+	else if (isRacing()) {
+		queriedAllServices = true;
+		addTarget(hostname, port == -1 ? 5222 : port);
+	}
+	else {
 		queryAddress(hostname);
 	}
 }
@@ -67,6 +92,22 @@ void Connector::handleServiceQueryResult(const std::vector<DomainNameServiceQuer
 	if (!serviceQueryResults.empty()) {
 		foundSomeDNS = true;
 	}
+	if (isRacing()) {
+		// Resolve all targets at once, and start racing as soon as the
+		// first addresses come in.
+		if (serviceQueryResults.empty()) {
+			SWIFT_LOG(debug) << "Falling back on A resolution" << std::endl;
+			queriedAllServices = true;
+			addTarget(hostname, port == -1 ? 5222 : port);
+		}
+		else {
+			foreach (const DomainNameServiceQuery::Result& result, serviceQueryResults) {
+				addTarget(result.hostname, result.port);
+			}
+			serviceQueryResults.clear();
+		}
+		return;
+	}
 	tryNextServiceOrFallback();
 }
 
@@ -161,7 +202,163 @@ void Connector::handleConnectionConnectFinished(bool error) {
 	}
 }
 
+void Connector::addTarget(const std::string& targetHostname, int targetPort) {
+	boost::shared_ptr<Target> target = boost::make_shared<Target>(targetHostname, targetPort);
+	targets.push_back(target);
+	target->addressQuery = resolver->createAddressQuery(targetHostname);
+	target->addressQuery->onResult.connect(boost::bind(&Connector::handleTargetAddressQueryResult, shared_from_this(), target.get(), _1, _2));
+	target->addressQuery->run();
+}
+
+void Connector::handleTargetAddressQueryResult(Target* target, const std::vector<HostAddress>& addresses, boost::optional<DomainNameResolveError> error) {
+	SWIFT_LOG(debug) << addresses.size() << " addresses for " << target->hostname << std::endl;
+	target->addressQuery.reset();
+	if (!error && !addresses.empty()) {
+		foundSomeDNS = true;
+
+		// Alternate between address families, starting with IPv6 (RFC 8305)
+		std::deque<HostAddress> ipv6Addresses;
+		std::deque<HostAddress> ipv4Addresses;
+		foreach (const HostAddress& address, addresses) {
+			(address.getRawAddress().is_v6() ? ipv6Addresses : ipv4Addresses).push_back(address);
+		}
+		while (!ipv6Addresses.empty() || !ipv4Addresses.empty()) {
+			if (!ipv6Addresses.empty()) {
+				target->addresses.push_back(ipv6Addresses.front());
+				ipv6Addresses.pop_front();
+			}
+			if (!ipv4Addresses.empty()) {
+				target->addresses.push_back(ipv4Addresses.front());
+				ipv4Addresses.pop_front();
+			}
+		}
+	}
+	if (!attemptDelayTimer) {
+		startNextAttempt();
+	}
+}
+
+void Connector::startNextAttempt() {
+	// Targets are tried in order of preference, but targets that are still
+	// being resolved are skipped.
+	boost::optional<HostAddressPort> candidate;
+	bool resolving = false;
+	foreach (boost::shared_ptr<Target> target, targets) {
+		if (!target->addresses.empty()) {
+			candidate = HostAddressPort(target->addresses.front(), target->port);
+			target->addresses.pop_front();
+			break;
+		}
+		if (target->addressQuery) {
+			resolving = true;
+		}
+	}
+
+	if (!candidate) {
+		if (resolving || !attempts.empty()) {
+			// Wait for more addresses, or for a running attempt to finish
+			return;
+		}
+		if (!queriedAllServices) {
+			SWIFT_LOG(debug) << "Falling back on A resolution" << std::endl;
+			queriedAllServices = true;
+			addTarget(hostname, port == -1 ? 5222 : port);
+		}
+		else {
+			finish(boost::shared_ptr<Connection>());
+		}
+		return;
+	}
+
+	SWIFT_LOG(debug) << "Racing connection to " << candidate->getAddress().toString() << ":" << candidate->getPort() << std::endl;
+	Attempt attempt;
+	attempt.connection = connectionFactory->createConnection();
+	attempt.connection->onConnectFinished.connect(boost::bind(&Connector::handleAttemptFinished, shared_from_this(), attempt.connection.get(), _1));
+	if (timeoutMilliseconds > 0) {
+		attempt.timer = timerFactory->createTimer(timeoutMilliseconds);
+		attempt.timer->onTick.connect(boost::bind(&Connector::handleAttemptTimeout, shared_from_this(), attempt.connection.get()));
+		attempt.timer->start();
+	}
+	attempts.push_back(attempt);
+
+	attemptDelayTimer = timerFactory->createTimer(connectionAttemptDelayMilliseconds);
+	attemptDelayTimer->onTick.connect(boost::bind(&Connector::handleAttemptDelayExpired, shared_from_this()));
+	attemptDelayTimer->start();
+
+	attempt.connection->connect(*candidate);
+}
+
+void Connector::handleAttemptDelayExpired() {
+	stopAttemptDelayTimer();
+	startNextAttempt();
+}
+
+void Connector::handleAttemptFinished(Connection* connection, bool error) {
+	SWIFT_LOG(debug) << "Attempt finished: " << (error ? "error" : "success") << std::endl;
+	if (error) {
+		handleAttemptFailed(connection, false);
+	}
+	else {
+		finish(removeAttempt(connection, false));
+	}
+}
+
+void Connector::handleAttemptTimeout(Connection* connection) {
+	SWIFT_LOG(debug) << "Attempt timed out" << std::endl;
+	handleAttemptFailed(connection, true);
+}
+
+void Connector::handleAttemptFailed(Connection* connection, bool cancel) {
+	removeAttempt(connection, cancel);
+	// Don't wait for the attempt delay after a failure
+	stopAttemptDelayTimer();
+	startNextAttempt();
+}
+
+boost::shared_ptr<Connection> Connector::removeAttempt(Connection* connection, bool cancel) {
+	for (std::vector<Attempt>::iterator i = attempts.begin(); i != attempts.end(); ++i) {
+		if (i->connection.get() == connection) {
+			Attempt attempt = *i;
+			attempts.erase(i);
+			if (attempt.timer) {
+				attempt.timer->stop();
+				attempt.timer->onTick.disconnect(boost::bind(&Connector::handleAttemptTimeout, shared_from_this(), connection));
+			}
+			attempt.connection->onConnectFinished.disconnect(boost::bind(&Connector::handleAttemptFinished, shared_from_this(), connection, _1));
+			if (cancel) {
+				attempt.connection->disconnect();
+			}
+			return attempt.connection;
+		}
+	}
+	return boost::shared_ptr<Connection>();
+}
+
+void Connector::stopAttemptDelayTimer() {
+	if (attemptDelayTimer) {
+		attemptDelayTimer->stop();
+		attemptDelayTimer->onTick.disconnect(boost::bind(&Connector::handleAttemptDelayExpired, shared_from_this()));
+		attemptDelayTimer.reset();
+	}
+}
+
+void Connector::cancelRacing(boost::shared_ptr<Connection> winner) {
+	stopAttemptDelayTimer();
+	while (!attempts.empty()) {
+		Connection* connection = attempts.back().connection.get();
+		removeAttempt(connection, connection != winner.get());
+	}
+	foreach (boost::shared_ptr<Target> target, targets) {
+		if (target->addressQuery) {
+			target->addressQuery->onResult.disconnect(boost::bind(&Connector::handleTargetAddressQueryResult, shared_from_this(), target.get(), _1, _2));
+			target->addressQuery.reset();
+		}
+	}
+	targets.clear();
+}
+
 void Connector::finish(boost::shared_ptr<Connection> connection) {
+	cancelRacing(connection);
 	if (timer) {
 		timer->stop();
 		timer->onTick.disconnect(boost::bind(&Connector::handleTimeout, shared_from_this()));
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <deque>
+#include <vector>
 #include <Swiften/Base/boost_bsignals.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/optional.hpp>
@@ -33,6 +34,22 @@ namespace Swift {
 			}
 
 			void setTimeoutMilliseconds(int milliseconds);
+
+			/**
+			 * Races connection attempts instead of trying the candidates one
+			 * after the other.
+			 *
+			 * When this is positive, the addresses of all SRV targets are
+			 * resolved in parallel, and a new connection attempt is started
+			 * after the given delay (or as soon as the previous attempt fails),
+			 * alternating between IPv6 and IPv4 addresses as described in
+			 * RFC 8305. The first attempt to succeed is used, and all others
+			 * are cancelled. The timeout applies to each attempt separately.
+			 *
+			 * Default: 0 (don't race attempts)
+			 */
+			void setConnectionAttemptDelayMilliseconds(int milliseconds);
+
 			void start();
 			void stop();
 
@@ -53,6 +70,30 @@ namespace Swift {
 			void finish(boost::shared_ptr<Connection>);
 			void handleTimeout();
 
+			struct Target {
+				Target(const std::string& hostname, int port) : hostname(hostname), port(port) {}
+				std::string hostname;
+				int port;
+				boost::shared_ptr<DomainNameAddressQuery> addressQuery;
+				std::deque<HostAddress> addresses;
+			};
+
+			struct Attempt {
+				boost::shared_ptr<Connection> connection;
+				boost::shared_ptr<Timer> timer;
+			};
+
+			bool isRacing() const;
+			void addTarget(const std::string& hostname, int port);
+			void handleTargetAddressQueryResult(Target* target, const std::vector<HostAddress>& addresses, boost::optional<DomainNameResolveError> error);
+			void startNextAttempt();
+			void handleAttemptDelayExpired();
+			void handleAttemptFinished(Connection* connection, bool error);
+			void handleAttemptTimeout(Connection* connection);
+			void handleAttemptFailed(Connection* connection, bool cancel);
+			boost::shared_ptr<Connection> removeAttempt(Connection* connection, bool cancel);
+			void stopAttemptDelayTimer();
+			void cancelRacing(boost::shared_ptr<Connection> winner);
 
 		private:
 			std::string hostname;
@@ -70,5 +111,9 @@ namespace Swift {
 			bool queriedAllServices;
 			boost::shared_ptr<Connection> currentConnection;
 			bool foundSomeDNS;
+			int connectionAttemptDelayMilliseconds;
+			std::vector<boost::shared_ptr<Target> > targets;
+			std::vector<Attempt> attempts;
+			boost::shared_ptr<Timer> attemptDelayTimer;
 	};
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -23,11 +23,15 @@ namespace Swift {
 			typedef boost::shared_ptr<DomainNameServiceQuery> ref;
 
 			struct Result {
-				Result(const std::string& hostname = "", int port = -1, int priority = -1, int weight = -1) : hostname(hostname), port(port), priority(priority), weight(weight) {}
+				Result(const std::string& hostname = "", int port = -1, int priority = -1, int weight = -1, int ttl = -1) : hostname(hostname), port(port), priority(priority), weight(weight), ttl(ttl) {}
 				std::string hostname;
 				int port;
 				int priority;
 				int weight;
+				/**
+				 * The time to live of the record in seconds, or -1 if unknown.
+				 */
+				int ttl;
 			};
 
 			virtual ~DomainNameServiceQuery();
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -49,12 +49,16 @@ boost::shared_ptr<Timer> DummyTimerFactory::createTimer(int milliseconds) {
 
 void DummyTimerFactory::setTime(int time) {
 	assert(time > currentTime);
-	foreach(boost::shared_ptr<DummyTimer> timer, timers) {
-		if (timer->getAlarmTime() > currentTime && timer->getAlarmTime() <= time && timer->isRunning) {
+	int previousTime = currentTime;
+	// Timers started from a tick start at the new time
+	currentTime = time;
+	// Iterate over a copy, because ticks can create new timers
+	std::list<boost::shared_ptr<DummyTimer> > currentTimers(timers);
+	foreach(boost::shared_ptr<DummyTimer> timer, currentTimers) {
+		if (timer->getAlarmTime() > previousTime && timer->getAlarmTime() <= time && timer->isRunning) {
 			timer->onTick();
 		}
 	}
-	currentTime = time;
 }
 
 }
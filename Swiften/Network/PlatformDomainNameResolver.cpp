@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -14,8 +14,10 @@
 #include <boost/bind.hpp>
 #include <boost/thread.hpp>
 #include <algorithm>
+#include <cassert>
 
 #include <string>
+#include <Swiften/Base/foreach.h>
 #include <Swiften/IDN/IDNConverter.h>
 #include <Swiften/Network/HostAddress.h>
 #include <Swiften/EventLoop/EventLoop.h>
@@ -27,15 +29,23 @@ using namespace Swift;
 
 namespace Swift {
 
-PlatformDomainNameResolver::PlatformDomainNameResolver(IDNConverter* idnConverter, EventLoop* eventLoop) : idnConverter(idnConverter), eventLoop(eventLoop), stopRequested(false) {
-	thread = new boost::thread(boost::bind(&PlatformDomainNameResolver::run, this));
+PlatformDomainNameResolver::PlatformDomainNameResolver(IDNConverter* idnConverter, EventLoop* eventLoop, size_t workerCount) : idnConverter(idnConverter), eventLoop(eventLoop), stopRequested(false) {
+	assert(workerCount > 0);
+	for (size_t i = 0; i < workerCount; ++i) {
+		threads.push_back(new boost::thread(boost::bind(&PlatformDomainNameResolver::run, this)));
+	}
 }
 
 PlatformDomainNameResolver::~PlatformDomainNameResolver() {
 	stopRequested = true;
-	addQueryToQueue(boost::shared_ptr<PlatformDomainNameQuery>());
-	thread->join();
-	delete thread;
+	// Wake up every worker
+	for (size_t i = 0; i < threads.size(); ++i) {
+		addQueryToQueue(boost::shared_ptr<PlatformDomainNameQuery>());
+	}
+	foreach (boost::thread* thread, threads) {
+		thread->join();
+		delete thread;
+	}
 }
 
 boost::shared_ptr<DomainNameServiceQuery> PlatformDomainNameResolver::createServiceQuery(const std::string& serviceLookupPrefix, const std::string& domain) {
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <deque>
+#include <vector>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/condition_variable.hpp>
@@ -22,9 +23,15 @@ namespace Swift {
 	class IDNConverter;	
 	class EventLoop;
 
+	/**
+	 * A resolver using the blocking resolver functions of the platform.
+	 *
+	 * Queries are run on a pool of worker threads, so a slow query doesn't
+	 * hold up the ones queued behind it.
+	 */
 	class SWIFTEN_API PlatformDomainNameResolver : public DomainNameResolver {
 		public:
-			PlatformDomainNameResolver(IDNConverter* idnConverter, EventLoop* eventLoop);
+			PlatformDomainNameResolver(IDNConverter* idnConverter, EventLoop* eventLoop, size_t workerCount = 4);
 			~PlatformDomainNameResolver();
 
 			virtual DomainNameServiceQuery::ref createServiceQuery(const std::string& serviceLookupPrefix, const std::string& domain);
@@ -40,7 +47,7 @@ namespace Swift {
 			IDNConverter* idnConverter;
 			EventLoop* eventLoop;
 			Atomic<bool> stopRequested;
-			boost::thread* thread;
+			std::vector<boost::thread*> threads;
 			std::deque<PlatformDomainNameQuery::ref> queue;
 			boost::mutex queueMutex;
 			boost::condition_variable queueNonEmpty;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,6 +12,7 @@
 
 #include <Swiften/Base/Platform.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <boost/numeric/conversion/cast.hpp>
 #ifdef SWIFTEN_PLATFORM_WINDOWS
 #undef UNICODE
@@ -36,6 +37,11 @@
 
 using namespace Swift;
 
+namespace {
+	// RFC 2181 section 8
+	const unsigned long MAX_TTL = 0x7FFFFFFFUL;
+}
+
 namespace Swift {
 
 PlatformDomainNameServiceQuery::PlatformDomainNameServiceQuery(const boost::optional<std::string>& serviceName, EventLoop* eventLoop, PlatformDomainNameResolver* resolver) : PlatformDomainNameQuery(resolver), eventLoop(eventLoop), serviceValid(false) {
@@ -74,6 +80,7 @@ void PlatformDomainNameServiceQuery::runBlocking() {
 			record.priority = currentEntry->Data.SRV.wPriority;
 			record.weight = currentEntry->Data.SRV.wWeight;
 			record.port = currentEntry->Data.SRV.wPort;
+			record.ttl = boost::numeric_cast<int>(std::min<DWORD>(currentEntry->dwTtl, MAX_TTL));
 				
 			// The pNameTarget is actually a PCWSTR, so I would have expected this 
 			// conversion to not work at all, but it does.
@@ -124,6 +131,13 @@ void PlatformDomainNameServiceQuery::runBlocking() {
 
 		int entryLength = dn_skipname(currentEntry, messageEnd);
 		currentEntry += entryLength;
+
+		// TTL
+		if (currentEntry + NS_RRFIXEDSZ >= messageEnd) {
+			emitError();
+			return;
+		}
+		record.ttl = boost::numeric_cast<int>(std::min<unsigned long>(ns_get32(currentEntry + NS_INT16SZ + NS_INT16SZ), MAX_TTL));
 		currentEntry += NS_RRFIXEDSZ;
 
 		// Priority
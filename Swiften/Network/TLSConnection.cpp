@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011 Isode Limited.
+ * Copyright (c) 2011-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -51,6 +51,7 @@ void TLSConnection::handleTLSDataForApplication(const SafeByteArray& data) {
 }
 
 void TLSConnection::connect(const HostAddressPort& address) {
+	context->setServerIdentity(address.toString());
 	connection->connect(address);
 }
 
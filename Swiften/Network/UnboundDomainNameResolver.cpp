@@ -7,6 +7,7 @@
 #include "UnboundDomainNameResolver.h"
 
 #include <vector>
+#include <algorithm>
 
 #include <boost/bind.hpp>
 #include <boost/smart_ptr/make_shared.hpp>
@@ -87,6 +88,7 @@ class UnboundDomainNameServiceQuery : public DomainNameServiceQuery, public Unbo
 							serviceRecord.priority = ldns_rdf2native_int16(ldns_rr_rdf(rr, 0));
 							serviceRecord.weight = ldns_rdf2native_int16(ldns_rr_rdf(rr, 1));
 							serviceRecord.port = ldns_rdf2native_int16(ldns_rr_rdf(rr, 2));
+							serviceRecord.ttl = static_cast<int>(std::min<uint32_t>(ldns_rr_ttl(rr), 0x7FFFFFFF));
 
 							ldns_buffer_rewind(buffer);
 							if ((ldns_rdf2buffer_str_dname(buffer, ldns_rr_rdf(rr, 3)) != LDNS_STATUS_OK) ||
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <boost/bind.hpp>
+
+#include <Swiften/Network/CachingDomainNameResolver.h>
+#include <Swiften/Network/StaticDomainNameResolver.h>
+#include <Swiften/Network/DummyTimerFactory.h>
+#include <Swiften/EventLoop/DummyEventLoop.h>
+
+using namespace Swift;
+
+class CachingDomainNameResolverTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(CachingDomainNameResolverTest);
+		CPPUNIT_TEST(testServiceQuery);
+		CPPUNIT_TEST(testServiceQuery_Cached);
+		CPPUNIT_TEST(testServiceQuery_ExpiresAfterTTL);
+		CPPUNIT_TEST(testServiceQuery_ExpiresAfterSmallestTTL);
+		CPPUNIT_TEST(testServiceQuery_ExpiresAfterDefaultTTLWithoutTTL);
+		CPPUNIT_TEST(testServiceQuery_ExpiresAfterMaximumTTL);
+		CPPUNIT_TEST(testServiceQuery_NegativeCaching);
+		CPPUNIT_TEST(testServiceQuery_NegativeCachingDisabled);
+		CPPUNIT_TEST(testServiceQuery_Coalesced);
+		CPPUNIT_TEST(testServiceQuery_CoalescedWithDestroyedQuery);
+		CPPUNIT_TEST(testAddressQuery);
+		CPPUNIT_TEST(testAddressQuery_Cached);
+		CPPUNIT_TEST(testAddressQuery_ExpiresAfterDefaultTTL);
+		CPPUNIT_TEST(testAddressQuery_NegativeCaching);
+		CPPUNIT_TEST(testAddressQuery_Coalesced);
+		CPPUNIT_TEST(testClear);
+		CPPUNIT_TEST(testDestroyWhileQueryPending);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void setUp() {
+			eventLoop = new DummyEventLoop();
+			timerFactory = new DummyTimerFactory();
+			realResolver = new CountingDomainNameResolver(eventLoop);
+			testling = new CachingDomainNameResolver(realResolver, timerFactory, eventLoop);
+			testling->setDefaultTTL(300);
+			testling->setMaximumTTL(3600);
+			testling->setNegativeTTL(30);
+			serviceResults.clear();
+			addressResults.clear();
+			addressErrors.clear();
+		}
+
+		void tearDown() {
+			delete testling;
+			delete realResolver;
+			delete timerFactory;
+			delete eventLoop;
+		}
+
+		void testServiceQuery() {
+			realResolver->addService("_xmpp-client._tcp.foo.com", DomainNameServiceQuery::Result("xmpp.foo.com", 5222, 0, 0, 60));
+
+			runServiceQuery();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(serviceResults.size()));
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(serviceResults[0].size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("xmpp.foo.com"), serviceResults[0][0].hostname);
+			CPPUNIT_ASSERT_EQUAL(5222, serviceResults[0][0].port);
+			CPPUNIT_ASSERT_EQUAL(1, realResolver->serviceQueries);
+		}
+
+		void testServiceQuery_Cached() {
+			realResolver->addService("_xmpp-client._tcp.foo.com", DomainNameServiceQuery::Result("xmpp.foo.com", 5222, 0, 0, 60));
+			runServiceQuery();
+
+			runServiceQuery();
+
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(serviceResults.size()));
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(serviceResults[1].size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("xmpp.foo.com"), serviceResults[1][0].hostname);
+			CPPUNIT_ASSERT_EQUAL(1, realResolver->serviceQueries);
+		}
+
+		void testServiceQuery_ExpiresAfterTTL() {
+			realResolver->addService("_xmpp-client._tcp.foo.com", DomainNameServiceQuery::Result("xmpp.foo.com", 5222, 0, 0, 60));
+			runServiceQuery();
+
+			timerFactory->setTime(59000);
+			runServiceQuery();
+			CPPUNIT_ASSERT_EQUAL(1, realResolver->serviceQueries);
+
+			timerFactory->setTime(60000);
+			runServiceQuery();
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->serviceQueries);
+			CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(serviceResults.size()));
+		}
+
+		void testServiceQuery_ExpiresAfterSmallestTTL() {
+			realResolver->addService("_xmpp-client._tcp.foo.com", DomainNameServiceQuery::Result("xmpp1.foo.com", 5222, 0, 0, 600));
+			realResolver->addService("_xmpp-client._tcp.foo.com", DomainNameServiceQuery::Result("xmpp2.foo.com", 5222, 1, 0, 60));
+			runServiceQuery();
+
+			timerFactory->setTime(60000);
+			runServiceQuery();
+
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->serviceQueries);
+		}
+
+		void testServiceQuery_ExpiresAfterDefaultTTLWithoutTTL() {
+			realResolver->addService("_xmpp-client._tcp.foo.com", DomainNameServiceQuery::Result("xmpp.foo.com", 5222, 0, 0));
+			runServiceQuery();
+
+			timerFactory->setTime(299000);
+			runServiceQuery();
+			CPPUNIT_ASSERT_EQUAL(1, realResolver->serviceQueries);
+
+			timerFactory->setTime(300000);
+			runServiceQuery();
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->serviceQueries);
+		}
+
+		void testServiceQuery_ExpiresAfterMaximumTTL() {
+			testling->setMaximumTTL(120);
+			realResolver->addService("_xmpp-client._tcp.foo.com", DomainNameServiceQuery::Result("xmpp.foo.com", 5222, 0, 0, 86400));
+			runServiceQuery();
+
+			timerFactory->setTime(120000);
+			runServiceQuery();
+
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->serviceQueries);
+		}
+
+		void testServiceQuery_NegativeCaching() {
+			runServiceQuery();
+			runServiceQuery();
+
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(serviceResults.size()));
+			CPPUNIT_ASSERT(serviceResults[1].empty());
+			CPPUNIT_ASSERT_EQUAL(1, realResolver->serviceQueries);
+
+			timerFactory->setTime(30000);
+			runServiceQuery();
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->serviceQueries);
+		}
+
+		void testServiceQuery_NegativeCachingDisabled() {
+			testling->setNegativeTTL(0);
+
+			runServiceQuery();
+			runServiceQuery();
+
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->serviceQueries);
+		}
+
+		void testServiceQuery_Coalesced() {
+			realResolver->addService("_xmpp-client._tcp.foo.com", DomainNameServiceQuery::Result("xmpp.foo.com", 5222, 0, 0, 60));
+			DomainNameServiceQuery::ref query1 = createServiceQuery();
+			DomainNameServiceQuery::ref query2 = createServiceQuery();
+			query1->run();
+			query2->run();
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(serviceResults.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("xmpp.foo.com"), serviceResults[0][0].hostname);
+			CPPUNIT_ASSERT_EQUAL(std::string("xmpp.foo.com"), serviceResults[1][0].hostname);
+			CPPUNIT_ASSERT_EQUAL(1, realResolver->serviceQueries);
+		}
+
+		void testServiceQuery_CoalescedWithDestroyedQuery() {
+			realResolver->addService("_xmpp-client._tcp.foo.com", DomainNameServiceQuery::Result("xmpp.foo.com", 5222, 0, 0, 60));
+			DomainNameServiceQuery::ref query1 = createServiceQuery();
+			DomainNameServiceQuery::ref query2 = createServiceQuery();
+			query1->run();
+			query2->run();
+			query1.reset();
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(serviceResults.size()));
+			CPPUNIT_ASSERT_EQUAL(1, realResolver->serviceQueries);
+		}
+
+		void testAddressQuery() {
+			realResolver->addAddress("xmpp.foo.com", HostAddress("1.2.3.4"));
+
+			runAddressQuery("xmpp.foo.com");
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(addressResults.size()));
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(addressResults[0].size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("1.2.3.4"), addressResults[0][0].toString());
+			CPPUNIT_ASSERT(!addressErrors[0]);
+			CPPUNIT_ASSERT_EQUAL(1, realResolver->addressQueries);
+		}
+
+		void testAddressQuery_Cached() {
+			realResolver->addAddress("xmpp.foo.com", HostAddress("1.2.3.4"));
+			runAddressQuery("xmpp.foo.com");
+
+			runAddressQuery("xmpp.foo.com");
+
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(addressResults.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("1.2.3.4"), addressResults[1][0].toString());
+			CPPUNIT_ASSERT(!addressErrors[1]);
+			CPPUNIT_ASSERT_EQUAL(1, realResolver->addressQueries);
+		}
+
+		void testAddressQuery_ExpiresAfterDefaultTTL() {
+			realResolver->addAddress("xmpp.foo.com", HostAddress("1.2.3.4"));
+			runAddressQuery("xmpp.foo.com");
+
+			timerFactory->setTime(300000);
+			runAddressQuery("xmpp.foo.com");
+
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->addressQueries);
+		}
+
+		void testAddressQuery_NegativeCaching() {
+			runAddressQuery("xmpp.foo.com");
+			runAddressQuery("xmpp.foo.com");
+
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(addressErrors.size()));
+			CPPUNIT_ASSERT(addressErrors[1]);
+			CPPUNIT_ASSERT_EQUAL(1, realResolver->addressQueries);
+
+			realResolver->addAddress("xmpp.foo.com", HostAddress("1.2.3.4"));
+			timerFactory->setTime(30000);
+			runAddressQuery("xmpp.foo.com");
+
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->addressQueries);
+			CPPUNIT_ASSERT(!addressErrors[2]);
+		}
+
+		void testAddressQuery_Coalesced() {
+			realResolver->addAddress("xmpp.foo.com", HostAddress("1.2.3.4"));
+			realResolver->addAddress("xmpp.bar.com", HostAddress("5.6.7.8"));
+			DomainNameAddressQuery::ref query1 = createAddressQuery("xmpp.foo.com");
+			DomainNameAddressQuery::ref query2 = createAddressQuery("xmpp.foo.com");
+			DomainNameAddressQuery::ref query3 = createAddressQuery("xmpp.bar.com");
+			query1->run();
+			query2->run();
+			query3->run();
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(addressResults.size()));
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->addressQueries);
+		}
+
+		void testClear() {
+			realResolver->addService("_xmpp-client._tcp.foo.com", DomainNameServiceQuery::Result("xmpp.foo.com", 5222, 0, 0, 60));
+			realResolver->addAddress("xmpp.foo.com", HostAddress("1.2.3.4"));
+			runServiceQuery();
+			runAddressQuery("xmpp.foo.com");
+
+			testling->clear();
+			runServiceQuery();
+			runAddressQuery("xmpp.foo.com");
+
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->serviceQueries);
+			CPPUNIT_ASSERT_EQUAL(2, realResolver->addressQueries);
+		}
+
+		void testDestroyWhileQueryPending() {
+			realResolver->addAddress("xmpp.foo.com", HostAddress("1.2.3.4"));
+			DomainNameAddressQuery::ref query = createAddressQuery("xmpp.foo.com");
+			query->run();
+
+			delete testling;
+			testling = NULL;
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT(addressResults.empty());
+		}
+
+	private:
+		DomainNameServiceQuery::ref createServiceQuery() {
+			DomainNameServiceQuery::ref query = testling->createServiceQuery("_xmpp-client._tcp.", "foo.com");
+			query->onResult.connect(boost::bind(&CachingDomainNameResolverTest::handleServiceResult, this, _1));
+			return query;
+		}
+
+		DomainNameAddressQuery::ref createAddressQuery(const std::string& name) {
+			DomainNameAddressQuery::ref query = testling->createAddressQuery(name);
+			query->onResult.connect(boost::bind(&CachingDomainNameResolverTest::handleAddressResult, this, _1, _2));
+			return query;
+		}
+
+		void runServiceQuery() {
+			DomainNameServiceQuery::ref query = createServiceQuery();
+			query->run();
+			eventLoop->processEvents();
+		}
+
+		void runAddressQuery(const std::string& name) {
+			DomainNameAddressQuery::ref query = createAddressQuery(name);
+			query->run();
+			eventLoop->processEvents();
+		}
+
+		void handleServiceResult(const std::vector<DomainNameServiceQuery::Result>& result) {
+			serviceResults.push_back(result);
+		}
+
+		void handleAddressResult(const std::vector<HostAddress>& addresses, boost::optional<DomainNameResolveError> error) {
+			addressResults.push_back(addresses);
+			addressErrors.push_back(error);
+		}
+
+	private:
+		struct CountingDomainNameResolver : public StaticDomainNameResolver {
+			CountingDomainNameResolver(EventLoop* eventLoop) : StaticDomainNameResolver(eventLoop), serviceQueries(0), addressQueries(0) {
+			}
+
+			virtual boost::shared_ptr<DomainNameServiceQuery> createServiceQuery(const std::string& serviceLookupPrefix, const std::string& domain) {
+				++serviceQueries;
+				return StaticDomainNameResolver::createServiceQuery(serviceLookupPrefix, domain);
+			}
+
+			virtual boost::shared_ptr<DomainNameAddressQuery> createAddressQuery(const std::string& name) {
+				++addressQueries;
+				return StaticDomainNameResolver::createAddressQuery(name);
+			}
+
+			int serviceQueries;
+			int addressQueries;
+		};
+
+		DummyEventLoop* eventLoop;
+		DummyTimerFactory* timerFactory;
+		CountingDomainNameResolver* realResolver;
+		CachingDomainNameResolver* testling;
+		std::vector<std::vector<DomainNameServiceQuery::Result> > serviceResults;
+		std::vector<std::vector<HostAddress> > addressResults;
+		std::vector<boost::optional<DomainNameResolveError> > addressErrors;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CachingDomainNameResolverTest);
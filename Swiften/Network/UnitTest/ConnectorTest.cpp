@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -39,6 +39,14 @@ class ConnectorTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testConnect_NoTimeout);
 		CPPUNIT_TEST(testStop_DuringSRVQuery);
 		CPPUNIT_TEST(testStop_Timeout);
+		CPPUNIT_TEST(testConnect_Racing);
+		CPPUNIT_TEST(testConnect_Racing_StartsNextAttemptAfterDelay);
+		CPPUNIT_TEST(testConnect_Racing_StartsNextAttemptAfterFailure);
+		CPPUNIT_TEST(testConnect_Racing_AlternatesAddressFamilies);
+		CPPUNIT_TEST(testConnect_Racing_AllSRVHostsFailWithFallbackHost);
+		CPPUNIT_TEST(testConnect_Racing_NoHosts);
+		CPPUNIT_TEST(testConnect_Racing_Timeout);
+		CPPUNIT_TEST(testStop_Racing);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -311,6 +319,153 @@ class ConnectorTest : public CppUnit::TestFixture {
 		}
 
 
+		void testConnect_Racing() {
+			Connector::ref testling(createConnector());
+			testling->setConnectionAttemptDelayMilliseconds(250);
+			resolver->addXMPPClientService("foo.com", host1);
+			resolver->addXMPPClientService("foo.com", host2);
+
+			testling->start();
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(connections.size()));
+			CPPUNIT_ASSERT(connections[0]);
+			CPPUNIT_ASSERT(host1 == *(connections[0]->hostAddressPort));
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(connectionFactory->connections.size()));
+			CPPUNIT_ASSERT(!boost::dynamic_pointer_cast<DomainNameResolveError>(error));
+		}
+
+		void testConnect_Racing_StartsNextAttemptAfterDelay() {
+			Connector::ref testling(createConnector());
+			testling->setConnectionAttemptDelayMilliseconds(250);
+			resolver->addXMPPClientService("foo.com", host1);
+			resolver->addXMPPClientService("foo.com", host2);
+
+			connectionFactory->isResponsive = false;
+			testling->start();
+			eventLoop->processEvents();
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(connectionFactory->connections.size()));
+
+			connectionFactory->isResponsive = true;
+			timerFactory->setTime(250);
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(connections.size()));
+			CPPUNIT_ASSERT(connections[0]);
+			CPPUNIT_ASSERT(host2 == *(connections[0]->hostAddressPort));
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(connectionFactory->connections.size()));
+			CPPUNIT_ASSERT(connectionFactory->connections[0]->disconnected);
+			CPPUNIT_ASSERT(!connectionFactory->connections[1]->disconnected);
+		}
+
+		void testConnect_Racing_StartsNextAttemptAfterFailure() {
+			Connector::ref testling(createConnector());
+			testling->setConnectionAttemptDelayMilliseconds(250);
+			resolver->addXMPPClientService("foo.com", host1);
+			resolver->addXMPPClientService("foo.com", host2);
+			connectionFactory->failingPorts.push_back(host1);
+
+			testling->start();
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(connections.size()));
+			CPPUNIT_ASSERT(connections[0]);
+			CPPUNIT_ASSERT(host2 == *(connections[0]->hostAddressPort));
+		}
+
+		void testConnect_Racing_AlternatesAddressFamilies() {
+			Connector::ref testling(createConnector());
+			testling->setConnectionAttemptDelayMilliseconds(250);
+			resolver->addXMPPClientService("foo.com", "host-foo.com", 1234);
+			resolver->addAddress("host-foo.com", HostAddress("1.1.1.1"));
+			resolver->addAddress("host-foo.com", HostAddress("2.2.2.2"));
+			resolver->addAddress("host-foo.com", HostAddress("2001:db8::1"));
+
+			connectionFactory->isResponsive = false;
+			testling->start();
+			eventLoop->processEvents();
+			timerFactory->setTime(250);
+			eventLoop->processEvents();
+			timerFactory->setTime(500);
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(connectionFactory->connections.size()));
+			CPPUNIT_ASSERT(HostAddressPort(HostAddress("2001:db8::1"), 1234) == *(connectionFactory->connections[0]->hostAddressPort));
+			CPPUNIT_ASSERT(HostAddressPort(HostAddress("1.1.1.1"), 1234) == *(connectionFactory->connections[1]->hostAddressPort));
+			CPPUNIT_ASSERT(HostAddressPort(HostAddress("2.2.2.2"), 1234) == *(connectionFactory->connections[2]->hostAddressPort));
+			CPPUNIT_ASSERT(connections.empty());
+		}
+
+		void testConnect_Racing_AllSRVHostsFailWithFallbackHost() {
+			Connector::ref testling(createConnector());
+			testling->setConnectionAttemptDelayMilliseconds(250);
+			resolver->addXMPPClientService("foo.com", host1);
+			resolver->addXMPPClientService("foo.com", host2);
+			resolver->addAddress("foo.com", host3.getAddress());
+			connectionFactory->failingPorts.push_back(host1);
+			connectionFactory->failingPorts.push_back(host2);
+
+			testling->start();
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(connections.size()));
+			CPPUNIT_ASSERT(connections[0]);
+			CPPUNIT_ASSERT(host3 == *(connections[0]->hostAddressPort));
+			CPPUNIT_ASSERT(!boost::dynamic_pointer_cast<DomainNameResolveError>(error));
+		}
+
+		void testConnect_Racing_NoHosts() {
+			Connector::ref testling(createConnector());
+			testling->setConnectionAttemptDelayMilliseconds(250);
+
+			testling->start();
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(connections.size()));
+			CPPUNIT_ASSERT(!connections[0]);
+			CPPUNIT_ASSERT(boost::dynamic_pointer_cast<DomainNameResolveError>(error));
+		}
+
+		void testConnect_Racing_Timeout() {
+			Connector::ref testling(createConnector());
+			testling->setTimeoutMilliseconds(1000);
+			testling->setConnectionAttemptDelayMilliseconds(250);
+			resolver->addXMPPClientService("foo.com", host1);
+			connectionFactory->isResponsive = false;
+
+			testling->start();
+			eventLoop->processEvents();
+			timerFactory->setTime(250);
+			eventLoop->processEvents();
+			CPPUNIT_ASSERT(connections.empty());
+
+			timerFactory->setTime(1000);
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(connections.size()));
+			CPPUNIT_ASSERT(!connections[0]);
+			CPPUNIT_ASSERT(connectionFactory->connections[0]->disconnected);
+			CPPUNIT_ASSERT(!boost::dynamic_pointer_cast<DomainNameResolveError>(error));
+		}
+
+		void testStop_Racing() {
+			Connector::ref testling(createConnector());
+			testling->setConnectionAttemptDelayMilliseconds(250);
+			resolver->addXMPPClientService("foo.com", host1);
+			connectionFactory->isResponsive = false;
+
+			testling->start();
+			eventLoop->processEvents();
+			testling->stop();
+			timerFactory->setTime(250);
+			eventLoop->processEvents();
+
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(connections.size()));
+			CPPUNIT_ASSERT(!connections[0]);
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(connectionFactory->connections.size()));
+			CPPUNIT_ASSERT(connectionFactory->connections[0]->disconnected);
+		}
+
 	private:
 		Connector::ref createConnector(int port = -1, boost::optional<std::string> serviceLookupPrefix = boost::optional<std::string>("_xmpp-client._tcp.")) {
 			Connector::ref connector = Connector::create("foo.com", port, serviceLookupPrefix, resolver, connectionFactory, timerFactory);
@@ -329,7 +484,7 @@ class ConnectorTest : public CppUnit::TestFixture {
 
 		struct MockConnection : public Connection {
 			public:
-				MockConnection(const std::vector<HostAddressPort>& failingPorts, bool isResponsive, EventLoop* eventLoop) : eventLoop(eventLoop), failingPorts(failingPorts), isResponsive(isResponsive) {}
+				MockConnection(const std::vector<HostAddressPort>& failingPorts, bool isResponsive, EventLoop* eventLoop) : eventLoop(eventLoop), failingPorts(failingPorts), isResponsive(isResponsive), disconnected(false) {}
 
 				void listen() { assert(false); }
 				void connect(const HostAddressPort& address) {
@@ -341,13 +496,14 @@ class ConnectorTest : public CppUnit::TestFixture {
 				}
 
 				HostAddressPort getLocalAddress() const { return HostAddressPort(); }
-				void disconnect() { assert(false); }
+				void disconnect() { disconnected = true; }
 				void write(const SafeByteArray&) { assert(false); }
 
 				EventLoop* eventLoop;
 				boost::optional<HostAddressPort> hostAddressPort;
 				std::vector<HostAddressPort> failingPorts;
 				bool isResponsive;
+				bool disconnected;
 		};
 
 		struct MockConnectionFactory : public ConnectionFactory {
@@ -355,12 +511,15 @@ class ConnectorTest : public CppUnit::TestFixture {
 			}
 
 			boost::shared_ptr<Connection> createConnection() {
-				return boost::shared_ptr<Connection>(new MockConnection(failingPorts, isResponsive, eventLoop));
+				boost::shared_ptr<MockConnection> connection(new MockConnection(failingPorts, isResponsive, eventLoop));
+				connections.push_back(connection);
+				return connection;
 			}
 
 			EventLoop* eventLoop;
 			bool isResponsive;
 			std::vector<HostAddressPort> failingPorts;
+			std::vector<boost::shared_ptr<MockConnection> > connections;
 		};
 
 	private:
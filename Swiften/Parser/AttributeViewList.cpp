@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/Parser/AttributeViewList.h>
+
+#include <boost/optional.hpp>
+
+using namespace Swift;
+
+const AttributeView* AttributeViewList::find(const StringView& attribute, const StringView& ns) const {
+	for (const AttributeView* i = begin(); i != end(); ++i) {
+		if (i->name == attribute && i->ns == ns) {
+			return i;
+		}
+	}
+	return NULL;
+}
+
+StringView AttributeViewList::getAttribute(const StringView& attribute, const StringView& ns) const {
+	const AttributeView* i = find(attribute, ns);
+	return i ? i->value : StringView();
+}
+
+bool AttributeViewList::getBoolAttribute(const StringView& attribute, bool defaultValue) const {
+	const AttributeView* i = find(attribute, StringView());
+	if (!i) {
+		return defaultValue;
+	}
+	return i->value == "true" || i->value == "1";
+}
+
+boost::optional<StringView> AttributeViewList::getAttributeValue(const StringView& attribute) const {
+	const AttributeView* i = find(attribute, StringView());
+	if (!i) {
+		return boost::optional<StringView>();
+	}
+	return i->value;
+}
+
+AttributeMap AttributeViewList::toAttributeMap() const {
+	AttributeMap result;
+	for (const AttributeView* i = begin(); i != end(); ++i) {
+		result.addAttribute(i->name.toString(), i->ns.toString(), i->value.toString());
+	}
+	return result;
+}
+
+AttributeViewBuffer::AttributeViewBuffer(const AttributeMap& attributes) : size_(0) {
+	for (std::vector<AttributeMap::Entry>::const_iterator i = attributes.getEntries().begin(); i != attributes.getEntries().end(); ++i) {
+		add(AttributeView(i->getAttribute().getName(), i->getAttribute().getNamespace(), i->getValue()));
+	}
+}
+
+void AttributeViewBuffer::add(const AttributeView& attribute) {
+	if (size_ < InlineCapacity) {
+		inline_[size_] = attribute;
+	}
+	else {
+		if (overflow_.empty()) {
+			overflow_.assign(inline_, inline_ + InlineCapacity);
+		}
+		overflow_.push_back(attribute);
+	}
+	++size_;
+}
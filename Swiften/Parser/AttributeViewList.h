@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <boost/optional/optional_fwd.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <Swiften/Base/API.h>
+#include <Swiften/Base/StringView.h>
+#include <Swiften/Parser/AttributeMap.h>
+
+namespace Swift {
+	/**
+	 * A non-owning attribute, as handed out by the XML parsers.
+	 */
+	struct AttributeView {
+		AttributeView() {}
+		AttributeView(const StringView& name, const StringView& ns, const StringView& value) : name(name), ns(ns), value(value) {}
+
+		StringView name;
+		StringView ns;
+		StringView value;
+	};
+
+	/**
+	 * A non-owning list of attributes of an element.
+	 *
+	 * The list and the attribute data it refers to are only valid for the
+	 * duration of the callback they were passed to.
+	 */
+	class SWIFTEN_API AttributeViewList {
+		public:
+			AttributeViewList() : attributes_(0), size_(0) {
+			}
+
+			AttributeViewList(const AttributeView* attributes, size_t size) : attributes_(attributes), size_(size) {
+			}
+
+			size_t size() const {
+				return size_;
+			}
+
+			const AttributeView& operator[](size_t i) const {
+				return attributes_[i];
+			}
+
+			const AttributeView* begin() const {
+				return attributes_;
+			}
+
+			const AttributeView* end() const {
+				return attributes_ + size_;
+			}
+
+			StringView getAttribute(const StringView& attribute, const StringView& ns = StringView()) const;
+			bool getBoolAttribute(const StringView& attribute, bool defaultValue = false) const;
+			boost::optional<StringView> getAttributeValue(const StringView& attribute) const;
+
+			/**
+			 * Creates an owning copy of the attributes.
+			 */
+			AttributeMap toAttributeMap() const;
+
+		private:
+			const AttributeView* find(const StringView& attribute, const StringView& ns) const;
+
+		private:
+			const AttributeView* attributes_;
+			size_t size_;
+	};
+
+	/**
+	 * Storage for the attribute views of a single element.
+	 *
+	 * Small attribute lists are kept in inline storage, so that building a
+	 * list does not need to allocate.
+	 */
+	class SWIFTEN_API AttributeViewBuffer : public boost::noncopyable {
+		public:
+			AttributeViewBuffer() : size_(0) {
+			}
+
+			explicit AttributeViewBuffer(const AttributeMap& attributes);
+
+			void add(const AttributeView& attribute);
+
+			AttributeViewList getList() const {
+				return AttributeViewList(overflow_.empty() ? inline_ : &overflow_[0], size_);
+			}
+
+		private:
+			enum { InlineCapacity = 8 };
+			AttributeView inline_[InlineCapacity];
+			std::vector<AttributeView> overflow_;
+			size_t size_;
+	};
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <Swiften/Base/StringView.h>
+
+namespace Swift {
+	/**
+	 * A hash table keyed on (element, namespace) pairs.
+	 *
+	 * Lookups take views, so that looking up the name of an element
+	 * that is being parsed does not need to copy it.
+	 */
+	template<typename T>
+	class ElementNameIndex {
+		private:
+			typedef std::pair<std::string, std::string> Key;
+			typedef std::pair<StringView, StringView> KeyView;
+
+			struct Hash {
+				size_t operator()(const KeyView& key) const {
+					size_t seed = boost::hash_range(key.first.begin(), key.first.end());
+					boost::hash_combine(seed, boost::hash_range(key.second.begin(), key.second.end()));
+					return seed;
+				}
+
+				size_t operator()(const Key& key) const {
+					return (*this)(KeyView(key.first, key.second));
+				}
+			};
+
+			struct Equal {
+				bool operator()(const KeyView& a, const Key& b) const {
+					return a.first == StringView(b.first) && a.second == StringView(b.second);
+				}
+
+				bool operator()(const Key& a, const Key& b) const {
+					return a == b;
+				}
+			};
+
+			typedef boost::unordered_map<Key, T, Hash, Equal> Map;
+
+		public:
+			typedef typename Map::iterator iterator;
+
+			/**
+			 * Returns the value for the given element and namespace, creating it if
+			 * it does not exist yet.
+			 */
+			T& operator()(const std::string& element, const std::string& ns) {
+				return map_[Key(element, ns)];
+			}
+
+			T* find(const StringView& element, const StringView& ns) {
+				typename Map::iterator i = map_.find(KeyView(element, ns), Hash(), Equal());
+				return i == map_.end() ? NULL : &i->second;
+			}
+
+			const T* find(const StringView& element, const StringView& ns) const {
+				typename Map::const_iterator i = map_.find(KeyView(element, ns), Hash(), Equal());
+				return i == map_.end() ? NULL : &i->second;
+			}
+
+			iterator begin() {
+				return map_.begin();
+			}
+
+			iterator end() {
+				return map_.end();
+			}
+
+			void erase(iterator i) {
+				map_.erase(i);
+			}
+
+		private:
+			Map map_;
+	};
+}
@@ -1,14 +1,36 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Parser/ElementParser.h>
 
+#include <Swiften/Parser/ParserArena.h>
+
 namespace Swift {
 
 ElementParser::~ElementParser() {
 }
 
+void* ElementParser::operator new(size_t size) {
+	return ParserArena::allocate(size);
+}
+
+void ElementParser::operator delete(void* pointer) {
+	ParserArena::deallocate(pointer);
+}
+
+void ElementParser::handleStartElementView(const StringView& element, const StringView& ns, const AttributeViewList& attributes) {
+	handleStartElement(element.toString(), ns.toString(), attributes.toAttributeMap());
+}
+
+void ElementParser::handleEndElementView(const StringView& element, const StringView& ns) {
+	handleEndElement(element.toString(), ns.toString());
+}
+
+void ElementParser::handleCharacterDataView(const StringView& data) {
+	handleCharacterData(data.toString());
+}
+
 }
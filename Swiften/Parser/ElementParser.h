@@ -1,27 +1,47 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <cstddef>
 #include <boost/shared_ptr.hpp>
 
 #include <string>
 #include <Swiften/Base/API.h>
 #include <Swiften/Elements/ToplevelElement.h>
 #include <Swiften/Parser/AttributeMap.h>
+#include <Swiften/Parser/AttributeViewList.h>
 
 namespace Swift {
 	class SWIFTEN_API ElementParser {
 		public:
 			virtual ~ElementParser();
 
+			/**
+			 * Parsers are allocated in the current ParserArena, if there is one.
+			 */
+			static void* operator new(size_t size);
+			static void operator delete(void* pointer);
+
 			virtual void handleStartElement(const std::string& element, const std::string& ns, const AttributeMap& attributes) = 0;
 			virtual void handleEndElement(const std::string& element, const std::string& ns) = 0;
 			virtual void handleCharacterData(const std::string& data) = 0;
 
+			/**
+			 * Zero-copy variants of the callbacks above.
+			 *
+			 * The default implementations create owning copies of the data, and
+			 * pass them on to the corresponding callback above.
+			 *
+			 * \see XMLParserClient
+			 */
+			virtual void handleStartElementView(const StringView& element, const StringView& ns, const AttributeViewList& attributes);
+			virtual void handleEndElementView(const StringView& element, const StringView& ns);
+			virtual void handleCharacterDataView(const StringView& data);
+
 			virtual boost::shared_ptr<ToplevelElement> getElement() const = 0;
 	};
 }
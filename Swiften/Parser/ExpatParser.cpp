@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,10 +8,12 @@
 
 #include <iostream>
 #include <string>
+#include <cstring>
+#include <cassert>
 #include <expat.h>
 #include <boost/numeric/conversion/cast.hpp>
 
-#include <Swiften/Base/String.h>
+#include <Swiften/Base/StringView.h>
 #include <Swiften/Parser/XMLParserClient.h>
 
 #pragma clang diagnostic ignored "-Wdisabled-macro-expansion"
@@ -24,39 +26,43 @@ struct ExpatParser::Private {
 	XML_Parser parser_;
 };
 
-static void handleStartElement(void* parser, const XML_Char* name, const XML_Char** attributes) {
-	std::pair<std::string,std::string> nsTagPair = String::getSplittedAtFirst(name, NAMESPACE_SEPARATOR);
-	if (nsTagPair.second == "") {
-		nsTagPair.second = nsTagPair.first;
-		nsTagPair.first = "";
+static void splitName(const XML_Char* name, StringView& element, StringView& ns) {
+	const char* separator = std::strchr(name, NAMESPACE_SEPARATOR);
+	if (separator) {
+		ns = StringView(name, static_cast<size_t>(separator - name));
+		element = StringView(separator + 1);
+	}
+	else {
+		ns = StringView();
+		element = StringView(name);
 	}
-	AttributeMap attributeValues;
+}
+
+static void handleStartElement(void* parser, const XML_Char* name, const XML_Char** attributes) {
+	StringView element, ns;
+	splitName(name, element, ns);
+	AttributeViewBuffer attributeValues;
 	const XML_Char** currentAttribute = attributes;
 	while (*currentAttribute) {
-		std::pair<std::string,std::string> nsAttributePair = String::getSplittedAtFirst(*currentAttribute, NAMESPACE_SEPARATOR);
-		if (nsAttributePair.second == "") {
-			nsAttributePair.second = nsAttributePair.first;
-			nsAttributePair.first = "";
-		}
-		attributeValues.addAttribute(nsAttributePair.second, nsAttributePair.first, std::string(*(currentAttribute+1)));
+		AttributeView attribute;
+		splitName(*currentAttribute, attribute.name, attribute.ns);
+		attribute.value = StringView(*(currentAttribute+1));
+		attributeValues.add(attribute);
 		currentAttribute += 2;
 	}
 
-	static_cast<XMLParser*>(parser)->getClient()->handleStartElement(nsTagPair.second, nsTagPair.first, attributeValues);
+	static_cast<XMLParser*>(parser)->getClient()->handleStartElementView(element, ns, attributeValues.getList());
 }
 
 static void handleEndElement(void* parser, const XML_Char* name) {
-	std::pair<std::string,std::string> nsTagPair = String::getSplittedAtFirst(name, NAMESPACE_SEPARATOR);
-	if (nsTagPair.second == "") {
-		nsTagPair.second = nsTagPair.first;
-		nsTagPair.first = "";
-	}
-	static_cast<XMLParser*>(parser)->getClient()->handleEndElement(nsTagPair.second, nsTagPair.first);
+	StringView element, ns;
+	splitName(name, element, ns);
+	static_cast<XMLParser*>(parser)->getClient()->handleEndElementView(element, ns);
 }
 
 static void handleCharacterData(void* parser, const XML_Char* data, int len) {
 	assert(len >= 0);
-	static_cast<XMLParser*>(parser)->getClient()->handleCharacterData(std::string(data, static_cast<size_t>(len)));
+	static_cast<XMLParser*>(parser)->getClient()->handleCharacterDataView(StringView(data, static_cast<size_t>(len)));
 }
 
 static void handleXMLDeclaration(void*, const XML_Char*, const XML_Char*, int) {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -9,6 +9,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/smart_ptr/make_shared.hpp>
 
+#include <Swiften/Parser/ParserArena.h>
 #include <Swiften/Parser/ElementParser.h>
 
 namespace Swift {
@@ -19,7 +20,7 @@ namespace Swift {
 	class GenericElementParser : public ElementParser {
 		public:
 			GenericElementParser() {
-				stanza_ = boost::make_shared<ElementType>();
+				stanza_ = ParserArena::makeShared<ElementType>();
 			}
 
 			virtual boost::shared_ptr<ToplevelElement> getElement() const {
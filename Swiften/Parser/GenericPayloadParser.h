@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -9,6 +9,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/smart_ptr/make_shared.hpp>
 
+#include <Swiften/Parser/ParserArena.h>
 #include <Swiften/Parser/PayloadParser.h>
 
 namespace Swift {
@@ -25,7 +26,7 @@ namespace Swift {
 	class GenericPayloadParser : public PayloadParser {
 		public:
 			GenericPayloadParser() : PayloadParser() {
-				payload_ = boost::make_shared<PAYLOAD_TYPE>();
+				payload_ = ParserArena::makeShared<PAYLOAD_TYPE>();
 			}
 
 			virtual boost::shared_ptr<Payload> getPayload() const {
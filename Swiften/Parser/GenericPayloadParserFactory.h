@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -26,6 +26,11 @@ namespace Swift {
 				return (tag_.empty() ? true : element == tag_) && (xmlns_.empty() ? true : xmlns_ == ns);
 			}
 
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const {
+				elements.push_back(std::make_pair(tag_, xmlns_));
+				return true;
+			}
+
 			virtual PayloadParser* createPayloadParser() {
 				return new PARSER_TYPE();
 			}
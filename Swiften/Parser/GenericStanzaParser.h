@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -9,6 +9,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/smart_ptr/make_shared.hpp>
 
+#include <Swiften/Parser/ParserArena.h>
 #include <Swiften/Parser/StanzaParser.h>
 
 namespace Swift {
@@ -20,7 +21,7 @@ namespace Swift {
 		public:
 			GenericStanzaParser(PayloadParserFactoryCollection* collection) : 
 						StanzaParser(collection) {
-				stanza_ = boost::make_shared<STANZA_TYPE>();
+				stanza_ = ParserArena::makeShared<STANZA_TYPE>();
 			}
 
 			virtual boost::shared_ptr<ToplevelElement> getElement() const {
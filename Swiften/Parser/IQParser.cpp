@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -15,8 +15,8 @@ IQParser::IQParser(PayloadParserFactoryCollection* factories) :
 		GenericStanzaParser<IQ>(factories) {
 }
 
-void IQParser::handleStanzaAttributes(const AttributeMap& attributes) {
-	boost::optional<std::string> type = attributes.getAttributeValue("type");
+void IQParser::handleStanzaAttributes(const AttributeViewList& attributes) {
+	boost::optional<StringView> type = attributes.getAttributeValue("type");
 	if (type) {
 		if (*type == "set") {
 			getStanzaGeneric()->setType(IQ::Set);
@@ -31,7 +31,7 @@ void IQParser::handleStanzaAttributes(const AttributeMap& attributes) {
 			getStanzaGeneric()->setType(IQ::Error);
 		}
 		else {
-			std::cerr << "Unknown IQ type: " << *type << std::endl;
+			std::cerr << "Unknown IQ type: " << type->toString() << std::endl;
 			getStanzaGeneric()->setType(IQ::Get);
 		}
 	}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -23,31 +23,27 @@ struct LibXMLParser::Private {
 };
 
 static void handleStartElement(void* parser, const xmlChar* name, const xmlChar*, const xmlChar* xmlns, int, const xmlChar**, int nbAttributes, int nbDefaulted, const xmlChar ** attributes) {
-	AttributeMap attributeValues;
+	AttributeViewBuffer attributeValues;
 	if (nbDefaulted != 0) {
 		// Just because i don't understand what this means yet :-)
 		std::cerr << "Unexpected nbDefaulted on XML element" << std::endl;
 	}
 	for (int i = 0; i < nbAttributes*5; i += 5) {
-		std::string attributeNS = "";
-		if (attributes[i+2]) {
-			attributeNS = std::string(reinterpret_cast<const char*>(attributes[i+2]));
-		}
-		attributeValues.addAttribute(
-				std::string(reinterpret_cast<const char*>(attributes[i])), 
-				attributeNS, 
-				std::string(reinterpret_cast<const char*>(attributes[i+3]),
-					boost::numeric_cast<size_t>(attributes[i+4]-attributes[i+3])));
+		attributeValues.add(AttributeView(
+				reinterpret_cast<const char*>(attributes[i]),
+				(attributes[i+2] ? StringView(reinterpret_cast<const char*>(attributes[i+2])) : StringView()),
+				StringView(reinterpret_cast<const char*>(attributes[i+3]),
+					boost::numeric_cast<size_t>(attributes[i+4]-attributes[i+3]))));
 	}
-	static_cast<XMLParser*>(parser)->getClient()->handleStartElement(reinterpret_cast<const char*>(name), (xmlns ? reinterpret_cast<const char*>(xmlns) : std::string()), attributeValues);
+	static_cast<XMLParser*>(parser)->getClient()->handleStartElementView(reinterpret_cast<const char*>(name), (xmlns ? StringView(reinterpret_cast<const char*>(xmlns)) : StringView()), attributeValues.getList());
 }
 
 static void handleEndElement(void *parser, const xmlChar* name, const xmlChar*, const xmlChar* xmlns) {
-	static_cast<XMLParser*>(parser)->getClient()->handleEndElement(reinterpret_cast<const char*>(name), (xmlns ? reinterpret_cast<const char*>(xmlns) : std::string()));
+	static_cast<XMLParser*>(parser)->getClient()->handleEndElementView(reinterpret_cast<const char*>(name), (xmlns ? StringView(reinterpret_cast<const char*>(xmlns)) : StringView()));
 }
 
 static void handleCharacterData(void* parser, const xmlChar* data, int len) {
-	static_cast<XMLParser*>(parser)->getClient()->handleCharacterData(std::string(reinterpret_cast<const char*>(data), boost::numeric_cast<size_t>(len)));
+	static_cast<XMLParser*>(parser)->getClient()->handleCharacterDataView(StringView(reinterpret_cast<const char*>(data), boost::numeric_cast<size_t>(len)));
 }
 
 static void handleError(void*, const char* /*m*/, ... ) {
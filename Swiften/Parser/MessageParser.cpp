@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -15,8 +15,8 @@ MessageParser::MessageParser(PayloadParserFactoryCollection* factories) :
 	getStanzaGeneric()->setType(Message::Normal);
 }
 
-void MessageParser::handleStanzaAttributes(const AttributeMap& attributes) {
-	boost::optional<std::string> type = attributes.getAttributeValue("type");
+void MessageParser::handleStanzaAttributes(const AttributeViewList& attributes) {
+	boost::optional<StringView> type = attributes.getAttributeValue("type");
 	if (type) {
 		if (*type == "chat") {
 			getStanzaGeneric()->setType(Message::Chat);
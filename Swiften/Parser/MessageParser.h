@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -16,6 +16,6 @@ namespace Swift {
 			MessageParser(PayloadParserFactoryCollection* factories);
 
 		private:
-			virtual void handleStanzaAttributes(const AttributeMap&);
+			virtual void handleStanzaAttributes(const AttributeViewList&);
 	};
 }
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/Parser/ParserArena.h>
+
+#include <new>
+#include <boost/thread/tss.hpp>
+
+namespace Swift {
+
+namespace {
+	void doNotDeleteArena(Arena*) {
+	}
+
+	boost::thread_specific_ptr<Arena>& getCurrentArenaPointer() {
+		static boost::thread_specific_ptr<Arena> currentArena(&doNotDeleteArena);
+		return currentArena;
+	}
+
+	/**
+	 * Placed before the memory returned by ParserArena::allocate(), to keep
+	 * the arena of the memory alive. The arena is empty for heap memory.
+	 */
+	struct AllocationHeader {
+		boost::shared_ptr<Arena> arena;
+	};
+
+	// Keeps the memory after the header aligned like Arena memory
+	const size_t ALIGNMENT = 16;
+	const size_t HEADER_SIZE = (sizeof(AllocationHeader) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+ParserArena::Scope::Scope(boost::shared_ptr<Arena> arena) : arena_(arena), previousArena_(NULL) {
+	if (arena_) {
+		previousArena_ = getCurrentArenaPointer().get();
+		getCurrentArenaPointer().reset(arena_.get());
+	}
+}
+
+ParserArena::Scope::~Scope() {
+	if (arena_) {
+		getCurrentArenaPointer().reset(previousArena_);
+	}
+}
+
+Arena* ParserArena::getCurrentArena() {
+	return getCurrentArenaPointer().get();
+}
+
+void* ParserArena::allocate(size_t size) {
+	Arena* arena = getCurrentArena();
+	char* memory = static_cast<char*>(arena ? arena->allocate(HEADER_SIZE + size) : ::operator new(HEADER_SIZE + size));
+	AllocationHeader* header = new (memory) AllocationHeader();
+	if (arena) {
+		header->arena = arena->shared_from_this();
+	}
+	return memory + HEADER_SIZE;
+}
+
+void ParserArena::deallocate(void* pointer) {
+	if (!pointer) {
+		return;
+	}
+	char* memory = static_cast<char*>(pointer) - HEADER_SIZE;
+	AllocationHeader* header = reinterpret_cast<AllocationHeader*>(memory);
+
+	// The arena may own the header, so only release it at the end
+	boost::shared_ptr<Arena> arena;
+	arena.swap(header->arena);
+	header->~AllocationHeader();
+	if (!arena) {
+		::operator delete(memory);
+	}
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+
+#include <Swiften/Base/API.h>
+#include <Swiften/Base/Arena.h>
+
+namespace Swift {
+	/**
+	 * Allocation of parsers and parsed elements in an Arena.
+	 *
+	 * While a ParserArena::Scope is active, the parsers created on the current
+	 * thread, and the elements and payloads they create, are allocated in the
+	 * arena of the scope. The arena is released when the last of these objects
+	 * is destroyed. Strings and containers inside the elements still use the
+	 * heap.
+	 */
+	class SWIFTEN_API ParserArena {
+		public:
+			class SWIFTEN_API Scope : public boost::noncopyable {
+				public:
+					/**
+					 * Activates the given arena for the lifetime of the scope. If the arena
+					 * is NULL, the scope has no effect.
+					 */
+					Scope(boost::shared_ptr<Arena> arena);
+					~Scope();
+
+				private:
+					boost::shared_ptr<Arena> arena_;
+					Arena* previousArena_;
+			};
+
+			/**
+			 * Returns the arena of the active scope on the current thread, or NULL if
+			 * there is no active scope.
+			 */
+			static Arena* getCurrentArena();
+
+			/**
+			 * Creates an object in the current arena, or on the heap if there is no
+			 * current arena.
+			 */
+			template<typename T>
+			static boost::shared_ptr<T> makeShared() {
+				if (Arena* arena = getCurrentArena()) {
+					return boost::allocate_shared<T>(ArenaAllocator<T>(arena->shared_from_this()));
+				}
+				return boost::make_shared<T>();
+			}
+
+			/**
+			 * Allocates memory in the current arena, or on the heap if there is no
+			 * current arena. The memory keeps the arena alive until it is passed to
+			 * deallocate().
+			 */
+			static void* allocate(size_t size);
+
+			/**
+			 * Releases memory returned by allocate().
+			 */
+			static void deallocate(void* pointer);
+	};
+}
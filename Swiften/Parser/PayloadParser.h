@@ -1,16 +1,18 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <cstddef>
 #include <boost/shared_ptr.hpp>
 
 
 #include <Swiften/Base/API.h>
 #include <Swiften/Parser/AttributeMap.h>
+#include <Swiften/Parser/AttributeViewList.h>
 #include <Swiften/Elements/Payload.h>
 
 namespace Swift {
@@ -28,6 +30,12 @@ namespace Swift {
 		public:
 			virtual ~PayloadParser();
 
+			/**
+			 * Parsers are allocated in the current ParserArena, if there is one.
+			 */
+			static void* operator new(size_t size);
+			static void operator delete(void* pointer);
+
 			/**
 			 * Handle the start of an XML element.
 			 */
@@ -43,6 +51,25 @@ namespace Swift {
 			 */
 			virtual void handleCharacterData(const std::string& data) = 0;
 
+			/**
+			 * Handle the start of an XML element, without copying the data.
+			 *
+			 * The element, namespace, and attributes are only valid for the
+			 * duration of the call. The default implementation creates owning
+			 * copies, and passes them on to handleStartElement().
+			 */
+			virtual void handleStartElementView(const StringView& element, const StringView& ns, const AttributeViewList& attributes);
+
+			/**
+			 * Handle the end of an XML element, without copying the data.
+			 */
+			virtual void handleEndElementView(const StringView& element, const StringView& ns);
+
+			/**
+			 * Handle character data, without copying the data.
+			 */
+			virtual void handleCharacterDataView(const StringView& data);
+
 			/**
 			 * Retrieve a pointer to the payload.
 			 */
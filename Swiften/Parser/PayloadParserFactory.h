@@ -1,11 +1,15 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <Swiften/Base/API.h>
 #include <Swiften/Parser/AttributeMap.h>
 
@@ -25,6 +29,17 @@ namespace Swift {
 			 */
 			virtual bool canParse(const std::string& element, const std::string& ns, const AttributeMap& attributes) const = 0;
 
+			/**
+			 * Retrieves the top-level elements (as element/namespace pairs) this factory
+			 * can parse, irrespective of their attributes. An empty element or namespace
+			 * matches any element or namespace.
+			 *
+			 * This allows PayloadParserFactoryCollection to find the factory without
+			 * calling canParse(). Factories that cannot describe the elements they parse
+			 * this way return false (which is the default).
+			 */
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const;
+
 			/**
 			 * Creates a new payload parser.
 			 */
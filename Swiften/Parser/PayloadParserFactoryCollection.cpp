@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,20 +7,49 @@
 #include <boost/bind.hpp>
 #include <algorithm>
 
+#include <Swiften/Base/foreach.h>
 #include <Swiften/Parser/PayloadParserFactoryCollection.h>
 #include <Swiften/Parser/PayloadParserFactory.h>
 
 namespace Swift {
 
-PayloadParserFactoryCollection::PayloadParserFactoryCollection() : defaultFactory_(NULL) {
+namespace {
+	bool isEntryForFactory(const std::pair<size_t, PayloadParserFactory*>& entry, PayloadParserFactory* factory) {
+		return entry.second == factory;
+	}
+}
+
+PayloadParserFactoryCollection::PayloadParserFactoryCollection() : nextSequenceNumber_(0), defaultFactory_(NULL) {
 }
 
 void PayloadParserFactoryCollection::addFactory(PayloadParserFactory* factory) {
 	factories_.push_back(factory);
+	Entry entry(nextSequenceNumber_++, factory);
+	std::vector<std::pair<std::string, std::string> > elements;
+	if (factory->getSupportedElements(elements)) {
+		typedef std::pair<std::string, std::string> Element;
+		foreach (const Element& element, elements) {
+			index_(element.first, element.second).push_back(entry);
+		}
+	}
+	else {
+		unindexedFactories_.push_back(entry);
+	}
 }
 
 void PayloadParserFactoryCollection::removeFactory(PayloadParserFactory* factory) {
 	factories_.erase(std::remove(factories_.begin(), factories_.end(), factory), factories_.end());
+	unindexedFactories_.erase(std::remove_if(unindexedFactories_.begin(), unindexedFactories_.end(), boost::bind(&isEntryForFactory, _1, factory)), unindexedFactories_.end());
+	for (ElementNameIndex<std::vector<Entry> >::iterator i = index_.begin(); i != index_.end(); ) {
+		std::vector<Entry>& entries = i->second;
+		entries.erase(std::remove_if(entries.begin(), entries.end(), boost::bind(&isEntryForFactory, _1, factory)), entries.end());
+		if (entries.empty()) {
+			index_.erase(i++);
+		}
+		else {
+			++i;
+		}
+	}
 }
 
 void PayloadParserFactoryCollection::setDefaultFactory(PayloadParserFactory* factory) {
@@ -28,10 +57,48 @@ void PayloadParserFactoryCollection::setDefaultFactory(PayloadParserFactory* fac
 }
 
 PayloadParserFactory* PayloadParserFactoryCollection::getPayloadParserFactory(const std::string& element, const std::string& ns, const AttributeMap& attributes) {
-	std::vector<PayloadParserFactory*>::reverse_iterator i = std::find_if(
-			factories_.rbegin(), factories_.rend(),
-			boost::bind(&PayloadParserFactory::canParse, _1, element, ns, attributes));
-	return (i != factories_.rend() ? *i : defaultFactory_);
+	const Entry* result = NULL;
+	findIndexedFactory(element, ns, result);
+	for (std::vector<Entry>::const_reverse_iterator i = unindexedFactories_.rbegin(); i != unindexedFactories_.rend() && (!result || i->first > result->first); ++i) {
+		if (i->second->canParse(element, ns, attributes)) {
+			result = &*i;
+			break;
+		}
+	}
+	return result ? result->second : defaultFactory_;
+}
+
+PayloadParserFactory* PayloadParserFactoryCollection::getPayloadParserFactory(const StringView& element, const StringView& ns, const AttributeViewList& attributes) {
+	const Entry* result = NULL;
+	findIndexedFactory(element, ns, result);
+	std::vector<Entry>::const_reverse_iterator i = unindexedFactories_.rbegin();
+	if (i != unindexedFactories_.rend() && (!result || i->first > result->first)) {
+		// Only create copies when there are factories that need them
+		std::string elementString = element.toString();
+		std::string nsString = ns.toString();
+		AttributeMap attributeMap = attributes.toAttributeMap();
+		for (; i != unindexedFactories_.rend() && (!result || i->first > result->first); ++i) {
+			if (i->second->canParse(elementString, nsString, attributeMap)) {
+				result = &*i;
+				break;
+			}
+		}
+	}
+	return result ? result->second : defaultFactory_;
+}
+
+void PayloadParserFactoryCollection::findIndexedFactory(const StringView& element, const StringView& ns, const Entry*& result) const {
+	const std::vector<Entry>* candidates[] = {
+		index_.find(element, ns),
+		index_.find(element, StringView()),
+		index_.find(StringView(), ns),
+		index_.find(StringView(), StringView())
+	};
+	foreach (const std::vector<Entry>* entries, candidates) {
+		if (entries && !entries->empty() && (!result || entries->back().first > result->first)) {
+			result = &entries->back();
+		}
+	}
 }
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,13 +7,27 @@
 #pragma once
 
 #include <vector>
+#include <utility>
 
 #include <Swiften/Parser/AttributeMap.h>
+#include <Swiften/Parser/AttributeViewList.h>
+#include <Swiften/Parser/ElementNameIndex.h>
 #include <Swiften/Base/API.h>
+#include <Swiften/Base/StringView.h>
 
 namespace Swift {
 	class PayloadParserFactory;
 
+	/**
+	 * A collection of payload parser factories.
+	 *
+	 * Factories that describe the elements they can parse (through
+	 * PayloadParserFactory::getSupportedElements()) are looked up through a
+	 * hash index on element and namespace. All other factories are asked
+	 * whether they can parse an element through PayloadParserFactory::canParse().
+	 * When multiple factories can parse an element, the one that was added last
+	 * is used.
+	 */
 	class SWIFTEN_API PayloadParserFactoryCollection {
 		public:
 			PayloadParserFactoryCollection();
@@ -23,9 +37,19 @@ namespace Swift {
 			void setDefaultFactory(PayloadParserFactory* factory);
 
 			PayloadParserFactory* getPayloadParserFactory(const std::string& element, const std::string& ns, const AttributeMap& attributes);
+			PayloadParserFactory* getPayloadParserFactory(const StringView& element, const StringView& ns, const AttributeViewList& attributes);
+
+		private:
+			// Factories, together with the order in which they were added
+			typedef std::pair<size_t, PayloadParserFactory*> Entry;
+
+			void findIndexedFactory(const StringView& element, const StringView& ns, const Entry*& result) const;
 
 		private:
 			std::vector<PayloadParserFactory*> factories_;
+			ElementNameIndex<std::vector<Entry> > index_;
+			std::vector<Entry> unindexedFactories_;
+			size_t nextSequenceNumber_;
 			PayloadParserFactory* defaultFactory_;
 	};
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,19 +11,19 @@ namespace Swift {
 BodyParser::BodyParser() : level_(0) {
 }
 
-void BodyParser::handleStartElement(const std::string&, const std::string&, const AttributeMap&) {
+void BodyParser::handleStartElementView(const StringView&, const StringView&, const AttributeViewList&) {
 	++level_;
 }
 
-void BodyParser::handleEndElement(const std::string&, const std::string&) {
+void BodyParser::handleEndElementView(const StringView&, const StringView&) {
 	--level_;
 	if (level_ == 0) {
 		getPayloadInternal()->setText(text_);
 	}
 }
 
-void BodyParser::handleCharacterData(const std::string& data) {
-	text_ += data;
+void BodyParser::handleCharacterDataView(const StringView& data) {
+	data.appendTo(text_);
 }
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,20 +13,20 @@ namespace Swift {
 CapsInfoParser::CapsInfoParser() : level(0) {
 }
 
-void CapsInfoParser::handleStartElement(const std::string&, const std::string& /*ns*/, const AttributeMap& attributes) {
+void CapsInfoParser::handleStartElementView(const StringView&, const StringView& /*ns*/, const AttributeViewList& attributes) {
 	if (level == 0) {
-		getPayloadInternal()->setHash(attributes.getAttribute("hash"));
-		getPayloadInternal()->setNode(attributes.getAttribute("node"));
-		getPayloadInternal()->setVersion(attributes.getAttribute("ver"));
+		getPayloadInternal()->setHash(attributes.getAttribute("hash").toString());
+		getPayloadInternal()->setNode(attributes.getAttribute("node").toString());
+		getPayloadInternal()->setVersion(attributes.getAttribute("ver").toString());
 	}
 	++level;
 }
 
-void CapsInfoParser::handleEndElement(const std::string&, const std::string&) {
+void CapsInfoParser::handleEndElementView(const StringView&, const StringView&) {
 	--level;
 }
 
-void CapsInfoParser::handleCharacterData(const std::string&) {
+void CapsInfoParser::handleCharacterDataView(const StringView&) {
 
 }
 
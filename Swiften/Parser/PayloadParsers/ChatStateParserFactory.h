@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -23,6 +23,15 @@ namespace Swift {
 					 || element == "paused" || element == "inactive" || element == "gone");
 			}
 
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const {
+				elements.push_back(std::make_pair("active", "http://jabber.org/protocol/chatstates"));
+				elements.push_back(std::make_pair("composing", "http://jabber.org/protocol/chatstates"));
+				elements.push_back(std::make_pair("paused", "http://jabber.org/protocol/chatstates"));
+				elements.push_back(std::make_pair("inactive", "http://jabber.org/protocol/chatstates"));
+				elements.push_back(std::make_pair("gone", "http://jabber.org/protocol/chatstates"));
+				return true;
+			}
+
 			virtual PayloadParser* createPayloadParser() {
 				return new ChatStateParser();
 			}
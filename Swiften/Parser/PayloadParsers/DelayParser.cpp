@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,23 +13,23 @@ namespace Swift {
 DelayParser::DelayParser() : level_(0) {
 }
 
-void DelayParser::handleStartElement(const std::string& /*element*/, const std::string& /*ns*/, const AttributeMap& attributes) {
+void DelayParser::handleStartElementView(const StringView& /*element*/, const StringView& /*ns*/, const AttributeViewList& attributes) {
 	if (level_ == 0) {
-		boost::posix_time::ptime stamp = stringToDateTime(attributes.getAttribute("stamp"));
+		boost::posix_time::ptime stamp = stringToDateTime(attributes.getAttribute("stamp").toString());
 		getPayloadInternal()->setStamp(stamp);
 		if (!attributes.getAttribute("from").empty()) {
-			std::string from = attributes.getAttribute("from");
+			std::string from = attributes.getAttribute("from").toString();
 			getPayloadInternal()->setFrom(JID(from));
 		}
 	}
 	++level_;
 }
 
-void DelayParser::handleEndElement(const std::string&, const std::string&) {
+void DelayParser::handleEndElementView(const StringView&, const StringView&) {
 	--level_;
 }
 
-void DelayParser::handleCharacterData(const std::string&) {
+void DelayParser::handleCharacterDataView(const StringView&) {
 
 }
 
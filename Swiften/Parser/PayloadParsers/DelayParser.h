@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,15 +8,16 @@
 
 #include <Swiften/Elements/Delay.h>
 #include <Swiften/Parser/GenericPayloadParser.h>
+#include <Swiften/Parser/ViewParser.h>
 
 namespace Swift {
-	class DelayParser : public GenericPayloadParser<Delay> {
+	class DelayParser : public ViewParser<GenericPayloadParser<Delay> > {
 		public:
 			DelayParser();
 
-			virtual void handleStartElement(const std::string& element, const std::string&, const AttributeMap& attributes);
-			virtual void handleEndElement(const std::string& element, const std::string&);
-			virtual void handleCharacterData(const std::string& data);
+			virtual void handleStartElementView(const StringView& element, const StringView&, const AttributeViewList& attributes);
+			virtual void handleEndElementView(const StringView& element, const StringView&);
+			virtual void handleCharacterDataView(const StringView& data);
 
 		private:
 			int level_;
@@ -21,6 +21,11 @@ namespace Swift {
 				return ns == "urn:xmpp:receipts" && element == "request";
 			}
 
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const {
+				elements.push_back(std::make_pair("request", "urn:xmpp:receipts"));
+				return true;
+			}
+
 			virtual PayloadParser* createPayloadParser() {
 				return new DeliveryReceiptRequestParser();
 			}
@@ -22,6 +22,11 @@ namespace Swift {
 				return element == "content" && ns == "urn:xmpp:jingle:1";
 			}
 
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const {
+				elements.push_back(std::make_pair("content", "urn:xmpp:jingle:1"));
+				return true;
+			}
+
 			virtual PayloadParser* createPayloadParser() {
 				return new JingleContentPayloadParser(factories);
 			}
@@ -28,6 +28,11 @@ namespace Swift {
 				return element == "description" && ns == "urn:xmpp:jingle:apps:file-transfer:4";
 			}
 
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const {
+				elements.push_back(std::make_pair("description", "urn:xmpp:jingle:apps:file-transfer:4"));
+				return true;
+			}
+
 			virtual PayloadParser* createPayloadParser() {
 				return new JingleFileTransferDescriptionParser(factories);
 			}
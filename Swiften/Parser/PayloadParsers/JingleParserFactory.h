@@ -22,6 +22,11 @@ namespace Swift {
 				return element == "jingle" && ns == "urn:xmpp:jingle:1";
 			}
 
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const {
+				elements.push_back(std::make_pair("jingle", "urn:xmpp:jingle:1"));
+				return true;
+			}
+
 			virtual PayloadParser* createPayloadParser() {
 				return new JingleParser(factories);
 			}
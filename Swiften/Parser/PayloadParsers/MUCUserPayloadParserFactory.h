@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -19,6 +19,11 @@ namespace Swift {
 				return element == "x" && ns == "http://jabber.org/protocol/muc#user";
 			}
 
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const {
+				elements.push_back(std::make_pair("x", "http://jabber.org/protocol/muc#user"));
+				return true;
+			}
+
 			virtual PayloadParser* createPayloadParser() {
 				return new MUCUserPayloadParser(factories);
 			}
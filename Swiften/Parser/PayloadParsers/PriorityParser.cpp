@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,11 +13,11 @@ namespace Swift {
 PriorityParser::PriorityParser() : level_(0) {
 }
 
-void PriorityParser::handleStartElement(const std::string&, const std::string&, const AttributeMap&) {
+void PriorityParser::handleStartElementView(const StringView&, const StringView&, const AttributeViewList&) {
 	++level_;
 }
 
-void PriorityParser::handleEndElement(const std::string&, const std::string&) {
+void PriorityParser::handleEndElementView(const StringView&, const StringView&) {
 	--level_;
 	if (level_ == 0) {
 		int priority = 0;
@@ -30,8 +30,8 @@ void PriorityParser::handleEndElement(const std::string&, const std::string&) {
 	}
 }
 
-void PriorityParser::handleCharacterData(const std::string& data) {
-	text_ += data;
+void PriorityParser::handleCharacterDataView(const StringView& data) {
+	data.appendTo(text_);
 }
 
 }
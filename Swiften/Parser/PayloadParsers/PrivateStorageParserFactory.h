@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,6 +21,11 @@ namespace Swift {
 				return element == "query" && ns == "jabber:iq:private";
 			}
 
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const {
+				elements.push_back(std::make_pair("query", "jabber:iq:private"));
+				return true;
+			}
+
 			virtual PayloadParser* createPayloadParser() {
 				return new PrivateStorageParser(factories);
 			}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013 Isode Limited.
+ * Copyright (c) 2013-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -20,6 +20,11 @@ namespace Swift {
 				return ns == "http://jabber.org/protocol/pubsub#errors";
 			}
 
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const {
+				elements.push_back(std::make_pair("", "http://jabber.org/protocol/pubsub#errors"));
+				return true;
+			}
+
 			virtual PayloadParser* createPayloadParser() {
 				return new PubSubErrorParser();
 			}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,19 +11,19 @@ namespace Swift {
 StatusParser::StatusParser() : level_(0) {
 }
 
-void StatusParser::handleStartElement(const std::string&, const std::string&, const AttributeMap&) {
+void StatusParser::handleStartElementView(const StringView&, const StringView&, const AttributeViewList&) {
 	++level_;
 }
 
-void StatusParser::handleEndElement(const std::string&, const std::string&) {
+void StatusParser::handleEndElementView(const StringView&, const StringView&) {
 	--level_;
 	if (level_ == 0) {
 		getPayloadInternal()->setText(text_);
 	}
 }
 
-void StatusParser::handleCharacterData(const std::string& data) {
-	text_ += data;
+void StatusParser::handleCharacterDataView(const StringView& data) {
+	data.appendTo(text_);
 }
 
 }
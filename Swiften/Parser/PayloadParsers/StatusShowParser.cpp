@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,11 +11,11 @@ namespace Swift {
 StatusShowParser::StatusShowParser() : level_(0) {
 }
 
-void StatusShowParser::handleStartElement(const std::string&, const std::string&, const AttributeMap&) {
+void StatusShowParser::handleStartElementView(const StringView&, const StringView&, const AttributeViewList&) {
 	++level_;
 }
 
-void StatusShowParser::handleEndElement(const std::string&, const std::string&) {
+void StatusShowParser::handleEndElementView(const StringView&, const StringView&) {
 	--level_;
 	if (level_ == 0) {
 		if (text_ == "away") {
@@ -36,8 +36,8 @@ void StatusShowParser::handleEndElement(const std::string&, const std::string&)
 	}
 }
 
-void StatusShowParser::handleCharacterData(const std::string& data) {
-	text_ += data;
+void StatusShowParser::handleCharacterDataView(const StringView& data) {
+	data.appendTo(text_);
 }
 
 }
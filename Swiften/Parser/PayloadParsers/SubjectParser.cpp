@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,20 +11,20 @@ namespace Swift {
 SubjectParser::SubjectParser() : level_(0) {
 }
 
-void SubjectParser::handleStartElement(const std::string&, const std::string&, const AttributeMap&) {
+void SubjectParser::handleStartElementView(const StringView&, const StringView&, const AttributeViewList&) {
 	++level_;
 }
 
-void SubjectParser::handleEndElement(const std::string&, const std::string&) {
+void SubjectParser::handleEndElementView(const StringView&, const StringView&) {
 	--level_;
 	if (level_ == 0) {
 		getPayloadInternal()->setText(text_);
 	}
 }
 
-void SubjectParser::handleCharacterData(const std::string& data) {
+void SubjectParser::handleCharacterDataView(const StringView& data) {
 	if (level_ == 1) { 
-		text_ += data;
+		data.appendTo(text_);
 	}
 }
 
@@ -16,23 +16,23 @@ ThreadParser::ThreadParser() : level_(0) {
 ThreadParser::~ThreadParser() {
 }
 
-void ThreadParser::handleStartElement(const std::string& element, const std::string&, const AttributeMap& attributes) {
+void ThreadParser::handleStartElementView(const StringView& element, const StringView&, const AttributeViewList& attributes) {
 	++level_;
 	if (element == "thread") {
-		getPayloadInternal()->setParent(attributes.getAttributeValue("parent").get_value_or(""));
+		getPayloadInternal()->setParent(attributes.getAttributeValue("parent").get_value_or("").toString());
 	}
 }
 
-void ThreadParser::handleEndElement(const std::string&, const std::string&) {
+void ThreadParser::handleEndElementView(const StringView&, const StringView&) {
 	--level_;
 	if (level_ == 0) {
 		getPayloadInternal()->setText(text_);
 	}
 }
 
-void ThreadParser::handleCharacterData(const std::string& data) {
+void ThreadParser::handleCharacterDataView(const StringView& data) {
 	if (level_ == 1) {
-		text_ += data;
+		data.appendTo(text_);
 	}
 }
 
@@ -9,16 +9,17 @@
 #include <Swiften/Base/API.h>
 #include <Swiften/Elements/Thread.h>
 #include <Swiften/Parser/GenericPayloadParser.h>
+#include <Swiften/Parser/ViewParser.h>
 
 namespace Swift {
-	class SWIFTEN_API ThreadParser : public GenericPayloadParser<Thread> {
+	class SWIFTEN_API ThreadParser : public ViewParser<GenericPayloadParser<Thread> > {
 		public:
 			ThreadParser();
 			virtual ~ThreadParser();
 
-			virtual void handleStartElement(const std::string& element, const std::string&, const AttributeMap& attributes);
-			virtual void handleEndElement(const std::string& element, const std::string&);
-			virtual void handleCharacterData(const std::string& data);
+			virtual void handleStartElementView(const StringView& element, const StringView&, const AttributeViewList& attributes);
+			virtual void handleEndElementView(const StringView& element, const StringView&);
+			virtual void handleCharacterDataView(const StringView& data);
 
 		private:
 			int level_;
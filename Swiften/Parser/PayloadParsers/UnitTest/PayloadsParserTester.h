@@ -9,12 +9,13 @@
 #include <Swiften/Parser/PayloadParsers/FullPayloadParserFactoryCollection.h>
 #include <Swiften/Parser/XMLParser.h>
 #include <Swiften/Parser/XMLParserClient.h>
+#include <Swiften/Parser/ViewParser.h>
 #include <Swiften/Parser/PlatformXMLParserFactory.h>
 #include <Swiften/Elements/Payload.h>
 #include <Swiften/Parser/PayloadParser.h>
 
 namespace Swift {
-	class PayloadsParserTester : public XMLParserClient {
+	class PayloadsParserTester : public ViewParser<XMLParserClient> {
 		public:
 			PayloadsParserTester() : level(0) {
 				xmlParser = PlatformXMLParserFactory().createXMLParser(this);
@@ -28,24 +29,24 @@ namespace Swift {
 				return xmlParser->parse(data);
 			}
 
-			virtual void handleStartElement(const std::string& element, const std::string& ns, const AttributeMap& attributes) {
+			virtual void handleStartElementView(const StringView& element, const StringView& ns, const AttributeViewList& attributes) {
 				if (level == 0) {
 					assert(!payloadParser.get());
 					PayloadParserFactory* payloadParserFactory = factories.getPayloadParserFactory(element, ns, attributes);
 					assert(payloadParserFactory);
 					payloadParser.reset(payloadParserFactory->createPayloadParser());
 				}
-				payloadParser->handleStartElement(element, ns, attributes);
+				payloadParser->handleStartElementView(element, ns, attributes);
 				level++;
 			}
 
-			virtual void handleEndElement(const std::string& element, const std::string& ns) {
+			virtual void handleEndElementView(const StringView& element, const StringView& ns) {
 				level--;
-				payloadParser->handleEndElement(element, ns);
+				payloadParser->handleEndElementView(element, ns);
 			}
 
-			virtual void handleCharacterData(const std::string& data) {
-				payloadParser->handleCharacterData(data);
+			virtual void handleCharacterDataView(const StringView& data) {
+				payloadParser->handleCharacterDataView(data);
 			}
 
 			boost::shared_ptr<Payload> getPayload() const {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -15,8 +15,8 @@ PresenceParser::PresenceParser(PayloadParserFactoryCollection* factories) :
 		GenericStanzaParser<Presence>(factories) {
 }
 
-void PresenceParser::handleStanzaAttributes(const AttributeMap& attributes) {
-	boost::optional<std::string> type = attributes.getAttributeValue("type");
+void PresenceParser::handleStanzaAttributes(const AttributeViewList& attributes) {
+	boost::optional<StringView> type = attributes.getAttributeValue("type");
 	if (type) {
 		if (*type == "unavailable") {
 			getStanzaGeneric()->setType(Presence::Unavailable);
@@ -40,7 +40,7 @@ void PresenceParser::handleStanzaAttributes(const AttributeMap& attributes) {
 			getStanzaGeneric()->setType(Presence::Error);
 		}
 		else {
-			std::cerr << "Unknown Presence type: " << *type << std::endl;
+			std::cerr << "Unknown Presence type: " << type->toString() << std::endl;
 			getStanzaGeneric()->setType(Presence::Available);
 		}
 	}
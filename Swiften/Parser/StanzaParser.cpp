@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -24,7 +24,7 @@ StanzaParser::StanzaParser(PayloadParserFactoryCollection* factories) :
 StanzaParser::~StanzaParser() {
 }
 
-void StanzaParser::handleStartElement(const std::string& element, const std::string& ns, const AttributeMap& attributes) {
+void StanzaParser::handleStartElementView(const StringView& element, const StringView& ns, const AttributeViewList& attributes) {
 	if (inStanza()) {
 		if (!inPayload()) {
 			assert(!currentPayloadParser_);
@@ -37,31 +37,31 @@ void StanzaParser::handleStartElement(const std::string& element, const std::str
 			}
 		}
 		assert(currentPayloadParser_);
-		currentPayloadParser_->handleStartElement(element, ns, attributes);
+		currentPayloadParser_->handleStartElementView(element, ns, attributes);
 	}
 	else {
-		boost::optional<std::string> from = attributes.getAttributeValue("from");
+		boost::optional<StringView> from = attributes.getAttributeValue("from");
 		if (from) {
-			getStanza()->setFrom(JID(*from));
+			getStanza()->setFrom(JID(from->toString()));
 		}
-		boost::optional<std::string> to = attributes.getAttributeValue("to");
+		boost::optional<StringView> to = attributes.getAttributeValue("to");
 		if (to) {
-			getStanza()->setTo(JID(*to));
+			getStanza()->setTo(JID(to->toString()));
 		}
-		boost::optional<std::string> id = attributes.getAttributeValue("id");
+		boost::optional<StringView> id = attributes.getAttributeValue("id");
 		if (id) {
-			getStanza()->setID(*id);
+			getStanza()->setID(id->toString());
 		}
 		handleStanzaAttributes(attributes);
 	}
 	++currentDepth_;
 }
 
-void StanzaParser::handleEndElement(const std::string& element, const std::string& ns) {
+void StanzaParser::handleEndElementView(const StringView& element, const StringView& ns) {
 	assert(inStanza());
 	if (inPayload()) {
 		assert(currentPayloadParser_);
-		currentPayloadParser_->handleEndElement(element, ns);
+		currentPayloadParser_->handleEndElementView(element, ns);
 		--currentDepth_;
 		if (!inPayload()) {
 			boost::shared_ptr<Payload> payload(currentPayloadParser_->getPayload());
@@ -76,9 +76,9 @@ void StanzaParser::handleEndElement(const std::string& element, const std::strin
 	}
 }
 
-void StanzaParser::handleCharacterData(const std::string& data) {
+void StanzaParser::handleCharacterDataView(const StringView& data) {
 	if (currentPayloadParser_) {
-		currentPayloadParser_->handleCharacterData(data);
+		currentPayloadParser_->handleCharacterDataView(data);
 	}
 }
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,23 +13,24 @@
 #include <string>
 #include <Swiften/Elements/Stanza.h>
 #include <Swiften/Parser/ElementParser.h>
+#include <Swiften/Parser/ViewParser.h>
 #include <Swiften/Parser/AttributeMap.h>
 
 namespace Swift {
 	class PayloadParser;
 	class PayloadParserFactoryCollection;
 
-	class SWIFTEN_API StanzaParser : public ElementParser, public boost::noncopyable {
+	class SWIFTEN_API StanzaParser : public ViewParser<ElementParser>, public boost::noncopyable {
 		public:
 			StanzaParser(PayloadParserFactoryCollection* factories);
 			~StanzaParser();
 
-			void handleStartElement(const std::string& element, const std::string& ns, const AttributeMap& attributes);
-			void handleEndElement(const std::string& element, const std::string& ns);
-			void handleCharacterData(const std::string& data);
+			void handleStartElementView(const StringView& element, const StringView& ns, const AttributeViewList& attributes);
+			void handleEndElementView(const StringView& element, const StringView& ns);
+			void handleCharacterDataView(const StringView& data);
 
 			virtual boost::shared_ptr<ToplevelElement> getElement() const = 0;
-			virtual void handleStanzaAttributes(const AttributeMap&) {}
+			virtual void handleStanzaAttributes(const AttributeViewList&) {}
 
 			virtual boost::shared_ptr<Stanza> getStanza() const {
 				return boost::dynamic_pointer_cast<Stanza>(getElement());
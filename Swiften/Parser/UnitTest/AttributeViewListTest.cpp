@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/optional.hpp>
+
+#include <Swiften/Parser/AttributeViewList.h>
+
+using namespace Swift;
+
+class AttributeViewListTest : public CppUnit::TestFixture
+{
+		CPPUNIT_TEST_SUITE(AttributeViewListTest);
+		CPPUNIT_TEST(testGetAttribute_Namespaced);
+		CPPUNIT_TEST(testGetAttribute_Unknown);
+		CPPUNIT_TEST(testGetAttributeValue);
+		CPPUNIT_TEST(testGetBoolAttribute);
+		CPPUNIT_TEST(testBuffer_ManyAttributes);
+		CPPUNIT_TEST(testToAttributeMap);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void testGetAttribute_Namespaced() {
+			AttributeViewBuffer buffer;
+			buffer.add(AttributeView("lang", "", "nl"));
+			buffer.add(AttributeView("lang", "http://www.w3.org/XML/1998/namespace", "en"));
+			buffer.add(AttributeView("lang", "", "fr"));
+
+			CPPUNIT_ASSERT_EQUAL(std::string("en"), buffer.getList().getAttribute("lang", "http://www.w3.org/XML/1998/namespace").toString());
+			CPPUNIT_ASSERT_EQUAL(std::string("nl"), buffer.getList().getAttribute("lang").toString());
+		}
+
+		void testGetAttribute_Unknown() {
+			AttributeViewBuffer buffer;
+			buffer.add(AttributeView("foo", "", "bar"));
+
+			CPPUNIT_ASSERT(buffer.getList().getAttribute("bar").empty());
+		}
+
+		void testGetAttributeValue() {
+			AttributeViewBuffer buffer;
+			buffer.add(AttributeView("foo", "", ""));
+
+			CPPUNIT_ASSERT(buffer.getList().getAttributeValue("foo"));
+			CPPUNIT_ASSERT(buffer.getList().getAttributeValue("foo")->empty());
+			CPPUNIT_ASSERT(!buffer.getList().getAttributeValue("bar"));
+		}
+
+		void testGetBoolAttribute() {
+			AttributeViewBuffer buffer;
+			buffer.add(AttributeView("foo", "", "true"));
+			buffer.add(AttributeView("bar", "", "0"));
+
+			CPPUNIT_ASSERT(buffer.getList().getBoolAttribute("foo"));
+			CPPUNIT_ASSERT(!buffer.getList().getBoolAttribute("bar", true));
+			CPPUNIT_ASSERT(buffer.getList().getBoolAttribute("baz", true));
+		}
+
+		void testBuffer_ManyAttributes() {
+			std::vector<std::string> names;
+			for (int i = 0; i < 20; ++i) {
+				names.push_back(std::string(1, static_cast<char>('a' + i)));
+			}
+			AttributeViewBuffer buffer;
+			for (size_t i = 0; i < names.size(); ++i) {
+				buffer.add(AttributeView(names[i], "", names[i]));
+			}
+
+			AttributeViewList list = buffer.getList();
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(20), list.size());
+			CPPUNIT_ASSERT_EQUAL(std::string("a"), list[0].value.toString());
+			CPPUNIT_ASSERT_EQUAL(std::string("t"), list.getAttribute("t").toString());
+		}
+
+		void testToAttributeMap() {
+			AttributeMap attributes;
+			attributes.addAttribute("foo", "", "bar");
+			attributes.addAttribute("lang", "http://www.w3.org/XML/1998/namespace", "en");
+			AttributeViewBuffer buffer(attributes);
+
+			AttributeMap result = buffer.getList().toAttributeMap();
+
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), result.getEntries().size());
+			CPPUNIT_ASSERT_EQUAL(std::string("bar"), result.getAttribute("foo"));
+			CPPUNIT_ASSERT_EQUAL(std::string("en"), result.getAttribute("lang", "http://www.w3.org/XML/1998/namespace"));
+		}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AttributeViewListTest);
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <Swiften/Base/Arena.h>
+#include <Swiften/Parser/ParserArena.h>
+#include <Swiften/Parser/PayloadParsers/BodyParser.h>
+
+using namespace Swift;
+
+class ParserArenaTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(ParserArenaTest);
+		CPPUNIT_TEST(testAllocate_WithoutScope);
+		CPPUNIT_TEST(testAllocate_InScope);
+		CPPUNIT_TEST(testAllocate_Aligned);
+		CPPUNIT_TEST(testNewParser_InScope);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void testAllocate_WithoutScope() {
+			void* p = ParserArena::allocate(32);
+
+			CPPUNIT_ASSERT(p);
+
+			ParserArena::deallocate(p);
+			ParserArena::deallocate(NULL);
+		}
+
+		void testAllocate_InScope() {
+			boost::shared_ptr<Arena> arena = boost::make_shared<Arena>(1024);
+			boost::weak_ptr<Arena> weakArena(arena);
+			void* p;
+			{
+				ParserArena::Scope scope(arena);
+				p = ParserArena::allocate(32);
+			}
+			arena.reset();
+
+			CPPUNIT_ASSERT(!weakArena.expired());
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1024), weakArena.lock()->getCapacity());
+
+			ParserArena::deallocate(p);
+
+			CPPUNIT_ASSERT(weakArena.expired());
+		}
+
+		void testAllocate_Aligned() {
+			boost::shared_ptr<Arena> arena = boost::make_shared<Arena>();
+			ParserArena::Scope scope(arena);
+
+			void* p = ParserArena::allocate(sizeof(double));
+
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), reinterpret_cast<size_t>(p) % sizeof(double));
+			ParserArena::deallocate(p);
+		}
+
+		void testNewParser_InScope() {
+			boost::shared_ptr<Arena> arena = boost::make_shared<Arena>();
+			boost::weak_ptr<Arena> weakArena(arena);
+			PayloadParser* parser;
+			{
+				ParserArena::Scope scope(arena);
+				parser = new BodyParser();
+			}
+			arena.reset();
+
+			CPPUNIT_ASSERT(!weakArena.expired());
+
+			delete parser;
+
+			CPPUNIT_ASSERT(weakArena.expired());
+		}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ParserArenaTest);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -20,6 +20,13 @@ class PayloadParserFactoryCollectionTest : public CppUnit::TestFixture
 		CPPUNIT_TEST(testGetPayloadParserFactory_TwoMatchingFactories);
 		CPPUNIT_TEST(testGetPayloadParserFactory_MatchWithDefaultFactory);
 		CPPUNIT_TEST(testGetPayloadParserFactory_NoMatchWithDefaultFactory);
+		CPPUNIT_TEST(testGetPayloadParserFactory_IndexedFactory);
+		CPPUNIT_TEST(testGetPayloadParserFactory_IndexedFactoryAnyNamespace);
+		CPPUNIT_TEST(testGetPayloadParserFactory_IndexedFactoryAnyElement);
+		CPPUNIT_TEST(testGetPayloadParserFactory_IndexedFactoryAddedAfterUnindexedFactory);
+		CPPUNIT_TEST(testGetPayloadParserFactory_UnindexedFactoryAddedAfterIndexedFactory);
+		CPPUNIT_TEST(testGetPayloadParserFactory_Views);
+		CPPUNIT_TEST(testRemoveFactory_IndexedFactory);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -87,8 +94,93 @@ class PayloadParserFactoryCollectionTest : public CppUnit::TestFixture
 
 			CPPUNIT_ASSERT(factory == &factory2);
 		}
-	
-	
+
+		void testGetPayloadParserFactory_IndexedFactory() {
+			PayloadParserFactoryCollection testling;
+			IndexedDummyFactory factory1("foo", "ns1");
+			testling.addFactory(&factory1);
+			IndexedDummyFactory factory2("foo", "ns2");
+			testling.addFactory(&factory2);
+
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "ns1", AttributeMap()) == &factory1);
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "ns2", AttributeMap()) == &factory2);
+			CPPUNIT_ASSERT(!testling.getPayloadParserFactory("foo", "ns3", AttributeMap()));
+			CPPUNIT_ASSERT(!testling.getPayloadParserFactory("bar", "ns1", AttributeMap()));
+		}
+
+		void testGetPayloadParserFactory_IndexedFactoryAnyNamespace() {
+			PayloadParserFactoryCollection testling;
+			IndexedDummyFactory factory1("foo", "ns1");
+			testling.addFactory(&factory1);
+			IndexedDummyFactory factory2("foo", "");
+			testling.addFactory(&factory2);
+
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "ns1", AttributeMap()) == &factory2);
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "ns2", AttributeMap()) == &factory2);
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "", AttributeMap()) == &factory2);
+		}
+
+		void testGetPayloadParserFactory_IndexedFactoryAnyElement() {
+			PayloadParserFactoryCollection testling;
+			IndexedDummyFactory factory1("", "ns1");
+			testling.addFactory(&factory1);
+			IndexedDummyFactory factory2("foo", "ns1");
+			testling.addFactory(&factory2);
+
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "ns1", AttributeMap()) == &factory2);
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("bar", "ns1", AttributeMap()) == &factory1);
+			CPPUNIT_ASSERT(!testling.getPayloadParserFactory("bar", "ns2", AttributeMap()));
+		}
+
+		void testGetPayloadParserFactory_IndexedFactoryAddedAfterUnindexedFactory() {
+			PayloadParserFactoryCollection testling;
+			DummyFactory factory1("foo");
+			testling.addFactory(&factory1);
+			IndexedDummyFactory factory2("foo", "ns1");
+			testling.addFactory(&factory2);
+
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "ns1", AttributeMap()) == &factory2);
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "ns2", AttributeMap()) == &factory1);
+		}
+
+		void testGetPayloadParserFactory_UnindexedFactoryAddedAfterIndexedFactory() {
+			PayloadParserFactoryCollection testling;
+			IndexedDummyFactory factory1("foo", "ns1");
+			testling.addFactory(&factory1);
+			DummyFactory factory2("foo");
+			testling.addFactory(&factory2);
+
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "ns1", AttributeMap()) == &factory2);
+		}
+
+		void testGetPayloadParserFactory_Views() {
+			PayloadParserFactoryCollection testling;
+			DummyFactory factory1("foo");
+			testling.addFactory(&factory1);
+			IndexedDummyFactory factory2("bar", "ns1");
+			testling.addFactory(&factory2);
+
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory(StringView("foo"), StringView("ns1"), AttributeViewList()) == &factory1);
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory(StringView("bar"), StringView("ns1"), AttributeViewList()) == &factory2);
+			CPPUNIT_ASSERT(!testling.getPayloadParserFactory(StringView("baz"), StringView("ns1"), AttributeViewList()));
+		}
+
+		void testRemoveFactory_IndexedFactory() {
+			PayloadParserFactoryCollection testling;
+			IndexedDummyFactory factory1("foo", "ns1");
+			testling.addFactory(&factory1);
+			IndexedDummyFactory factory2("foo", "ns1");
+			testling.addFactory(&factory2);
+
+			testling.removeFactory(&factory2);
+
+			CPPUNIT_ASSERT(testling.getPayloadParserFactory("foo", "ns1", AttributeMap()) == &factory1);
+
+			testling.removeFactory(&factory1);
+
+			CPPUNIT_ASSERT(!testling.getPayloadParserFactory("foo", "ns1", AttributeMap()));
+		}
+
 	private:
 		struct DummyFactory : public PayloadParserFactory {
 			DummyFactory(const std::string& element = "") : element(element) {}
@@ -98,6 +190,20 @@ class PayloadParserFactoryCollectionTest : public CppUnit::TestFixture
 			virtual PayloadParser* createPayloadParser() { return NULL; }
 			std::string element;
 		};
+
+		struct IndexedDummyFactory : public PayloadParserFactory {
+			IndexedDummyFactory(const std::string& element, const std::string& ns) : element(element), ns(ns) {}
+			virtual bool canParse(const std::string& e, const std::string& n, const AttributeMap&) const {
+				return (element.empty() || element == e) && (ns.empty() || ns == n);
+			}
+			virtual bool getSupportedElements(std::vector<std::pair<std::string, std::string> >& elements) const {
+				elements.push_back(std::make_pair(element, ns));
+				return true;
+			}
+			virtual PayloadParser* createPayloadParser() { return NULL; }
+			std::string element;
+			std::string ns;
+		};
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PayloadParserFactoryCollectionTest);
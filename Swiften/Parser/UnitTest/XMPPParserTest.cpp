@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,15 +11,18 @@
 #include <Swiften/Elements/ProtocolHeader.h>
 #include <string>
 #include <Swiften/Parser/XMPPParser.h>
+#include <Swiften/Parser/ParserArena.h>
 #include <Swiften/Parser/ElementParser.h>
 #include <Swiften/Parser/XMPPParserClient.h>
 #include <Swiften/Parser/PayloadParserFactoryCollection.h>
 #include <Swiften/Parser/PlatformXMLParserFactory.h>
+#include <Swiften/Parser/PayloadParsers/FullPayloadParserFactoryCollection.h>
 #include <Swiften/Elements/Presence.h>
 #include <Swiften/Elements/IQ.h>
 #include <Swiften/Elements/Message.h>
 #include <Swiften/Elements/StreamFeatures.h>
 #include <Swiften/Elements/UnknownElement.h>
+#include <Swiften/Elements/Body.h>
 
 using namespace Swift;
 
@@ -35,6 +38,7 @@ class XMPPParserTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testParse_StrayCharacterData);
 		CPPUNIT_TEST(testParse_InvalidStreamStart);
 		CPPUNIT_TEST(testParse_ElementEndAfterInvalidStreamStart);
+		CPPUNIT_TEST(testParse_WithArenas);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -157,6 +161,27 @@ class XMPPParserTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT(!testling.parse("<tream/>"));
 		}
 
+		void testParse_WithArenas() {
+			FullPayloadParserFactoryCollection factories;
+			boost::shared_ptr<XMPPParser> testling(new XMPPParser(&client_, &factories, &xmlParserFactory_));
+			testling->setUseArenas(true);
+
+			CPPUNIT_ASSERT(testling->parse("<stream:stream xmlns:stream='http://etherx.jabber.org/streams'>"));
+			CPPUNIT_ASSERT(testling->parse("<message from='foo@bar.com/baz'><body>Hello</body></message>"));
+			CPPUNIT_ASSERT(testling->parse("<message><body>World</body></message>"));
+			testling.reset();
+
+			CPPUNIT_ASSERT_EQUAL(3, static_cast<int>(client_.events.size()));
+			boost::shared_ptr<Message> message = boost::dynamic_pointer_cast<Message>(client_.events[1].element);
+			CPPUNIT_ASSERT(message);
+			CPPUNIT_ASSERT_EQUAL(JID("foo@bar.com/baz"), message->getFrom());
+			CPPUNIT_ASSERT_EQUAL(std::string("Hello"), message->getPayload<Body>()->getText());
+			message = boost::dynamic_pointer_cast<Message>(client_.events[2].element);
+			CPPUNIT_ASSERT(message);
+			CPPUNIT_ASSERT_EQUAL(std::string("World"), message->getPayload<Body>()->getText());
+			CPPUNIT_ASSERT(!ParserArena::getCurrentArena());
+		}
+
 	private:
 		class Client : public XMPPParserClient {
 			public:
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <Swiften/Base/StringView.h>
+#include <Swiften/Parser/AttributeMap.h>
+#include <Swiften/Parser/AttributeViewList.h>
+
+namespace Swift {
+	/**
+	 * Base for parsers that only handle the zero-copy view callbacks of
+	 * PARSER_TYPE (an XMLParserClient, ElementParser, or PayloadParser).
+	 *
+	 * The owning callbacks are implemented by passing views of their
+	 * arguments on to the view callbacks, which subclasses have to
+	 * implement.
+	 */
+	template<typename PARSER_TYPE>
+	class ViewParser : public PARSER_TYPE {
+		public:
+			virtual void handleStartElement(const std::string& element, const std::string& ns, const AttributeMap& attributes) {
+				AttributeViewBuffer attributeViews(attributes);
+				this->handleStartElementView(element, ns, attributeViews.getList());
+			}
+
+			virtual void handleEndElement(const std::string& element, const std::string& ns) {
+				this->handleEndElementView(element, ns);
+			}
+
+			virtual void handleCharacterData(const std::string& data) {
+				this->handleCharacterDataView(data);
+			}
+
+			virtual void handleStartElementView(const StringView& element, const StringView& ns, const AttributeViewList& attributes) = 0;
+			virtual void handleEndElementView(const StringView& element, const StringView& ns) = 0;
+			virtual void handleCharacterDataView(const StringView& data) = 0;
+	};
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,7 +7,9 @@
 #pragma once
 
 #include <Swiften/Base/API.h>
+#include <Swiften/Base/StringView.h>
 #include <Swiften/Parser/AttributeMap.h>
+#include <Swiften/Parser/AttributeViewList.h>
 
 namespace Swift {
 	class SWIFTEN_API XMLParserClient {
@@ -17,5 +19,17 @@ namespace Swift {
 			virtual void handleStartElement(const std::string& element, const std::string& ns, const AttributeMap& attributes) = 0;
 			virtual void handleEndElement(const std::string& element, const std::string& ns) = 0;
 			virtual void handleCharacterData(const std::string& data) = 0;
+
+			/**
+			 * Zero-copy variants of the callbacks above, which are the ones
+			 * called by the XML parsers.
+			 *
+			 * The views passed to these callbacks are only valid for the duration
+			 * of the call. The default implementations create owning copies, and
+			 * pass them on to the corresponding callback above.
+			 */
+			virtual void handleStartElementView(const StringView& element, const StringView& ns, const AttributeViewList& attributes);
+			virtual void handleEndElementView(const StringView& element, const StringView& ns);
+			virtual void handleCharacterDataView(const StringView& data);
 	};
 }
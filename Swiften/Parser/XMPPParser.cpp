@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -41,12 +41,75 @@
 #include <Swiften/Parser/TLSProceedParser.h>
 #include <Swiften/Parser/ComponentHandshakeParser.h>
 #include <Swiften/Parser/XMLParserFactory.h>
+#include <Swiften/Parser/ElementNameIndex.h>
+#include <Swiften/Parser/ParserArena.h>
 
 // TODO: Whenever an error occurs in the handlers, stop the parser by returing
 // a bool value, and stopping the XML parser
 
 namespace Swift {
 
+namespace {
+	typedef ElementParser* (*ElementParserCreator)(PayloadParserFactoryCollection*);
+
+	template<typename T>
+	ElementParser* createParser(PayloadParserFactoryCollection*) {
+		return new T();
+	}
+
+	template<typename T>
+	ElementParser* createStanzaParser(PayloadParserFactoryCollection* payloadParserFactories) {
+		return new T(payloadParserFactories);
+	}
+
+	/**
+	 * Maps top-level elements onto their parsers. An empty namespace
+	 * matches the element in any namespace.
+	 */
+	class ElementParserCreators {
+		public:
+			ElementParserCreators() {
+				creators_("presence", "") = &createStanzaParser<PresenceParser>;
+				creators_("iq", "") = &createStanzaParser<IQParser>;
+				creators_("message", "") = &createStanzaParser<MessageParser>;
+				creators_("features", "http://etherx.jabber.org/streams") = &createParser<StreamFeaturesParser>;
+				creators_("error", "http://etherx.jabber.org/streams") = &createParser<StreamErrorParser>;
+				creators_("auth", "") = &createParser<AuthRequestParser>;
+				creators_("success", "") = &createParser<AuthSuccessParser>;
+				creators_("failure", "urn:ietf:params:xml:ns:xmpp-sasl") = &createParser<AuthFailureParser>;
+				creators_("challenge", "urn:ietf:params:xml:ns:xmpp-sasl") = &createParser<AuthChallengeParser>;
+				creators_("response", "urn:ietf:params:xml:ns:xmpp-sasl") = &createParser<AuthResponseParser>;
+				creators_("starttls", "") = &createParser<StartTLSParser>;
+				creators_("failure", "urn:ietf:params:xml:ns:xmpp-tls") = &createParser<StartTLSFailureParser>;
+				creators_("compress", "") = &createParser<CompressParser>;
+				creators_("compressed", "") = &createParser<CompressedParser>;
+				creators_("failure", "http://jabber.org/protocol/compress") = &createParser<CompressFailureParser>;
+				creators_("proceed", "") = &createParser<TLSProceedParser>;
+				creators_("enable", "urn:xmpp:sm:2") = &createParser<EnableStreamManagementParser>;
+				creators_("enabled", "urn:xmpp:sm:2") = &createParser<StreamManagementEnabledParser>;
+				creators_("failed", "urn:xmpp:sm:2") = &createParser<StreamManagementFailedParser>;
+				creators_("resume", "urn:xmpp:sm:2") = &createParser<StreamResumeParser>;
+				creators_("resumed", "urn:xmpp:sm:2") = &createParser<StreamResumedParser>;
+				creators_("a", "urn:xmpp:sm:2") = &createParser<StanzaAckParser>;
+				creators_("r", "urn:xmpp:sm:2") = &createParser<StanzaAckRequestParser>;
+				creators_("handshake", "") = &createParser<ComponentHandshakeParser>;
+			}
+
+			ElementParser* create(const StringView& element, const StringView& ns, PayloadParserFactoryCollection* payloadParserFactories) const {
+				const ElementParserCreator* creator = creators_.find(element, ns);
+				if (!creator) {
+					creator = creators_.find(element, StringView());
+				}
+				return creator ? (*creator)(payloadParserFactories) : new UnknownElementParser();
+			}
+
+		private:
+			ElementNameIndex<ElementParserCreator> creators_;
+	};
+
+	const ElementParserCreators elementParserCreators;
+}
+
 XMPPParser::XMPPParser(
 		XMPPParserClient* client, 
 		PayloadParserFactoryCollection* payloadParserFactories,
@@ -56,7 +119,8 @@ XMPPParser::XMPPParser(
 				payloadParserFactories_(payloadParserFactories), 
 				level_(0),
 				currentElementParser_(0),
-				parseErrorOccurred_(false) {
+				parseErrorOccurred_(false),
+				useArenas_(false) {
 	xmlParser_ = xmlParserFactory->createXMLParser(this);
 }
 
@@ -70,15 +134,15 @@ bool XMPPParser::parse(const std::string& data) {
 	return xmlParseResult && !parseErrorOccurred_;
 }
 
-void XMPPParser::handleStartElement(const std::string& element, const std::string& ns, const AttributeMap& attributes) {
+void XMPPParser::handleStartElementView(const StringView& element, const StringView& ns, const AttributeViewList& attributes) {
 	if (!parseErrorOccurred_) {
 		if (level_ == TopLevel) {
 			if (element == "stream" && ns == "http://etherx.jabber.org/streams") {
 				ProtocolHeader header;
-				header.setFrom(attributes.getAttribute("from"));
-				header.setTo(attributes.getAttribute("to"));
-				header.setID(attributes.getAttribute("id"));
-				header.setVersion(attributes.getAttribute("version"));
+				header.setFrom(attributes.getAttribute("from").toString());
+				header.setTo(attributes.getAttribute("to").toString());
+				header.setID(attributes.getAttribute("id").toString());
+				header.setVersion(attributes.getAttribute("version").toString());
 				client_->handleStreamStart(header);
 			}
 			else {
@@ -88,15 +152,21 @@ void XMPPParser::handleStartElement(const std::string& element, const std::strin
 		else {
 			if (level_ == StreamLevel) {
 				assert(!currentElementParser_);
+				if (useArenas_) {
+					currentArena_ = boost::make_shared<Arena>();
+				}
+			}
+			ParserArena::Scope arenaScope(currentArena_);
+			if (level_ == StreamLevel) {
 				currentElementParser_ = createElementParser(element, ns);
 			}
-			currentElementParser_->handleStartElement(element, ns, attributes);
+			currentElementParser_->handleStartElementView(element, ns, attributes);
 		}
 	}
 	++level_;
 }
 
-void XMPPParser::handleEndElement(const std::string& element, const std::string& ns) {
+void XMPPParser::handleEndElementView(const StringView& element, const StringView& ns) {
 	assert(level_ > TopLevel);
 	--level_;
 	if (!parseErrorOccurred_) {
@@ -106,20 +176,25 @@ void XMPPParser::handleEndElement(const std::string& element, const std::string&
 		}
 		else {
 			assert(currentElementParser_);
-			currentElementParser_->handleEndElement(element, ns);
+			{
+				ParserArena::Scope arenaScope(currentArena_);
+				currentElementParser_->handleEndElementView(element, ns);
+			}
 			if (level_ == StreamLevel) {
 				client_->handleElement(currentElementParser_->getElement());
 				delete currentElementParser_;
 				currentElementParser_ = NULL;
+				currentArena_.reset();
 			}
 		}
 	}
 }
 
-void XMPPParser::handleCharacterData(const std::string& data) {
+void XMPPParser::handleCharacterDataView(const StringView& data) {
 	if (!parseErrorOccurred_) {
 		if (currentElementParser_) {
-			currentElementParser_->handleCharacterData(data);
+			ParserArena::Scope arenaScope(currentArena_);
+			currentElementParser_->handleCharacterDataView(data);
 		}
 	//else {
 	//	std::cerr << "XMPPParser: Ignoring stray character data: " << data << std::endl;
@@ -127,80 +202,8 @@ void XMPPParser::handleCharacterData(const std::string& data) {
 	}
 }
 
-ElementParser* XMPPParser::createElementParser(const std::string& element, const std::string& ns) {
-	if (element == "presence") {
-		return new PresenceParser(payloadParserFactories_);
-	}
-	else if (element == "iq") {
-		return new IQParser(payloadParserFactories_);
-	}
-	else if (element == "message") {
-		return new MessageParser(payloadParserFactories_);
-	}
-	else if (element == "features"  && ns == "http://etherx.jabber.org/streams") {
-		return new StreamFeaturesParser();
-	}
-	else if (element == "error" && ns == "http://etherx.jabber.org/streams") {
-		return new StreamErrorParser();
-	}
-	else if (element == "auth") {
-		return new AuthRequestParser();
-	}
-	else if (element == "success") {
-		return new AuthSuccessParser();
-	}
-	else if (element == "failure" && ns == "urn:ietf:params:xml:ns:xmpp-sasl") {
-		return new AuthFailureParser();
-	}
-	else if (element == "challenge" && ns == "urn:ietf:params:xml:ns:xmpp-sasl") {
-		return new AuthChallengeParser();
-	}
-	else if (element == "response" && ns == "urn:ietf:params:xml:ns:xmpp-sasl") {
-		return new AuthResponseParser();
-	}
-	else if (element == "starttls") {
-		return new StartTLSParser();
-	}
-	else if (element == "failure" && ns == "urn:ietf:params:xml:ns:xmpp-tls") {
-		return new StartTLSFailureParser();
-	}
-	else if (element == "compress") {
-		return new CompressParser();
-	}
-	else if (element == "compressed") {
-		return new CompressedParser();
-	}
-	else if (element == "failure" && ns == "http://jabber.org/protocol/compress") {
-		return new CompressFailureParser();
-	}
-	else if (element == "proceed") {
-		return new TLSProceedParser();
-	}
-	else if (element == "enable" && ns == "urn:xmpp:sm:2") {
-		return new EnableStreamManagementParser();
-	}
-	else if (element == "enabled" && ns == "urn:xmpp:sm:2") {
-		return new StreamManagementEnabledParser();
-	}
-	else if (element == "failed" && ns == "urn:xmpp:sm:2") {
-		return new StreamManagementFailedParser();
-	}
-	else if (element == "resume" && ns == "urn:xmpp:sm:2") {
-		return new StreamResumeParser();
-	}
-	else if (element == "resumed" && ns == "urn:xmpp:sm:2") {
-		return new StreamResumedParser();
-	}
-	else if (element == "a" && ns == "urn:xmpp:sm:2") {
-		return new StanzaAckParser();
-	}
-	else if (element == "r" && ns == "urn:xmpp:sm:2") {
-		return new StanzaAckRequestParser();
-	}
-	else if (element == "handshake") {
-		return new ComponentHandshakeParser();
-	}
-	return new UnknownElementParser();
+ElementParser* XMPPParser::createElementParser(const StringView& element, const StringView& ns) {
+	return elementParserCreators.create(element, ns, payloadParserFactories_);
 }
 
 }
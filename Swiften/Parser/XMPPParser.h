@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,6 +11,7 @@
 
 #include <Swiften/Base/API.h>
 #include <Swiften/Parser/XMLParserClient.h>
+#include <Swiften/Parser/ViewParser.h>
 #include <Swiften/Parser/AttributeMap.h>
 
 namespace Swift {
@@ -19,8 +20,9 @@ namespace Swift {
 	class XMLParserFactory;	
 	class ElementParser;
 	class PayloadParserFactoryCollection;
+	class Arena;
 
-	class SWIFTEN_API XMPPParser : public XMLParserClient, boost::noncopyable {
+	class SWIFTEN_API XMPPParser : public ViewParser<XMLParserClient>, boost::noncopyable {
 		public:
 			XMPPParser(
 					XMPPParserClient* parserClient, 
@@ -30,15 +32,24 @@ namespace Swift {
 
 			bool parse(const std::string&);
 
+			/**
+			 * Allocate every parsed top-level element, together with its payloads and
+			 * the parsers creating them, in its own memory arena.
+			 *
+			 * This reduces the number of allocations needed for large elements, at the
+			 * cost of keeping the memory of an element around for as long as any part
+			 * of it is still referenced.
+			 */
+			void setUseArenas(bool b) {
+				useArenas_ = b;
+			}
+
 		private:
-			virtual void handleStartElement(
-					const std::string& element, 
-					const std::string& ns, 
-					const AttributeMap& attributes);
-			virtual void handleEndElement(const std::string& element, const std::string& ns);
-			virtual void handleCharacterData(const std::string& data);
+			virtual void handleStartElementView(const StringView& element, const StringView& ns, const AttributeViewList& attributes);
+			virtual void handleEndElementView(const StringView& element, const StringView& ns);
+			virtual void handleCharacterDataView(const StringView& data);
 
-			ElementParser* createElementParser(const std::string& element, const std::string& xmlns);
+			ElementParser* createElementParser(const StringView& element, const StringView& xmlns);
 
 		private:
 			XMLParser* xmlParser_;
@@ -52,5 +63,7 @@ namespace Swift {
 			int level_;
 			ElementParser* currentElementParser_;
 			bool parseErrorOccurred_;
+			bool useArenas_;
+			boost::shared_ptr<Arena> currentArena_;
 	};
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -24,7 +24,8 @@ PresenceOracle::~PresenceOracle() {
 }
 
 void PresenceOracle::handleStanzaChannelAvailableChanged(bool available) {
-	if (available) {
+	// A resumed stream keeps the presence of the previous one
+	if (available && !stanzaChannel_->isStreamResumed()) {
 		entries_.clear();
 	}
 }
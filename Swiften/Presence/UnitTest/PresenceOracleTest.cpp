@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -21,6 +21,7 @@ class PresenceOracleTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testReceivePresenceFromDifferentResources);
 		CPPUNIT_TEST(testSubscriptionRequest);
 		CPPUNIT_TEST(testReconnectResetsPresences);
+		CPPUNIT_TEST(testResumeKeepsPresences);
 		CPPUNIT_TEST(testHighestPresenceSingle);
 		CPPUNIT_TEST(testHighestPresenceMultiple);
 		CPPUNIT_TEST(testHighestPresenceGlobal);
@@ -145,6 +146,15 @@ class PresenceOracleTest : public CppUnit::TestFixture {
 
 			CPPUNIT_ASSERT(!oracle_->getLastPresence(user1));
 		}
+
+		void testResumeKeepsPresences() {
+			boost::shared_ptr<Presence> sentPresence(createPresence(user1));
+			stanzaChannel_->onPresenceReceived(sentPresence);
+			stanzaChannel_->setAvailable(false);
+			stanzaChannel_->setAvailable(true, true);
+
+			CPPUNIT_ASSERT_EQUAL(sentPresence, oracle_->getLastPresence(user1));
+		}
 	
 	private:
 		Presence::ref makeOnline(const std::string& resource, int priority) {
@@ -13,6 +13,7 @@
 #include <Swiften/Base/Algorithm.h>
 #include <Swiften/Base/sleep.h>
 #include <Swiften/Network/BoostConnection.h>
+#include <Swiften/Network/BoostConnectionServer.h>
 #include <Swiften/Network/HostAddress.h>
 #include <Swiften/Network/HostAddressPort.h>
 #include <Swiften/Network/BoostIOServiceThread.h>
@@ -28,6 +29,8 @@ class BoostConnectionTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testDestructor_PendingEvents);
 		CPPUNIT_TEST(testWrite);
 		CPPUNIT_TEST(testWriteMultipleSimultaniouslyQueuesWrites);
+		CPPUNIT_TEST(testWrite_Loopback);
+		CPPUNIT_TEST(testWriteShared_Loopback);
 #ifdef TEST_IPV6
 		CPPUNIT_TEST(testWrite_IPv6);
 #endif
@@ -129,6 +132,79 @@ class BoostConnectionTest : public CppUnit::TestFixture {
 			}
 		}
 
+		void testWrite_Loopback() {
+			BoostConnectionServer::ref server(BoostConnectionServer::create(HostAddress("127.0.0.1"), 9998, boostIOServiceThread_->getIOService(), eventLoop_));
+			server->onNewConnection.connect(boost::bind(&BoostConnectionTest::handleNewConnection, this, _1));
+			server->start();
+
+			BoostConnection::ref testling(BoostConnection::create(boostIOServiceThread_->getIOService(), eventLoop_));
+			testling->onConnectFinished.connect(boost::bind(&BoostConnectionTest::handleConnectFinished, this));
+			testling->connect(HostAddressPort(HostAddress("127.0.0.1"), 9998));
+			while (!connectFinished) {
+				Swift::sleep(10);
+				eventLoop_->processEvents();
+			}
+
+			// Write a lot of small chunks, so writes get batched
+			SafeByteArray expectedData;
+			for (int i = 0; i < 10000; ++i) {
+				SafeByteArray chunk(100, static_cast<unsigned char>('a' + i % 26));
+				append(expectedData, chunk);
+				testling->write(chunk);
+			}
+			for (int i = 0; i < 1000 && receivedData.size() < expectedData.size(); ++i) {
+				Swift::sleep(10);
+				eventLoop_->processEvents();
+			}
+
+			CPPUNIT_ASSERT(ByteArray(expectedData.begin(), expectedData.end()) == receivedData);
+
+			testling->disconnect();
+			serverConnection->disconnect();
+			server->stop();
+			serverConnection.reset();
+		}
+
+		void testWriteShared_Loopback() {
+			BoostConnectionServer::ref server(BoostConnectionServer::create(HostAddress("127.0.0.1"), 9997, boostIOServiceThread_->getIOService(), eventLoop_));
+			server->onNewConnection.connect(boost::bind(&BoostConnectionTest::handleNewConnection, this, _1));
+			server->start();
+
+			BoostConnection::ref testling(BoostConnection::create(boostIOServiceThread_->getIOService(), eventLoop_));
+			testling->onConnectFinished.connect(boost::bind(&BoostConnectionTest::handleConnectFinished, this));
+			testling->connect(HostAddressPort(HostAddress("127.0.0.1"), 9997));
+			while (!connectFinished) {
+				Swift::sleep(10);
+				eventLoop_->processEvents();
+			}
+
+			// Interleave large shared chunks with regular writes
+			ByteArray expectedData;
+			for (int i = 0; i < 16; ++i) {
+				boost::shared_ptr<ByteArray> chunk = boost::make_shared<ByteArray>(131072, static_cast<unsigned char>('a' + i));
+				append(expectedData, *chunk);
+				testling->writeShared(chunk);
+				append(expectedData, createByteArray("-"));
+				testling->write(createSafeByteArray("-"));
+			}
+			for (int i = 0; i < 1000 && receivedData.size() < expectedData.size(); ++i) {
+				Swift::sleep(10);
+				eventLoop_->processEvents();
+			}
+
+			CPPUNIT_ASSERT(expectedData == receivedData);
+
+			testling->disconnect();
+			serverConnection->disconnect();
+			server->stop();
+			serverConnection.reset();
+		}
+
+		void handleNewConnection(boost::shared_ptr<Connection> connection) {
+			serverConnection = connection;
+			serverConnection->onDataRead.connect(boost::bind(&BoostConnectionTest::handleDataRead, this, _1));
+		}
+
 		void doWrite(BoostConnection* connection) {
 			connection->write(createSafeByteArray("<stream:stream>"));
 			connection->write(createSafeByteArray("\r\n\r\n")); // Temporarily, while we don't have an xmpp server running on ipv6
@@ -151,6 +227,7 @@ class BoostConnectionTest : public CppUnit::TestFixture {
 		boost::shared_ptr<boost::asio::io_service> boostIOService;
 		DummyEventLoop* eventLoop_;
 		ByteArray receivedData;
+		boost::shared_ptr<Connection> serverConnection;
 		bool disconnected;
 		bool connectFinished;
 };
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <Swiften/Base/sleep.h>
+#include <Swiften/Network/BoostIOServicePool.h>
+#include <Swiften/Network/NetworkFactories.h>
+#include <Swiften/Network/TimerFactory.h>
+#include <Swiften/Network/Timer.h>
+
+using namespace Swift;
+
+class BoostIOServicePoolTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(BoostIOServicePoolTest);
+		CPPUNIT_TEST(testGetNextShard);
+		CPPUNIT_TEST(testPost_RunsOnShardThread);
+		CPPUNIT_TEST(testTimer_FiresOnShardThread);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void testGetNextShard() {
+			BoostIOServicePool testling(2);
+
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), testling.getShardCount());
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), testling.getNextShard());
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), testling.getNextShard());
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), testling.getNextShard());
+		}
+
+		void testPost_RunsOnShardThread() {
+			BoostIOServicePool testling(2);
+
+			testling.post(0, boost::bind(&BoostIOServicePoolTest::recordThread, this));
+			testling.post(1, boost::bind(&BoostIOServicePoolTest::recordThread, this));
+			waitForThreads(2);
+
+			boost::lock_guard<boost::mutex> lock(mutex_);
+			CPPUNIT_ASSERT(threads_[0] != threads_[1]);
+			CPPUNIT_ASSERT(threads_[0] != boost::this_thread::get_id());
+			CPPUNIT_ASSERT(threads_[1] != boost::this_thread::get_id());
+		}
+
+		void testTimer_FiresOnShardThread() {
+			BoostIOServicePool testling(2);
+			testling.post(1, boost::bind(&BoostIOServicePoolTest::recordThread, this));
+			waitForThreads(1);
+
+			Timer::ref timer = testling.getNetworkFactories(1)->getTimerFactory()->createTimer(10);
+			timer->onTick.connect(boost::bind(&BoostIOServicePoolTest::recordThread, this));
+			testling.post(1, boost::bind(&Timer::start, timer));
+			waitForThreads(2);
+
+			boost::lock_guard<boost::mutex> lock(mutex_);
+			CPPUNIT_ASSERT(threads_[0] == threads_[1]);
+		}
+
+	private:
+		void recordThread() {
+			boost::lock_guard<boost::mutex> lock(mutex_);
+			threads_.push_back(boost::this_thread::get_id());
+		}
+
+		void waitForThreads(size_t count) {
+			for (int i = 0; i < 500; ++i) {
+				{
+					boost::lock_guard<boost::mutex> lock(mutex_);
+					if (threads_.size() >= count) {
+						return;
+					}
+				}
+				Swift::sleep(10);
+			}
+			CPPUNIT_FAIL("Timeout");
+		}
+
+	private:
+		boost::mutex mutex_;
+		std::vector<boost::thread::id> threads_;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BoostIOServicePoolTest);
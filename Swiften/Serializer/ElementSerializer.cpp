@@ -1,14 +1,20 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Serializer/ElementSerializer.h>
 
+#include <Swiften/Serializer/XML/XMLWriter.h>
+
 namespace Swift {
 
 ElementSerializer::~ElementSerializer() {
 }
 
+void ElementSerializer::write(boost::shared_ptr<ToplevelElement> element, XMLWriter& writer) const {
+	writer.writeRaw(serialize(element));
+}
+
 }
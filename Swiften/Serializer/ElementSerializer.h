@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,11 +12,20 @@
 #include <Swiften/Base/SafeByteArray.h>
 
 namespace Swift {
+	class XMLWriter;
+
 	class ElementSerializer {
 		public:
 			virtual ~ElementSerializer();
 
 			virtual SafeByteArray serialize(boost::shared_ptr<ToplevelElement> element) const = 0;
 			virtual bool canSerialize(boost::shared_ptr<ToplevelElement> element) const = 0;
+
+			/**
+			 * Writes the element directly to the given writer.
+			 *
+			 * The default implementation writes the result of serialize().
+			 */
+			virtual void write(boost::shared_ptr<ToplevelElement> element, XMLWriter& writer) const;
 	};
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -9,6 +9,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include <Swiften/Serializer/PayloadSerializer.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 	template<typename PAYLOAD_TYPE>
@@ -22,6 +23,17 @@ namespace Swift {
 				return !!boost::dynamic_pointer_cast<PAYLOAD_TYPE>(element);
 			}
 
+			virtual void write(boost::shared_ptr<Payload> element, XMLWriter& writer) const {
+				writePayload(boost::dynamic_pointer_cast<PAYLOAD_TYPE>(element), writer);
+			}
+
 			virtual std::string serializePayload(boost::shared_ptr<PAYLOAD_TYPE>) const = 0;
+
+			virtual void writePayload(boost::shared_ptr<PAYLOAD_TYPE> payload, XMLWriter& writer) const {
+				std::string result = serializePayload(payload);
+				if (!result.empty()) {
+					writer.writeRaw(result);
+				}
+			}
 	};
 }
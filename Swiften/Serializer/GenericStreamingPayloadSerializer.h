@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+
+#include <Swiften/Serializer/GenericPayloadSerializer.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
+
+namespace Swift {
+	/**
+	 * Base class for payload serializers that write their payload directly
+	 * to an XMLWriter.
+	 *
+	 * Subclasses only implement writePayload(); the string serialization is
+	 * derived from it.
+	 */
+	template<typename PAYLOAD_TYPE>
+	class GenericStreamingPayloadSerializer : public GenericPayloadSerializer<PAYLOAD_TYPE> {
+		public:
+			virtual std::string serializePayload(boost::shared_ptr<PAYLOAD_TYPE> payload) const {
+				SafeByteArray result;
+				XMLWriter writer(result);
+				writePayload(payload, writer);
+				return std::string(result.begin(), result.end());
+			}
+
+			virtual void writePayload(boost::shared_ptr<PAYLOAD_TYPE>, XMLWriter&) const = 0;
+	};
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,7 +12,7 @@
 #include <boost/optional.hpp>
 
 namespace Swift {
-	class XMLElement;
+	class XMLWriter;
 
 	class MessageSerializer : public GenericStanzaSerializer<Message> {
 		public:
@@ -21,6 +21,6 @@ namespace Swift {
 		private:
 			void setStanzaSpecificAttributesGeneric(
 					boost::shared_ptr<Message> message, 
-					XMLElement& element) const;
+					XMLWriter& writer) const;
 	};
 }
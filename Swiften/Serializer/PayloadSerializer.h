@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,6 +13,7 @@
 
 namespace Swift {
 	class Payload;
+	class XMLWriter;
 
 	class SWIFTEN_API PayloadSerializer {
 		public:
@@ -20,5 +21,13 @@ namespace Swift {
 
 			virtual bool canSerialize(boost::shared_ptr<Payload>) const = 0;
 			virtual std::string serialize(boost::shared_ptr<Payload>) const = 0;
+
+			/**
+			 * Writes the payload directly to the given writer.
+			 *
+			 * The default implementation writes the result of serialize(), if
+			 * it is not empty.
+			 */
+			virtual void write(boost::shared_ptr<Payload>, XMLWriter&) const;
 	};
 }
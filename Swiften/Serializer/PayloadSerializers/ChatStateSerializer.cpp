@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,20 +8,20 @@
 
 namespace Swift {
 
-ChatStateSerializer::ChatStateSerializer() : GenericPayloadSerializer<ChatState>() {
+ChatStateSerializer::ChatStateSerializer() : GenericStreamingPayloadSerializer<ChatState>() {
 }
 
-std::string ChatStateSerializer::serializePayload(boost::shared_ptr<ChatState> chatState)  const {
-	std::string result("<");
+void ChatStateSerializer::writePayload(boost::shared_ptr<ChatState> chatState, XMLWriter& writer) const {
+	std::string tag;
 	switch (chatState->getChatState()) {
-		case ChatState::Active: result += "active"; break;
-		case ChatState::Composing: result += "composing"; break;
-		case ChatState::Paused: result += "paused"; break;
-		case ChatState::Inactive: result += "inactive"; break;
-		case ChatState::Gone: result += "gone"; break;
+		case ChatState::Active: tag = "active"; break;
+		case ChatState::Composing: tag = "composing"; break;
+		case ChatState::Paused: tag = "paused"; break;
+		case ChatState::Inactive: tag = "inactive"; break;
+		case ChatState::Gone: tag = "gone"; break;
 	}
-	result += " xmlns=\"http://jabber.org/protocol/chatstates\"/>";
-	return result;
+	writer.startElement(tag, "http://jabber.org/protocol/chatstates");
+	writer.endElement();
 }
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -10,21 +10,21 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include <Swiften/Base/String.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
 #include <Swiften/Base/DateTime.h>
 
 namespace Swift {
 
-DelaySerializer::DelaySerializer() : GenericPayloadSerializer<Delay>() {
+DelaySerializer::DelaySerializer() : GenericStreamingPayloadSerializer<Delay>() {
 }
 
-std::string DelaySerializer::serializePayload(boost::shared_ptr<Delay> delay)  const {
-	XMLElement delayElement("delay", "urn:xmpp:delay");
+void DelaySerializer::writePayload(boost::shared_ptr<Delay> delay, XMLWriter& writer) const {
+	writer.startElement("delay");
 	if (delay->getFrom() && delay->getFrom()->isValid()) {
-		delayElement.setAttribute("from", delay->getFrom()->toString());
+		writer.addAttribute("from", delay->getFrom()->toString());
 	}
-	delayElement.setAttribute("stamp", dateTimeToString(delay->getStamp()));
-	return delayElement.serialize();
+	writer.addAttribute("stamp", dateTimeToString(delay->getStamp()));
+	writer.addAttribute("xmlns", "urn:xmpp:delay");
+	writer.endElement();
 }
 
 }
@@ -1,20 +1,20 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
-#include <Swiften/Serializer/GenericPayloadSerializer.h>
+#include <Swiften/Serializer/GenericStreamingPayloadSerializer.h>
 #include <Swiften/Elements/Delay.h>
 
 namespace Swift {
-	class DelaySerializer : public GenericPayloadSerializer<Delay> {
+	class DelaySerializer : public GenericStreamingPayloadSerializer<Delay> {
 		public:
 			DelaySerializer();
 
-			virtual std::string serializePayload(boost::shared_ptr<Delay>)  const;
+			virtual void writePayload(boost::shared_ptr<Delay>, XMLWriter&) const;
 	};
 }
 
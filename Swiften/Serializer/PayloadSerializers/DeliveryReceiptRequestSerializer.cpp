@@ -5,18 +5,17 @@
  */
 
 #include <Swiften/Serializer/PayloadSerializers/DeliveryReceiptRequestSerializer.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
 
 #include <Swiften/Base/Log.h>
 
 namespace Swift {
 
-DeliveryReceiptRequestSerializer::DeliveryReceiptRequestSerializer() : GenericPayloadSerializer<DeliveryReceiptRequest>() {
+DeliveryReceiptRequestSerializer::DeliveryReceiptRequestSerializer() : GenericStreamingPayloadSerializer<DeliveryReceiptRequest>() {
 }
 
-std::string DeliveryReceiptRequestSerializer::serializePayload(boost::shared_ptr<DeliveryReceiptRequest> /* request*/) const {
-	XMLElement requestXML("request", "urn:xmpp:receipts");
-	return requestXML.serialize();
+void DeliveryReceiptRequestSerializer::writePayload(boost::shared_ptr<DeliveryReceiptRequest> /* request*/, XMLWriter& writer) const {
+	writer.startElement("request", "urn:xmpp:receipts");
+	writer.endElement();
 }
 
 }
@@ -5,17 +5,17 @@
  */
 
 #include <Swiften/Serializer/PayloadSerializers/DeliveryReceiptSerializer.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
 
 namespace Swift {
 
-DeliveryReceiptSerializer::DeliveryReceiptSerializer() : GenericPayloadSerializer<DeliveryReceipt>() {
+DeliveryReceiptSerializer::DeliveryReceiptSerializer() : GenericStreamingPayloadSerializer<DeliveryReceipt>() {
 }
 
-std::string DeliveryReceiptSerializer::serializePayload(boost::shared_ptr<DeliveryReceipt> receipt) const {
-	XMLElement received("received", "urn:xmpp:receipts");
-	received.setAttribute("id", receipt->getReceivedID());
-	return received.serialize();
+void DeliveryReceiptSerializer::writePayload(boost::shared_ptr<DeliveryReceipt> receipt, XMLWriter& writer) const {
+	writer.startElement("received");
+	writer.addAttribute("id", receipt->getReceivedID());
+	writer.addAttribute("xmlns", "urn:xmpp:receipts");
+	writer.endElement();
 }
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,20 +7,16 @@
 #include <Swiften/Serializer/PayloadSerializers/NicknameSerializer.h>
 
 #include <boost/shared_ptr.hpp>
-#include <boost/smart_ptr/make_shared.hpp>
-
-#include <Swiften/Serializer/XML/XMLElement.h>
-#include <Swiften/Serializer/XML/XMLTextNode.h>
 
 namespace Swift {
 
-NicknameSerializer::NicknameSerializer() : GenericPayloadSerializer<Nickname>() {
+NicknameSerializer::NicknameSerializer() : GenericStreamingPayloadSerializer<Nickname>() {
 }
 
-std::string NicknameSerializer::serializePayload(boost::shared_ptr<Nickname> nick)  const {
-	XMLElement nickElement("nick", "http://jabber.org/protocol/nick");
-	nickElement.addNode(boost::make_shared<XMLTextNode>(nick->getNickname()));
-	return nickElement.serialize();
+void NicknameSerializer::writePayload(boost::shared_ptr<Nickname> nick, XMLWriter& writer) const {
+	writer.startElement("nick", "http://jabber.org/protocol/nick");
+	writer.writeText(nick->getNickname());
+	writer.endElement();
 }
 
 }
@@ -1,20 +1,20 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
-#include <Swiften/Serializer/GenericPayloadSerializer.h>
+#include <Swiften/Serializer/GenericStreamingPayloadSerializer.h>
 #include <Swiften/Elements/Nickname.h>
 
 namespace Swift {
-	class NicknameSerializer : public GenericPayloadSerializer<Nickname> {
+	class NicknameSerializer : public GenericStreamingPayloadSerializer<Nickname> {
 		public:
 			NicknameSerializer();
 
-			virtual std::string serializePayload(boost::shared_ptr<Nickname>)  const;
+			virtual void writePayload(boost::shared_ptr<Nickname>, XMLWriter&) const;
 	};
 }
 
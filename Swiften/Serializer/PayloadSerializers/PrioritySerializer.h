@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,16 +8,16 @@
 
 #include <boost/lexical_cast.hpp>
 
-#include <Swiften/Serializer/GenericPayloadSerializer.h>
+#include <Swiften/Serializer/GenericStreamingPayloadSerializer.h>
 #include <Swiften/Elements/Priority.h>
 
 namespace Swift {
-	class PrioritySerializer : public GenericPayloadSerializer<Priority> {
+	class PrioritySerializer : public GenericStreamingPayloadSerializer<Priority> {
 		public:
-			PrioritySerializer() : GenericPayloadSerializer<Priority>() {}
+			PrioritySerializer() : GenericStreamingPayloadSerializer<Priority>() {}
 
-			virtual std::string serializePayload(boost::shared_ptr<Priority> priority)  const {
-				return "<priority>" + boost::lexical_cast<std::string>(priority->getPriority()) + "</priority>";
+			virtual void writePayload(boost::shared_ptr<Priority> priority, XMLWriter& writer) const {
+				writer.writeTextElement("priority", boost::lexical_cast<std::string>(priority->getPriority()));
 			}
 	};
 }
@@ -1,23 +1,21 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
-#include <Swiften/Serializer/GenericPayloadSerializer.h>
-#include <Swiften/Serializer/XML/XMLTextNode.h>
+#include <Swiften/Serializer/GenericStreamingPayloadSerializer.h>
 #include <Swiften/Elements/Subject.h>
 
 namespace Swift {
-	class SubjectSerializer : public GenericPayloadSerializer<Subject> {
+	class SubjectSerializer : public GenericStreamingPayloadSerializer<Subject> {
 		public:
-			SubjectSerializer() : GenericPayloadSerializer<Subject>() {}
+			SubjectSerializer() : GenericStreamingPayloadSerializer<Subject>() {}
 
-			virtual std::string serializePayload(boost::shared_ptr<Subject> subject)  const {
-				XMLTextNode textNode(subject->getText());
-				return "<subject>" + textNode.serialize() + "</subject>";
+			virtual void writePayload(boost::shared_ptr<Subject> subject, XMLWriter& writer) const {
+				writer.writeTextElement("subject", subject->getText());
 			}
 	};
 }
@@ -6,20 +6,21 @@
 
 #include <Swiften/Serializer/PayloadSerializers/ThreadSerializer.h>
 
-#include <Swiften/Serializer/XML/XMLElement.h>
-
 namespace Swift {
-	ThreadSerializer::ThreadSerializer() : GenericPayloadSerializer<Thread>() {	
+	ThreadSerializer::ThreadSerializer() : GenericStreamingPayloadSerializer<Thread>() {	
 	}
 
 	ThreadSerializer::~ThreadSerializer() {
 	}
 
-	std::string ThreadSerializer::serializePayload(boost::shared_ptr<Thread> thread)  const {
-		XMLElement threadNode("thread", "", thread->getText());
+	void ThreadSerializer::writePayload(boost::shared_ptr<Thread> thread, XMLWriter& writer) const {
+		writer.startElement("thread");
 		if (!thread->getParent().empty()) {
-			threadNode.setAttribute("parent", thread->getParent());
+			writer.addAttribute("parent", thread->getParent());
+		}
+		if (!thread->getText().empty()) {
+			writer.writeText(thread->getText());
 		}
-		return threadNode.serialize();
+		writer.endElement();
 	}
 }
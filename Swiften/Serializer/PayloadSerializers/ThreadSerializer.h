@@ -7,16 +7,15 @@
 #pragma once
 
 #include <Swiften/Base/API.h>
-#include <Swiften/Serializer/GenericPayloadSerializer.h>
-#include <Swiften/Serializer/XML/XMLTextNode.h>
+#include <Swiften/Serializer/GenericStreamingPayloadSerializer.h>
 #include <Swiften/Elements/Thread.h>
 
 namespace Swift {
-	class SWIFTEN_API ThreadSerializer : public GenericPayloadSerializer<Thread> {
+	class SWIFTEN_API ThreadSerializer : public GenericStreamingPayloadSerializer<Thread> {
 		public:
 			ThreadSerializer();
 			virtual ~ThreadSerializer();
 
-			virtual std::string serializePayload(boost::shared_ptr<Thread> thread) const;
+			virtual void writePayload(boost::shared_ptr<Thread> thread, XMLWriter& writer) const;
 	};
 }
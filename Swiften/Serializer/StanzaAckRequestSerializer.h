@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -10,7 +10,7 @@
 
 #include <Swiften/Elements/StanzaAckRequest.h>
 #include <Swiften/Serializer/GenericElementSerializer.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 	class StanzaAckRequestSerializer : public GenericElementSerializer<StanzaAckRequest> {
@@ -18,8 +18,16 @@ namespace Swift {
 			StanzaAckRequestSerializer() : GenericElementSerializer<StanzaAckRequest>() {
 			}
 
-			virtual SafeByteArray serialize(boost::shared_ptr<ToplevelElement>) const {
-				return createSafeByteArray(XMLElement("r", "urn:xmpp:sm:2").serialize());
+			virtual SafeByteArray serialize(boost::shared_ptr<ToplevelElement> element) const {
+				SafeByteArray result;
+				XMLWriter writer(result);
+				write(element, writer);
+				return result;
+			}
+
+			virtual void write(boost::shared_ptr<ToplevelElement>, XMLWriter& writer) const {
+				writer.startElement("r", "urn:xmpp:sm:2");
+				writer.endElement();
 			}
 	};
 }
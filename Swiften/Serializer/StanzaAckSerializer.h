@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,7 +11,7 @@
 
 #include <Swiften/Elements/StanzaAck.h>
 #include <Swiften/Serializer/GenericElementSerializer.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 	class StanzaAckSerializer : public GenericElementSerializer<StanzaAck> {
@@ -20,11 +20,19 @@ namespace Swift {
 			}
 
 			virtual SafeByteArray serialize(boost::shared_ptr<ToplevelElement> element) const {
+				SafeByteArray result;
+				XMLWriter writer(result);
+				write(element, writer);
+				return result;
+			}
+
+			virtual void write(boost::shared_ptr<ToplevelElement> element, XMLWriter& writer) const {
 				StanzaAck::ref stanzaAck(boost::dynamic_pointer_cast<StanzaAck>(element));
 				assert(stanzaAck->isValid());
-				XMLElement result("a", "urn:xmpp:sm:2");
-				result.setAttribute("h", std::string(boost::lexical_cast<std::string>(stanzaAck->getHandledStanzasCount())));
-				return createSafeByteArray(result.serialize());
+				writer.startElement("a");
+				writer.addAttribute("h", boost::lexical_cast<std::string>(stanzaAck->getHandledStanzasCount()));
+				writer.addAttribute("xmlns", "urn:xmpp:sm:2");
+				writer.endElement();
 			}
 	};
 }
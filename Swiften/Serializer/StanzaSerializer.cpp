@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,8 +11,7 @@
 #include <iostream>
 
 #include <Swiften/Base/foreach.h>
-#include <Swiften/Serializer/XML/XMLElement.h>
-#include <Swiften/Serializer/XML/XMLRawTextNode.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 #include <Swiften/Serializer/PayloadSerializer.h>
 #include <Swiften/Serializer/PayloadSerializerCollection.h>
 #include <Swiften/Elements/Stanza.h>
@@ -23,44 +22,59 @@ StanzaSerializer::StanzaSerializer(const std::string& tag, PayloadSerializerColl
 }
 
 SafeByteArray StanzaSerializer::serialize(boost::shared_ptr<ToplevelElement> element) const {
+	SafeByteArray result;
+	XMLWriter writer(result);
+	write(element, writer);
+	return result;
+}
+
+SafeByteArray StanzaSerializer::serialize(boost::shared_ptr<ToplevelElement> element, const std::string& xmlns) const {
+	SafeByteArray result;
+	XMLWriter writer(result);
+	write(element, xmlns, writer);
+	return result;
+}
+
+void StanzaSerializer::write(boost::shared_ptr<ToplevelElement> element, XMLWriter& writer) const {
 	if (explicitDefaultNS_) {
-		return serialize(element, explicitDefaultNS_.get());
+		write(element, explicitDefaultNS_.get(), writer);
 	}
 	else {
-		return serialize(element, "");
+		write(element, "", writer);
 	}
 }
 
-SafeByteArray StanzaSerializer::serialize(boost::shared_ptr<ToplevelElement> element, const std::string& xmlns) const {
+void StanzaSerializer::write(boost::shared_ptr<ToplevelElement> element, const std::string& xmlns, XMLWriter& writer) const {
 	boost::shared_ptr<Stanza> stanza(boost::dynamic_pointer_cast<Stanza>(element));
 
-	XMLElement stanzaElement(tag_, explicitDefaultNS_ ? explicitDefaultNS_.get() : xmlns);
+	// Attributes are written in the same (alphabetical) order as the
+	// tree-based serializer used to produce.
+	writer.startElement(tag_);
 	if (stanza->getFrom().isValid()) {
-		stanzaElement.setAttribute("from", stanza->getFrom());
+		writer.addAttribute("from", stanza->getFrom());
+	}
+	if (!stanza->getID().empty()) {
+		writer.addAttribute("id", stanza->getID());
 	}
 	if (stanza->getTo().isValid()) {
-		stanzaElement.setAttribute("to", stanza->getTo());
+		writer.addAttribute("to", stanza->getTo());
 	}
-	if (!stanza->getID().empty()) {
-		stanzaElement.setAttribute("id", stanza->getID());
+	setStanzaSpecificAttributes(stanza, writer);
+	std::string ns = explicitDefaultNS_ ? explicitDefaultNS_.get() : xmlns;
+	if (!ns.empty()) {
+		writer.addAttribute("xmlns", ns);
 	}
-	setStanzaSpecificAttributes(stanza, stanzaElement);
 
-	std::string serializedPayloads;
 	foreach (const boost::shared_ptr<Payload>& payload, stanza->getPayloads()) {
 		PayloadSerializer* serializer = payloadSerializers_->getPayloadSerializer(payload);
 		if (serializer) {
-			serializedPayloads += serializer->serialize(payload);
+			serializer->write(payload, writer);
 		}
 		else {
 			std::cerr << "Could not find serializer for " << typeid(*(payload.get())).name() << std::endl;
 		}
 	}
-	if (!serializedPayloads.empty()) {
-		stanzaElement.addNode(boost::shared_ptr<XMLNode>(new XMLRawTextNode(serializedPayloads)));
-	}
-
-	return createSafeByteArray(stanzaElement.serialize());
+	writer.endElement();
 }
 
 }
@@ -1,16 +1,24 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
+#include <QA/Checker/IO.h>
+
 #include <cppunit/extensions/HelperMacros.h>
 #include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/smart_ptr/make_shared.hpp>
 
 #include <Swiften/Serializer/XMPPSerializer.h>
 #include <Swiften/Elements/AuthChallenge.h>
 #include <Swiften/Serializer/PayloadSerializerCollection.h>
 #include <Swiften/Elements/ProtocolHeader.h>
+#include <Swiften/Elements/Message.h>
+#include <Swiften/Elements/Presence.h>
+#include <Swiften/Elements/ChatState.h>
+#include <Swiften/Elements/StanzaAck.h>
+#include <Swiften/Serializer/PayloadSerializers/FullPayloadSerializerCollection.h>
 
 using namespace Swift;
 
@@ -19,6 +27,10 @@ class XMPPSerializerTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testSerializeHeader_Client);
 		CPPUNIT_TEST(testSerializeHeader_Component);
 		CPPUNIT_TEST(testSerializeHeader_Server);
+		CPPUNIT_TEST(testSerializeElement_Message);
+		CPPUNIT_TEST(testSerializeElement_PresenceWithoutSerializedPayloads);
+		CPPUNIT_TEST(testSerializeElement_ExplicitNamespace);
+		CPPUNIT_TEST(testSerializeElement_StanzaAck);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -63,6 +75,48 @@ class XMPPSerializerTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT_EQUAL(std::string("<?xml version=\"1.0\"?><stream:stream xmlns=\"jabber:server\" xmlns:stream=\"http://etherx.jabber.org/streams\" from=\"bla@foo.com\" to=\"foo.com\" id=\"myid\" version=\"0.99\">"), testling->serializeHeader(protocolHeader));
 		}
 
+		void testSerializeElement_Message() {
+			FullPayloadSerializerCollection payloadSerializers;
+			XMPPSerializer testling(&payloadSerializers, ClientStreamType, false);
+			boost::shared_ptr<Message> message(new Message());
+			message->setFrom(JID("foo@bar.com/baz"));
+			message->setTo(JID("bar@foo.com"));
+			message->setID("id-1");
+			message->setType(Message::Chat);
+			message->setBody("Hello & <bye>");
+			message->addPayload(boost::make_shared<ChatState>(ChatState::Composing));
+
+			CPPUNIT_ASSERT_EQUAL(createSafeByteArray(
+				"<message from=\"foo@bar.com/baz\" id=\"id-1\" to=\"bar@foo.com\" type=\"chat\">"
+					"<body>Hello &amp; &lt;bye&gt;</body>"
+					"<composing xmlns=\"http://jabber.org/protocol/chatstates\"/>"
+				"</message>"), testling.serializeElement(message));
+		}
+
+		void testSerializeElement_PresenceWithoutSerializedPayloads() {
+			FullPayloadSerializerCollection payloadSerializers;
+			XMPPSerializer testling(&payloadSerializers, ClientStreamType, false);
+			boost::shared_ptr<Presence> presence(new Presence());
+			presence->setShow(StatusShow::Online);
+
+			CPPUNIT_ASSERT_EQUAL(createSafeByteArray("<presence/>"), testling.serializeElement(presence));
+		}
+
+		void testSerializeElement_ExplicitNamespace() {
+			FullPayloadSerializerCollection payloadSerializers;
+			XMPPSerializer testling(&payloadSerializers, ServerStreamType, true);
+			boost::shared_ptr<Presence> presence(new Presence("Away"));
+			presence->setType(Presence::Unavailable);
+
+			CPPUNIT_ASSERT_EQUAL(createSafeByteArray("<presence type=\"unavailable\" xmlns=\"jabber:server\"><status>Away</status></presence>"), testling.serializeElement(presence));
+		}
+
+		void testSerializeElement_StanzaAck() {
+			boost::shared_ptr<XMPPSerializer> testling(createSerializer(ClientStreamType));
+
+			CPPUNIT_ASSERT_EQUAL(createSafeByteArray("<a h=\"3\" xmlns=\"urn:xmpp:sm:2\"/>"), testling->serializeElement(boost::make_shared<StanzaAck>(3)));
+		}
+
 	private:
 		XMPPSerializer* createSerializer(StreamType type) {
 			return new XMPPSerializer(payloadSerializerCollection, type, false);
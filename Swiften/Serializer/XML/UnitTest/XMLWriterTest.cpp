@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/Serializer/XML/XMLWriter.h>
+
+using namespace Swift;
+
+class XMLWriterTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(XMLWriterTest);
+		CPPUNIT_TEST(testWrite);
+		CPPUNIT_TEST(testWrite_EmptyElement);
+		CPPUNIT_TEST(testWrite_EmptyText);
+		CPPUNIT_TEST(testWrite_SpecialAttributeCharacters);
+		CPPUNIT_TEST(testWrite_SpecialTextCharacters);
+		CPPUNIT_TEST(testWrite_Raw);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void testWrite() {
+			SafeByteArray output;
+			XMLWriter testling(output);
+
+			testling.startElement("foo", "http://example.com");
+			testling.addAttribute("myatt", "myval");
+			testling.writeTextElement("bar", "Blo");
+			testling.startElement("baz");
+			testling.writeText("Bli");
+			testling.endElement();
+			testling.endElement();
+
+			CPPUNIT_ASSERT_EQUAL(std::string(
+				"<foo xmlns=\"http://example.com\" myatt=\"myval\">"
+					"<bar>Blo</bar>"
+					"<baz>Bli</baz>"
+				"</foo>"), toString(output));
+		}
+
+		void testWrite_EmptyElement() {
+			SafeByteArray output;
+			XMLWriter testling(output);
+
+			testling.startElement("foo", "http://example.com");
+			testling.endElement();
+
+			CPPUNIT_ASSERT_EQUAL(std::string("<foo xmlns=\"http://example.com\"/>"), toString(output));
+		}
+
+		void testWrite_EmptyText() {
+			SafeByteArray output;
+			XMLWriter testling(output);
+
+			testling.writeTextElement("foo", "");
+
+			CPPUNIT_ASSERT_EQUAL(std::string("<foo></foo>"), toString(output));
+		}
+
+		void testWrite_SpecialAttributeCharacters() {
+			SafeByteArray output;
+			XMLWriter testling(output);
+
+			testling.startElement("foo");
+			testling.addAttribute("myatt", "a<\"'&>b");
+			testling.endElement();
+
+			CPPUNIT_ASSERT_EQUAL(std::string("<foo myatt=\"a&lt;&quot;&apos;&amp;&gt;b\"/>"), toString(output));
+		}
+
+		void testWrite_SpecialTextCharacters() {
+			SafeByteArray output;
+			XMLWriter testling(output);
+
+			testling.writeTextElement("foo", "Bli&</stream>'\"");
+
+			CPPUNIT_ASSERT_EQUAL(std::string("<foo>Bli&amp;&lt;/stream&gt;'\"</foo>"), toString(output));
+		}
+
+		void testWrite_Raw() {
+			SafeByteArray output;
+			XMLWriter testling(output);
+
+			testling.startElement("foo");
+			testling.writeRaw("<bar/>");
+			testling.endElement();
+
+			CPPUNIT_ASSERT_EQUAL(std::string("<foo><bar/></foo>"), toString(output));
+		}
+
+	private:
+		static std::string toString(const SafeByteArray& data) {
+			return std::string(data.begin(), data.end());
+		}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(XMLWriterTest);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -8,6 +8,7 @@
 
 #include <Swiften/Base/foreach.h>
 #include <Swiften/Serializer/XML/XMLTextNode.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 
@@ -21,34 +22,26 @@ XMLElement::XMLElement(const std::string& tag, const std::string& xmlns, const s
 }
 
 std::string XMLElement::serialize() {
-	std::string result;
-	result += "<" + tag_;
+	SafeByteArray result;
+	XMLWriter writer(result);
+	write(writer);
+	return std::string(result.begin(), result.end());
+}
+
+void XMLElement::write(XMLWriter& writer) {
+	writer.startElement(tag_);
 	typedef std::pair<std::string,std::string> Pair;
 	foreach(const Pair& p, attributes_) {
-		result += " " + p.first + "=\"" + p.second + "\"";
-	}
-
-	if (!childNodes_.empty()) {
-		result += ">";
-		foreach (boost::shared_ptr<XMLNode> node, childNodes_) {
-			result += node->serialize();
-		}
-		result += "</" + tag_ + ">";
+		writer.addAttribute(p.first, p.second);
 	}
-	else {
-		result += "/>";
+	foreach (boost::shared_ptr<XMLNode> node, childNodes_) {
+		node->write(writer);
 	}
-	return result;
+	writer.endElement();
 }
 
 void XMLElement::setAttribute(const std::string& attribute, const std::string& value) {
-	std::string escapedValue(value);
-	String::replaceAll(escapedValue, '&', "&amp;");
-	String::replaceAll(escapedValue, '<', "&lt;");
-	String::replaceAll(escapedValue, '>', "&gt;");
-	String::replaceAll(escapedValue, '\'', "&apos;");
-	String::replaceAll(escapedValue, '"', "&quot;");
-	attributes_[attribute] = escapedValue;
+	attributes_[attribute] = value;
 }
 
 void XMLElement::addNode(boost::shared_ptr<XMLNode> node) {
@@ -1,14 +1,20 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Serializer/XML/XMLNode.h>
 
+#include <Swiften/Serializer/XML/XMLWriter.h>
+
 namespace Swift {
 
 XMLNode::~XMLNode() {
 }
 
+void XMLNode::write(XMLWriter& writer) {
+	writer.writeRaw(serialize());
+}
+
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -11,10 +11,19 @@
 #include <Swiften/Base/API.h>
 
 namespace Swift {
+	class XMLWriter;
+
 	class SWIFTEN_API XMLNode {
 		public:
 			virtual ~XMLNode();
 
 			virtual std::string serialize() = 0;
+
+			/**
+			 * Writes the node to the given writer.
+			 *
+			 * The default implementation writes the result of serialize().
+			 */
+			virtual void write(XMLWriter& writer);
 	};
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <Swiften/Serializer/XML/XMLNode.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 #include <Swiften/Base/String.h>
 
 namespace Swift {
@@ -14,16 +15,18 @@ namespace Swift {
 		public:
 			typedef boost::shared_ptr<XMLTextNode> ref;
 
-			XMLTextNode(const std::string& text) : text_(text) {
-				String::replaceAll(text_, '&', "&amp;"); // Should come first
-				String::replaceAll(text_, '<', "&lt;");
-				String::replaceAll(text_, '>', "&gt;");
+			XMLTextNode(const std::string& text) {
+				XMLWriter::appendEscapedText(text, text_);
 			}
 
 			std::string serialize() {
 				return text_;
 			}
 
+			void write(XMLWriter& writer) {
+				writer.writeRaw(text_);
+			}
+
 			static ref create(const std::string& text) {
 				return ref(new XMLTextNode(text));
 			}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/Serializer/XML/XMLWriter.h>
+
+#include <cassert>
+#include <cstring>
+
+namespace Swift {
+
+namespace {
+	const char* getEscapeSequence(char c, bool attribute) {
+		switch (c) {
+			case '&': return "&amp;";
+			case '<': return "&lt;";
+			case '>': return "&gt;";
+			case '\'': return attribute ? "&apos;" : 0;
+			case '"': return attribute ? "&quot;" : 0;
+			default: return 0;
+		}
+	}
+
+	/**
+	 * Appends the escaped text in a single pass, copying runs of characters
+	 * that do not need escaping at once.
+	 */
+	template<typename Output>
+	void appendEscaped(const std::string& text, bool attribute, Output& output) {
+		const char* data = text.data();
+		size_t runStart = 0;
+		for (size_t i = 0; i < text.size(); ++i) {
+			const char* escapeSequence = getEscapeSequence(data[i], attribute);
+			if (escapeSequence) {
+				output.insert(output.end(), data + runStart, data + i);
+				output.insert(output.end(), escapeSequence, escapeSequence + std::strlen(escapeSequence));
+				runStart = i + 1;
+			}
+		}
+		output.insert(output.end(), data + runStart, data + text.size());
+	}
+}
+
+XMLWriter::XMLWriter(SafeByteArray& output) : output_(output), startTagOpen_(false) {
+}
+
+void XMLWriter::startElement(const std::string& tag, const std::string& xmlns) {
+	closeStartTag();
+	output_.push_back('<');
+	append(tag);
+	openElements_.push_back(tag);
+	startTagOpen_ = true;
+	if (!xmlns.empty()) {
+		addAttribute("xmlns", xmlns);
+	}
+}
+
+void XMLWriter::addAttribute(const std::string& attribute, const std::string& value) {
+	assert(startTagOpen_);
+	output_.push_back(' ');
+	append(attribute);
+	append("=\"", 2);
+	appendEscaped(value, true, output_);
+	output_.push_back('"');
+}
+
+void XMLWriter::endElement() {
+	assert(!openElements_.empty());
+	if (startTagOpen_) {
+		append("/>", 2);
+		startTagOpen_ = false;
+	}
+	else {
+		append("</", 2);
+		append(openElements_.back());
+		output_.push_back('>');
+	}
+	openElements_.pop_back();
+}
+
+void XMLWriter::writeText(const std::string& text) {
+	closeStartTag();
+	appendEscaped(text, false, output_);
+}
+
+void XMLWriter::writeRaw(const std::string& data) {
+	closeStartTag();
+	append(data);
+}
+
+void XMLWriter::writeRaw(const SafeByteArray& data) {
+	closeStartTag();
+	output_.insert(output_.end(), data.begin(), data.end());
+}
+
+void XMLWriter::writeTextElement(const std::string& tag, const std::string& text) {
+	startElement(tag);
+	writeText(text);
+	endElement();
+}
+
+void XMLWriter::appendEscapedText(const std::string& text, std::string& result) {
+	appendEscaped(text, false, result);
+}
+
+void XMLWriter::appendEscapedAttributeValue(const std::string& value, std::string& result) {
+	appendEscaped(value, true, result);
+}
+
+void XMLWriter::closeStartTag() {
+	if (startTagOpen_) {
+		output_.push_back('>');
+		startTagOpen_ = false;
+	}
+}
+
+void XMLWriter::append(const char* data, size_t size) {
+	output_.insert(output_.end(), data, data + size);
+}
+
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include <Swiften/Base/API.h>
+#include <Swiften/Base/SafeByteArray.h>
+
+namespace Swift {
+	/**
+	 * Writes XML directly into an output buffer.
+	 *
+	 * Text and attribute values are escaped while they are being appended,
+	 * so no intermediate element trees or strings are created.
+	 */
+	class SWIFTEN_API XMLWriter : public boost::noncopyable {
+		public:
+			XMLWriter(SafeByteArray& output);
+
+			/**
+			 * Opens a new element. Attributes can be added until content
+			 * is written or the element is ended.
+			 */
+			void startElement(const std::string& tag, const std::string& xmlns = "");
+			void addAttribute(const std::string& attribute, const std::string& value);
+			void endElement();
+
+			void writeText(const std::string& text);
+			void writeRaw(const std::string& data);
+			void writeRaw(const SafeByteArray& data);
+
+			/**
+			 * Convenience method for writing an element that only contains text.
+			 */
+			void writeTextElement(const std::string& tag, const std::string& text);
+
+			static void appendEscapedText(const std::string& text, std::string& result);
+			static void appendEscapedAttributeValue(const std::string& value, std::string& result);
+
+		private:
+			void closeStartTag();
+			void append(const char* data, size_t size);
+			void append(const std::string& s) {
+				append(s.data(), s.size());
+			}
+
+		private:
+			SafeByteArray& output_;
+			std::vector<std::string> openElements_;
+			bool startTagOpen_;
+	};
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -36,6 +36,7 @@
 #include <Swiften/Serializer/PresenceSerializer.h>
 #include <Swiften/Serializer/IQSerializer.h>
 #include <Swiften/Serializer/ComponentHandshakeSerializer.h>
+#include <Swiften/Serializer/XML/XMLWriter.h>
 
 namespace Swift {
 
@@ -86,7 +87,10 @@ std::string XMPPSerializer::serializeHeader(const ProtocolHeader& header) const
 SafeByteArray XMPPSerializer::serializeElement(boost::shared_ptr<ToplevelElement> element) const {
 	std::vector< boost::shared_ptr<ElementSerializer> >::const_iterator i = std::find_if(serializers_.begin(), serializers_.end(), boost::bind(&ElementSerializer::canSerialize, _1, element));
 	if (i != serializers_.end()) {
-		return (*i)->serialize(element);
+		SafeByteArray result;
+		XMLWriter writer(result);
+		(*i)->write(element, writer);
+		return result;
 	}
 	else {
 		std::cerr << "Could not find serializer for " << typeid(*(element.get())).name() << std::endl;
@@ -1,15 +1,17 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/Session/Session.h>
 
+#include <cassert>
 #include <boost/bind.hpp>
 
 #include <Swiften/StreamStack/XMPPLayer.h>
 #include <Swiften/StreamStack/StreamStack.h>
+#include <Swiften/StreamStack/TLSLayer.h>
 
 namespace Swift {
 
@@ -25,11 +27,13 @@ Session::Session(
 			xmppLayer(NULL),
 			connectionLayer(NULL),
 			streamStack(0),
+			tlsLayer(NULL),
 			finishing(false) {
 }
 
 Session::~Session() {
 	delete streamStack;
+	delete tlsLayer;
 	delete connectionLayer;
 	delete xmppLayer;
 }
@@ -76,6 +80,25 @@ void Session::initializeStreamStack() {
 	streamStack = new StreamStack(xmppLayer, connectionLayer);
 }
 
+bool Session::addTLSEncryption(TLSContextFactory* tlsContextFactory, CertificateWithKey::ref certificate) {
+	assert(!tlsLayer);
+	TLSLayer* layer = new TLSLayer(tlsContextFactory);
+	if (!layer->setServerCertificate(certificate)) {
+		delete layer;
+		return false;
+	}
+	tlsLayer = layer;
+	tlsLayer->onError.connect(boost::bind(&Session::handleTLSError, this, _1));
+	streamStack->addLayer(tlsLayer);
+	xmppLayer->resetParser();
+	tlsLayer->accept();
+	return true;
+}
+
+void Session::handleTLSError(boost::shared_ptr<Swift::TLSError>) {
+	finishSession(TLSError);
+}
+
 void Session::sendElement(boost::shared_ptr<ToplevelElement> stanza) {
 	xmppLayer->writeElement(stanza);
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -17,6 +17,8 @@
 #include <Swiften/Network/Connection.h>
 #include <Swiften/StreamStack/ConnectionLayer.h>
 #include <Swiften/Base/SafeByteArray.h>
+#include <Swiften/TLS/CertificateWithKey.h>
+#include <Swiften/TLS/TLSError.h>
 
 namespace Swift {
 	class ProtocolHeader;
@@ -27,6 +29,8 @@ namespace Swift {
 	class PayloadSerializerCollection;
 	class XMPPLayer;
 	class XMLParserFactory;
+	class TLSContextFactory;
+	class TLSLayer;
 
 	class SWIFTEN_API Session : public boost::enable_shared_from_this<Session> {
 		public:
@@ -95,10 +99,23 @@ namespace Swift {
 				return streamStack;
 			}
 
+			/**
+			 * Encrypts the rest of the stream, with this side acting as the
+			 * TLS server. Returns false if the certificate can't be used.
+			 *
+			 * The stream is restarted, so the parser is reset.
+			 */
+			bool addTLSEncryption(TLSContextFactory* tlsContextFactory, CertificateWithKey::ref certificate);
+
+			bool isTLSEncrypted() const {
+				return tlsLayer != NULL;
+			}
+
 			void setFinished();
 
 		private:
 			void handleDisconnected(const boost::optional<Connection::Error>& error);
+			void handleTLSError(boost::shared_ptr<Swift::TLSError> error);
 
 		private:
 			JID localJID;
@@ -110,6 +127,7 @@ namespace Swift {
 			XMPPLayer* xmppLayer;
 			ConnectionLayer* connectionLayer;
 			StreamStack* streamStack;
+			TLSLayer* tlsLayer;
 			bool finishing;
 	};
 }
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2010-2014 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <string>
 #include <Swiften/Base/boost_bsignals.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/optional.hpp>
@@ -67,6 +68,14 @@ namespace Swift {
 				return certificate && !certificate->isNull();
 			}
 
+			/**
+			 * Sets the identity of the server, which is used to resume the TLS
+			 * session of an earlier connection to it.
+			 */
+			void setTLSServerIdentity(const std::string& identity) {
+				tlsServerIdentity = identity;
+			}
+
 			virtual Certificate::ref getPeerCertificate() const = 0;
 			virtual std::vector<Certificate::ref> getPeerCertificateChain() const = 0;
 			virtual boost::shared_ptr<CertificateVerificationError> getPeerCertificateVerificationError() const = 0;
@@ -85,7 +94,12 @@ namespace Swift {
 				return certificate;
 			}
 
+			const std::string& getTLSServerIdentity() const {
+				return tlsServerIdentity;
+			}
+
 		private:
 			CertificateWithKey::ref certificate;
+			std::string tlsServerIdentity;
 	};
 }
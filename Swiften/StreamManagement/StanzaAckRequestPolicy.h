@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace Swift {
+	/**
+	 * Determines when a StanzaAckRequester asks the other side to ack the
+	 * stanzas that were sent.
+	 *
+	 * Only sent messages cause ack requests. The conditions can be combined,
+	 * in which case an ack is requested as soon as one of them holds.
+	 */
+	struct StanzaAckRequestPolicy {
+		StanzaAckRequestPolicy() : messageCount(1), maxDelayMilliseconds(0), idleMilliseconds(0), maxUnackedStanzas(0) {
+		}
+
+		/**
+		 * Request an ack once this many messages were sent since the
+		 * last request, or 0 to disable.
+		 *
+		 * Default: 1
+		 */
+		unsigned int messageCount;
+
+		/**
+		 * Request an ack at most this many milliseconds after the first
+		 * message since the last request was sent, or 0 to disable.
+		 *
+		 * Default: 0
+		 */
+		int maxDelayMilliseconds;
+
+		/**
+		 * Request an ack when no message was sent for this many
+		 * milliseconds, or 0 to disable.
+		 *
+		 * Default: 0
+		 */
+		int idleMilliseconds;
+
+		/**
+		 * The maximum number of unacked stanzas to keep, or 0 for no limit.
+		 *
+		 * When the limit is exceeded, the oldest stanzas are forgotten: they
+		 * are not reported when acked, and a stream on which stanzas were
+		 * forgotten cannot be resumed.
+		 *
+		 * Default: 0
+		 */
+		size_t maxUnackedStanzas;
+	};
+}
@@ -1,44 +1,125 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/StreamManagement/StanzaAckRequester.h>
 
+#include <cassert>
+#include <boost/bind.hpp>
 #include <boost/numeric/conversion/cast.hpp>
 #include <iostream>
 
+#include <Swiften/Base/Log.h>
 #include <Swiften/Elements/Message.h>
+#include <Swiften/Network/Timer.h>
+#include <Swiften/Network/TimerFactory.h>
 
 namespace Swift {
 
 static const unsigned int MAX_HANDLED_STANZA_COUNT = boost::numeric_cast<unsigned int>((1ULL<<32) - 1);
 
-StanzaAckRequester::StanzaAckRequester() : lastHandledStanzasCount(0) {
+StanzaAckRequester::StanzaAckRequester() : lastHandledStanzasCount(0), forgottenStanzasCount(0), unrequestedMessagesCount(0) {
 
 }
 
+StanzaAckRequester::StanzaAckRequester(unsigned int handledStanzasCount, const std::deque<boost::shared_ptr<Stanza> >& unackedStanzas) : lastHandledStanzasCount(handledStanzasCount), unackedStanzas(unackedStanzas), forgottenStanzasCount(0), unrequestedMessagesCount(0) {
+}
+
+StanzaAckRequester::~StanzaAckRequester() {
+	resetTimers();
+}
+
+void StanzaAckRequester::setPolicy(const StanzaAckRequestPolicy& policy, TimerFactory* timerFactory) {
+	resetTimers();
+	this->policy = policy;
+	if (policy.maxDelayMilliseconds > 0) {
+		assert(timerFactory);
+		delayTimer = timerFactory->createTimer(policy.maxDelayMilliseconds);
+		delayTimer->onTick.connect(boost::bind(&StanzaAckRequester::handleTimerTick, this));
+	}
+	if (policy.idleMilliseconds > 0) {
+		assert(timerFactory);
+		idleTimer = timerFactory->createTimer(policy.idleMilliseconds);
+		idleTimer->onTick.connect(boost::bind(&StanzaAckRequester::handleTimerTick, this));
+	}
+}
+
 void StanzaAckRequester::handleStanzaSent(boost::shared_ptr<Stanza> stanza) {
 	unackedStanzas.push_back(stanza);
+	if (policy.maxUnackedStanzas > 0 && unackedStanzas.size() > policy.maxUnackedStanzas) {
+		if (forgottenStanzasCount == 0) {
+			SWIFT_LOG(warning) << "Too many unacked stanzas; forgetting the oldest ones" << std::endl;
+		}
+		unackedStanzas.pop_front();
+		++forgottenStanzasCount;
+	}
 	if (boost::dynamic_pointer_cast<Message>(stanza)) {
-		onRequestAck();
+		++unrequestedMessagesCount;
+		if (policy.messageCount > 0 && unrequestedMessagesCount >= policy.messageCount) {
+			requestAck();
+			return;
+		}
+		if (delayTimer && unrequestedMessagesCount == 1) {
+			delayTimer->start();
+		}
+		if (idleTimer) {
+			idleTimer->stop();
+			idleTimer->start();
+		}
 	}
 }
 
 void StanzaAckRequester::handleAckReceived(unsigned int handledStanzasCount) {
 	unsigned int i = lastHandledStanzasCount;
 	while (i != handledStanzasCount) {
-		if (unackedStanzas.empty()) {
-			std::cerr << "Warning: Server acked more stanzas than we sent" << std::endl;
-			break;
+		// Forgotten stanzas were sent before any stanza still in the queue
+		if (forgottenStanzasCount > 0) {
+			--forgottenStanzasCount;
+		}
+		else {
+			if (unackedStanzas.empty()) {
+				std::cerr << "Warning: Server acked more stanzas than we sent" << std::endl;
+				break;
+			}
+			boost::shared_ptr<Stanza> ackedStanza = unackedStanzas.front();
+			unackedStanzas.pop_front();
+			onStanzaAcked(ackedStanza);
 		}
-		boost::shared_ptr<Stanza> ackedStanza = unackedStanzas.front();
-		unackedStanzas.pop_front();
-		onStanzaAcked(ackedStanza);
 		i = (i == MAX_HANDLED_STANZA_COUNT ? 0 : i + 1);
 	}
 	lastHandledStanzasCount = handledStanzasCount;
 }
 
+void StanzaAckRequester::requestAck() {
+	unrequestedMessagesCount = 0;
+	if (delayTimer) {
+		delayTimer->stop();
+	}
+	if (idleTimer) {
+		idleTimer->stop();
+	}
+	onRequestAck();
+}
+
+void StanzaAckRequester::handleTimerTick() {
+	if (unrequestedMessagesCount > 0) {
+		requestAck();
+	}
+}
+
+void StanzaAckRequester::resetTimers() {
+	if (delayTimer) {
+		delayTimer->stop();
+		delayTimer->onTick.disconnect(boost::bind(&StanzaAckRequester::handleTimerTick, this));
+		delayTimer.reset();
+	}
+	if (idleTimer) {
+		idleTimer->stop();
+		idleTimer->onTick.disconnect(boost::bind(&StanzaAckRequester::handleTimerTick, this));
+		idleTimer.reset();
+	}
+}
+
 }
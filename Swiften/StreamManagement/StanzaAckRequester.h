@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -12,23 +12,72 @@
 #include <Swiften/Base/API.h>
 #include <Swiften/Elements/Stanza.h>
 #include <Swiften/Base/boost_bsignals.h>
+#include <Swiften/StreamManagement/StanzaAckRequestPolicy.h>
 
 namespace Swift {
+	class Timer;
+	class TimerFactory;
+
 	class SWIFTEN_API StanzaAckRequester {
 		public:
 			StanzaAckRequester();
 
+			/**
+			 * Creates a requester that continues from the state of a previous
+			 * stream (e.g. when the stream is resumed).
+			 */
+			StanzaAckRequester(unsigned int handledStanzasCount, const std::deque<boost::shared_ptr<Stanza> >& unackedStanzas);
+			~StanzaAckRequester();
+
+			/**
+			 * Sets when acks are requested. A timer factory is only needed if
+			 * the policy has a delay or an idle time set.
+			 */
+			void setPolicy(const StanzaAckRequestPolicy& policy, TimerFactory* timerFactory = NULL);
+
 			void handleStanzaSent(boost::shared_ptr<Stanza> stanza);
 			void handleAckReceived(unsigned int handledStanzasCount);
 
+			/**
+			 * Returns the last handled stanza count received from the other side.
+			 */
+			unsigned int getHandledStanzasCount() const {
+				return lastHandledStanzasCount;
+			}
+
+			/**
+			 * Returns the stanzas that were sent but not acked yet, oldest first.
+			 */
+			const std::deque<boost::shared_ptr<Stanza> >& getUnackedStanzas() const {
+				return unackedStanzas;
+			}
+
+			/**
+			 * Returns whether unacked stanzas were dropped from the queue
+			 * because of StanzaAckRequestPolicy::maxUnackedStanzas.
+			 */
+			bool hasForgottenStanzas() const {
+				return forgottenStanzasCount > 0;
+			}
+
 		public:
 			boost::signal<void ()> onRequestAck;
 			boost::signal<void (boost::shared_ptr<Stanza>)> onStanzaAcked;
 
+		private:
+			void requestAck();
+			void handleTimerTick();
+			void resetTimers();
+
 		private:
 			friend class StanzaAckRequesterTest;
+			StanzaAckRequestPolicy policy;
 			unsigned int lastHandledStanzasCount;
 			std::deque<boost::shared_ptr<Stanza> > unackedStanzas;
+			size_t forgottenStanzasCount;
+			unsigned int unrequestedMessagesCount;
+			boost::shared_ptr<Timer> delayTimer;
+			boost::shared_ptr<Timer> idleTimer;
 	};
 
 }
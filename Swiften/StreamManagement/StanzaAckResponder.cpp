@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -15,6 +15,9 @@ static const unsigned int MAX_HANDLED_STANZA_COUNT = boost::numeric_cast<unsigne
 StanzaAckResponder::StanzaAckResponder() : handledStanzasCount(0) {
 }
 
+StanzaAckResponder::StanzaAckResponder(unsigned int handledStanzasCount) : handledStanzasCount(handledStanzasCount) {
+}
+
 void StanzaAckResponder::handleStanzaReceived() {
 	handledStanzasCount = (handledStanzasCount == MAX_HANDLED_STANZA_COUNT ? 0 : handledStanzasCount + 1);
 }
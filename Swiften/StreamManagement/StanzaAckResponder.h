@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -17,9 +17,19 @@ namespace Swift {
 		public:
 			StanzaAckResponder();
 
+			/**
+			 * Creates a responder that continues counting from a previous stream
+			 * (e.g. when the stream is resumed).
+			 */
+			StanzaAckResponder(unsigned int handledStanzasCount);
+
 			void handleStanzaReceived();
 			void handleAckRequestReceived();
 
+			unsigned int getHandledStanzasCount() const {
+				return handledStanzasCount;
+			}
+
 		public:
 			boost::signal<void (unsigned int /* handledStanzaCount */)> onAck;
 
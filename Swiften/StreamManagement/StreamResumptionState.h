@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+#include <Swiften/Elements/Stanza.h>
+#include <Swiften/JID/JID.h>
+
+namespace Swift {
+	/**
+	 * The state of a stream management session that is needed to resume it
+	 * on a new stream (XEP-0198).
+	 */
+	struct StreamResumptionState {
+		StreamResumptionState() : handledStanzasCount(0), ackedStanzasCount(0) {
+		}
+
+		/**
+		 * The resumption ID assigned by the server.
+		 */
+		std::string id;
+
+		/**
+		 * The full JID that was bound on the stream.
+		 */
+		JID jid;
+
+		/**
+		 * The number of stanzas received on the stream.
+		 */
+		unsigned int handledStanzasCount;
+
+		/**
+		 * The number of sent stanzas that were acked by the server.
+		 */
+		unsigned int ackedStanzasCount;
+
+		/**
+		 * The sent stanzas that were not acked yet, oldest first.
+		 */
+		std::deque<boost::shared_ptr<Stanza> > unackedStanzas;
+	};
+}
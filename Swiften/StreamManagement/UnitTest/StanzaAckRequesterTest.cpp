@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -13,6 +13,7 @@
 #include <Swiften/Elements/Message.h>
 #include <Swiften/Elements/Presence.h>
 #include <Swiften/Elements/IQ.h>
+#include <Swiften/Network/DummyTimerFactory.h>
 
 using namespace Swift;
 
@@ -28,11 +29,23 @@ class StanzaAckRequesterTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST(testHandleAckReceived_AcksMultipleStanzas);
 		CPPUNIT_TEST(testHandleAckReceived_MultipleAcks);
 		CPPUNIT_TEST(testHandleAckReceived_WrapAround);
+		CPPUNIT_TEST(testHandleStanzaSent_MessageCountPolicy);
+		CPPUNIT_TEST(testHandleStanzaSent_MessageCountPolicyReducesRequests);
+		CPPUNIT_TEST(testHandleStanzaSent_MaxDelayPolicy);
+		CPPUNIT_TEST(testHandleStanzaSent_MaxDelayPolicyRestartsAfterRequest);
+		CPPUNIT_TEST(testHandleStanzaSent_IdlePolicy);
+		CPPUNIT_TEST(testHandleStanzaSent_IdlePolicyWithoutMessagesDoesNotRequestAck);
+		CPPUNIT_TEST(testHandleStanzaSent_MaxUnackedStanzas);
 		CPPUNIT_TEST_SUITE_END();
 
 	public:
 		void setUp() {
 			acksRequested = 0;
+			timerFactory = new DummyTimerFactory();
+		}
+
+		void tearDown() {
+			delete timerFactory;
 		}
 
 		void testHandleStanzaSent_MessageRequestsAck() {
@@ -121,6 +134,124 @@ class StanzaAckRequesterTest : public CppUnit::TestFixture {
 			CPPUNIT_ASSERT_EQUAL(std::string("m2"), ackedStanzas[1]->getID());
 		}
 
+		void testHandleStanzaSent_MessageCountPolicy() {
+			boost::shared_ptr<StanzaAckRequester> testling(createRequester());
+			StanzaAckRequestPolicy policy;
+			policy.messageCount = 3;
+			testling->setPolicy(policy);
+
+			testling->handleStanzaSent(createMessage("m1"));
+			testling->handleStanzaSent(createIQ("iq1"));
+			testling->handleStanzaSent(createMessage("m2"));
+			CPPUNIT_ASSERT_EQUAL(0, acksRequested);
+
+			testling->handleStanzaSent(createMessage("m3"));
+			CPPUNIT_ASSERT_EQUAL(1, acksRequested);
+		}
+
+		// Compares the number of ack requests (and thus of acks) of a bulk
+		// send with the default policy to one requesting in batches
+		void testHandleStanzaSent_MessageCountPolicyReducesRequests() {
+			boost::shared_ptr<StanzaAckRequester> perMessage(createRequester());
+			for (int i = 0; i < 10000; ++i) {
+				perMessage->handleStanzaSent(createMessage("m"));
+			}
+			CPPUNIT_ASSERT_EQUAL(10000, acksRequested);
+
+			acksRequested = 0;
+			boost::shared_ptr<StanzaAckRequester> batched(createRequester());
+			StanzaAckRequestPolicy policy;
+			policy.messageCount = 100;
+			batched->setPolicy(policy);
+			for (int i = 0; i < 10000; ++i) {
+				batched->handleStanzaSent(createMessage("m"));
+			}
+			CPPUNIT_ASSERT_EQUAL(100, acksRequested);
+		}
+
+		void testHandleStanzaSent_MaxDelayPolicy() {
+			boost::shared_ptr<StanzaAckRequester> testling(createRequester());
+			StanzaAckRequestPolicy policy;
+			policy.messageCount = 0;
+			policy.maxDelayMilliseconds = 100;
+			testling->setPolicy(policy, timerFactory);
+
+			testling->handleStanzaSent(createMessage("m1"));
+			timerFactory->setTime(50);
+			testling->handleStanzaSent(createMessage("m2"));
+			timerFactory->setTime(99);
+			CPPUNIT_ASSERT_EQUAL(0, acksRequested);
+
+			timerFactory->setTime(100);
+			CPPUNIT_ASSERT_EQUAL(1, acksRequested);
+		}
+
+		void testHandleStanzaSent_MaxDelayPolicyRestartsAfterRequest() {
+			boost::shared_ptr<StanzaAckRequester> testling(createRequester());
+			StanzaAckRequestPolicy policy;
+			policy.messageCount = 2;
+			policy.maxDelayMilliseconds = 100;
+			testling->setPolicy(policy, timerFactory);
+
+			testling->handleStanzaSent(createMessage("m1"));
+			testling->handleStanzaSent(createMessage("m2"));
+			timerFactory->setTime(50);
+			testling->handleStanzaSent(createMessage("m3"));
+			timerFactory->setTime(100);
+			CPPUNIT_ASSERT_EQUAL(1, acksRequested);
+
+			timerFactory->setTime(150);
+			CPPUNIT_ASSERT_EQUAL(2, acksRequested);
+		}
+
+		void testHandleStanzaSent_IdlePolicy() {
+			boost::shared_ptr<StanzaAckRequester> testling(createRequester());
+			StanzaAckRequestPolicy policy;
+			policy.messageCount = 0;
+			policy.idleMilliseconds = 100;
+			testling->setPolicy(policy, timerFactory);
+
+			testling->handleStanzaSent(createMessage("m1"));
+			timerFactory->setTime(50);
+			testling->handleStanzaSent(createMessage("m2"));
+			timerFactory->setTime(120);
+			CPPUNIT_ASSERT_EQUAL(0, acksRequested);
+
+			timerFactory->setTime(150);
+			CPPUNIT_ASSERT_EQUAL(1, acksRequested);
+		}
+
+		void testHandleStanzaSent_IdlePolicyWithoutMessagesDoesNotRequestAck() {
+			boost::shared_ptr<StanzaAckRequester> testling(createRequester());
+			StanzaAckRequestPolicy policy;
+			policy.messageCount = 0;
+			policy.idleMilliseconds = 100;
+			testling->setPolicy(policy, timerFactory);
+
+			testling->handleStanzaSent(createPresence("p1"));
+			timerFactory->setTime(200);
+
+			CPPUNIT_ASSERT_EQUAL(0, acksRequested);
+		}
+
+		void testHandleStanzaSent_MaxUnackedStanzas() {
+			boost::shared_ptr<StanzaAckRequester> testling(createRequester());
+			StanzaAckRequestPolicy policy;
+			policy.maxUnackedStanzas = 2;
+			testling->setPolicy(policy);
+
+			testling->handleStanzaSent(createMessage("m1"));
+			testling->handleStanzaSent(createMessage("m2"));
+			testling->handleStanzaSent(createMessage("m3"));
+			CPPUNIT_ASSERT_EQUAL(2, static_cast<int>(testling->getUnackedStanzas().size()));
+			CPPUNIT_ASSERT(testling->hasForgottenStanzas());
+
+			testling->handleAckReceived(2);
+			CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(ackedStanzas.size()));
+			CPPUNIT_ASSERT_EQUAL(std::string("m2"), ackedStanzas[0]->getID());
+			CPPUNIT_ASSERT(!testling->hasForgottenStanzas());
+		}
+
 	private:
 		Message::ref createMessage(const std::string& id) {
 			Message::ref result(new Message());
@@ -157,6 +288,7 @@ class StanzaAckRequesterTest : public CppUnit::TestFixture {
 
 	private:
 		int acksRequested;
+		DummyTimerFactory* timerFactory;
 		std::vector< boost::shared_ptr<Stanza> > ackedStanzas;
 };
 
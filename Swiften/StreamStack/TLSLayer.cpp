@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -29,6 +29,10 @@ void TLSLayer::connect() {
 	context->connect();
 }
 
+void TLSLayer::accept() {
+	context->accept();
+}
+
 void TLSLayer::writeData(const SafeByteArray& data) {
 	context->handleDataFromApplication(data);
 }
@@ -41,6 +45,14 @@ bool TLSLayer::setClientCertificate(CertificateWithKey::ref certificate) {
 	return context->setClientCertificate(certificate);
 }
 
+bool TLSLayer::setServerCertificate(CertificateWithKey::ref certificate) {
+	return context->setServerCertificate(certificate);
+}
+
+void TLSLayer::setServerIdentity(const std::string& identity) {
+	context->setServerIdentity(identity);
+}
+
 Certificate::ref TLSLayer::getPeerCertificate() const {
 	return context->getPeerCertificate();
 }
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <string>
 #include <Swiften/Base/boost_bsignals.h>
 
 #include <Swiften/Base/SafeByteArray.h>
@@ -25,7 +26,10 @@ namespace Swift {
 			~TLSLayer();
 
 			void connect();
+			void accept();
 			bool setClientCertificate(CertificateWithKey::ref cert);
+			bool setServerCertificate(CertificateWithKey::ref cert);
+			void setServerIdentity(const std::string& identity);
 
 			Certificate::ref getPeerCertificate() const;
 			std::vector<Certificate::ref> getPeerCertificateChain() const;
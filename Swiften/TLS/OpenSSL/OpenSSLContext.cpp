@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010-2013 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -23,6 +23,7 @@
 #include <Swiften/TLS/OpenSSL/OpenSSLCertificate.h>
 #include <Swiften/TLS/CertificateWithKey.h>
 #include <Swiften/TLS/PKCS12Certificate.h>
+#include <Swiften/StringCodecs/Hexify.h>
 
 #pragma GCC diagnostic ignored "-Wold-style-cast"
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -39,10 +40,25 @@ static void freeX509Stack(STACK_OF(X509)* stack) {
 	sk_X509_free(stack);
 }
 
-OpenSSLContext::OpenSSLContext() : state_(Start), context_(0), handle_(0), readBIO_(0), writeBIO_(0) {
+OpenSSLContext::OpenSSLContext(boost::shared_ptr<SSL_CTX> context, boost::shared_ptr<OpenSSLSessionCache> sessionCache) : state_(Start), context_(context), sessionCache_(sessionCache), server_(false), handle_(0), readBIO_(0), writeBIO_(0) {
+	// Created here already, so that a client certificate can be set on it
+	// without touching the shared SSL_CTX.
+	handle_ = SSL_new(context_.get());
+	SSL_set_app_data(handle_, this);
+}
+
+OpenSSLContext::~OpenSSLContext() {
+	SSL_free(handle_);
+}
+
+boost::shared_ptr<SSL_CTX> OpenSSLContext::createContext() {
 	ensureLibraryInitialized();
-	context_ = SSL_CTX_new(SSLv23_client_method());
-	SSL_CTX_set_options(context_, SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3);
+	boost::shared_ptr<SSL_CTX> context(SSL_CTX_new(SSLv23_method()), SSL_CTX_free);
+	SSL_CTX_set_options(context.get(), SSL_OP_NO_SSLv2 | SSL_OP_NO_SSLv3);
+
+	// Client sessions are kept per factory, in an OpenSSLSessionCache
+	SSL_CTX_set_session_cache_mode(context.get(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+	SSL_CTX_sess_set_new_cb(context.get(), &OpenSSLContext::handleNewSession);
 
 	// TODO: implement CRL checking
 	// TODO: download CRL (HTTP transport)
@@ -52,7 +68,7 @@ OpenSSLContext::OpenSSLContext() : state_(Start), context_(0), handle_(0), readB
 	// TODO: handle OCSP stapling see https://www.rfc-editor.org/rfc/rfc4366.txt
 	// Load system certs
 #if defined(SWIFTEN_PLATFORM_WINDOWS)
-	X509_STORE* store = SSL_CTX_get_cert_store(context_);
+	X509_STORE* store = SSL_CTX_get_cert_store(context.get());
 	HCERTSTORE systemStore = CertOpenSystemStore(0, "ROOT");
 	if (systemStore) {
 		PCCERT_CONTEXT certContext = NULL;
@@ -68,7 +84,7 @@ OpenSSLContext::OpenSSLContext() : state_(Start), context_(0), handle_(0), readB
 		}
 	}
 #elif !defined(SWIFTEN_PLATFORM_MACOSX)
-	SSL_CTX_load_verify_locations(context_, NULL, "/etc/ssl/certs");
+	SSL_CTX_load_verify_locations(context.get(), NULL, "/etc/ssl/certs");
 #elif defined(SWIFTEN_PLATFORM_MACOSX) && !defined(SWIFTEN_PLATFORM_IPHONE)
 	// On Mac OS X 10.5 (OpenSSL < 0.9.8), OpenSSL does not automatically look in the system store.
 	// On Mac OS X 10.6 (OpenSSL >= 0.9.8), OpenSSL *does* look in the system store to determine trust.
@@ -76,7 +92,7 @@ OpenSSLContext::OpenSSLContext() : state_(Start), context_(0), handle_(0), readB
 	// the certificates first. See 
 	//		http://opensource.apple.com/source/OpenSSL098/OpenSSL098-27/src/crypto/x509/x509_vfy_apple.c
 	// to understand why. We therefore add all certs from the system store ourselves.
-	X509_STORE* store = SSL_CTX_get_cert_store(context_);
+	X509_STORE* store = SSL_CTX_get_cert_store(context.get());
 	CFArrayRef anchorCertificates;
 	if (SecTrustCopyAnchorCertificates(&anchorCertificates) == 0) {
 		for (int i = 0; i < CFArrayGetCount(anchorCertificates); ++i) {
@@ -96,11 +112,7 @@ OpenSSLContext::OpenSSLContext() : state_(Start), context_(0), handle_(0), readB
 		CFRelease(anchorCertificates);
 	}
 #endif
-}
-
-OpenSSLContext::~OpenSSLContext() {
-	SSL_free(handle_);
-	SSL_CTX_free(context_);
+	return context;
 }
 
 void OpenSSLContext::ensureLibraryInitialized() {
@@ -119,23 +131,67 @@ void OpenSSLContext::ensureLibraryInitialized() {
 	}
 }
 
+int OpenSSLContext::handleNewSession(SSL* handle, SSL_SESSION* session) {
+	OpenSSLContext* context = static_cast<OpenSSLContext*>(SSL_get_app_data(handle));
+	if (!context || !context->sessionCache_ || context->serverIdentity_.empty()) {
+		return 0;
+	}
+	context->sessionCache_->setSession(context->getSessionKey(), session);
+	// We keep the reference to the session
+	return 1;
+}
+
+void OpenSSLContext::setServerIdentity(const std::string& identity) {
+	serverIdentity_ = identity;
+}
+
+std::string OpenSSLContext::getSessionKey() const {
+	// A session authenticated with one client certificate must not be
+	// resumed with another one, or without one
+	if (clientCertificateFingerprint_.empty()) {
+		return serverIdentity_;
+	}
+	return serverIdentity_ + " " + clientCertificateFingerprint_;
+}
+
 void OpenSSLContext::connect() {
-	handle_ = SSL_new(context_);
+	if (sessionCache_ && !serverIdentity_.empty()) {
+		if (boost::shared_ptr<SSL_SESSION> session = sessionCache_->getSession(getSessionKey())) {
+			SSL_set_session(handle_, session.get());
+		}
+	}
+
+	SSL_set_connect_state(handle_);
+	startHandshake();
+}
+
+void OpenSSLContext::accept() {
+	server_ = true;
+	SSL_set_accept_state(handle_);
+	startHandshake();
+}
+
+void OpenSSLContext::startHandshake() {
 	// Ownership of BIOs is ransferred
 	readBIO_ = BIO_new(BIO_s_mem());
 	writeBIO_ = BIO_new(BIO_s_mem());
 	SSL_set_bio(handle_, readBIO_, writeBIO_);
 
 	state_ = Connecting;
-	doConnect();
+	doHandshake();
 }
 
-void OpenSSLContext::doConnect() {
-	int connectResult = SSL_connect(handle_);
-	int error = SSL_get_error(handle_, connectResult);
+void OpenSSLContext::doHandshake() {
+	int handshakeResult = SSL_do_handshake(handle_);
+	int error = SSL_get_error(handle_, handshakeResult);
 	switch (error) {
 		case SSL_ERROR_NONE: {
 			state_ = Connected;
+			if (sessionCache_ && !server_) {
+				sessionCache_->handleHandshakeFinished(SSL_session_reused(handle_) != 0);
+			}
+			// The last handshake message may still have to be sent
+			sendPendingDataToNetwork();
 			//std::cout << x->name << std::endl;
 			//const char* comp = SSL_get_current_compression(handle_);
 			//std::cout << "Compression: " << SSL_COMP_get_name(comp) << std::endl;
@@ -147,6 +203,10 @@ void OpenSSLContext::doConnect() {
 			break;
 		default:
 			state_ = Error;
+			// Don't offer the session again if it caused the failure
+			if (sessionCache_ && !serverIdentity_.empty()) {
+				sessionCache_->removeSession(getSessionKey());
+			}
 			onError(boost::make_shared<TLSError>());
 	}
 }
@@ -165,7 +225,7 @@ void OpenSSLContext::handleDataFromNetwork(const SafeByteArray& data) {
 	BIO_write(readBIO_, vecptr(data), data.size());
 	switch (state_) {
 		case Connecting:
-			doConnect();
+			doHandshake();
 			break;
 		case Connected:
 			sendPendingDataToApplication();
@@ -202,6 +262,23 @@ void OpenSSLContext::sendPendingDataToApplication() {
 }
 
 bool OpenSSLContext::setClientCertificate(CertificateWithKey::ref certificate) {
+	if (!setCertificate(certificate)) {
+		return false;
+	}
+	unsigned char fingerprint[EVP_MAX_MD_SIZE];
+	unsigned int fingerprintSize = 0;
+	if (X509_digest(SSL_get_certificate(handle_), EVP_sha256(), fingerprint, &fingerprintSize) != 1) {
+		return false;
+	}
+	clientCertificateFingerprint_ = Hexify::hexify(createByteArray(fingerprint, fingerprintSize));
+	return true;
+}
+
+bool OpenSSLContext::setServerCertificate(CertificateWithKey::ref certificate) {
+	return setCertificate(certificate);
+}
+
+bool OpenSSLContext::setCertificate(CertificateWithKey::ref certificate) {
 	boost::shared_ptr<PKCS12Certificate> pkcs12Certificate = boost::dynamic_pointer_cast<PKCS12Certificate>(certificate);
 	if (!pkcs12Certificate || pkcs12Certificate->isNull()) {
 		return false;
@@ -230,15 +307,31 @@ bool OpenSSLContext::setClientCertificate(CertificateWithKey::ref certificate) {
 	boost::shared_ptr<EVP_PKEY> privateKey(privateKeyPtr, EVP_PKEY_free);
 	boost::shared_ptr<STACK_OF(X509)> caCerts(caCertsPtr, freeX509Stack);
 
-	// Use the key & certificates
-	if (SSL_CTX_use_certificate(context_, cert.get()) != 1) {
+#if OPENSSL_VERSION_NUMBER < 0x10002000L
+	// Before OpenSSL 1.0.2, the CA certificates can only be set on an SSL_CTX,
+	// so this connection gets an SSL_CTX of its own.
+	if (sk_X509_num(caCerts.get()) > 0) {
+		assert(state_ == Start);
+		context_ = createContext();
+		SSL_free(handle_);
+		handle_ = SSL_new(context_.get());
+		SSL_set_app_data(handle_, this);
+	}
+#endif
+
+	// Use the key & certificates for this connection only
+	if (SSL_use_certificate(handle_, cert.get()) != 1) {
 		return false;
 	}
-	if (SSL_CTX_use_PrivateKey(context_, privateKey.get()) != 1) {
+	if (SSL_use_PrivateKey(handle_, privateKey.get()) != 1) {
 		return false;
 	}
 	for (int i = 0;  i < sk_X509_num(caCerts.get()); ++i) {
-		SSL_CTX_add_extra_chain_cert(context_, sk_X509_value(caCerts.get(), i));
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+		SSL_add0_chain_cert(handle_, sk_X509_value(caCerts.get(), i));
+#else
+		SSL_CTX_add_extra_chain_cert(context_.get(), sk_X509_value(caCerts.get(), i));
+#endif
 	}
 	return true;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -9,20 +9,41 @@
 #include <openssl/ssl.h>
 #include <Swiften/Base/boost_bsignals.h>
 #include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <Swiften/TLS/TLSContext.h>
 #include <Swiften/Base/ByteArray.h>
 #include <Swiften/TLS/CertificateWithKey.h>
+#include <Swiften/TLS/OpenSSL/OpenSSLSessionCache.h>
 
 namespace Swift {
 
 	class OpenSSLContext : public TLSContext, boost::noncopyable {
 		public:
-			OpenSSLContext();
+			/**
+			 * Creates a context for a single connection. The SSL_CTX, which
+			 * holds the trust store, can be shared by many contexts. Before
+			 * OpenSSL 1.0.2, a context whose certificate comes with CA
+			 * certificates switches to an SSL_CTX of its own.
+			 *
+			 * If a session cache is given, the context resumes the session of an
+			 * earlier connection to the same server with the same client
+			 * certificate, if there is one.
+			 */
+			OpenSSLContext(boost::shared_ptr<SSL_CTX> context, boost::shared_ptr<OpenSSLSessionCache> sessionCache = boost::shared_ptr<OpenSSLSessionCache>());
 			~OpenSSLContext();
 
+			/**
+			 * Creates an SSL_CTX for client and server connections, which
+			 * trusts the certificates in the system store.
+			 */
+			static boost::shared_ptr<SSL_CTX> createContext();
+
 			void connect();
+			virtual void accept();
 			bool setClientCertificate(CertificateWithKey::ref cert);
+			virtual bool setServerCertificate(CertificateWithKey::ref cert);
+			virtual void setServerIdentity(const std::string& identity);
 
 			void handleDataFromNetwork(const SafeByteArray&);
 			void handleDataFromApplication(const SafeByteArray&);
@@ -34,10 +55,14 @@ namespace Swift {
 
 		private:
 			static void ensureLibraryInitialized();	
+			static int handleNewSession(SSL* handle, SSL_SESSION* session);
 
 			static CertificateVerificationError::Type getVerificationErrorTypeForResult(int);
 
-			void doConnect();
+			bool setCertificate(CertificateWithKey::ref cert);
+			std::string getSessionKey() const;
+			void startHandshake();
+			void doHandshake();
 			void sendPendingDataToNetwork();
 			void sendPendingDataToApplication();
 
@@ -45,7 +70,11 @@ namespace Swift {
 			enum State { Start, Connecting, Connected, Error };
 
 			State state_;
-			SSL_CTX* context_;
+			boost::shared_ptr<SSL_CTX> context_;
+			boost::shared_ptr<OpenSSLSessionCache> sessionCache_;
+			std::string serverIdentity_;
+			std::string clientCertificateFingerprint_;
+			bool server_;
 			SSL* handle_;
 			BIO* readBIO_;
 			BIO* writeBIO_;
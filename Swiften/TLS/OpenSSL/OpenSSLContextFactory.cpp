@@ -1,21 +1,56 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/TLS/OpenSSL/OpenSSLContextFactory.h>
+
+#include <boost/smart_ptr/make_shared.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/weak_ptr.hpp>
+
 #include <Swiften/TLS/OpenSSL/OpenSSLContext.h>
 #include <Swiften/Base/Log.h>
 
 namespace Swift {
 
+namespace {
+	boost::mutex sharedContextMutex;
+	boost::weak_ptr<SSL_CTX> sharedContext;
+
+	/**
+	 * Returns the SSL_CTX shared by all factories, creating it if no
+	 * factory holds it anymore.
+	 */
+	boost::shared_ptr<SSL_CTX> getSharedContext() {
+		boost::lock_guard<boost::mutex> lock(sharedContextMutex);
+		boost::shared_ptr<SSL_CTX> context = sharedContext.lock();
+		if (!context) {
+			context = OpenSSLContext::createContext();
+			sharedContext = context;
+		}
+		return context;
+	}
+}
+
+OpenSSLContextFactory::OpenSSLContextFactory() : sessionCache_(boost::make_shared<OpenSSLSessionCache>()) {
+}
+
+OpenSSLContextFactory::OpenSSLContextFactory(boost::shared_ptr<SSL_CTX> context) : context_(context), sessionCache_(boost::make_shared<OpenSSLSessionCache>()) {
+}
+
 bool OpenSSLContextFactory::canCreate() const {
 	return true;
 }
 
 TLSContext* OpenSSLContextFactory::createTLSContext() {
-	return new OpenSSLContext();
+	// Created on first use, because loading the trust store is expensive
+	if (!context_) {
+		context_ = getSharedContext();
+	}
+	return new OpenSSLContext(context_, sessionCache_);
 }
 
 void OpenSSLContextFactory::setCheckCertificateRevocation(bool check) {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
@@ -9,14 +9,43 @@
 #include <Swiften/TLS/TLSContextFactory.h>
 
 #include <cassert>
+#include <openssl/ssl.h>
+#include <boost/shared_ptr.hpp>
+
+#include <Swiften/TLS/OpenSSL/OpenSSLSessionCache.h>
 
 namespace Swift {
+	/**
+	 * Creates OpenSSL contexts.
+	 *
+	 * All contexts share one SSL_CTX, so the trust store is only loaded
+	 * once. By default, the SSL_CTX is also shared with other factories.
+	 *
+	 * The contexts of a factory share a session cache, so reconnecting to
+	 * a server can resume the session of an earlier connection.
+	 */
 	class OpenSSLContextFactory : public TLSContextFactory {
 		public:
+			OpenSSLContextFactory();
+
+			/**
+			 * Creates contexts from the given SSL_CTX, e.g. to use a different
+			 * trust store.
+			 */
+			OpenSSLContextFactory(boost::shared_ptr<SSL_CTX> context);
+
 			bool canCreate() const;
 			virtual TLSContext* createTLSContext();
 
 			// Not supported
 			virtual void setCheckCertificateRevocation(bool b);
+
+			OpenSSLSessionCache* getSessionCache() const {
+				return sessionCache_.get();
+			}
+
+		private:
+			boost::shared_ptr<SSL_CTX> context_;
+			boost::shared_ptr<OpenSSLSessionCache> sessionCache_;
 	};
 }
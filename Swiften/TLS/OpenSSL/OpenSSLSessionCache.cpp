@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <Swiften/TLS/OpenSSL/OpenSSLSessionCache.h>
+
+#include <boost/thread/locks.hpp>
+
+namespace Swift {
+
+OpenSSLSessionCache::OpenSSLSessionCache(size_t capacity) : sessions(capacity), resumedHandshakes(0), fullHandshakes(0) {
+}
+
+boost::shared_ptr<SSL_SESSION> OpenSSLSessionCache::getSession(const std::string& key) {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	const boost::shared_ptr<SSL_SESSION>* session = sessions.get(key);
+	return session ? *session : boost::shared_ptr<SSL_SESSION>();
+}
+
+void OpenSSLSessionCache::setSession(const std::string& key, SSL_SESSION* session) {
+	boost::shared_ptr<SSL_SESSION> sessionPointer(session, SSL_SESSION_free);
+	boost::lock_guard<boost::mutex> lock(mutex);
+	sessions.put(key, sessionPointer);
+}
+
+void OpenSSLSessionCache::removeSession(const std::string& key) {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	sessions.remove(key);
+}
+
+void OpenSSLSessionCache::handleHandshakeFinished(bool resumed) {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	if (resumed) {
+		++resumedHandshakes;
+	}
+	else {
+		++fullHandshakes;
+	}
+}
+
+size_t OpenSSLSessionCache::getResumedHandshakeCount() const {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	return resumedHandshakes;
+}
+
+size_t OpenSSLSessionCache::getFullHandshakeCount() const {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	return fullHandshakes;
+}
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#pragma once
+
+#include <string>
+#include <openssl/ssl.h>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <Swiften/Base/LRUCache.h>
+
+namespace Swift {
+	/**
+	 * Keeps the TLS sessions of recent connections, keyed by the identity of
+	 * the server and the client certificate, so that new connections to the
+	 * same server with the same certificate can resume them instead of doing
+	 * a full handshake.
+	 *
+	 * This class is thread-safe.
+	 */
+	class OpenSSLSessionCache : public boost::noncopyable {
+		public:
+			OpenSSLSessionCache(size_t capacity = 100);
+
+			/**
+			 * Returns the session for the given key, or NULL if there is none.
+			 */
+			boost::shared_ptr<SSL_SESSION> getSession(const std::string& key);
+
+			/**
+			 * Stores a session. This takes over the reference to the session.
+			 */
+			void setSession(const std::string& key, SSL_SESSION* session);
+
+			void removeSession(const std::string& key);
+
+			void handleHandshakeFinished(bool resumed);
+
+			size_t getResumedHandshakeCount() const;
+			size_t getFullHandshakeCount() const;
+
+		private:
+			mutable boost::mutex mutex;
+			LRUCache<std::string, boost::shared_ptr<SSL_SESSION> > sessions;
+			size_t resumedHandshakes;
+			size_t fullHandshakes;
+	};
+}
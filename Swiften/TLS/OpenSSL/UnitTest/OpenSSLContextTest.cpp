@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <vector>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/smart_ptr/make_shared.hpp>
+#include <openssl/evp.h>
+#include <openssl/pkcs12.h>
+#include <openssl/x509.h>
+
+#include <Swiften/Base/ByteArray.h>
+#include <Swiften/TLS/OpenSSL/OpenSSLContext.h>
+#include <Swiften/TLS/OpenSSL/OpenSSLContextFactory.h>
+#include <Swiften/TLS/PKCS12Certificate.h>
+
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+
+using namespace Swift;
+
+class OpenSSLContextTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(OpenSSLContextTest);
+		CPPUNIT_TEST(testHandshake);
+		CPPUNIT_TEST(testHandshake_ResumesSession);
+		CPPUNIT_TEST(testHandshake_OtherServerIdentityDoesNotResume);
+		CPPUNIT_TEST(testHandshake_SameClientCertificateResumesSession);
+		CPPUNIT_TEST(testHandshake_OtherClientCertificateDoesNotResume);
+		CPPUNIT_TEST(testAccept_NoCertificate);
+		CPPUNIT_TEST(testAccept_CertificateWithCASendsChain);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void setUp() {
+			certificate = createCertificate();
+			clientFactory = new OpenSSLContextFactory();
+			serverFactory = new OpenSSLContextFactory();
+		}
+
+		void tearDown() {
+			delete serverFactory;
+			delete clientFactory;
+		}
+
+		void testHandshake() {
+			boost::shared_ptr<ContextPair> connection = createContextPair("example.com", certificate);
+
+			connection->handshake();
+
+			CPPUNIT_ASSERT(connection->clientConnected);
+			CPPUNIT_ASSERT(connection->serverConnected);
+			CPPUNIT_ASSERT(!connection->error);
+
+			connection->client->handleDataFromApplication(createSafeByteArray("<stream>"));
+			connection->server->handleDataFromApplication(createSafeByteArray("<features/>"));
+			connection->pump();
+
+			CPPUNIT_ASSERT_EQUAL(std::string("<stream>"), safeByteArrayToString(connection->serverData));
+			CPPUNIT_ASSERT_EQUAL(std::string("<features/>"), safeByteArrayToString(connection->clientData));
+		}
+
+		void testHandshake_ResumesSession() {
+			boost::shared_ptr<ContextPair> connection1 = createContextPair("example.com", certificate);
+			connection1->handshake();
+			boost::shared_ptr<ContextPair> connection2 = createContextPair("example.com", certificate);
+			connection2->handshake();
+
+			CPPUNIT_ASSERT(connection2->clientConnected);
+			CPPUNIT_ASSERT(connection2->serverConnected);
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), clientFactory->getSessionCache()->getFullHandshakeCount());
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), clientFactory->getSessionCache()->getResumedHandshakeCount());
+		}
+
+		void testHandshake_OtherServerIdentityDoesNotResume() {
+			boost::shared_ptr<ContextPair> connection1 = createContextPair("example.com", certificate);
+			connection1->handshake();
+			boost::shared_ptr<ContextPair> connection2 = createContextPair("example.org", certificate);
+			connection2->handshake();
+
+			CPPUNIT_ASSERT(connection2->clientConnected);
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), clientFactory->getSessionCache()->getFullHandshakeCount());
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), clientFactory->getSessionCache()->getResumedHandshakeCount());
+		}
+
+		void testHandshake_SameClientCertificateResumesSession() {
+			CertificateWithKey::ref clientCertificate = createCertificate();
+			boost::shared_ptr<ContextPair> connection1 = createContextPair("example.com", certificate, clientCertificate);
+			connection1->handshake();
+			boost::shared_ptr<ContextPair> connection2 = createContextPair("example.com", certificate, clientCertificate);
+			connection2->handshake();
+
+			CPPUNIT_ASSERT(connection2->clientConnected);
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), clientFactory->getSessionCache()->getFullHandshakeCount());
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), clientFactory->getSessionCache()->getResumedHandshakeCount());
+		}
+
+		void testHandshake_OtherClientCertificateDoesNotResume() {
+			boost::shared_ptr<ContextPair> connection1 = createContextPair("example.com", certificate, createCertificate());
+			connection1->handshake();
+			boost::shared_ptr<ContextPair> connection2 = createContextPair("example.com", certificate, createCertificate());
+			connection2->handshake();
+			boost::shared_ptr<ContextPair> connection3 = createContextPair("example.com", certificate);
+			connection3->handshake();
+
+			CPPUNIT_ASSERT(connection2->clientConnected);
+			CPPUNIT_ASSERT(connection3->clientConnected);
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), clientFactory->getSessionCache()->getFullHandshakeCount());
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), clientFactory->getSessionCache()->getResumedHandshakeCount());
+		}
+
+		void testAccept_NoCertificate() {
+			boost::shared_ptr<ContextPair> connection = createContextPair("example.com", CertificateWithKey::ref());
+
+			connection->handshake();
+
+			CPPUNIT_ASSERT(!connection->serverConnected);
+			CPPUNIT_ASSERT(connection->error);
+		}
+
+		void testAccept_CertificateWithCASendsChain() {
+			boost::shared_ptr<X509> caCertificate = createX509(createKey(), "Example CA");
+			boost::shared_ptr<ContextPair> connection = createContextPair("example.com", createCertificate(caCertificate));
+
+			connection->handshake();
+
+			CPPUNIT_ASSERT(connection->clientConnected);
+			std::vector<Certificate::ref> chain = connection->client->getPeerCertificateChain();
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), chain.size());
+			CPPUNIT_ASSERT_EQUAL(std::string("Example CA"), chain[1]->getCommonNames()[0]);
+		}
+
+	private:
+		/**
+		 * A client and a server context, talking to each other.
+		 */
+		struct ContextPair {
+			ContextPair(TLSContext* client, TLSContext* server) : client(client), server(server), clientConnected(false), serverConnected(false), error(false) {
+				client->onDataForNetwork.connect(boost::bind(&ContextPair::handleData, this, &toServer, _1));
+				client->onDataForApplication.connect(boost::bind(&ContextPair::handleData, this, &clientData, _1));
+				client->onConnected.connect(boost::bind(&ContextPair::handleConnected, this, &clientConnected));
+				client->onError.connect(boost::bind(&ContextPair::handleError, this));
+				server->onDataForNetwork.connect(boost::bind(&ContextPair::handleData, this, &toClient, _1));
+				server->onDataForApplication.connect(boost::bind(&ContextPair::handleData, this, &serverData, _1));
+				server->onConnected.connect(boost::bind(&ContextPair::handleConnected, this, &serverConnected));
+				server->onError.connect(boost::bind(&ContextPair::handleError, this));
+			}
+
+			~ContextPair() {
+				delete client;
+				delete server;
+			}
+
+			void handshake() {
+				server->accept();
+				client->connect();
+				pump();
+			}
+
+			void pump() {
+				while (!error && (!toServer.empty() || !toClient.empty())) {
+					SafeByteArray data;
+					data.swap(toServer);
+					if (!data.empty()) {
+						server->handleDataFromNetwork(data);
+					}
+					data.clear();
+					data.swap(toClient);
+					if (!data.empty()) {
+						client->handleDataFromNetwork(data);
+					}
+				}
+			}
+
+			void handleData(SafeByteArray* target, const SafeByteArray& data) {
+				target->insert(target->end(), data.begin(), data.end());
+			}
+
+			void handleConnected(bool* connected) {
+				*connected = true;
+			}
+
+			void handleError() {
+				error = true;
+			}
+
+			TLSContext* client;
+			TLSContext* server;
+			SafeByteArray toServer;
+			SafeByteArray toClient;
+			SafeByteArray clientData;
+			SafeByteArray serverData;
+			bool clientConnected;
+			bool serverConnected;
+			bool error;
+		};
+
+		boost::shared_ptr<ContextPair> createContextPair(const std::string& serverIdentity, CertificateWithKey::ref serverCertificate, CertificateWithKey::ref clientCertificate = CertificateWithKey::ref()) {
+			TLSContext* client = clientFactory->createTLSContext();
+			client->setServerIdentity(serverIdentity);
+			if (clientCertificate) {
+				CPPUNIT_ASSERT(client->setClientCertificate(clientCertificate));
+			}
+			TLSContext* server = serverFactory->createTLSContext();
+			if (serverCertificate) {
+				CPPUNIT_ASSERT(server->setServerCertificate(serverCertificate));
+			}
+			return boost::make_shared<ContextPair>(client, server);
+		}
+
+		/**
+		 * Creates a certificate with a new key, signed by itself. The given CA
+		 * certificate is sent along with it.
+		 */
+		static CertificateWithKey::ref createCertificate(boost::shared_ptr<X509> caCertificate = boost::shared_ptr<X509>()) {
+			boost::shared_ptr<EVP_PKEY> key = createKey();
+			boost::shared_ptr<X509> x509 = createX509(key, "example.com");
+
+			boost::shared_ptr<STACK_OF(X509)> caCertificates(sk_X509_new_null(), freeX509Stack);
+			if (caCertificate) {
+				sk_X509_push(caCertificates.get(), caCertificate.get());
+			}
+			boost::shared_ptr<PKCS12> pkcs12(PKCS12_create(const_cast<char*>(""), const_cast<char*>("example.com"), key.get(), x509.get(), caCertificates.get(), 0, 0, 0, 0, 0), PKCS12_free);
+			int size = i2d_PKCS12(pkcs12.get(), NULL);
+			ByteArray data(static_cast<size_t>(size));
+			unsigned char* dataPointer = vecptr(data);
+			i2d_PKCS12(pkcs12.get(), &dataPointer);
+
+			boost::shared_ptr<PKCS12Certificate> certificate = boost::make_shared<PKCS12Certificate>();
+			certificate->setData(data);
+			return certificate;
+		}
+
+		static boost::shared_ptr<EVP_PKEY> createKey() {
+			boost::shared_ptr<EVP_PKEY_CTX> keyContext(EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, NULL), EVP_PKEY_CTX_free);
+			EVP_PKEY_keygen_init(keyContext.get());
+			EVP_PKEY_CTX_set_rsa_keygen_bits(keyContext.get(), 2048);
+			EVP_PKEY* keyPointer = NULL;
+			EVP_PKEY_keygen(keyContext.get(), &keyPointer);
+			return boost::shared_ptr<EVP_PKEY>(keyPointer, EVP_PKEY_free);
+		}
+
+		static boost::shared_ptr<X509> createX509(boost::shared_ptr<EVP_PKEY> key, const std::string& commonName) {
+			boost::shared_ptr<X509> x509(X509_new(), X509_free);
+			X509_set_version(x509.get(), 2);
+			ASN1_INTEGER_set(X509_get_serialNumber(x509.get()), 1);
+			X509_gmtime_adj(X509_get_notBefore(x509.get()), 0);
+			X509_gmtime_adj(X509_get_notAfter(x509.get()), 3600);
+			X509_set_pubkey(x509.get(), key.get());
+			X509_NAME* name = X509_get_subject_name(x509.get());
+			X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>(commonName.c_str()), -1, -1, 0);
+			X509_set_issuer_name(x509.get(), name);
+			X509_sign(x509.get(), key.get(), EVP_sha256());
+			return x509;
+		}
+
+		static void freeX509Stack(STACK_OF(X509)* stack) {
+			sk_X509_free(stack);
+		}
+
+	private:
+		CertificateWithKey::ref certificate;
+		OpenSSLContextFactory* clientFactory;
+		OpenSSLContextFactory* serverFactory;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OpenSSLContextTest);
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2015 Isode Limited.
+ * All rights reserved.
+ * See the COPYING file for more information.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+
+#include <Swiften/TLS/OpenSSL/OpenSSLSessionCache.h>
+
+using namespace Swift;
+
+class OpenSSLSessionCacheTest : public CppUnit::TestFixture {
+		CPPUNIT_TEST_SUITE(OpenSSLSessionCacheTest);
+		CPPUNIT_TEST(testGetSession_NoSession);
+		CPPUNIT_TEST(testSetSession);
+		CPPUNIT_TEST(testSetSession_ReplacesSession);
+		CPPUNIT_TEST(testSetSession_EvictsOldestSession);
+		CPPUNIT_TEST(testRemoveSession);
+		CPPUNIT_TEST(testHandshakeFinished);
+		CPPUNIT_TEST_SUITE_END();
+
+	public:
+		void testGetSession_NoSession() {
+			OpenSSLSessionCache testling;
+
+			CPPUNIT_ASSERT(!testling.getSession("example.com"));
+		}
+
+		void testSetSession() {
+			OpenSSLSessionCache testling;
+			SSL_SESSION* session = SSL_SESSION_new();
+
+			testling.setSession("example.com", session);
+
+			CPPUNIT_ASSERT(session == testling.getSession("example.com").get());
+			CPPUNIT_ASSERT(!testling.getSession("example.org"));
+		}
+
+		void testSetSession_ReplacesSession() {
+			OpenSSLSessionCache testling;
+			SSL_SESSION* session = SSL_SESSION_new();
+
+			testling.setSession("example.com", SSL_SESSION_new());
+			testling.setSession("example.com", session);
+
+			CPPUNIT_ASSERT(session == testling.getSession("example.com").get());
+		}
+
+		void testSetSession_EvictsOldestSession() {
+			OpenSSLSessionCache testling(2);
+
+			testling.setSession("example.com", SSL_SESSION_new());
+			testling.setSession("example.org", SSL_SESSION_new());
+			testling.getSession("example.com");
+			testling.setSession("example.net", SSL_SESSION_new());
+
+			CPPUNIT_ASSERT(testling.getSession("example.com"));
+			CPPUNIT_ASSERT(!testling.getSession("example.org"));
+			CPPUNIT_ASSERT(testling.getSession("example.net"));
+		}
+
+		void testRemoveSession() {
+			OpenSSLSessionCache testling;
+			testling.setSession("example.com", SSL_SESSION_new());
+
+			testling.removeSession("example.com");
+
+			CPPUNIT_ASSERT(!testling.getSession("example.com"));
+		}
+
+		void testHandshakeFinished() {
+			OpenSSLSessionCache testling;
+
+			testling.handleHandshakeFinished(false);
+			testling.handleHandshakeFinished(true);
+			testling.handleHandshakeFinished(true);
+
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), testling.getFullHandshakeCount());
+			CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), testling.getResumedHandshakeCount());
+		}
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OpenSSLSessionCacheTest);
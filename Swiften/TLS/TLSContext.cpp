@@ -1,16 +1,29 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #include <Swiften/TLS/TLSContext.h>
 
+#include <boost/smart_ptr/make_shared.hpp>
+
 namespace Swift {
 
 TLSContext::~TLSContext() {
 }
 
+void TLSContext::accept() {
+	onError(boost::make_shared<TLSError>());
+}
+
+bool TLSContext::setServerCertificate(CertificateWithKey::ref) {
+	return false;
+}
+
+void TLSContext::setServerIdentity(const std::string&) {
+}
+
 Certificate::ref TLSContext::getPeerCertificate() const {
 	std::vector<Certificate::ref> chain = getPeerCertificateChain();
 	return chain.empty() ? Certificate::ref() : chain[0];
@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2010 Isode Limited.
+ * Copyright (c) 2010-2015 Isode Limited.
  * All rights reserved.
  * See the COPYING file for more information.
  */
 
 #pragma once
 
+#include <string>
 #include <Swiften/Base/boost_bsignals.h>
 #include <boost/shared_ptr.hpp>
 
@@ -23,8 +24,31 @@ namespace Swift {
 
 			virtual void connect() = 0;
 
+			/**
+			 * Starts the handshake as the server side of the connection.
+			 *
+			 * A server certificate must be set before calling this. Contexts
+			 * that only support the client side report an error.
+			 */
+			virtual void accept();
+
 			virtual bool setClientCertificate(CertificateWithKey::ref cert) = 0;
 
+			/**
+			 * Sets the certificate this context presents when accepting a
+			 * connection. Returns false if the certificate can't be used.
+			 */
+			virtual bool setServerCertificate(CertificateWithKey::ref cert);
+
+			/**
+			 * Sets the identity of the server this context connects to.
+			 *
+			 * Contexts that support session resumption use this to find a
+			 * session of an earlier connection to the same server. This must be
+			 * called before connect().
+			 */
+			virtual void setServerIdentity(const std::string& identity);
+
 			virtual void handleDataFromNetwork(const SafeByteArray&) = 0;
 			virtual void handleDataFromApplication(const SafeByteArray&) = 0;
 